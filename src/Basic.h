@@ -8,6 +8,7 @@
 #include "Libs.h"
 #include "Exception.h"
 #include "Utils/Logger.h"
+#include "Utils/SlotMap.h"
 
 using SRenderer     = SDL_Renderer;
 using SSurface      = SDL_Surface;
@@ -109,6 +110,7 @@ namespace MyEngine {
      * @brief Generate unique ID.
      * 
      * @details Multiple ID generators can be created and generate unique ID values.
+     * All functions are thread-safe, at most `MAX_GENERATOR_COUNT` generators can be created.
      * \endif
      */
     class IDGenerator {
@@ -119,6 +121,7 @@ namespace MyEngine {
         IDGenerator(IDGenerator&&) = delete;
         IDGenerator& operator=(const IDGenerator&) = delete;
         IDGenerator& operator=(IDGenerator&&) = delete;
+        static constexpr size_t MAX_GENERATOR_COUNT = 64;
 
         /**
          * \if EN
@@ -126,12 +129,21 @@ namespace MyEngine {
          *
          * @details You can use the `getID()` function to generate this ID from the specified generator.
          * @return The index of the new ID generator.
+         * @note If there are already `MAX_GENERATOR_COUNT` generators, it throws `MyEngine::OutOfRangeException`.
          * \endif
          * @see getID
+         * @throw OutOfRangeException
          */
         static size_t newIDGenerator() {
-            _id_list.emplace_back(0);
-            return _id_list.size() - 1;
+            auto index = _generator_count.load();
+            do {
+                if (index >= MAX_GENERATOR_COUNT) {
+                    auto err = FMT::format("IDGenerator: Can't create more than {} ID generators!", MAX_GENERATOR_COUNT);
+                    Logger::log(err, Logger::Fatal);
+                    throw OutOfRangeException(err);
+                }
+            } while (!_generator_count.compare_exchange_weak(index, index + 1));
+            return index;
         }
 
         /**
@@ -141,7 +153,7 @@ namespace MyEngine {
          * \endif
          */
         static uint64_t getNewEventID() {
-            return ++_id_list[0];
+            return _id_list[0].fetch_add(1, std::memory_order_relaxed) + 1;
         }
         /**
          * \if EN
@@ -150,7 +162,7 @@ namespace MyEngine {
          * \endif
          */
         static uint64_t getNewGlobalEventID() {
-            return ++_id_list[1];
+            return _id_list[1].fetch_add(1, std::memory_order_relaxed) + 1;
         }
 
         /**
@@ -160,7 +172,7 @@ namespace MyEngine {
          * \endif
          */
         static uint64_t getNewTextID() {
-            return ++_id_list[2];
+            return _id_list[2].fetch_add(1, std::memory_order_relaxed) + 1;
         }
 
         /**
@@ -178,17 +190,28 @@ namespace MyEngine {
          * @throw OutOfRangeException
          */
         static uint64_t getID(size_t index = 0) {
-            if (index >= _id_list.size()) {
+            if (index >= _generator_count.load()) {
                 auto err = FMT::format("IDGenerator: The index of {} is not exist!", index);
                 Logger::log(Logger::Fatal, "IDGenerator: The index of {} is not exist!", index);
                 throw OutOfRangeException(err);
             }
-            return ++_id_list[index];
+            return _id_list[index].fetch_add(1, std::memory_order_relaxed) + 1;
         }
     private:
-        static std::vector<uint64_t> _id_list;
+        static std::array<std::atomic<uint64_t>, MAX_GENERATOR_COUNT> _id_list;
+        static std::atomic<size_t> _generator_count;
     };
-    inline std::vector<uint64_t> IDGenerator::_id_list(4, 0);
+    inline std::array<std::atomic<uint64_t>, IDGenerator::MAX_GENERATOR_COUNT> IDGenerator::_id_list{};
+    inline std::atomic<size_t> IDGenerator::_generator_count{4};
+
+    struct EventTag;
+    struct GlobalEventTag;
+    /// \if EN
+    /// @brief Handles of the events in `EventSystem`.
+    /// @details They wrap the IDs from `IDGenerator`, which are never reused, so a stale handle never matches.
+    /// \endif
+    using EventHandle = Handle<EventTag>;
+    using GlobalEventHandle = Handle<GlobalEventTag>;
 
     struct GeometryF;
     /**
@@ -2,14 +2,17 @@
 
 #include <memory>
 #include "Utils/Logger.h"
+#include "Utils/Clock.h"
 #include "Utils/FileSystem.h"
 #include "Utils/RGBAColor.h"
+#include "Utils/FontFaceCache.h"
+#include "Renderer/GlyphAtlas.h"
 #define MAX_AUDIO_FILE_SIZE (2 * 1024 * 1024) /// Defined the larger audio file
 
 namespace MyEngine {
     Font::Font(const std::string& font_path, float font_size)
             : _font_size(font_size), _font_path(font_path) {
-        _font = TTF_OpenFont(font_path.c_str(), font_size);
+        _font = FontFaceCache::global()->openFont(font_path, font_size);
         if (!_font) {
             Logger::log(FMT::format("Font: Can't load font from path '{}'.", font_path),
                         Logger::Error);
@@ -19,21 +22,24 @@ namespace MyEngine {
 
     Font::~Font() {
         if (_font) {
-            TTF_CloseFont(_font);
+            GlyphAtlas::forgetFont(_font);
+            FontFaceCache::global()->closeFont(_font);
         }
     }
 
     void Font::setFontPath(const std::string &font_path) {
-        auto _new_font = TTF_OpenFont(font_path.c_str(), _font_size);
+        auto _new_font = FontFaceCache::global()->openFont(font_path, _font_size);
         if (!_new_font) {
             Logger::log(FMT::format("Font: Can't load font from path '{}'.", font_path),
                         Logger::Error);
             return;
         }
         if (_font) {
-            TTF_CloseFont(_font);
+            GlyphAtlas::forgetFont(_font);
+            FontFaceCache::global()->closeFont(_font);
         }
         _font = _new_font;
+        _font_path = font_path;
     }
 
     const std::string& Font::fontPath() const { return _font_path; }
@@ -90,6 +96,8 @@ namespace MyEngine {
     }
 
     void Font::setFontHinting(uint32_t flags) {
+        /// The cached glyphs are rasterized with the old hinting.
+        GlyphAtlas::forgetFont(_font);
         TTF_SetFontHinting(_font, static_cast<TTF_HintingFlags>(flags));
         _font_hinting = flags;
     }
@@ -194,55 +202,80 @@ namespace MyEngine {
 
     FontMap FontDatabase::getFontDatabaseFromSystem() {
         if (!_is_loaded) {
-            StringList find_font_dir;
+            ensureIndex();
+            _font_db.clear();
+            _font_db.reserve(_font_index.size());
+            /// The index is sorted by name and the first scanned file comes first, so it wins as before.
+            for (size_t i = 0; i < _font_index.size(); ++i) {
+                auto font = _font_index.at(i);
+                _font_db.try_emplace(std::string(font.name), font.path);
+            }
+            Logger::log("FontDatabase: Get Font files from system!", Logger::Debug);
+            _is_loaded = true;
+        }
+        return _font_db;
+    }
+
+    std::string FontDatabase::findFontFromSystem(const std::string &font_name) {
+        ensureIndex();
+        auto font = _font_index.find(font_name);
+        if (!font) return {};
+        return std::string(font->path);
+    }
+
+    void FontDatabase::setFontIndexPath(const std::string& path) {
+        _index_path = path;
+        if (_font_index.isLoaded()) rebuildFontIndex();
+    }
+
+    void FontDatabase::rebuildFontIndex() {
+        ensureIndex(true);
+        _is_loaded = false;
+        _font_db.clear();
+        _def_fonts.clear();
+    }
+
+    std::vector<std::string> FontDatabase::systemFontDirectories() {
+        StringList find_font_dir;
+        std::string home;
+        if (auto home_folder = SDL_GetUserFolder(SDL_FOLDER_HOME)) home = home_folder;
 #ifdef _WIN32
-            find_font_dir.emplace_back("C:/Windows/Fonts");
+        find_font_dir.emplace_back("C:/Windows/Fonts");
+        if (!home.empty()) find_font_dir.emplace_back(home + "AppData/Local/Microsoft/Windows/Fonts");
 #endif
 #ifdef __linux__
-            find_font_dir.emplace_back("/usr/share/fonts");
-            if (FileSystem::isDir("~/.fonts")) {
-                find_font_dir.emplace_back("~/.fonts");
-            }
-            if (FileSystem::isDir("~/.local/share/fonts")) {
-                find_font_dir.emplace_back("~/.local/share/fonts");
-            }
+        find_font_dir.emplace_back("/usr/share/fonts");
+        if (!home.empty()) {
+            find_font_dir.emplace_back(home + ".fonts");
+            find_font_dir.emplace_back(home + ".local/share/fonts");
+        }
 #endif
 #ifdef __APPLE__
-            if (FileSystem::isDir("/System/Library/Fonts")) {
-                find_font_dir.emplace_back("/System/Library/Fonts");
-            }
-            if (FileSystem::isDir("/Library/Fonts")) {
-                find_font_dir.emplace_back("/Library/Fonts");
-            }
-            if (FileSystem::isDir("~/Library/Fonts")) {
-                find_font_dir.emplace_back("~/Library/Fonts");
-            }
+        find_font_dir.emplace_back("/System/Library/Fonts");
+        find_font_dir.emplace_back("/Library/Fonts");
+        if (!home.empty()) find_font_dir.emplace_back(home + "Library/Fonts");
 #endif
+        /// The missing directories are kept, so the index is updated when they are created.
+        return find_font_dir;
+    }
 
-            for (auto& font_dir : find_font_dir) {
-                StringList font_files = FileSystem::listFilesRecursively(font_dir,
-                                                         {".ttf", ".otf", ".ttc", ".woff", ".eot"});
-                for (auto& file : font_files) {
-                    auto short_file = FileSystem::getShortFileName(file, true);
-                    if (!_font_db.contains(short_file)) {
-                        _font_db.insert({FileSystem::getShortFileName(file, true), file});
-                    }
-                }
+    void FontDatabase::ensureIndex(bool rebuild) {
+        if (_font_index.isLoaded() && !rebuild) return;
+        if (!_index_path) {
+            _index_path.emplace();
+            if (auto pref_path = SDL_GetPrefPath("MyEngine", "Cache")) {
+                *_index_path = std::string(pref_path) + "FontIndex.bin";
+                SDL_free(pref_path);
             }
-            Logger::log("FontDatabase: Get Font files from system!", Logger::Debug);
-            _is_loaded = true;
         }
-        return _font_db;
-    }
-
-    std::string FontDatabase::findFontFromSystem(const std::string &font_name) {
-        if (!_is_loaded) getFontDatabaseFromSystem();
-        if (!_font_db.contains(font_name)) return {};
-        return _font_db[font_name];
+        auto start = std::chrono::steady_clock::now();
+        _font_index.load(*_index_path, systemFontDirectories(), rebuild);
+        Logger::log(Logger::Debug, "FontDatabase: The font index of {} fonts is ready in {} us",
+                    _font_index.size(), std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - start).count());
     }
 
     std::vector<FontDatabase::FontInfo> FontDatabase::getSystemDefaultFont() {
-        if (!_is_loaded) getFontDatabaseFromSystem();
         if (!_def_fonts.empty()) return _def_fonts;
 #ifdef _WIN32
         StringList common_fonts = { "arial", "segoeui", "tahoma", "verdana", "calibri" };
@@ -424,7 +457,7 @@ namespace MyEngine {
     TextureAtlas::~TextureAtlas() {}
 
     bool TextureAtlas::addTiles(const std::string &tiles_name, const MyEngine::GeometryF &clip_geometry) {
-        if (_tiles_map.contains(tiles_name)) {
+        if (_tiles_names.contains(tiles_name)) {
             Logger::log(FMT::format("TextureAtlas: Tiles '{}' is already in tiles map! "
                                     , tiles_name), Logger::Error);
             return false;
@@ -437,14 +470,14 @@ namespace MyEngine {
         ptr->clip_area = { clip_geometry.pos.x, clip_geometry.pos.y,
                            clip_geometry.size.width, clip_geometry.size.height };
 
-        _tiles_map.insert({tiles_name, Tile(tiles_name, std::move(new_list))});
+        _tiles_names.emplace(tiles_name, _tiles.emplace(tiles_name, std::move(new_list)));
         return true;
     }
 
     bool TextureAtlas::addTilesProperty(const std::string &tiles_name) {
-        if (_tiles_map.contains(tiles_name)) {
-            auto& temp = _tiles_map.at(tiles_name).properties.front();
-            _tiles_map.at(tiles_name).properties.push_back(std::make_unique<TextureProperty>(temp.get()));
+        if (auto tiles = findTiles(tiles_name)) {
+            auto& temp = tiles->properties.front();
+            tiles->properties.push_back(std::make_unique<TextureProperty>(temp.get()));
             return true;
         } else {
             Logger::log(FMT::format("TextureAtlas: Tiles '{}' is not in tiles map! "
@@ -454,21 +487,23 @@ namespace MyEngine {
     }
 
     bool TextureAtlas::eraseTiles(const std::string &tiles_name) {
-        if (_tiles_map.contains(tiles_name)) {
-            _tiles_map.erase(tiles_name);
+        auto it = _tiles_names.find(tiles_name);
+        if (it != _tiles_names.end()) {
+            _tiles.erase(it->second);
+            _tiles_names.erase(it);
             return true;
         }
         return false;
     }
 
     TextureProperty *TextureAtlas::tilesProperty(const std::string &tiles_name, size_t index) {
-        if (_tiles_map.contains(tiles_name)) {
-            if (index >= _tiles_map[tiles_name].properties.size()) {
+        if (auto tiles = findTiles(tiles_name)) {
+            if (index >= tiles->properties.size()) {
                 Logger::log(FMT::format("TextureAtlas: The index of the tiles '{}' is out of range! "
                             "Try to use `TextureAtlas::tilesPropertyCount()`?", tiles_name), Logger::Error);
                 return nullptr;
             }
-            return _tiles_map[tiles_name].properties[index].get();
+            return tiles->properties[index].get();
         } else {
             Logger::log(FMT::format("TextureAtlas: Tiles '{}' is not in tiles map! "
                         "Did you forget to use `TextureAtlas::addTiles()`?", tiles_name), Logger::Error);
@@ -476,9 +511,23 @@ namespace MyEngine {
         }
     }
 
+    TextureProperty *TextureAtlas::tilesProperty(TextureHandle tiles, size_t index) {
+        auto tile = _tiles.get(tiles);
+        if (!tile) {
+            Logger::log(Logger::Error, "TextureAtlas: Tiles handle {} is not valid!", tiles.value());
+            return nullptr;
+        }
+        if (index >= tile->properties.size()) {
+            Logger::log(FMT::format("TextureAtlas: The index of the tiles '{}' is out of range! "
+                        "Try to use `TextureAtlas::tilesPropertyCount()`?", tile->name), Logger::Error);
+            return nullptr;
+        }
+        return tile->properties[index].get();
+    }
+
     size_t TextureAtlas::tilesPropertyCount(const std::string& tiles_name) const {
-        if (_tiles_map.contains(tiles_name)) {
-            return _tiles_map.at(tiles_name).properties.size();
+        if (auto tiles = findTiles(tiles_name)) {
+            return tiles->properties.size();
         } else {
             Logger::log(FMT::format("TextureAtlas: Tiles '{}' is not in tiles map! "
                         "Did you forget to use `TextureAtlas::addTiles()`?", tiles_name), Logger::Error);
@@ -487,7 +536,7 @@ namespace MyEngine {
     }
 
     void TextureAtlas::setCurrentTiles(const std::string &tiles_name) {
-        if (_tiles_map.contains(tiles_name)) {
+        if (_tiles_names.contains(tiles_name)) {
             _current_tiles = tiles_name;
         } else {
             Logger::log(FMT::format("TextureAtlas: Tiles '{}' is not in tiles map! "
@@ -501,19 +550,28 @@ namespace MyEngine {
 
     StringList TextureAtlas::tilesNameList() const {
         StringList out;
-        for (auto& [name, t] : _tiles_map) {
-            out.emplace_back(name);
+        for (auto& tiles : _tiles) {
+            out.emplace_back(tiles.name);
         }
         return out;
     }
 
     bool TextureAtlas::isTilesNameExist(const std::string& tiles_name) const {
-        return _tiles_map.contains(tiles_name);
+        return _tiles_names.contains(tiles_name);
+    }
+
+    TextureHandle TextureAtlas::tilesHandle(const std::string &tiles_name) const {
+        auto it = _tiles_names.find(tiles_name);
+        return it != _tiles_names.end() ? it->second : TextureHandle{};
+    }
+
+    bool TextureAtlas::isTilesHandleValid(TextureHandle tiles) const {
+        return _tiles.contains(tiles);
     }
 
     void TextureAtlas::draw() {
-        if (_tiles_map.contains(_current_tiles)) {
-            renderer()->drawTexture(self(), _tiles_map[_current_tiles].properties[0].get());
+        if (auto tiles = findTiles(_current_tiles)) {
+            renderer()->drawTexture(self(), tiles->properties[0].get());
         } else {
             auto err = FMT::format("TextureAtlas: Tiles '{}' is not in tiles map! "
                                    "Did you forget to use `TextureAtlas::addTiles()`?", _current_tiles);
@@ -523,14 +581,14 @@ namespace MyEngine {
     }
 
     void TextureAtlas::draw(size_t index) {
-        if (_tiles_map.contains(_current_tiles)) {
-            if (index >= _tiles_map[_current_tiles].properties.size()) {
+        if (auto tiles = findTiles(_current_tiles)) {
+            if (index >= tiles->properties.size()) {
                 auto err = FMT::format("TextureAtlas: The index of the tiles '{}' is out of range! "
                                        "Try to use `TextureAtlas::tilesPropertyCount()`?", _current_tiles);
                 Logger::log(err, Logger::Fatal);
                 throw OutOfRangeException(err);
             }
-            renderer()->drawTexture(self(), _tiles_map[_current_tiles].properties[index].get());
+            renderer()->drawTexture(self(), tiles->properties[index].get());
         } else {
             auto err = FMT::format("TextureAtlas: Tiles '{}' is not in tiles map! "
                                    "Did you forget to use `TextureAtlas::addTiles()`?", _current_tiles);
@@ -540,20 +598,38 @@ namespace MyEngine {
     }
 
     void TextureAtlas::draw(const std::string &tiles_name, size_t index) {
-        if (_tiles_map.contains(tiles_name)) {
-            if (index >= _tiles_map[tiles_name].properties.size()) {
-                auto err = FMT::format("TextureAtlas: The index of the tiles '{}' is out of range! "
-                                       "Try to use `TextureAtlas::tilesPropertyCount()`?", _current_tiles);
-                Logger::log(err, Logger::Fatal);
-                throw OutOfRangeException(err);
-            }
-            renderer()->drawTexture(self(), _tiles_map[tiles_name].properties[index].get());
-        } else {
+        auto tiles = tilesHandle(tiles_name);
+        if (!tiles) {
             auto err = FMT::format("TextureAtlas: Tiles '{}' is not in tiles map! "
                                    "Did you forget to use `TextureAtlas::addTiles()`?", tiles_name);
             Logger::log(err, Logger::Fatal);
             throw OutOfRangeException(err);
         }
+        draw(tiles, index);
+    }
+
+    void TextureAtlas::draw(TextureHandle tiles, size_t index) {
+        auto tile = _tiles.get(tiles);
+        if (!tile) {
+            auto err = FMT::format("TextureAtlas: Tiles handle {} is not valid!", tiles.value());
+            Logger::log(err, Logger::Fatal);
+            throw OutOfRangeException(err);
+        }
+        if (index >= tile->properties.size()) {
+            auto err = FMT::format("TextureAtlas: The index of the tiles '{}' is out of range! "
+                                   "Try to use `TextureAtlas::tilesPropertyCount()`?", tile->name);
+            Logger::log(err, Logger::Fatal);
+            throw OutOfRangeException(err);
+        }
+        renderer()->drawTexture(self(), tile->properties[index].get());
+    }
+
+    TextureAtlas::Tile *TextureAtlas::findTiles(const std::string &tiles_name) {
+        return _tiles.get(tilesHandle(tiles_name));
+    }
+
+    const TextureAtlas::Tile *TextureAtlas::findTiles(const std::string &tiles_name) const {
+        return _tiles.get(tilesHandle(tiles_name));
     }
 
 
@@ -563,10 +639,11 @@ namespace MyEngine {
         loadAnimation(file_path);
         EventSystem::global()->appendGlobalEvent(IDGenerator::getNewGlobalEventID(), [this] {
             if (!_playing) return;
-            auto now = SDL_GetTicks();
+            Engine::requestRedraw();
+            auto now = Clock::ticks();
             if (now - _start_time >= _textures[_cur_frame]->duration) {
                 _cur_frame = (_cur_frame + 1 >= _textures.size() ? 0 : _cur_frame + 1);
-                _start_time = SDL_GetTicks();
+                _start_time = Clock::ticks();
             }
         });
     }
@@ -669,7 +746,7 @@ namespace MyEngine {
 
     void TextureAnimation::play(size_t frame) {
         _cur_frame = frame;
-        _start_time = SDL_GetTicks();
+        _start_time = Clock::ticks();
         _playing = true;
     }
 
@@ -702,7 +779,7 @@ namespace MyEngine {
 
     BGM::~BGM() {
         if (_play_status > Invalid) unload();
-        EventSystem::global()->removeGlobalEvent(_global_ev_id);
+        EventSystem::global()->removeGlobalEvent(_global_ev_handle);
     }
 
     void BGM::setPath(const std::string &path) {
@@ -924,8 +1001,7 @@ namespace MyEngine {
     }
 
     void BGM::init() {
-        _global_ev_id = IDGenerator::getNewGlobalEventID();
-        EventSystem::global()->appendGlobalEvent(_global_ev_id, [this]() {
+        _global_ev_handle = EventSystem::global()->appendGlobalEvent([this]() {
             if ((_play_status == Playing || _play_status == FadingOut) && !MIX_TrackPlaying(_track)) {
                 _play_status = Loaded;
             } else if (_play_status == FadingIn) {
@@ -3,6 +3,7 @@
 #define MYENGINE_COMPONETS_H
 #include "Basic.h"
 #include "MultiThread/Components.h"
+#include "Utils/FontIndex.h"
 
 namespace MyEngine {
     class Font {
@@ -88,10 +89,24 @@ namespace MyEngine {
         static FontMap getFontDatabaseFromSystem();
         static std::string findFontFromSystem(const std::string &font_name);
         static std::vector<FontInfo> getSystemDefaultFont();
+        /**
+         * \if EN
+         * @brief Set the path of the persistent font index, it must be set before the first lookup
+         * @param path The index file path, the index is kept in memory only if it is empty
+         * @details The default path is `FontIndex.bin` in the preference path of the engine.
+         * \endif
+         */
+        static void setFontIndexPath(const std::string& path);
+        /// Scan all system font directories again, e.g. after installing the fonts.
+        static void rebuildFontIndex();
     private:
+        static std::vector<std::string> systemFontDirectories();
+        static void ensureIndex(bool rebuild = false);
         static bool _is_loaded;
         static FontMap _font_db;
         static std::vector<FontInfo> _def_fonts;
+        static FontIndex _font_index;
+        static std::optional<std::string> _index_path;
     };
 
     class BGM {
@@ -150,7 +165,7 @@ namespace MyEngine {
         MIX_Mixer* _mixer;
         MIX_Audio* _audio{nullptr};
         MIX_Track* _track{nullptr};
-        uint64_t _global_ev_id{0};
+        GlobalEventHandle _global_ev_handle{};
     };
 
     class SFX {
@@ -398,14 +413,17 @@ namespace MyEngine {
         Renderer* _renderer;
     };
 
+    struct TextureTag;
+    using TextureHandle = Handle<TextureTag>;
+
     class TextureAtlas : public Texture {
     public:
         struct Tile {
             std::string name;
             std::vector<std::unique_ptr<TextureProperty>> properties;
         };
-        using constIter = std::unordered_map<std::string, Tile>::const_iterator;
-        using iter = std::unordered_map<std::string, Tile>::iterator;
+        using constIter = SlotMap<Tile, TextureTag>::const_iterator;
+        using iter = SlotMap<Tile, TextureTag>::iterator;
         TextureAtlas(const TextureAtlas &) = delete;
         TextureAtlas(TextureAtlas &&) = delete;
         TextureAtlas &operator=(const TextureAtlas &) = delete;
@@ -415,27 +433,36 @@ namespace MyEngine {
         explicit TextureAtlas(SDL_Surface* surface, Renderer *renderer, bool deep_copy = false);
         ~TextureAtlas();
 
-        iter begin() { return _tiles_map.begin(); }
-        constIter begin() const { return _tiles_map.cbegin(); }
-        iter end() { return _tiles_map.end(); }
-        constIter end() const { return _tiles_map.cend(); }
-        size_t count() { return _tiles_map.size(); }
+        iter begin() { return _tiles.begin(); }
+        constIter begin() const { return _tiles.begin(); }
+        iter end() { return _tiles.end(); }
+        constIter end() const { return _tiles.end(); }
+        size_t count() { return _tiles.size(); }
 
         bool addTiles(const std::string& tiles_name, const MyEngine::GeometryF &clip_geometry);
         bool addTilesProperty(const std::string& tiles_name);
         bool eraseTiles(const std::string& tiles_name);
         TextureProperty* tilesProperty(const std::string& tiles_name, size_t index = 0);
+        /// Get the tiles property by the handle, it skips looking up the name.
+        TextureProperty* tilesProperty(TextureHandle tiles, size_t index = 0);
         [[nodiscard]] size_t tilesPropertyCount(const std::string& tiles_name) const;
         void setCurrentTiles(const std::string& tiles_name);
         [[nodiscard]] const std::string& currentTiles() const;
         StringList tilesNameList() const;
         [[nodiscard]] bool isTilesNameExist(const std::string& tiles_name) const;
+        /// Get the handle of the tiles, it is null if the tiles are not added. It becomes stale after `eraseTiles()`.
+        [[nodiscard]] TextureHandle tilesHandle(const std::string& tiles_name) const;
+        [[nodiscard]] bool isTilesHandleValid(TextureHandle tiles) const;
 
         void draw() override;
         void draw(size_t index = 0);
         void draw(const std::string& tiles_name, size_t index = 0);
+        void draw(TextureHandle tiles, size_t index = 0);
     private:
-        std::unordered_map<std::string, Tile> _tiles_map;
+        Tile* findTiles(const std::string& tiles_name);
+        const Tile* findTiles(const std::string& tiles_name) const;
+        SlotMap<Tile, TextureTag> _tiles;
+        std::unordered_map<std::string, TextureHandle> _tiles_names;
         std::string _current_tiles;
     };
 
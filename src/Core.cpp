@@ -4,6 +4,9 @@
 #include "Utils/All.h"
 #include "Renderer/BaseCommand.h"
 #include "Renderer/CommandFactory.h"
+#include "MultiThread/TimerScheduler.h"
+#include "MultiThread/ThreadPool.h"
+#include "MultiThread/Coroutine.h"
 
 namespace MyEngine {
     std::unique_ptr<EventSystem> EventSystem::_instance{};
@@ -12,9 +15,41 @@ namespace MyEngine {
     bool Engine::_quit_requested{false};
     int Engine::_return_code{0};
     bool Engine::_show_app_info{true};
+    std::atomic<bool> Engine::_redraw_all{false};
+    std::atomic<bool> Engine::_sleeping{false};
+    uint32_t Engine::_wake_up_event_type{0};
     bool FontDatabase::_is_loaded{false};
     FontMap FontDatabase::_font_db{};
     std::vector<FontDatabase::FontInfo> FontDatabase::_def_fonts{};
+    FontIndex FontDatabase::_font_index{};
+    std::optional<std::string> FontDatabase::_index_path{};
+
+    namespace {
+        /// Copy the pointer list into the command arena, the command keeps it until it is executed.
+        template<typename T>
+        std::span<T* const> arenaCopy(LinearArena& arena, const std::vector<T*>& list) {
+            return arena.copyArray<T*>(list);
+        }
+
+        SDL_FColor toFColor(const SDL_Color& color) {
+            return {static_cast<float>(color.r) / 255.f, static_cast<float>(color.g) / 255.f,
+                    static_cast<float>(color.b) / 255.f, static_cast<float>(color.a) / 255.f};
+        }
+
+        /// Clip the glyph quad to the rectangle, the source rectangle is cut by the same ratio.
+        bool clipGlyph(SDL_FRect& dest, SDL_FRect& src, const Geometry& clip) {
+            auto left = std::max(dest.x, static_cast<float>(clip.x));
+            auto top = std::max(dest.y, static_cast<float>(clip.y));
+            auto right = std::min(dest.x + dest.w, static_cast<float>(clip.x + clip.width));
+            auto bottom = std::min(dest.y + dest.h, static_cast<float>(clip.y + clip.height));
+            if (right <= left || bottom <= top) return false;
+            auto scale_x = src.w / dest.w, scale_y = src.h / dest.h;
+            src = {src.x + (left - dest.x) * scale_x, src.y + (top - dest.y) * scale_y,
+                   (right - left) * scale_x, (bottom - top) * scale_y};
+            dest = {left, top, right - left, bottom - top};
+            return true;
+        }
+    }
 
     Renderer::Renderer(Window* window) : _window(window) {
         _renderer = SDL_CreateRenderer(_window->self(), nullptr);
@@ -30,6 +65,18 @@ namespace MyEngine {
                 RenderCommand::CommandFactory::release(std::move(cmd));
             }
         }
+        for (auto& cmd : _native_cmd_list) {
+            RenderCommand::CommandFactory::release(std::move(cmd));
+        }
+        _glyph_atlas.reset();
+        if (_debug_font) {
+            SDL_DestroyTexture(_debug_font);
+            _debug_font = nullptr;
+        }
+        if (_scaled_target) {
+            SDL_DestroyTexture(_scaled_target);
+            _scaled_target = nullptr;
+        }
         if (_renderer) {
             SDL_DestroyRenderer(_renderer);
             _renderer = nullptr;
@@ -68,16 +115,27 @@ namespace MyEngine {
     }
 
     void Renderer::_update() {
+        auto start_ns = SDL_GetTicksNS();
+        if (_glyph_pending) flushGlyphs();
+        bool scaled = _dyn_res_enabled && beginScaledTarget();
         SDL_SetRenderDrawColor(_renderer, _background_color.r, _background_color.g,
                                 _background_color.b, _background_color.a);
         SDL_RenderClear(_renderer);
-        for (auto& cmd : _cmd_list) {
-            cmd->exec();
-            RenderCommand::CommandFactory::release(std::move(cmd));
-            _render_count++;
+        executeCommands(_cmd_list);
+        if (scaled) endScaledTarget();
+        executeCommands(_native_cmd_list);
+        /// Nothing refers to the arena after the lists are executed, the commands recorded later are kept in it
+        /// until this renderer renders again, however many frames the window skips.
+        _cmd_arena.reset();
+        /// Both lists start without the viewport in the scaled mode.
+        if (scaled) _recorded_viewport = {};
+        if (_dyn_res_enabled) {
+            /// Wait for the batched commands, so the frame time includes the real rendering work.
+            SDL_FlushRenderer(_renderer);
+            _frame_time_ns = SDL_GetTicksNS() - start_ns;
+            updateResolutionScale();
         }
         SDL_RenderPresent(_renderer);
-        _cmd_list.clear();
         auto now = SDL_GetTicks();
         if (now - _start_ts >= 1000) {
             _start_ts = SDL_GetTicks();
@@ -87,6 +145,143 @@ namespace MyEngine {
         _window->paintEvent();
     }
 
+    LinearArena* Renderer::commandArena() {
+        return &_cmd_arena;
+    }
+
+    bool Renderer::isNativeCommand() const {
+        return _dyn_res_enabled && _native_ui && _native_layer;
+    }
+
+    void Renderer::executeCommands(std::deque<std::unique_ptr<RenderCommand::BaseCommand>>& cmd_list) {
+        for (auto& cmd : cmd_list) {
+            cmd->exec();
+            RenderCommand::CommandFactory::release(std::move(cmd));
+            _render_count++;
+        }
+        cmd_list.clear();
+    }
+
+    bool Renderer::beginScaledTarget() {
+        int width = 0, height = 0;
+        if (!SDL_GetCurrentRenderOutputSize(_renderer, &width, &height) || width <= 0 || height <= 0) return false;
+        /// The target is created at the maximum scale, the smaller scales only use the top-left part of it.
+        auto target_width = static_cast<int>(std::ceil(static_cast<float>(width) * _max_res_scale));
+        auto target_height = static_cast<int>(std::ceil(static_cast<float>(height) * _max_res_scale));
+        if (!_scaled_target || target_width != _target_width || target_height != _target_height) {
+            if (_scaled_target) SDL_DestroyTexture(_scaled_target);
+            _scaled_target = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+                                               target_width, target_height);
+            if (!_scaled_target) {
+                Logger::log(Logger::Error, "Renderer: Failed to create the scaled target! Exception: {}",
+                            SDL_GetError());
+                _dyn_res_enabled = false;
+                return false;
+            }
+            SDL_SetTextureScaleMode(_scaled_target, SDL_SCALEMODE_LINEAR);
+            _target_width = target_width;
+            _target_height = target_height;
+        }
+        SDL_SetRenderTarget(_renderer, _scaled_target);
+        SDL_SetRenderScale(_renderer, _res_scale, _res_scale);
+        return true;
+    }
+
+    void Renderer::endScaledTarget() {
+        SDL_SetRenderViewport(_renderer, nullptr);
+        SDL_SetRenderClipRect(_renderer, nullptr);
+        SDL_SetRenderTarget(_renderer, nullptr);
+        SDL_SetRenderScale(_renderer, 1.f, 1.f);
+        auto scale = _res_scale / _max_res_scale;
+        SDL_FRect src{0, 0, static_cast<float>(_target_width) * scale, static_cast<float>(_target_height) * scale};
+        SDL_RenderTexture(_renderer, _scaled_target, &src, nullptr);
+    }
+
+    void Renderer::updateResolutionScale() {
+        _frame_samples[_frame_sample_count++] = _frame_time_ns;
+        if (_frame_sample_count < FRAME_SAMPLES) return;
+        /// Start a new window after every adjustment, so the next one only sees the frames at the new scale.
+        _frame_sample_count = 0;
+        auto samples = _frame_samples;
+        auto p90 = samples.begin() + FRAME_SAMPLES * 9 / 10;
+        std::nth_element(samples.begin(), p90, samples.end());
+        _frame_time_p90_ns = *p90;
+        auto scale = _res_scale;
+        auto budget = static_cast<float>(_target_frame_ns);
+        auto frame_time = static_cast<float>(_frame_time_p90_ns);
+        if (frame_time > budget) {
+            /// The cost grows with the pixels, so the scale follows the square root of the ratio.
+            scale = std::min(scale - 0.05f, scale * std::max(0.75f, std::sqrt(budget / frame_time)));
+        } else if (frame_time < budget * 0.7f) {
+            /// One step costs 21% more pixels at most, it can't push 70% of the budget over it.
+            scale += 0.05f;
+        }
+        scale = std::clamp(std::round(scale * 20.f) / 20.f, _min_res_scale, _max_res_scale);
+        if (scale == _res_scale) return;
+        Logger::log(Logger::Debug, "Renderer: Resolution scale {} -> {} (P90 frame time: {} ns)",
+                    _res_scale, scale, _frame_time_p90_ns);
+        _res_scale = scale;
+    }
+
+    void Renderer::setDynamicResolutionEnabled(bool enabled) {
+        if (_glyph_pending) flushGlyphs();
+        _dyn_res_enabled = enabled;
+        _frame_sample_count = 0;
+        _res_scale = _max_res_scale;
+        if (!enabled && _scaled_target) {
+            SDL_DestroyTexture(_scaled_target);
+            _scaled_target = nullptr;
+        }
+    }
+
+    bool Renderer::dynamicResolutionEnabled() const {
+        return _dyn_res_enabled;
+    }
+
+    void Renderer::setTargetFrameTime(uint64_t time_ns) {
+        _target_frame_ns = std::max<uint64_t>(time_ns, 1);
+        _frame_sample_count = 0;
+    }
+
+    uint64_t Renderer::targetFrameTime() const {
+        return _target_frame_ns;
+    }
+
+    void Renderer::setResolutionScaleRange(float min_scale, float max_scale) {
+        _max_res_scale = std::clamp(max_scale, 0.1f, 1.f);
+        _min_res_scale = std::clamp(min_scale, 0.1f, _max_res_scale);
+        _res_scale = std::clamp(_res_scale, _min_res_scale, _max_res_scale);
+    }
+
+    float Renderer::resolutionScale() const {
+        return _dyn_res_enabled ? _res_scale : 1.f;
+    }
+
+    void Renderer::setNativeUIEnabled(bool enabled) {
+        if (_glyph_pending) flushGlyphs();
+        _native_ui = enabled;
+    }
+
+    bool Renderer::nativeUIEnabled() const {
+        return _native_ui;
+    }
+
+    void Renderer::beginNativeLayer() {
+        _native_layer += 1;
+    }
+
+    void Renderer::endNativeLayer() {
+        if (_native_layer) _native_layer -= 1;
+    }
+
+    uint64_t Renderer::frameTimeNS() const {
+        return _frame_time_ns;
+    }
+
+    uint64_t Renderer::frameTimePercentileNS() const {
+        return _frame_time_p90_ns;
+    }
+
     void Renderer::fillBackground(const SDL_Color &color) {
         addCommand<RenderCommand::FillCMD>(_renderer, color);
     }
@@ -104,8 +299,16 @@ namespace MyEngine {
     }
 
     void Renderer::drawPoints(const std::vector<Graphics::Point*>& point_list) {
+        if (point_list.empty()) return;
         addCommand<RenderCommand::PointCMD>(_renderer, nullptr,
-                        RenderCommand::BaseCommand::Mode::Multiple, point_list.size(), point_list);
+                        RenderCommand::BaseCommand::Mode::Multiple, point_list.size(),
+                        arenaCopy(_cmd_arena, point_list));
+    }
+
+    void Renderer::drawPoints(std::span<const Graphics::Point> points) {
+        if (points.empty()) return;
+        addCommand<RenderCommand::PointCMD>(_renderer, nullptr, RenderCommand::BaseCommand::Mode::Multiple,
+                        points.size(), std::span<Graphics::Point* const>(), points);
     }
 
     void Renderer::drawLine(Graphics::Line *line) {
@@ -122,8 +325,16 @@ namespace MyEngine {
     }
 
     void Renderer::drawRectangles(const std::vector<Graphics::Rectangle*> &rectangle_list) {
+        if (rectangle_list.empty()) return;
         addCommand<RenderCommand::RectangleCMD>(_renderer, nullptr,
-                        RenderCommand::BaseCommand::Mode::Multiple, rectangle_list.size(), rectangle_list);
+                        RenderCommand::BaseCommand::Mode::Multiple, rectangle_list.size(),
+                        arenaCopy(_cmd_arena, rectangle_list));
+    }
+
+    void Renderer::drawRectangles(std::span<const Graphics::Rectangle> rectangles) {
+        if (rectangles.empty()) return;
+        addCommand<RenderCommand::RectangleCMD>(_renderer, nullptr, RenderCommand::BaseCommand::Mode::Multiple,
+                        rectangles.size(), std::span<Graphics::Rectangle* const>(), rectangles);
     }
 
     void Renderer::drawTriangle(Graphics::Triangle* triangle) {
@@ -152,13 +363,51 @@ namespace MyEngine {
     void Renderer::drawTexture(SDL_Texture* texture, const std::vector<TextureProperty*>& properties) {
         if (!texture || properties.empty()) return;
         addCommand<RenderCommand::TextureCMD>(_renderer, texture, nullptr, RenderCommand::BaseCommand::Mode::Multiple,
-                                  properties.size(), properties);
+                                  properties.size(), arenaCopy(_cmd_arena, properties));
+    }
+
+    void Renderer::drawTexture(SDL_Texture* texture, std::span<const TextureProperty> properties) {
+        if (!texture || properties.empty()) return;
+        addCommand<RenderCommand::TextureCMD>(_renderer, texture, nullptr, RenderCommand::BaseCommand::Mode::Multiple,
+                                  properties.size(), std::span<TextureProperty* const>(),
+                                  std::span<SDL_Texture* const>(), properties);
     }
 
     void Renderer::drawTextures(const std::vector<SDL_Texture*>& textures,
                                 const std::vector<TextureProperty*>& properties) {
+        if (properties.empty()) return;
+        if (textures.size() != properties.size()) {
+            Logger::log(Logger::Warn, "Renderer: The count of the textures ({}) is not the count of the properties ({})! "
+                                      "Skipped drawing the textures!", textures.size(), properties.size());
+            return;
+        }
         addCommand<RenderCommand::TextureCMD>(_renderer, nullptr, nullptr, RenderCommand::BaseCommand::Mode::Custom,
-                                  properties.size(), properties, textures);
+                                  properties.size(), arenaCopy(_cmd_arena, properties),
+                                  arenaCopy(_cmd_arena, textures));
+    }
+
+    void Renderer::drawTextures(std::span<SDL_Texture* const> textures, std::span<const TextureProperty> properties) {
+        if (properties.empty()) return;
+        if (textures.size() != properties.size()) {
+            Logger::log(Logger::Warn, "Renderer: The count of the textures ({}) is not the count of the properties ({})! "
+                                      "Skipped drawing the textures!", textures.size(), properties.size());
+            return;
+        }
+        addCommand<RenderCommand::TextureCMD>(_renderer, nullptr, nullptr, RenderCommand::BaseCommand::Mode::Custom,
+                                  properties.size(), std::span<TextureProperty* const>(), textures, properties);
+    }
+
+    void Renderer::drawSprites(SDL_Texture* texture, std::span<const SDL_FRect> dest_rects,
+                               std::span<const SDL_FRect> src_rects, std::span<const SDL_FColor> colors) {
+        if (!texture || dest_rects.empty()) return;
+        if ((!src_rects.empty() && src_rects.size() != dest_rects.size()) ||
+            (!colors.empty() && colors.size() != dest_rects.size())) {
+            Logger::log(Logger::Warn, "Renderer: The count of the source rectangles ({}) or the colors ({}) is not "
+                                      "the count of the destination rectangles ({})! Skipped drawing the sprites!",
+                        src_rects.size(), colors.size(), dest_rects.size());
+            return;
+        }
+        addCommand<RenderCommand::SpriteBatchCMD>(_renderer, texture, dest_rects, src_rects, colors);
     }
 
     void Renderer::drawText(TTF_Text* text, Vector2& position) {
@@ -168,35 +417,208 @@ namespace MyEngine {
 
     void Renderer::drawTexts(TTF_Text* text, const std::vector<Vector2*>& position_list) {
         if (!text) return;
+        if (position_list.empty()) return;
         addCommand<RenderCommand::TextCMD>(_renderer, text, Vector2(), RenderCommand::BaseCommand::Mode::Multiple,
-                                           position_list.size(), position_list);
+                                           position_list.size(), arenaCopy(_cmd_arena, position_list));
+    }
+
+    void Renderer::drawTexts(TTF_Text* text, std::span<const Vector2> positions) {
+        if (!text || positions.empty()) return;
+        addCommand<RenderCommand::TextCMD>(_renderer, text, Vector2(), RenderCommand::BaseCommand::Mode::Multiple,
+                                           positions.size(), std::span<Vector2* const>(),
+                                           std::span<TTF_Text* const>(), positions);
     }
 
     void Renderer::drawTexts(const std::vector<TTF_Text*>& text_list, const std::vector<Vector2*>& position_list) {
-        addCommand<RenderCommand::TextCMD>(_renderer, nullptr, Vector2(), RenderCommand::BaseCommand::Mode::Multiple,
-                                           position_list.size(), position_list, text_list);
+        if (position_list.empty()) return;
+        if (text_list.size() != position_list.size()) {
+            Logger::log(Logger::Warn, "Renderer: The count of the texts ({}) is not the count of the positions ({})! "
+                                      "Skipped drawing the texts!", text_list.size(), position_list.size());
+            return;
+        }
+        addCommand<RenderCommand::TextCMD>(_renderer, nullptr, Vector2(), RenderCommand::BaseCommand::Mode::Custom,
+                                           position_list.size(), arenaCopy(_cmd_arena, position_list),
+                                           arenaCopy(_cmd_arena, text_list));
+    }
+
+    void Renderer::drawTexts(std::span<TTF_Text* const> texts, std::span<const Vector2> positions) {
+        if (positions.empty()) return;
+        if (texts.size() != positions.size()) {
+            Logger::log(Logger::Warn, "Renderer: The count of the texts ({}) is not the count of the positions ({})! "
+                                      "Skipped drawing the texts!", texts.size(), positions.size());
+            return;
+        }
+        addCommand<RenderCommand::TextCMD>(_renderer, nullptr, Vector2(), RenderCommand::BaseCommand::Mode::Custom,
+                                           positions.size(), std::span<Vector2* const>(), texts, positions);
     }
 
-    void Renderer::drawDebugText(const std::string &text, const MyEngine::Vector2 &position,
+    void Renderer::drawDebugText(std::string_view text, const MyEngine::Vector2 &position,
                                  const SDL_Color& color) {
         if (text.empty()) return;
-        addCommand<RenderCommand::DebugTextCMD>(_renderer, text, position, color);
+        auto texture = debugFont();
+        if (!texture) return;
+        auto& viewport = beginGlyphs();
+        constexpr auto SIZE = static_cast<float>(SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE);
+        auto f_color = toFColor(color);
+        auto pen_x = position.x + static_cast<float>(viewport.x);
+        auto pen_y = position.y + static_cast<float>(viewport.y);
+        auto str = text.data();
+        auto length = text.size();
+        while (length) {
+            auto codepoint = SDL_StepUTF8(&str, &length);
+            /// The same as `SDL_RenderDebugText()`, it stops at the null character.
+            if (!codepoint) break;
+            if (codepoint != ' ') {
+                auto index = codepoint < 32 || codepoint > 255 ? '?' - 32 : codepoint - 32;
+                SDL_FRect src{static_cast<float>(index % DEBUG_FONT_COLUMNS) * SIZE,
+                              static_cast<float>(index / DEBUG_FONT_COLUMNS) * SIZE, SIZE, SIZE};
+                addGlyphQuad(texture, {pen_x, pen_y, SIZE, SIZE}, src, f_color, viewport);
+            }
+            pen_x += SIZE;
+        }
     }
 
     void Renderer::drawDebugTexts(const StringList& text_list, const std::vector<Vector2*>& position_list,
                                   const SDL_Color& color) {
-        if (text_list.empty()) return;
-        addCommand<RenderCommand::DebugTextCMD>(_renderer, std::string(), Vector2(), color,
-                            RenderCommand::BaseCommand::Mode::Multiple, position_list.size(),
-                            text_list, position_list);
+        if (text_list.size() != position_list.size()) {
+            Logger::log(Logger::Warn, "Renderer: The count of the texts ({}) is not the count of the positions ({})! "
+                                      "Skipped drawing the debug texts!", text_list.size(), position_list.size());
+            return;
+        }
+        for (size_t i = 0; i < text_list.size(); ++i) {
+            if (position_list[i]) drawDebugText(text_list[i], *position_list[i], color);
+        }
+    }
+
+    void Renderer::drawDebugTexts(std::span<const std::string_view> text_list, std::span<const Vector2> positions,
+                                  const SDL_Color& color) {
+        if (text_list.size() != positions.size()) {
+            Logger::log(Logger::Warn, "Renderer: The count of the texts ({}) is not the count of the positions ({})! "
+                                      "Skipped drawing the debug texts!", text_list.size(), positions.size());
+            return;
+        }
+        for (size_t i = 0; i < text_list.size(); ++i) drawDebugText(text_list[i], positions[i], color);
     }
 
     void Renderer::drawDebugFPS(const MyEngine::Vector2 &position, const SDL_Color &color) {
-        addCommand<RenderCommand::DebugTextCMD>(_renderer,
-                    FMT::format("FPS: {}", window()->_engine->fps()), position, color);
+        drawDebugText(FrameArena::global()->format("FPS: {}", window()->_engine->fps()), position, color);
+    }
+
+    void Renderer::drawGlyphText(TTF_Font* font, std::string_view text, const Vector2& position,
+                                 const SDL_Color& color) {
+        if (!font || text.empty()) return;
+        _glyph_layout.clear();
+        GlyphAtlas::layoutText(font, text, _glyph_layout);
+        drawGlyphs(font, _glyph_layout, position, color);
+    }
+
+    void Renderer::drawGlyphs(TTF_Font* font, std::span<const GlyphPlacement> glyphs, const Vector2& position,
+                              const SDL_Color& color) {
+        if (!font || glyphs.empty()) return;
+        auto atlas = glyphAtlas();
+        auto frame = FrameArena::global()->frameIndex();
+        auto& viewport = beginGlyphs();
+        auto f_color = toFColor(color);
+        auto origin_x = position.x + static_cast<float>(viewport.x);
+        auto origin_y = position.y + static_cast<float>(viewport.y);
+        for (auto& placement : glyphs) {
+            auto glyph = atlas->glyph(font, placement.codepoint, frame);
+            if (!glyph || glyph->page == GlyphAtlas::NO_PAGE) continue;
+            addGlyphQuad(atlas->page(glyph->page),
+                         {origin_x + placement.x + glyph->offset_x, origin_y + placement.y + glyph->offset_y,
+                          glyph->src.w, glyph->src.h},
+                         glyph->src, f_color, viewport);
+        }
+    }
+
+    GlyphAtlas* Renderer::glyphAtlas() {
+        if (!_glyph_atlas) _glyph_atlas = std::make_unique<GlyphAtlas>(_renderer);
+        return _glyph_atlas.get();
+    }
+
+    const Geometry& Renderer::beginGlyphs() {
+        bool native = isNativeCommand();
+        if (_glyph_pending && _glyph_native != native) flushGlyphs();
+        _glyph_native = native;
+        return _recorded_viewport[native];
+    }
+
+    void Renderer::addGlyphQuad(SDL_Texture* texture, SDL_FRect dest, SDL_FRect src, const SDL_FColor& color,
+                                const Geometry& viewport) {
+        if (viewport.width > 0 && viewport.height > 0 && !clipGlyph(dest, src, viewport)) return;
+        auto run = std::find_if(_glyph_runs.begin(), _glyph_runs.end(),
+                                [texture](const GlyphRun& item) { return item.texture == texture; });
+        if (run == _glyph_runs.end()) run = _glyph_runs.insert(_glyph_runs.end(), GlyphRun{texture});
+        run->dest_rects.push_back(dest);
+        run->src_rects.push_back(src);
+        run->colors.push_back(color);
+        _glyph_pending = true;
+    }
+
+    void Renderer::flushGlyphs() {
+        _glyph_pending = false;
+        bool native = _glyph_native;
+        auto& viewport = _recorded_viewport[native];
+        bool has_viewport = viewport.width > 0 && viewport.height > 0;
+        /// Make sure the batch goes into the list it was laid out for.
+        if (native) beginNativeLayer();
+        if (has_viewport) addCommand<RenderCommand::ViewPortCMD>(_renderer, true, Geometry());
+        auto arena = &_cmd_arena;
+        for (auto& run : _glyph_runs) {
+            if (run.dest_rects.empty()) continue;
+            addCommand<RenderCommand::SpriteBatchCMD>(_renderer, run.texture,
+                                                      arena->copyArray<SDL_FRect>(run.dest_rects),
+                                                      arena->copyArray<SDL_FRect>(run.src_rects),
+                                                      arena->copyArray<SDL_FColor>(run.colors));
+            run.dest_rects.clear();
+            run.src_rects.clear();
+            run.colors.clear();
+        }
+        if (has_viewport) addCommand<RenderCommand::ViewPortCMD>(_renderer, false, viewport);
+        if (native) endNativeLayer();
+    }
+
+    SDL_Texture* Renderer::debugFont() {
+        if (_debug_font) return _debug_font;
+        constexpr int SIZE = SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE;
+        /// Bake the characters drawn by `SDL_RenderDebugText()` once, from the space to U+00FF.
+        constexpr int COUNT = 256 - 32;
+        auto texture = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_TARGET,
+                                         DEBUG_FONT_COLUMNS * SIZE,
+                                         (COUNT + DEBUG_FONT_COLUMNS - 1) / DEBUG_FONT_COLUMNS * SIZE);
+        if (!texture) {
+            Logger::log(Logger::Error, "Renderer: Can't create the debug font! Exception: {}", SDL_GetError());
+            return nullptr;
+        }
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+        uint8_t r, g, b, a;
+        SDL_GetRenderDrawColor(_renderer, &r, &g, &b, &a);
+        auto target = SDL_GetRenderTarget(_renderer);
+        SDL_SetRenderTarget(_renderer, texture);
+        SDL_SetRenderDrawColor(_renderer, 0, 0, 0, 0);
+        SDL_RenderClear(_renderer);
+        SDL_SetRenderDrawColor(_renderer, 255, 255, 255, 255);
+        for (int i = 0; i < COUNT; ++i) {
+            auto codepoint = static_cast<uint32_t>(i + 32);
+            char utf8[3]{};
+            if (codepoint < 0x80) {
+                utf8[0] = static_cast<char>(codepoint);
+            } else {
+                utf8[0] = static_cast<char>(0xC0 | codepoint >> 6);
+                utf8[1] = static_cast<char>(0x80 | (codepoint & 0x3F));
+            }
+            SDL_RenderDebugText(_renderer, static_cast<float>(i % DEBUG_FONT_COLUMNS * SIZE),
+                                static_cast<float>(i / DEBUG_FONT_COLUMNS * SIZE), utf8);
+        }
+        SDL_SetRenderTarget(_renderer, target);
+        SDL_SetRenderDrawColor(_renderer, r, g, b, a);
+        _debug_font = texture;
+        return _debug_font;
     }
 
     void Renderer::setViewport(const Geometry& geometry) {
+        _recorded_viewport[isNativeCommand()] = geometry.width == 0 || geometry.height == 0 ? Geometry() : geometry;
         if (geometry.width == 0 || geometry.height == 0) {
             addCommand<RenderCommand::ViewPortCMD>(_renderer, true, geometry);
         } else {
@@ -205,6 +627,8 @@ namespace MyEngine {
     }
 
     void Renderer::setClipView(const Geometry& geometry) {
+        /// The clip view is applied as the viewport as well.
+        _recorded_viewport[isNativeCommand()] = geometry.width == 0 || geometry.height == 0 ? Geometry() : geometry;
         if (geometry.width == 0 || geometry.height == 0) {
             addCommand<RenderCommand::ClipViewCMD>(_renderer, true, geometry);
         } else {
@@ -511,15 +935,37 @@ namespace MyEngine {
         return _engine;
     }
 
-    void Window::installPaintEvent(const std::function<void(Renderer* renderer)>& paint_event, bool push_back) {
-        if (push_back) _paint_event_list.push_back(paint_event);
-        else _paint_event_list.push_front(paint_event);
+    void Window::installPaintEvent(PaintEvent paint_event, bool push_back) {
+        if (_painting) {
+            /// The running paint event may be moved if the list grows.
+            _pending_paint_events.emplace_back(std::move(paint_event), push_back);
+            return;
+        }
+        if (push_back) _paint_event_list.push_back(std::move(paint_event));
+        else _paint_event_list.insert(_paint_event_list.begin(), std::move(paint_event));
+    }
+
+    void Window::requestRedraw() {
+        if (_redraw_requested.exchange(true)) return;
+        Engine::wakeUp();
+    }
+
+    void Window::requestRedrawAfter(uint64_t ms) {
+        _redraw_deadline = std::min(_redraw_deadline, Clock::ticks() + ms);
+    }
+
+    bool Window::isRedrawRequested() const {
+        return _redraw_requested.load();
     }
 
     void Window::paintEvent() {
+        _painting = true;
         for (auto& ev : _paint_event_list) {
             if (ev) ev(_renderer.get());
         }
+        _painting = false;
+        for (auto& [ev, push_back] : _pending_paint_events) installPaintEvent(std::move(ev), push_back);
+        _pending_paint_events.clear();
     }
 
     void Window::resizeEvent() {
@@ -583,78 +1029,73 @@ namespace MyEngine {
         return (_instance ? _instance.get() : nullptr);
     }
 
-    void EventSystem::appendEvent(uint64_t id, const std::function<void(SDL_Event)>& event) {
-        if (_event_list.contains(id)) {
+    void EventSystem::appendEvent(uint64_t id, Event event) {
+        if (!_event_list.append(id, std::move(event))) {
             Logger::log(Logger::Warn, "EventSystem: The event with ID {} is already exists! It will overwrite it!", id);
-            _event_list[id] = event;
             return;
         }
-        _event_list.emplace(id, event);
         Logger::log(Logger::Debug, "EventSystem: Append a new event with ID {}", id);
     }
 
+    EventHandle EventSystem::appendEvent(Event event) {
+        auto id = IDGenerator::getNewEventID();
+        appendEvent(id, std::move(event));
+        return EventHandle::fromValue(id);
+    }
+
     void EventSystem::removeEvent(uint64_t id) {
-        if (_event_list.contains(id)) {
-            // _event_list.erase(id);
-            _del_event_deque.push_back(id);
-            Logger::log(Logger::Debug, "EventSystem: Requested to remove event with ID {}", id);
+        if (_event_list.remove(id)) {
+            Logger::log(Logger::Debug, "EventSystem: Removed the event with ID {}", id);
         } else {
             Logger::log(Logger::Warn, "EventSystem: The event with ID {} is not found!", id);
         }
     }
 
-    void EventSystem::appendGlobalEvent(uint64_t g_id, const std::function<void()>& event) {
-        if (_global_event_list.contains(g_id)) {
+    void EventSystem::removeEvent(EventHandle handle) {
+        if (handle) removeEvent(handle.value());
+    }
+
+    void EventSystem::appendGlobalEvent(uint64_t g_id, GlobalEvent event) {
+        if (!_global_event_list.append(g_id, std::move(event))) {
             Logger::log(Logger::Warn, "EventSystem: The global event with ID {} is already exists! It will overwrite it!", g_id);
-            _global_event_list[g_id] = event;
         } else {
-            _global_event_list.emplace(g_id, event);
             Logger::log(Logger::Debug, "EventSystem: Append a global event by ID {}", g_id);
         }
     }
 
+    GlobalEventHandle EventSystem::appendGlobalEvent(GlobalEvent event) {
+        auto g_id = IDGenerator::getNewGlobalEventID();
+        appendGlobalEvent(g_id, std::move(event));
+        return GlobalEventHandle::fromValue(g_id);
+    }
+
     void EventSystem::removeGlobalEvent(uint64_t g_id) {
-        if (_global_event_list.contains(g_id)) {
-            // _global_event_list.erase(g_id);
-            _del_g_event_deque.push_back(g_id);
-            Logger::log(Logger::Debug, "EventSystem: Requested to remove global event with ID {}", g_id);
+        if (_global_event_list.remove(g_id)) {
+            Logger::log(Logger::Debug, "EventSystem: Removed a global event with ID {}", g_id);
         } else {
             Logger::log(Logger::Warn, "EventSystem: The global event with ID {} is not found!", g_id);
         }
     }
 
+    void EventSystem::removeGlobalEvent(GlobalEventHandle handle) {
+        if (handle) removeGlobalEvent(handle.value());
+    }
+
     size_t EventSystem::eventCount() const { return _event_list.size(); }
 
     bool EventSystem::run() {
         SDL_Event ev;
         bool running = true;
-        if (SDL_PollEvent(&ev)) {
-            _kb_events = const_cast<bool*>(SDL_GetKeyboardState(&_nums_keys));
-            _keys_status.clear();
-            for (int i = 0; i < _nums_keys; ++i) {
-                if (_kb_events[i]) _keys_status.emplace_back(static_cast<SDL_Scancode>(i));
-            }
-
-            _mouse_events = static_cast<MouseStatus>(SDL_GetMouseState(&_mouse_pos.x, &_mouse_pos.y));
-            if (!_mouse_down_changed) {
-                // When any of mouse buttons is pressed down, triggered...
-                if (_mouse_events > MouseStatus::None) {
-                    _mouse_down_changed = true;
-                    _before_mouse_down_pos.reset(_mouse_pos);
-                }
-            } else {
-                if (_mouse_events > MouseStatus::None) {
-                    _mouse_down_dis.reset(_mouse_pos - _before_mouse_down_pos);
-                } else {
-                    _mouse_down_changed = false;
-                    _mouse_down_dis.reset(0, 0);
-                }
-            }
-            auto win_id_list = _engine->windowIDList();
+        if (pollEvent(ev)) {
+            _polled_event_count += 1;
+            /// The list only lives in this frame, so it is allocated in the frame arena.
+            std::pmr::vector<uint32_t> win_id_list(FrameArena::global()->resource());
+            win_id_list.reserve(_engine->windowCount());
+            for (auto& [id, win] : *_engine) win_id_list.push_back(id);
             if (!win_id_list.empty()) {
                 static bool mouse_down = false, key_down = false;
                 std::for_each(win_id_list.begin(), win_id_list.end(),
-                              [this, &ev, &win_id_list, &running] (uint32_t id) {
+                              [this, &ev, &running] (uint32_t id) {
                     auto win = _engine->window(id);
                     if (ev.window.windowID != id) return;
                     if (ev.window.type == SDL_EVENT_WINDOW_MOVED) {
@@ -667,8 +1108,7 @@ namespace MyEngine {
                         win->lostFocusEvent();
                     } else if (ev.window.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED) {
                         win->unloadEvent();
-                        win_id_list = _engine->windowIDList();
-                        if (win_id_list.empty()) running = false;
+                        if (!_engine->windowCount()) running = false;
                         return;
                     } else if (ev.window.type == SDL_EVENT_WINDOW_HIDDEN) {
                         win->hideEvent();
@@ -768,24 +1208,173 @@ namespace MyEngine {
                     }
                 });
             }
-            for (auto& event : _event_list) {
-                if (event.second) event.second(ev);
+            _event_list(ev);
+        }
+        _global_event_list();
+        return running;
+    }
+
+    bool EventSystem::pollEvent(SDL_Event& ev) {
+        if (!_replayer) {
+            if (!SDL_PollEvent(&ev)) return false;
+            _kb_events = const_cast<bool*>(SDL_GetKeyboardState(&_nums_keys));
+            _keys_status.clear();
+            for (int i = 0; i < _nums_keys; ++i) {
+                if (_kb_events[i]) _keys_status.emplace_back(static_cast<SDL_Scancode>(i));
+            }
+            _mouse_events = static_cast<MouseStatus>(SDL_GetMouseState(&_mouse_pos.x, &_mouse_pos.y));
+            updateInputStatus();
+            if (_recorder) {
+                InputSnapshot snapshot{static_cast<uint8_t>(_mouse_events), _mouse_pos.x, _mouse_pos.y, _keys_status};
+                _recorder->writeEvent(_frame_index, Clock::ticksNS(), ev, snapshot);
             }
-            for (auto& id : _del_event_deque) {
-                _event_list.erase(id);
-                Logger::log(Logger::Debug, "EventSystem: Removed the event with ID {}", id);
+            return true;
+        }
+        /// While replaying, the live input is dropped. Only closing the application is accepted.
+        SDL_Event live_ev;
+        while (SDL_PollEvent(&live_ev)) {
+            if (live_ev.type == SDL_EVENT_QUIT || live_ev.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED) {
+                Logger::log("EventSystem: The replay is interrupted!", Logger::Warn);
+                stopReplay();
+                Engine::exit();
+                return false;
             }
         }
-        for (auto& e : _global_event_list) {
-            if (e.second) e.second();
+        auto record = _replayer->nextEvent(_frame_index);
+        if (!record) return false;
+        ev = record->event;
+        Clock::setVirtualTime(record->timestamp_ns);
+        std::fill_n(_replay_kb_events.get(), SDL_SCANCODE_COUNT, false);
+        for (auto& key : record->snapshot.keys) {
+            if (key < SDL_SCANCODE_COUNT) _replay_kb_events[key] = true;
+        }
+        _kb_events = _replay_kb_events.get();
+        _nums_keys = SDL_SCANCODE_COUNT;
+        _keys_status = record->snapshot.keys;
+        _mouse_events = static_cast<MouseStatus>(record->snapshot.mouse_state);
+        _mouse_pos.reset(record->snapshot.mouse_x, record->snapshot.mouse_y);
+        updateInputStatus();
+        return true;
+    }
+
+    void EventSystem::updateInputStatus() {
+        if (!_mouse_down_changed) {
+            // When any of mouse buttons is pressed down, triggered...
+            if (_mouse_events > MouseStatus::None) {
+                _mouse_down_changed = true;
+                _before_mouse_down_pos.reset(_mouse_pos);
+            }
+        } else {
+            if (_mouse_events > MouseStatus::None) {
+                _mouse_down_dis.reset(_mouse_pos - _before_mouse_down_pos);
+            } else {
+                _mouse_down_changed = false;
+                _mouse_down_dis.reset(0, 0);
+            }
         }
-        for (auto& id : _del_g_event_deque) {
-            _global_event_list.erase(id);
-            Logger::log(Logger::Debug, "EventSystem: Removed a global event with ID {}", id);
+    }
+
+    bool EventSystem::startRecording(const std::string &path) {
+        if (_replayer) {
+            Logger::log("EventSystem: Can't start recording while replaying!", Logger::Error);
+            return false;
+        }
+        if (_recorder) {
+            Logger::log("EventSystem: The recording is already started! It will be restarted!", Logger::Warn);
+            stopRecording();
+        }
+        auto recorder = std::make_unique<EventRecorder>(path, Clock::ticksNS());
+        if (!recorder->isValid()) return false;
+        _recorder = std::move(recorder);
+        _frame_index = 0;
+        Logger::log(Logger::Info, "EventSystem: Started recording to '{}'", path);
+        return true;
+    }
+
+    void EventSystem::stopRecording() {
+        if (!_recorder) return;
+        _recorder->close();
+        _recorder.reset();
+    }
+
+    bool EventSystem::isRecording() const {
+        return _recorder != nullptr;
+    }
+
+    bool EventSystem::startReplay(const std::string &path, ReplayMode mode, bool quit_on_finished) {
+        if (_recorder) {
+            Logger::log("EventSystem: Can't start replaying while recording!", Logger::Error);
+            return false;
+        }
+        auto replayer = std::make_unique<EventReplayer>(path);
+        if (!replayer->isValid()) return false;
+        if (!_replay_kb_events) _replay_kb_events = std::make_unique<bool[]>(SDL_SCANCODE_COUNT);
+        if (mode == Headless) {
+            for (auto& id : _engine->windowIDList()) {
+                _engine->window(id)->hide();
+            }
+        }
+        Clock::setVirtualTime(replayer->startTime());
+        _replayer = std::move(replayer);
+        _replay_quit_on_finished = quit_on_finished;
+        _frame_index = 0;
+        _replay_start_ns = SDL_GetTicksNS();
+        _replay_max_frame_ns = 0;
+        Logger::log(Logger::Info, "EventSystem: Started replaying '{}' in {} mode", path,
+                    (mode == Headless ? "headless" : "windowed"));
+        return true;
+    }
+
+    void EventSystem::stopReplay() {
+        if (!_replayer) return;
+        auto elapsed_ms = static_cast<double>(SDL_GetTicksNS() - _replay_start_ns) / 1e6;
+        Logger::log(Logger::Info, "EventSystem: Replayed {} frame(s) in {:.3f} ms, "
+                                  "average frame time: {:.3f} ms, max frame time: {:.3f} ms",
+                    _frame_index, elapsed_ms, (_frame_index ? elapsed_ms / (double)_frame_index : 0.0),
+                    static_cast<double>(_replay_max_frame_ns) / 1e6);
+        _replayer.reset();
+        _kb_events = const_cast<bool*>(SDL_GetKeyboardState(&_nums_keys));
+        Clock::resetToSystemTime();
+    }
+
+    bool EventSystem::isReplaying() const {
+        return _replayer != nullptr;
+    }
+
+    uint64_t EventSystem::frameIndex() const {
+        return _frame_index;
+    }
+
+    uint64_t EventSystem::polledEventCount() const {
+        return _polled_event_count;
+    }
+
+    bool EventSystem::hasPendingReplayEvent() const {
+        return _replayer && _replayer->hasEventInFrame(_frame_index);
+    }
+
+    void EventSystem::prepareFrame() {
+        if (_replayer) {
+            if (auto record = _replayer->nextFrame(_frame_index)) {
+                Clock::setVirtualTime(record->timestamp_ns);
+            }
+            _replay_frame_ns = SDL_GetTicksNS();
+        } else if (_recorder) {
+            _frame_ts = Clock::ticksNS();
+        }
+    }
+
+    void EventSystem::finishFrame() {
+        if (_replayer) {
+            _replay_max_frame_ns = std::max(_replay_max_frame_ns, SDL_GetTicksNS() - _replay_frame_ns);
+        } else if (_recorder) {
+            _recorder->writeFrame(_frame_index, _frame_ts);
+        }
+        _frame_index += 1;
+        if (_replayer && _replayer->finished()) {
+            stopReplay();
+            if (_replay_quit_on_finished) Engine::exit();
         }
-        _del_event_deque.clear();
-        _del_g_event_deque.clear();
-        return running;
     }
 
     size_t EventSystem::globalEventCount() const {
@@ -860,6 +1449,8 @@ namespace MyEngine {
         if (!SDL_Init(SDL_INIT_AUDIO | SDL_INIT_VIDEO | SDL_INIT_EVENTS)) {
             throwFatalError();
         }
+        if (!_wake_up_event_type) _wake_up_event_type = SDL_RegisterEvents(1);
+        TimerScheduler::global()->setNotifier(&Engine::requestRedraw);
         Logger::log("Engine: Started up application!");
         TextSystem::global();
         if (!TextSystem::global()->_is_loaded) {
@@ -1010,17 +1601,94 @@ namespace MyEngine {
 
     void Engine::setFPS(uint32_t fps) {
         _fps = fps;
-        if (!_fps) {
-            _frame_in_ns = 0; 
-            return;
-        }
-        _frame_in_ns = 1.0e9 / _fps;
+        _frame_pacer.setFrameTime(_fps ? 1000000000ull / _fps : 0);
     }
 
     uint32_t Engine::fps() const {
         return _real_fps;
     }
 
+    FramePacer* Engine::framePacer() {
+        return &_frame_pacer;
+    }
+
+    void Engine::setFixedUpdateRate(uint32_t rate) {
+        _fixed_rate = rate;
+        _fixed_dt_ns = (rate ? 1000000000ull / rate : 0);
+        _fixed_accumulator_ns = 0;
+        _fixed_last_ns = 0;
+        _interpolation_alpha = 0;
+    }
+
+    uint32_t Engine::fixedUpdateRate() const {
+        return _fixed_rate;
+    }
+
+    double Engine::fixedDeltaTime() const {
+        return static_cast<double>(_fixed_dt_ns) / 1.0e9;
+    }
+
+    void Engine::setMaxFixedUpdates(uint32_t count) {
+        _max_fixed_updates = std::max(count, 1u);
+    }
+
+    uint32_t Engine::maxFixedUpdates() const {
+        return _max_fixed_updates;
+    }
+
+    double Engine::interpolationAlpha() const {
+        return _interpolation_alpha;
+    }
+
+    uint64_t Engine::fixedUpdateCount() const {
+        return _fixed_update_count;
+    }
+
+    uint64_t Engine::droppedFixedUpdateCount() const {
+        return _dropped_fixed_update_count;
+    }
+
+    void Engine::appendFixedUpdateEvent(uint64_t id, FixedUpdateEvent event) {
+        /// The replaced event may be running in the step, the list replaces it after the step.
+        if (!_fixed_update_list.append(id, std::move(event))) {
+            Logger::log(Logger::Warn, "Engine: The fixed update event with ID {} is already exists! It will overwrite it!", id);
+        }
+    }
+
+    void Engine::removeFixedUpdateEvent(uint64_t id) {
+        if (!_fixed_update_list.remove(id)) {
+            Logger::log(Logger::Warn, "Engine: The fixed update event with ID {} is not found!", id);
+        }
+    }
+
+    size_t Engine::fixedUpdateEventCount() const {
+        return _fixed_update_list.size();
+    }
+
+    void Engine::setRedrawOnDemand(bool enabled) {
+        _redraw_on_demand = enabled;
+        if (!enabled) return;
+        /// Render the current state at first.
+        _redraw_all.store(true);
+        _last_polled_event_count = EventSystem::global(this)->polledEventCount();
+    }
+
+    bool Engine::redrawOnDemand() const {
+        return _redraw_on_demand;
+    }
+
+    void Engine::requestRedraw() {
+        _redraw_all.store(true);
+        wakeUp();
+    }
+
+    void Engine::wakeUp() {
+        if (!_wake_up_event_type || !_sleeping.exchange(false)) return;
+        SDL_Event ev{};
+        ev.type = _wake_up_event_type;
+        SDL_PushEvent(&ev);
+    }
+
     void Engine::throwFatalError() {
         std::string get_err_info = Logger::lastError();
         if (get_err_info.empty()) {
@@ -1038,39 +1706,168 @@ namespace MyEngine {
         _clean_up_event = event;
     }
 
+    JobGraph* Engine::jobGraph() {
+        return &_job_graph;
+    }
+
+    ThreadPool* Engine::jobPool() {
+        if (!_job_pool) {
+            /// The main thread also runs the jobs, so leave one core for it.
+            auto threads = std::max(ThreadPool::hardwareThreads(), 2u) - 1;
+            _job_pool = std::make_unique<ThreadPool>(1024, threads);
+        }
+        return _job_pool.get();
+    }
+
     void Engine::cleanUp() {
         if (_clean_up_event) {
             _clean_up_event();
         }
+        /// The coroutines may hold the resources of the windows.
+        CoroutineScheduler::global()->clear();
         for (auto& win : _window_list) {
             win.second.reset();
         }
         _window_list.clear();
         TextSystem::global()->unload();
         AudioSystem::global()->unload();
+        EventSystem::global()->stopRecording();
+        EventSystem::global()->stopReplay();
         // Clear all events. [p.s: Only exec while Engine doing clean up]
         EventSystem::global()->_event_list.clear();
         EventSystem::global()->_global_event_list.clear();
+        _fixed_update_list.clear();
+        _job_graph.clear();
+        _job_pool.reset();
+        TimerScheduler::global()->setNotifier(nullptr);
         SDL_Quit();
         if (_running) _running = false;
         Logger::log("Engine: Clean up finished!");
     }
 
+    bool Engine::isRedrawPending() const {
+        if (_redraw_all.load() || _fixed_update_list.size()) return true;
+        if (CoroutineScheduler::global()->hasPendingFrame()) return true;
+        auto now = Clock::ticks();
+        for (auto& [id, win] : _window_list) {
+            if (win->_redraw_settle || win->_redraw_requested.load()
+                || win->_redraw_deadline <= now) return true;
+        }
+        return false;
+    }
+
+    void Engine::waitForRedraw() {
+        /// Wake up once in a second at least, so the memory monitoring still works.
+        uint64_t timeout = 1000;
+        auto now = Clock::ticks();
+        auto wake_time = CoroutineScheduler::global()->nextWakeTime();
+        for (auto& [id, win] : _window_list) wake_time = std::min(wake_time, win->_redraw_deadline);
+        if (wake_time != UINT64_MAX) timeout = std::min(timeout, wake_time > now ? wake_time - now : 0);
+        auto timer_scheduler = TimerScheduler::global();
+        if (timer_scheduler->serviceMode() == TimerScheduler::MainLoop) {
+            auto deadline_ns = timer_scheduler->nextDeadlineNS();
+            auto now_ns = Clock::ticksNS();
+            if (deadline_ns != UINT64_MAX) {
+                timeout = std::min(timeout, deadline_ns > now_ns ? (deadline_ns - now_ns + 999999) / 1000000 : 0);
+            }
+        }
+        if (!timeout) return;
+        /// Check again after announcing the sleep, the other threads wake it up after invalidating the windows.
+        _sleeping.store(true);
+        if (!isRedrawPending()) SDL_WaitEventTimeout(nullptr, static_cast<int32_t>(timeout));
+        _sleeping.store(false);
+    }
+
+    void Engine::fixedUpdate() {
+        if (!_fixed_dt_ns) return;
+        auto now = Clock::ticksNS();
+        if (!_fixed_last_ns) _fixed_last_ns = now;
+        _fixed_accumulator_ns += now - _fixed_last_ns;
+        _fixed_last_ns = now;
+        /// Drop the time which can't be caught up in this frame, or the updates will take longer and longer.
+        auto max_ns = _fixed_dt_ns * _max_fixed_updates;
+        if (_fixed_accumulator_ns > max_ns) {
+            _dropped_fixed_update_count += (_fixed_accumulator_ns - max_ns) / _fixed_dt_ns;
+            _fixed_accumulator_ns = max_ns;
+        }
+        auto dt = fixedDeltaTime();
+        while (_fixed_accumulator_ns >= _fixed_dt_ns) {
+            _fixed_update_list(dt);
+            _fixed_accumulator_ns -= _fixed_dt_ns;
+            _fixed_update_count += 1;
+        }
+        _interpolation_alpha = static_cast<double>(_fixed_accumulator_ns) / static_cast<double>(_fixed_dt_ns);
+    }
+
+    void Engine::updateVSyncInterval() {
+        uint64_t interval = 0;
+        for (auto& [id, win] : _window_list) {
+            auto mode = win->renderer()->currentVSyncMode();
+            if (mode == Renderer::Disable) continue;
+            auto display_mode = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(win->self()));
+            if (!display_mode || display_mode->refresh_rate <= 0) continue;
+            auto rate = static_cast<uint64_t>(mode == Renderer::Adaptive ? 1 : mode);
+            interval = std::max(interval, static_cast<uint64_t>(1.0e9 / display_mode->refresh_rate) * rate);
+        }
+        _frame_pacer.setVSyncInterval(interval);
+    }
+
     void Engine::running() {
         auto start_time = SDL_GetTicks();
         auto frames = 0U;
-        auto start_ns = SDL_GetTicksNS();
+        auto event_system = EventSystem::global(this);
+        auto timer_scheduler = TimerScheduler::global();
+        auto coroutine_scheduler = CoroutineScheduler::global();
+        updateVSyncInterval();
         while (_running && !_quit_requested) {
             /// Event processing and rendering processing
-            _running = EventSystem::global(this)->run();
+            _running = event_system->run();
             if (!_running) break;
+            /// Timers serviced by the main loop or dispatched to the main thread
+            timer_scheduler->update();
+            timer_scheduler->dispatchMainThread();
             auto current_time = SDL_GetTicks();
-            auto current_ns = SDL_GetTicksNS();
-            if ((double)(current_ns - start_ns) >= _frame_in_ns) {
-                for (auto& win : _window_list) {
-                    win.second->renderer()->_update();
+            /// While replaying, the next frame is rendered as soon as all events of the current frame are processed.
+            bool replaying = event_system->isReplaying();
+            bool next_frame = replaying ? !event_system->hasPendingReplayEvent() : _frame_pacer.isFrameDue();
+            bool on_demand = _redraw_on_demand && !replaying;
+            if (on_demand && event_system->polledEventCount() != _last_polled_event_count) {
+                /// Any input may change what is shown.
+                _last_polled_event_count = event_system->polledEventCount();
+                _redraw_all.store(true);
+            }
+            if (on_demand && !isRedrawPending()) {
+                /// Nothing is invalidated, sleep until the next event or the next deadline.
+                waitForRedraw();
+                next_frame = false;
+            } else if (!next_frame && !replaying) {
+                /// Sleep until the next frame or the next event, instead of busy-waiting.
+                _frame_pacer.wait();
+            }
+            if (next_frame) {
+                _frame_pacer.frameStarted();
+                FrameArena::global()->nextFrame();
+                event_system->prepareFrame();
+                /// Simulation steps at the fixed rate, then the updates and painting of this frame.
+                fixedUpdate();
+                coroutine_scheduler->update();
+                /// Update jobs of this frame, the independent jobs overlap on the job pool.
+                if (!_job_graph.isEmpty()) _job_graph.run(jobPool());
+                bool redraw_all = _redraw_all.exchange(false) || !on_demand;
+                auto now = Clock::ticks();
+                for (auto& [id, win] : _window_list) {
+                    bool requested = win->_redraw_requested.exchange(false);
+                    if (win->_redraw_deadline <= now) {
+                        requested = true;
+                        win->_redraw_deadline = UINT64_MAX;
+                    }
+                    requested = requested || redraw_all;
+                    if (!requested && !win->_redraw_settle) continue;
+                    /// The painting commands are recorded after presenting, so render once more to show them.
+                    win->_redraw_settle = requested;
+                    win->renderer()->_update();
                 }
-                start_ns = SDL_GetTicksNS();
+                event_system->finishFrame();
                 frames += 1;
             }
             if (current_time - start_time >= 1000) {
@@ -1117,11 +1914,14 @@ namespace MyEngine {
                 }
                 frames = 0;
                 start_time = SDL_GetTicks();
+                updateVSyncInterval();
             }
         }
     }
 
     TextSystem::TextSystem() {
+        /// Construct the face cache first, so it is destroyed after the fonts of the text system.
+        FontFaceCache::global();
         load();
     }
 
@@ -1137,24 +1937,44 @@ namespace MyEngine {
         }
         Logger::log("TextSystem: Loaded text system");
         _is_loaded = true;
+        std::lock_guard<std::mutex> lock(_bake_mutex);
+        _bake_closed = false;
     }
 
     void TextSystem::unload() {
-        std::for_each(_text_map.begin(), _text_map.end(), [](auto& text) {
-            TTF_DestroyText(text.second.self);
-        });
-        std::for_each(_font_map.begin(), _font_map.end(), [](auto& font) {
-            TTF_DestroyRendererTextEngine(font.second.engine);
-            TTF_DestroySurfaceTextEngine(font.second.surface_engine);
-            font.second.font.reset();
-        });
+        {
+            /// Wait for the running bakes, the fonts of the workers must be closed before `TTF_Quit()`.
+            std::unique_lock<std::mutex> lock(_bake_mutex);
+            _bake_closed = true;
+            _bake_cond.wait(lock, [this] { return _bake_running == 0; });
+            for (auto& [thread_id, context] : _bake_contexts) releaseBakeContext(context);
+            _bake_contexts.clear();
+        }
+        for (auto& text : _texts) {
+            TTF_DestroyText(text.self);
+        }
+        for (auto& font : _fonts) {
+            font.font.reset();
+        }
+        for (auto& [renderer, engine] : _renderer_engines) {
+            TTF_DestroyRendererTextEngine(engine);
+        }
+        if (_text_engine) {
+            TTF_DestroySurfaceTextEngine(_text_engine);
+            _text_engine = nullptr;
+        }
+        _texts.clear();
+        _fonts.clear();
+        _font_names.clear();
+        _renderer_engines.clear();
+        _layout_cache.clear();
         TTF_Quit();
         Logger::log("TextSystem: Unloaded text system");
     }
 
     bool TextSystem::addFont(const std::string& font_name, const std::string& font_path, Renderer* renderer,
                              float font_size) {
-        if (_font_map.contains(font_name)) {
+        if (_font_names.contains(font_name)) {
             Logger::log(Logger::Error, "TextSystem: Font '{}' is already added!", font_name);
             return false;
         }
@@ -1162,241 +1982,259 @@ namespace MyEngine {
             Logger::log(Logger::Error, "TextSystem: Can't add font! The specified renderer is not valid!");
             return false;
         }
-        _font_map.emplace(font_name, 
-                FontEngine{TTF_CreateRendererTextEngine(renderer->self()),
-                           TTF_CreateSurfaceTextEngine(),
-                           std::make_unique<Font>(font_path, font_size)});
-        auto& new_font = _font_map.at(font_name);
+        auto engine = rendererEngine(renderer);
+        if (!engine) return false;
+        FontEngine new_font{engine, std::make_unique<Font>(font_path, font_size), font_name};
         if (!new_font.font->self()) {
-            TTF_DestroyRendererTextEngine(new_font.engine);
-            TTF_DestroySurfaceTextEngine(new_font.surface_engine);
-            _font_map.erase(font_name);
             Logger::log(Logger::Error, "TextSystem: Can't load font '{}'! Exception: {}", font_name, SDL_GetError());
             return false;
         }
+        _font_names.emplace(font_name, _fonts.insert(std::move(new_font)));
         return true;
     }
 
     bool TextSystem::removeFont(const std::string& font_name) {
-        if (!_font_map.contains(font_name)) {
+        auto handle = fontHandle(font_name);
+        if (!handle) {
             Logger::log(Logger::Error, "TextSystem: Font '{}' is not in the font list!", font_name);
             return false;
         }
-        TTF_DestroyRendererTextEngine(_font_map[font_name].engine);
-        TTF_DestroySurfaceTextEngine(_font_map[font_name].surface_engine);
-        _font_map.erase(font_name);
+        auto font = _fonts.get(handle)->font->self();
+        std::erase_if(_layout_cache, [font](const auto& item) { return item.first.font == font; });
+        _fonts.erase(handle);
+        _font_names.erase(font_name);
         return true;
     }
 
     Font* TextSystem::font(const std::string& font_name) {
-        if (!_font_map.contains(font_name)) {
+        auto handle = fontHandle(font_name);
+        if (!handle) {
             auto err = FMT::format("TextSystem: Font '{}' is not in the font list!", font_name);
             Logger::log(err, Logger::Fatal);
             throw NullPointerException(err);
         }
-        return _font_map.at(font_name).font.get();
+        return _fonts.get(handle)->font.get();
+    }
+
+    Font* TextSystem::font(FontHandle font) {
+        auto font_engine = _fonts.get(font);
+        if (!font_engine) {
+            auto err = FMT::format("TextSystem: Font handle {} is not valid!", font.value());
+            Logger::log(err, Logger::Fatal);
+            throw NullPointerException(err);
+        }
+        return font_engine->font.get();
+    }
+
+    FontHandle TextSystem::fontHandle(const std::string& font_name) const {
+        auto it = _font_names.find(font_name);
+        return it != _font_names.end() ? it->second : FontHandle{};
     }
 
     bool TextSystem::isFontContain(const std::string& font_name) const {
-        return _font_map.contains(font_name);
+        return _font_names.contains(font_name);
     }
 
     StringList TextSystem::fontNameList() const {
-        StringList font_list(_font_map.size());
-        std::for_each(_font_map.begin(), _font_map.end(), [&font_list](const auto& font) {
-            font_list.push_back(font.first);
-        });
+        StringList font_list;
+        font_list.reserve(_fonts.size());
+        for (auto& font : _fonts) {
+            font_list.push_back(font.name);
+        }
         return font_list;
     }
 
     bool TextSystem::setFontSize(const std::string &font_name, float font_size) {
-        if (!_font_map.contains(font_name)) {
+        auto handle = fontHandle(font_name);
+        if (!handle) {
             auto err = FMT::format("TextSystem: Font '{}' is not in the font list!", font_name);
             Logger::log(err, Logger::Error);
             return false;
         }
-        _font_map[font_name].font->setFontSize(font_size);
-        for (auto& [id, text] : _text_map) {
-            if (text.font_name == font_name) {
-                int w = 0, h = 0;
-                TTF_GetTextSize(text.self, &w, &h);
-                text.text_size.reset((float)w, (float)h);
-            }
-        }
+        /// The layouts are checked against the font size when they are used, only the drawn texts are measured.
+        _fonts.get(handle)->font->setFontSize(font_size);
         return true;
     }
 
-    bool TextSystem::addText(uint64_t text_id, const std::string& font_name, const std::string& text) {
-        if (_text_map.contains(text_id)) {
-            Logger::log(Logger::Error, "TextSystem: Text ID {} is already added to text list!", text_id);
-            return false;
+    TextHandle TextSystem::addText(const std::string& font_name, const std::string& text) {
+        auto font_engine = _fonts.get(fontHandle(font_name));
+        if (!font_engine) {
+            Logger::log(Logger::Error, "TextSystem: Can't add text with the font '{}'!", font_name);
+            return {};
         }
-        if (!_font_map.contains(font_name)) {
-            Logger::log(Logger::Error, "TextSystem: Text ID {} can not add the font '{}'!", text_id, font_name);
-            return false;
-        }
-        _text_map.emplace(text_id, Text(nullptr, text, font_name));
-        _text_map[text_id].self = TTF_CreateText(_font_map[font_name].engine,
-                                                 _font_map[font_name].font->self(),
-                                                 text.c_str(),
-                                                 text.size());
-        if (!_text_map[text_id].self) {
+        auto self = TTF_CreateText(font_engine->engine, font_engine->font->self(), text.c_str(), text.size());
+        if (!self) {
             Logger::log(Logger::Error, "TextSystem: Can't create text! Exception: {}", SDL_GetError());
-            _text_map.erase(text_id);
-            return false;
+            return {};
         }
-        int w = 0, h = 0;
-        TTF_GetTextSize(_text_map[text_id].self, &w, &h);
-        _text_map[text_id].text_size.reset(static_cast<float>(w), static_cast<float>(h));
-        return true;
+        return _texts.emplace(self, text, font_name, fontHandle(font_name));
     }
 
-    bool TextSystem::removeText(uint64_t text_id) {
-        if (!_text_map.contains(text_id)) {
-            Logger::log(Logger::Error, "TextSystem: Text ID {} is not in the text list!", text_id);
+    bool TextSystem::removeText(TextHandle text) {
+        auto m_text = _texts.get(text);
+        if (!m_text) {
+            Logger::log(Logger::Error, "TextSystem: Text handle {} is not in the text list!", text.value());
             return false;
         }
-        _text_map.erase(text_id);
+        TTF_DestroyText(m_text->self);
+        _texts.erase(text);
         return true;
     }
 
-    bool TextSystem::setText(uint64_t text_id, const std::string& text) {
-        if (!_text_map.contains(text_id)) {
-            Logger::log(Logger::Error, "TextSystem: Text ID {} is not in the text list!", text_id);
+    bool TextSystem::setText(TextHandle text, const std::string& string) {
+        auto m_text = _texts.get(text);
+        if (!m_text) {
+            Logger::log(Logger::Error, "TextSystem: Text handle {} is not in the text list!", text.value());
             return false;
         }
-        auto& m_text = _text_map[text_id];
-        auto _ret = TTF_SetTextString(m_text.self, text.c_str(), text.size());
+        if (m_text->text == string) return true;
+        auto _ret = TTF_SetTextString(m_text->self, string.c_str(), string.size());
         if (!_ret) {
-            Logger::log(Logger::Error, "TextSystem: Can't set text to text ID {}! Exception: {}", text_id, SDL_GetError());
+            Logger::log(Logger::Error, "TextSystem: Can't set text to text handle {}! Exception: {}",
+                        text.value(), SDL_GetError());
             return false;
         }
-        m_text.text = text;
-        int w = 0, h = 0;
-        TTF_GetTextSize(_text_map[text_id].self, &w, &h);
-        _text_map[text_id].text_size.reset(static_cast<float>(w), static_cast<float>(h));
+        m_text->text = string;
+        m_text->layout.reset();
         return true;
     }
 
-    bool TextSystem::appendText(uint64_t text_id, const std::string& text) {
-        if (!_text_map.contains(text_id)) {
-            Logger::log(Logger::Error, "TextSystem: Text ID {} is not in the text list!", text_id);
+    bool TextSystem::appendText(TextHandle text, const std::string& string) {
+        auto m_text = _texts.get(text);
+        if (!m_text) {
+            Logger::log(Logger::Error, "TextSystem: Text handle {} is not in the text list!", text.value());
             return false;
         }
-        auto& m_text = _text_map[text_id];
-        auto _ret = TTF_AppendTextString(m_text.self, text.c_str(), text.size());
+        auto _ret = TTF_AppendTextString(m_text->self, string.c_str(), string.size());
         if (!_ret) {
-            Logger::log(Logger::Error, "TextSystem: Can't set text to text ID {}! Exception: {}", text_id, SDL_GetError());
+            Logger::log(Logger::Error, "TextSystem: Can't set text to text handle {}! Exception: {}",
+                        text.value(), SDL_GetError());
             return false;
         }
-        m_text.text += text;
-        int w = 0, h = 0;
-        TTF_GetTextSize(_text_map[text_id].self, &w, &h);
-        _text_map[text_id].text_size.reset(static_cast<float>(w), static_cast<float>(h));
+        m_text->text += string;
+        m_text->layout.reset();
         return true;
     }
 
-    bool TextSystem::setTextFont(uint64_t text_id, const std::string& font_name) {
-        if (!_text_map.contains(text_id)) {
-            Logger::log(Logger::Error, "TextSystem: Text ID {} is not in the text list!", text_id);
+    bool TextSystem::setTextFont(TextHandle text, const std::string& font_name) {
+        auto m_text = _texts.get(text);
+        if (!m_text) {
+            Logger::log(Logger::Error, "TextSystem: Text handle {} is not in the text list!", text.value());
             return false;
         }
-        if (!_font_map.contains(font_name)) {
+        auto handle = fontHandle(font_name);
+        if (!handle) {
             Logger::log(Logger::Error, "TextSystem: Font '{}' is not in the font list!", font_name);
             return false;
         }
-        auto& m_text = _text_map[text_id];
-        auto _ret = TTF_SetTextFont(m_text.self, _font_map[font_name].font->self());
+        auto _ret = TTF_SetTextFont(m_text->self, _fonts.get(handle)->font->self());
         if (!_ret) {
-            Logger::log(Logger::Error, "TextSystem: Can't set font '{}' to text ID {}! Exception: {}", font_name, text_id, SDL_GetError());
+            Logger::log(Logger::Error, "TextSystem: Can't set font '{}' to text handle {}! Exception: {}",
+                        font_name, text.value(), SDL_GetError());
             return false;
         }
-        m_text.font_name = font_name;
-        int w = 0, h = 0;
-        TTF_GetTextSize(_text_map[text_id].self, &w, &h);
-        _text_map[text_id].text_size.reset(static_cast<float>(w), static_cast<float>(h));
+        m_text->font_name = font_name;
+        m_text->font = handle;
+        m_text->layout.reset();
         return true;
     }
 
-    bool TextSystem::setTextColor(uint64_t text_id, const SDL_Color& color) {
-        if (!_text_map.contains(text_id)) {
-            Logger::log(Logger::Error, "TextSystem: Text ID {} is not in the text list!", text_id);
+    bool TextSystem::setTextColor(TextHandle text, const SDL_Color& color) {
+        auto m_text = _texts.get(text);
+        if (!m_text) {
+            Logger::log(Logger::Error, "TextSystem: Text handle {} is not in the text list!", text.value());
             return false;
         }
-        auto& m_text = _text_map[text_id];
-        auto _ret = TTF_SetTextColor(m_text.self, color.r, color.g, color.b, color.a);
+        auto _ret = TTF_SetTextColor(m_text->self, color.r, color.g, color.b, color.a);
         if (!_ret) {
-            Logger::log(Logger::Error, "TextSystem: Can't set font color to text ID {}! Exception: {}", text_id, SDL_GetError());
+            Logger::log(Logger::Error, "TextSystem: Can't set font color to text handle {}! Exception: {}",
+                        text.value(), SDL_GetError());
             return false;
         }
-        m_text.font_color = color;
+        m_text->font_color = color;
         return true;
     }
 
-    TextSystem::Text* TextSystem::indexOfText(uint64_t text_id) {
-        if (!_text_map.contains(text_id)) {
-            auto err = FMT::format("TextSystem: Text ID {} is not in the text list!", text_id);
+    TextSystem::Text* TextSystem::indexOfText(TextHandle text) {
+        auto m_text = _texts.get(text);
+        if (!m_text) {
+            auto err = FMT::format("TextSystem: Text handle {} is not in the text list!", text.value());
             Logger::log(err, Logger::Fatal);
             throw NullPointerException(err);
         }
-        return &_text_map.at(text_id);
+        return m_text;
     }
 
-    bool TextSystem::isTextContain(uint64_t text_id) const {
-        return _text_map.contains(text_id);
+    TextSystem::Text* TextSystem::findText(TextHandle text) {
+        return _texts.get(text);
     }
 
-    std::vector<uint64_t> TextSystem::textIDList() const {
-        std::vector<uint64_t> id_list(_text_map.size());
-        std::for_each(_text_map.begin(), _text_map.end(), [&id_list](const auto& text) {
-            id_list.push_back(text.first);
-        });
-        return id_list;
+    bool TextSystem::isTextContain(TextHandle text) const {
+        return _texts.contains(text);
     }
 
-    bool TextSystem::drawText(uint64_t text_id, const Vector2& pos, Renderer* renderer) {
+    std::vector<TextHandle> TextSystem::textList() const {
+        std::vector<TextHandle> text_list;
+        text_list.reserve(_texts.size());
+        for (size_t i = 0; i < _texts.size(); ++i) {
+            text_list.push_back(_texts.handleAt(i));
+        }
+        return text_list;
+    }
+
+    bool TextSystem::drawText(TextHandle text, const Vector2& pos, Renderer* renderer) {
         if (!renderer) {
             Logger::log("TextSystem: The specified renderer is not valid!", Logger::Error);
             return false;
         }
-        if (!_text_map.contains(text_id)) {
-            Logger::log(Logger::Error, "TextSystem: Text ID {} is not in the text list!", text_id);
+        auto m_text = _texts.get(text);
+        if (!m_text) {
+            Logger::log(Logger::Error, "TextSystem: Text handle {} is not in the text list!", text.value());
+            return false;
+        }
+        auto layout = ensureLayout(*m_text);
+        if (!layout) {
+            Logger::log(Logger::Error, "TextSystem: The font of text handle {} is removed!", text.value());
             return false;
         }
-        auto temp_pos = pos;
-        renderer->drawText(_text_map[text_id].self, temp_pos);
+        /// The glyphs are batched by the renderer, the layout is reused until the string or the font is changed.
+        renderer->drawGlyphs(layout->font, layout->glyphs, pos, m_text->font_color);
         return true;
     }
 
     bool TextSystem::updateFont(const std::string &font_name) {
-        if (!_font_map.contains(font_name)) {
+        auto handle = fontHandle(font_name);
+        if (!handle) {
             auto err = FMT::format("TextSystem: Font '{}' is not in the font list!", font_name);
             Logger::log(err, Logger::Error);
             return false;
         }
-        for (auto& [id, text] : _text_map) {
-            if (text.font_name == font_name) {
-                int w = 0, h = 0;
-                TTF_GetTextSize(text.self, &w, &h);
-                text.text_size.reset((float)w, (float)h);
-            }
+        /// The font may be changed in the ways the layouts are not keyed by, e.g. the kerning.
+        auto font = _fonts.get(handle)->font->self();
+        std::erase_if(_layout_cache, [font](const auto& item) { return item.first.font == font; });
+        for (auto& text : _texts) {
+            if (text.font == handle) text.layout.reset();
         }
         return true;
     }
 
-    SDL_Surface* TextSystem::toImage(uint64_t text_id) {
-        if (!_text_map.contains(text_id)) {
-            Logger::log(Logger::Error, "TextSystem: Text ID {} is not in the text list!", text_id);
+    SDL_Surface* TextSystem::toImage(TextHandle text) {
+        auto m_text = _texts.get(text);
+        if (!m_text) {
+            Logger::log(Logger::Error, "TextSystem: Text handle {} is not in the text list!", text.value());
             return nullptr;
         }
-        if (!_font_map.contains(_text_map[text_id].font_name)) {
-            Logger::log(Logger::Error, "TextSystem: Text ID {} has not set the font! Please use `setTextFont()` to set the font!", text_id);
+        auto font_engine = _fonts.get(m_text->font);
+        if (!font_engine) {
+            Logger::log(Logger::Error, "TextSystem: Text handle {} has not set the font! "
+                                       "Please use `setTextFont()` to set the font!", text.value());
             return nullptr;
         }
-        auto& font_engine = _font_map[_text_map[text_id].font_name];
-        auto& text =  _text_map[text_id].text;
-        TTF_Text* temp_text = TTF_CreateText(font_engine.surface_engine, font_engine.font->self(), text.c_str(), text.size());
-        auto t_surface = font_engine.font->toImage(text);
+        if (!_text_engine) _text_engine = TTF_CreateSurfaceTextEngine();
+        auto& string = m_text->text;
+        TTF_Text* temp_text = TTF_CreateText(_text_engine, font_engine->font->self(),
+                                             string.c_str(), string.size());
+        auto t_surface = font_engine->font->toImage(string);
         SDL_Surface* surface = SDL_CreateSurface(t_surface->w, t_surface->h, SDL_PIXELFORMAT_ABGR64);
         SDL_DestroySurface(t_surface);
         auto _ret = TTF_DrawSurfaceText(temp_text, 0, 0, surface);
@@ -1408,6 +2246,230 @@ namespace MyEngine {
         TTF_DestroyText(temp_text);
         return surface;
     }
+
+    Future<std::shared_ptr<SDL_Surface>> TextSystem::toImageAsync(TextHandle text, ThreadPool* pool) {
+        auto m_text = _texts.get(text);
+        if (!m_text) {
+            Logger::log(Logger::Error, "TextSystem: Text handle {} is not in the text list!", text.value());
+            return {};
+        }
+        auto font_engine = _fonts.get(m_text->font);
+        if (!font_engine) {
+            Logger::log(Logger::Error, "TextSystem: Text handle {} has not set the font! "
+                                       "Please use `setTextFont()` to set the font!", text.value());
+            return {};
+        }
+        return submitBake(*font_engine, m_text->text, m_text->font_color, pool);
+    }
+
+    Future<std::shared_ptr<SDL_Surface>> TextSystem::toImageAsync(const std::string& font_name,
+                                                                  const std::string& string,
+                                                                  const SDL_Color& color, ThreadPool* pool) {
+        auto font_engine = _fonts.get(fontHandle(font_name));
+        if (!font_engine) {
+            Logger::log(Logger::Error, "TextSystem: Font '{}' is not in the font list!", font_name);
+            return {};
+        }
+        return submitBake(*font_engine, string, color, pool);
+    }
+
+    Future<std::shared_ptr<SDL_Surface>> TextSystem::submitBake(const FontEngine& font, const std::string& string,
+                                                                const SDL_Color& color, ThreadPool* pool) {
+        if (!pool) {
+            Logger::log(Logger::Error, "TextSystem: Can't bake text! The specified thread pool is not valid!");
+            return {};
+        }
+        /// The settings are read from the font, the workers never touch the font of the main thread.
+        auto ttf_font = font.font->self();
+        BakeJob job{font.font->fontPath(), font.font->fontSize(), static_cast<uint32_t>(TTF_GetFontStyle(ttf_font)),
+                    font.font->outline(), static_cast<int>(TTF_GetFontHinting(ttf_font)),
+                    static_cast<int>(TTF_GetFontDirection(ttf_font)), TTF_GetFontLineSkip(ttf_font),
+                    TTF_GetFontKerning(ttf_font), color, font.font->outlineColor(), string};
+        return pool->submit([this, job = std::move(job)] { return bake(job); });
+    }
+
+    std::shared_ptr<SDL_Surface> TextSystem::bake(const BakeJob& job) {
+        BakeContext* context;
+        {
+            std::lock_guard<std::mutex> lock(_bake_mutex);
+            if (_bake_closed) return nullptr;
+            _bake_running += 1;
+            context = &_bake_contexts[std::this_thread::get_id()];
+        }
+        auto surface = bakeSurface(*context, job);
+        {
+            std::lock_guard<std::mutex> lock(_bake_mutex);
+            _bake_running -= 1;
+        }
+        _bake_cond.notify_all();
+        return {surface, SDL_DestroySurface};
+    }
+
+    SDL_Surface* TextSystem::bakeSurface(BakeContext& context, const BakeJob& job) {
+        /// The fonts are opened from the shared face, so a font per worker costs little memory.
+        static constexpr size_t MAX_CONTEXT_FONTS = 16;
+        auto key = FMT::format("{}#{}", job.font_path, job.font_size);
+        auto it = context.fonts.find(key);
+        if (it == context.fonts.end()) {
+            if (context.fonts.size() >= MAX_CONTEXT_FONTS) releaseBakeContext(context);
+            auto font = FontFaceCache::global()->openFont(job.font_path, job.font_size);
+            if (!font) {
+                Logger::log(Logger::Error, "TextSystem: Can't open font '{}' to bake text! Exception: {}",
+                            job.font_path, SDL_GetError());
+                return nullptr;
+            }
+            it = context.fonts.emplace(std::move(key), font).first;
+        }
+        if (!context.engine) context.engine = TTF_CreateSurfaceTextEngine();
+        if (!context.engine) {
+            Logger::log(Logger::Error, "TextSystem: Can't create the text engine! Exception: {}", SDL_GetError());
+            return nullptr;
+        }
+        auto font = it->second;
+        TTF_SetFontStyle(font, static_cast<TTF_FontStyleFlags>(job.style));
+        TTF_SetFontHinting(font, static_cast<TTF_HintingFlags>(job.hinting));
+        TTF_SetFontDirection(font, static_cast<TTF_Direction>(job.direction));
+        TTF_SetFontLineSkip(font, job.line_skip);
+        TTF_SetFontKerning(font, job.kerning);
+
+        auto render = [&context, font, &job](const SDL_Color& color) -> SDL_Surface* {
+            auto text = TTF_CreateText(context.engine, font, job.text.c_str(), job.text.size());
+            if (!text) return nullptr;
+            TTF_SetTextColor(text, color.r, color.g, color.b, color.a);
+            int width = 0, height = 0;
+            TTF_GetTextSize(text, &width, &height);
+            auto surface = SDL_CreateSurface(std::max(width, 1), std::max(height, 1), SDL_PIXELFORMAT_RGBA32);
+            if (surface && !TTF_DrawSurfaceText(text, 0, 0, surface)) {
+                SDL_DestroySurface(surface);
+                surface = nullptr;
+            }
+            TTF_DestroyText(text);
+            return surface;
+        };
+        SDL_Surface* surface;
+        if (job.outline) {
+            TTF_SetFontOutline(font, static_cast<int>(job.outline));
+            surface = render(job.outline_color);
+            TTF_SetFontOutline(font, 0);
+            if (surface && job.color.a > 0) {
+                /// The same as `Font::toImage()`, the filled text is centered in the outline.
+                if (auto filled = render(job.color)) {
+                    SDL_Rect rect{surface->w / 2 - filled->w / 2, surface->h / 2 - filled->h / 2,
+                                  filled->w, filled->h};
+                    SDL_BlitSurface(filled, nullptr, surface, &rect);
+                    SDL_DestroySurface(filled);
+                }
+            }
+        } else {
+            surface = render(job.color);
+        }
+        if (!surface) {
+            Logger::log(Logger::Error, "TextSystem: Text to image failed! Exception: {}", SDL_GetError());
+        }
+        return surface;
+    }
+
+    void TextSystem::releaseBakeContext(BakeContext& context) {
+        if (context.engine) {
+            TTF_DestroySurfaceTextEngine(context.engine);
+            context.engine = nullptr;
+        }
+        for (auto& [key, font] : context.fonts) FontFaceCache::global()->closeFont(font);
+        context.fonts.clear();
+    }
+
+    TTF_TextEngine* TextSystem::rendererEngine(Renderer* renderer) {
+        auto it = _renderer_engines.find(renderer->self());
+        if (it != _renderer_engines.end()) return it->second;
+        auto engine = TTF_CreateRendererTextEngine(renderer->self());
+        if (!engine) {
+            Logger::log(Logger::Error, "TextSystem: Can't create the text engine! Exception: {}", SDL_GetError());
+            return nullptr;
+        }
+        _renderer_engines.emplace(renderer->self(), engine);
+        return engine;
+    }
+
+    const Size& TextSystem::textSize(TextHandle text) {
+        static const Size EMPTY_SIZE{};
+        auto m_text = _texts.get(text);
+        if (!m_text) return EMPTY_SIZE;
+        auto layout = ensureLayout(*m_text);
+        return layout ? layout->size : EMPTY_SIZE;
+    }
+
+    const TextSystem::TextLayout* TextSystem::textLayout(TextHandle text) {
+        auto m_text = _texts.get(text);
+        return m_text ? ensureLayout(*m_text) : nullptr;
+    }
+
+    void TextSystem::setLayoutCacheCapacity(size_t capacity) {
+        _layout_capacity = std::max<size_t>(capacity, 1);
+        if (_layout_cache.size() > _layout_capacity) _layout_cache.clear();
+    }
+
+    size_t TextSystem::layoutCacheSize() const {
+        return _layout_cache.size();
+    }
+
+    size_t TextSystem::LayoutKeyHash::operator()(const LayoutKey& key) const noexcept {
+        auto hash = key.hash;
+        auto combine = [&hash](uint64_t value) {
+            hash ^= std::hash<uint64_t>{}(value) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        };
+        combine(reinterpret_cast<uintptr_t>(key.font));
+        combine(static_cast<uint64_t>(key.size_bits) << 32 | key.style);
+        combine(static_cast<uint32_t>(key.outline));
+        return hash;
+    }
+
+    const TextSystem::TextLayout* TextSystem::ensureLayout(Text& text) {
+        auto font_engine = _fonts.get(text.font);
+        if (!font_engine || !font_engine->font->self()) return nullptr;
+        auto font = font_engine->font->self();
+        auto font_size = TTF_GetFontSize(font);
+        auto style = static_cast<uint32_t>(TTF_GetFontStyle(font));
+        auto outline = TTF_GetFontOutline(font);
+        auto generation = GlyphAtlas::fontGeneration();
+        auto& layout = text.layout;
+        if (layout && layout->font == font && layout->font_size == font_size && layout->style == style
+            && layout->outline == outline && layout->font_generation == generation) {
+            return layout.get();
+        }
+        /// The texts with the same string and font share the layout, e.g. the same labels in many rows.
+        LayoutKey key{font, std::bit_cast<uint32_t>(font_size), style, outline,
+                      std::hash<std::string_view>{}(text.text)};
+        auto frame = FrameArena::global()->frameIndex();
+        auto it = _layout_cache.find(key);
+        if (it != _layout_cache.end() && it->second.text == text.text
+            && it->second.layout->font_generation == generation) {
+            it->second.last_used = frame;
+            layout = it->second.layout;
+            return layout.get();
+        }
+        auto new_layout = std::make_shared<TextLayout>();
+        new_layout->font = font;
+        new_layout->font_size = font_size;
+        new_layout->style = style;
+        new_layout->outline = outline;
+        new_layout->font_generation = generation;
+        int w = 0, h = 0;
+        TTF_GetStringSize(font, text.text.c_str(), text.text.size(), &w, &h);
+        new_layout->size.reset(static_cast<float>(w), static_cast<float>(h));
+        GlyphAtlas::layoutText(font, text.text, new_layout->glyphs, &new_layout->line_starts);
+        if (it != _layout_cache.end()) {
+            it->second = {text.text, new_layout, frame};
+        } else {
+            if (_layout_cache.size() >= _layout_capacity) {
+                /// The texts keep their layouts, only the sharing of the dropped ones is lost.
+                std::erase_if(_layout_cache, [frame](const auto& item) { return item.second.last_used + 1 < frame; });
+                if (_layout_cache.size() >= _layout_capacity) _layout_cache.clear();
+            }
+            _layout_cache.emplace(key, LayoutEntry{text.text, new_layout, frame});
+        }
+        layout = std::move(new_layout);
+        return layout.get();
+    }
     
     AudioSystem::AudioSystem() {
         _is_init = load();
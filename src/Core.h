@@ -26,6 +26,13 @@
 #include "Basic.h"
 #include "Components.h"
 #include "Utils/Cursor.h"
+#include "Utils/EventRecorder.h"
+#include "MultiThread/JobGraph.h"
+#include "MultiThread/Future.h"
+#include "Utils/FramePacer.h"
+#include "Utils/FrameArena.h"
+#include "Utils/InplaceFunction.h"
+#include "Renderer/GlyphAtlas.h"
 
 namespace MyEngine {
     class Engine;
@@ -48,19 +55,61 @@ namespace MyEngine {
     namespace RenderCommand {
         class BaseCommand;
         class CommandFactory;
+        class TextCMD;
+        class DebugTextCMD;
+        class ViewPortCMD;
+        class ClipViewCMD;
     }
 
     class Renderer {
     private:
-        std::deque<std::unique_ptr<RenderCommand::BaseCommand>> _cmd_list;
+        std::deque<std::unique_ptr<RenderCommand::BaseCommand>> _cmd_list, _native_cmd_list;
+        /// The lists and strings of the recorded commands, it is reset after the commands are executed.
+        LinearArena _cmd_arena{};
         SDL_Renderer* _renderer{nullptr};
         Window* _window{nullptr};
         size_t _render_count{0}, _render_cnt_in_sec{0};
         uint64_t _start_ts{0};
         static SDL_Color _background_color;
+        static constexpr size_t FRAME_SAMPLES = 30;
+        bool _dyn_res_enabled{false}, _native_ui{true};
+        uint32_t _native_layer{0};
+        float _res_scale{1.f}, _min_res_scale{0.5f}, _max_res_scale{1.f};
+        uint64_t _target_frame_ns{16666666}, _frame_time_ns{0}, _frame_time_p90_ns{0};
+        std::array<uint64_t, FRAME_SAMPLES> _frame_samples{};
+        size_t _frame_sample_count{0};
+        SDL_Texture* _scaled_target{nullptr};
+        int _target_width{0}, _target_height{0};
+        std::unique_ptr<GlyphAtlas> _glyph_atlas;
+        /// The debug characters baked from `SDL_RenderDebugText()`.
+        SDL_Texture* _debug_font{nullptr};
+        static constexpr int DEBUG_FONT_COLUMNS = 16;
+        /// The glyph quads waiting to be batched, one run per texture (the atlas pages and the debug font).
+        struct GlyphRun {
+            SDL_Texture* texture;
+            std::vector<SDL_FRect> dest_rects, src_rects;
+            std::vector<SDL_FColor> colors;
+        };
+        std::vector<GlyphRun> _glyph_runs;
+        bool _glyph_pending{false}, _glyph_native{false};
+        std::vector<GlyphPlacement> _glyph_layout;
+        /// The last viewport recorded into the scene list and the native list, the glyph quads are absolute.
+        std::array<Geometry, 2> _recorded_viewport{};
 
         template<typename T, typename ...Args>
         void addCommand(Args... args);
+        /// Whether the commands are drawn into the native list, only the ones in the native layer are.
+        [[nodiscard]] bool isNativeCommand() const;
+        void executeCommands(std::deque<std::unique_ptr<RenderCommand::BaseCommand>>& cmd_list);
+        bool beginScaledTarget();
+        void endScaledTarget();
+        void updateResolutionScale();
+        /// Prepare to add the glyph quads, return the viewport they are clipped to.
+        const Geometry& beginGlyphs();
+        void addGlyphQuad(SDL_Texture* texture, SDL_FRect dest, SDL_FRect src, const SDL_FColor& color,
+                          const Geometry& viewport);
+        void flushGlyphs();
+        SDL_Texture* debugFont();
     public:
         enum VSyncMode : int8_t {
             Disable,
@@ -79,16 +128,28 @@ namespace MyEngine {
         [[nodiscard]] size_t renderCountInSec() const;
         [[nodiscard]] SDL_Surface* capture() const;
         [[nodiscard]] SDL_Surface* capture(Geometry geometry) const;
+        /**
+         * \if EN
+         * @brief Get the arena of the commands recorded for the next frame of this renderer
+         * @details The memory is valid until the renderer executes its commands, even if the window skips frames
+         * in the redraw-on-demand mode. It fits the spans passed to the draw functions which are not copied.
+         * \endif
+         */
+        [[nodiscard]] LinearArena* commandArena();
         void _update();
         void fillBackground(const SDL_Color& color);
         void fillBackground(SDL_Color&& color);
         void fillBackground(uint64_t rgb_hex = 0);
         void drawPoint(Graphics::Point* point);
         void drawPoints(const std::vector<Graphics::Point*>& point_list);
+        /// The span is not copied, it must be valid until the next frame is rendered.
+        void drawPoints(std::span<const Graphics::Point> points);
         void drawLine(Graphics::Line* line);
         void drawLines(const std::vector<Graphics::Line*>& line_list);
         void drawRectangle(Graphics::Rectangle* rectangle);
         void drawRectangles(const std::vector<Graphics::Rectangle*>& rectangle_list);
+        /// The span is not copied, it must be valid until the next frame is rendered.
+        void drawRectangles(std::span<const Graphics::Rectangle> rectangles);
         void drawTriangle(Graphics::Triangle* triangle);
         void drawTriangles(const std::vector<Graphics::Triangle*>& triangle);
         void drawEllipse(Graphics::Ellipse* ellipse);
@@ -96,19 +157,93 @@ namespace MyEngine {
         void drawTexture(SDL_Texture* texture, TextureProperty* property);
         void drawTexture(SDL_Texture* texture, const std::vector<TextureProperty*>& property);
         void drawTextures(const std::vector<SDL_Texture*>& textures, const std::vector<TextureProperty*>& properties);
+        /// The spans are not copied, they must be valid until the next frame is rendered.
+        void drawTexture(SDL_Texture* texture, std::span<const TextureProperty> properties);
+        void drawTextures(std::span<SDL_Texture* const> textures, std::span<const TextureProperty> properties);
+        /**
+         * \if EN
+         * @brief Draw the instances of one texture with one geometry call
+         * @param texture    The shared texture (e.g. a texture atlas)
+         * @param dest_rects The destination rectangles of the instances
+         * @param src_rects  The source rectangles in pixels, empty means the whole texture
+         * @param colors     The color modulation of the instances, empty means white
+         * @note The spans are not copied, they must be valid until the next frame is rendered.
+         * \endif
+         */
+        void drawSprites(SDL_Texture* texture, std::span<const SDL_FRect> dest_rects,
+                         std::span<const SDL_FRect> src_rects = {}, std::span<const SDL_FColor> colors = {});
 
         void drawText(TTF_Text* text, Vector2& position);
         void drawTexts(TTF_Text* text, const std::vector<Vector2*>& position_list);
         void drawTexts(const std::vector<TTF_Text*>& text_list, const std::vector<Vector2*>& position_list);
-        void drawDebugText(const std::string& text, const Vector2& position,
+        /// The spans are not copied, they must be valid until the next frame is rendered.
+        void drawTexts(TTF_Text* text, std::span<const Vector2> positions);
+        void drawTexts(std::span<TTF_Text* const> texts, std::span<const Vector2> positions);
+        /**
+         * \if EN
+         * @brief Draw the text with the debug font of SDL
+         * @details The characters are drawn from a texture baked at the first use, and batched with the other
+         * texts, so hundreds of lines cost one geometry call. The string is laid out at once, it is not kept.
+         * \endif
+         */
+        void drawDebugText(std::string_view text, const Vector2& position,
                            const SDL_Color& color = StdColor::Black);
+        /// Format the debug text into the frame arena and draw it, nothing is allocated on the heap.
+        template<typename... Args>
+        void drawDebugText(const Vector2& position, const SDL_Color& color,
+                           FMT::format_string<Args...> fmt, Args&&... args);
         void drawDebugTexts(const StringList& text_list, const std::vector<Vector2*>& position_list,
                            const SDL_Color& color = StdColor::Black);
+        void drawDebugTexts(std::span<const std::string_view> text_list, std::span<const Vector2> positions,
+                            const SDL_Color& color = StdColor::Black);
         void drawDebugFPS(const Vector2& position = {20, 20}, const SDL_Color& color = StdColor::Black);
+        /**
+         * \if EN
+         * @brief Draw the text with the glyphs cached in the glyph atlas
+         * @details The glyph quads of the consecutive texts are merged into one geometry call per atlas page,
+         * whatever fonts and sizes they use. The string is laid out at once, it is not kept.
+         * \endif
+         */
+        void drawGlyphText(TTF_Font* font, std::string_view text, const Vector2& position,
+                           const SDL_Color& color = StdColor::Black);
+        /// Draw the glyphs laid out by `GlyphAtlas::layoutText()`, e.g. the cached layout of a text.
+        void drawGlyphs(TTF_Font* font, std::span<const GlyphPlacement> glyphs, const Vector2& position,
+                        const SDL_Color& color = StdColor::Black);
+        /// Get the glyph atlas of the renderer, it is created at the first use.
+        GlyphAtlas* glyphAtlas();
         void setViewport(const Geometry& geometry);
         void setClipView(const Geometry& geometry);
         void setBlendMode(const SDL_BlendMode& blend_mode);
 
+        /**
+         * \if EN
+         * @brief Render at an adaptive internal resolution to keep the frame time in the budget
+         * @details The commands are rendered into an off-screen target with a smaller render scale,
+         * then the target is stretched to the window. The scale is adjusted from the 90th percentile
+         * of the recent frame times, it is lowered when the budget is exceeded and raised when there is
+         * enough headroom, the band between them keeps it from oscillating.
+         * \endif
+         */
+        void setDynamicResolutionEnabled(bool enabled);
+        [[nodiscard]] bool dynamicResolutionEnabled() const;
+        /// Set the frame time budget in nanoseconds, the default is 1/60 second.
+        void setTargetFrameTime(uint64_t time_ns);
+        [[nodiscard]] uint64_t targetFrameTime() const;
+        void setResolutionScaleRange(float min_scale, float max_scale = 1.f);
+        [[nodiscard]] float resolutionScale() const;
+        /// Keep the widgets at the native resolution, they are drawn above the scaled scene.
+        /// The other commands, the text included, are drawn in the scene with its viewports and clip views.
+        void setNativeUIEnabled(bool enabled);
+        [[nodiscard]] bool nativeUIEnabled() const;
+        /// The commands between them are drawn at the native resolution if the native UI is enabled,
+        /// the widgets paint in the native layer.
+        void beginNativeLayer();
+        void endNativeLayer();
+        /// Get the time of rendering the last frame in nanoseconds, presenting is not included.
+        [[nodiscard]] uint64_t frameTimeNS() const;
+        /// Get the 90th percentile of the frame times used by the last adjustment.
+        [[nodiscard]] uint64_t frameTimePercentileNS() const;
+
         template<typename T, typename ...Args>
         void addCustomCommand(Args... args);
     };
@@ -116,6 +251,7 @@ namespace MyEngine {
     class Window {
         friend class Renderer;
         friend class EventSystem;
+        friend class Engine;
     public:
         struct WindowSize {
             int width, height;
@@ -184,7 +320,19 @@ namespace MyEngine {
 
         [[nodiscard]] SDL_Window* self() const;
         [[nodiscard]] Engine* engine() const;
-        void installPaintEvent(const std::function<void(Renderer* renderer)>& paint_event, bool push_back = false);
+        using PaintEvent = InplaceFunction<void(Renderer*)>;
+        void installPaintEvent(PaintEvent paint_event, bool push_back = false);
+        /**
+         * \if EN
+         * @brief Invalidate the window, it is rendered at the next frame
+         * @details It only matters in the redraw-on-demand mode (see `Engine::setRedrawOnDemand()`).
+         * It is thread-safe, the main loop is woken up if it is called on other threads.
+         * \endif
+         */
+        void requestRedraw();
+        /// Invalidate the window after `ms` milliseconds of the engine clock, it can only be called on the main thread.
+        void requestRedrawAfter(uint64_t ms);
+        [[nodiscard]] bool isRedrawRequested() const;
     protected:
         virtual void paintEvent();
         virtual void resizeEvent();
@@ -229,9 +377,15 @@ namespace MyEngine {
         bool _drag_mode{false};
         std::string _drop_url{};
         Vector2 _mouse_pos{}, _dragging_pos{};
-        std::deque<std::function<void(Renderer*)>> _paint_event_list;
+        std::vector<PaintEvent> _paint_event_list;
+        /// The paint events installed while painting, with `push_back` of each.
+        std::vector<std::pair<PaintEvent, bool>> _pending_paint_events;
+        bool _painting{false};
         Engine* _engine;
         Cursor::StdCursor _cursor{};
+        std::atomic<bool> _redraw_requested{true};
+        bool _redraw_settle{false};
+        uint64_t _redraw_deadline{UINT64_MAX};
     };
 
     class EventSystem {
@@ -245,11 +399,18 @@ namespace MyEngine {
 
         static EventSystem* global(Engine* engine);
         static EventSystem* global();
-        void appendEvent(uint64_t id, const std::function<void(SDL_Event)>& event);
+        using Event = CallbackList<void(SDL_Event)>::Function;
+        using GlobalEvent = CallbackList<void()>::Function;
+        void appendEvent(uint64_t id, Event event);
+        /// Append the event with a new unique ID from `IDGenerator`, the handle is used to remove it.
+        EventHandle appendEvent(Event event);
         void removeEvent(uint64_t id);
+        void removeEvent(EventHandle handle);
 
-        void appendGlobalEvent(uint64_t g_id, const std::function<void()>& event);
+        void appendGlobalEvent(uint64_t g_id, GlobalEvent event);
+        GlobalEventHandle appendGlobalEvent(GlobalEvent event);
         void removeGlobalEvent(uint64_t g_id);
+        void removeGlobalEvent(GlobalEventHandle handle);
 
         [[nodiscard]] size_t eventCount() const;
         [[nodiscard]] size_t globalEventCount() const;
@@ -261,19 +422,43 @@ namespace MyEngine {
         [[nodiscard]] const Vector2& captureMousePosition() const;
         bool run();
         static std::string_view mouseStatusName(MouseStatus status);
+
+        enum ReplayMode : uint8_t {
+            Windowed,
+            Headless
+        };
+        bool startRecording(const std::string& path);
+        void stopRecording();
+        [[nodiscard]] bool isRecording() const;
+        bool startReplay(const std::string& path, ReplayMode mode = Windowed, bool quit_on_finished = true);
+        void stopReplay();
+        [[nodiscard]] bool isReplaying() const;
+        [[nodiscard]] uint64_t frameIndex() const;
+        /// Get the number of the events polled since the engine is started.
+        [[nodiscard]] uint64_t polledEventCount() const;
     private:
         explicit EventSystem(Engine* engine) : _engine(engine) {}
+        bool pollEvent(SDL_Event& ev);
+        void updateInputStatus();
+        bool hasPendingReplayEvent() const;
+        void prepareFrame();
+        void finishFrame();
         static std::unique_ptr<EventSystem> _instance;
         Engine* _engine{nullptr};
+        std::unique_ptr<EventRecorder> _recorder;
+        std::unique_ptr<EventReplayer> _replayer;
+        std::unique_ptr<bool[]> _replay_kb_events;
+        bool _replay_quit_on_finished{true};
+        uint64_t _frame_index{0}, _frame_ts{0}, _polled_event_count{0};
+        uint64_t _replay_start_ns{0}, _replay_frame_ns{0}, _replay_max_frame_ns{0};
         bool* _kb_events{nullptr};
         int _nums_keys{0};
         bool _mouse_down_changed{false};
         std::vector<SDL_Scancode> _keys_status;
         MouseStatus _mouse_events{0};
         Vector2 _mouse_pos{0, 0}, _mouse_down_dis{0, 0}, _before_mouse_down_pos{0, 0};
-        std::unordered_map<uint64_t, std::function<void(SDL_Event)>> _event_list{};
-        std::vector<uint64_t> _del_event_deque, _del_g_event_deque;
-        std::unordered_map<uint64_t, std::function<void()>> _global_event_list{};
+        CallbackList<void(SDL_Event)> _event_list{};
+        CallbackList<void()> _global_event_list{};
     };
 
     class Engine {
@@ -327,42 +512,136 @@ namespace MyEngine {
 
         void setFPS(uint32_t fps);
         [[nodiscard]] uint32_t fps() const;
+        /// Get the frame pacer of the main loop, it also reports the pacing jitter.
+        FramePacer* framePacer();
+
+        /**
+         * \if EN
+         * @brief Set the rate of the fixed update in a second, `0` means disabled
+         * @details The fixed update events are called with the same delta time at the fixed rate,
+         * no matter how fast the frames are rendered. The elapsed time is accumulated in every frame,
+         * and the remaining part is reported by `interpolationAlpha()` to interpolate the rendering.
+         * \endif
+         */
+        void setFixedUpdateRate(uint32_t rate);
+        [[nodiscard]] uint32_t fixedUpdateRate() const;
+        /// Get the delta time of one fixed update in seconds.
+        [[nodiscard]] double fixedDeltaTime() const;
+        /// Set the maximum fixed updates in a frame, the time beyond it is dropped to avoid the spiral of death.
+        void setMaxFixedUpdates(uint32_t count);
+        [[nodiscard]] uint32_t maxFixedUpdates() const;
+        /// Get the progress between the last fixed update and the next one in [0, 1).
+        [[nodiscard]] double interpolationAlpha() const;
+        [[nodiscard]] uint64_t fixedUpdateCount() const;
+        [[nodiscard]] uint64_t droppedFixedUpdateCount() const;
+        using FixedUpdateEvent = CallbackList<void(double)>::Function;
+        /// Append the fixed update event, the argument is the delta time in seconds.
+        void appendFixedUpdateEvent(uint64_t id, FixedUpdateEvent event);
+        void removeFixedUpdateEvent(uint64_t id);
+        [[nodiscard]] size_t fixedUpdateEventCount() const;
+
+        /**
+         * \if EN
+         * @brief Only render the windows after they are invalidated
+         * @details A window is invalidated by the input events, the changed widgets, the running animations,
+         * timers and coroutines, or `Window::requestRedraw()`. If nothing is invalidated,
+         * the main loop sleeps until the next event or the next deadline, so the idle application takes almost no CPU.
+         * The fixed update events keep rendering at the full frame rate while they are installed.
+         * \endif
+         */
+        void setRedrawOnDemand(bool enabled);
+        [[nodiscard]] bool redrawOnDemand() const;
+        /// Invalidate all windows, it is thread-safe.
+        static void requestRedraw();
+        /// Wake up the main loop sleeping in the redraw-on-demand mode, it is thread-safe.
+        static void wakeUp();
         static void throwFatalError();
 
         void installCleanUpEvent(const std::function<void()>& event);
 
+        /**
+         * \if EN
+         * @brief Get the job graph running in every frame before rendering
+         * @details The independent jobs run in parallel on the job pool, see `JobGraph`.
+         * \endif
+         */
+        JobGraph* jobGraph();
+        /// Get the thread pool running the job graph, it is created at the first call.
+        ThreadPool* jobPool();
+
     private:
         void cleanUp();
         void running();
+        void fixedUpdate();
+        void updateVSyncInterval();
+        [[nodiscard]] bool isRedrawPending() const;
+        void waitForRedraw();
         static bool _quit_requested;
         static int _return_code;
         static SDL_WindowID _main_window_id;
         static bool _show_app_info;
+        static std::atomic<bool> _redraw_all, _sleeping;
+        static uint32_t _wake_up_event_type;
 
-        double _frame_in_ns{0};
+        FramePacer _frame_pacer;
         uint32_t _fps{0};
         uint32_t _real_fps{0};
+        uint32_t _fixed_rate{0}, _max_fixed_updates{5};
+        uint64_t _fixed_dt_ns{0}, _fixed_accumulator_ns{0}, _fixed_last_ns{0};
+        uint64_t _fixed_update_count{0}, _dropped_fixed_update_count{0};
+        double _interpolation_alpha{0};
+        CallbackList<void(double)> _fixed_update_list{};
         bool _running{};
+        bool _redraw_on_demand{false};
+        uint64_t _last_polled_event_count{0};
         std::unordered_map<SDL_WindowID, std::unique_ptr<Window>> _window_list;
         std::function<void()> _clean_up_event;
         size_t _used_mem_kb{0}, _max_mem_kb{0}, _warn_mem_kb{0};
+        JobGraph _job_graph;
+        std::unique_ptr<ThreadPool> _job_pool;
     };
 
+    struct TextTag;
+    struct FontTag;
+    using TextHandle = Handle<TextTag>;
+    using FontHandle = Handle<FontTag>;
+
     class TextSystem : public Template::Singleton<TextSystem> {
         friend class Template::Singleton<TextSystem>;
         friend class Engine;
     public:
+        /**
+         * \if EN
+         * @brief The measured size, the line breaks and the glyph placements of a string
+         * @details The layouts are cached by the font, its size, style and outline, and the string,
+         * so the texts with the same string share one layout, and changing the color never lays out again.
+         * \endif
+         */
+        struct TextLayout {
+            TTF_Font* font;
+            float font_size;
+            uint32_t style;
+            int outline;
+            uint64_t font_generation;
+            Size size;
+            /// The byte offsets where the lines start.
+            std::vector<uint32_t> line_starts;
+            std::vector<GlyphPlacement> glyphs;
+        };
         struct Text {
             TTF_Text* self;
             std::string text;
             std::string font_name;
-            Size text_size{};
+            FontHandle font{};
             SDL_Color font_color{StdColor::Black};
+            /// It is null until the text is measured or drawn, and reset when the string or the font is changed.
+            std::shared_ptr<const TextLayout> layout{};
         };
         struct FontEngine {
+            /// The text engine of the renderer, it is shared by all fonts added with the renderer.
             TTF_TextEngine* engine;
-            TTF_TextEngine* surface_engine;
             std::shared_ptr<Font> font;
+            std::string name;
         };
         TextSystem(TextSystem &&) = delete;
         TextSystem(const TextSystem &) = delete;
@@ -375,30 +654,117 @@ namespace MyEngine {
                      float font_size = 9.f);
         bool removeFont(const std::string& font_name);
         Font* font(const std::string& font_name);
+        Font* font(FontHandle font);
+        /// Get the handle of the font, it is null if the font is not added.
+        [[nodiscard]] FontHandle fontHandle(const std::string& font_name) const;
         [[nodiscard]] bool isFontContain(const std::string& font_name) const;
         StringList fontNameList() const;
 
         bool setFontSize(const std::string& font_name, float font_size);
-        bool addText(uint64_t text_id, const std::string& font_name, const std::string& text);
-        bool removeText(uint64_t text_id);
-        bool setText(uint64_t text_id, const std::string& text);
-        bool appendText(uint64_t text_id, const std::string& text);
-        bool setTextFont(uint64_t text_id, const std::string& font_name);
-        bool setTextColor(uint64_t text_id, const SDL_Color& color);
-        Text* indexOfText(uint64_t text_id);
-        [[nodiscard]] bool isTextContain(uint64_t text_id) const;
-        [[nodiscard]] std::vector<uint64_t> textIDList() const;
-        bool drawText(uint64_t text_id, const Vector2& pos, Renderer* renderer);
+        /**
+         * \if EN
+         * @brief Create a text with the specified font
+         * @return The handle of the new text, it is null if the text can't be created.
+         * @note The handle becomes stale after `removeText()`, the functions taking it fail safely then.
+         * \endif
+         */
+        TextHandle addText(const std::string& font_name, const std::string& text);
+        bool removeText(TextHandle text);
+        bool setText(TextHandle text, const std::string& string);
+        bool appendText(TextHandle text, const std::string& string);
+        bool setTextFont(TextHandle text, const std::string& font_name);
+        bool setTextColor(TextHandle text, const SDL_Color& color);
+        Text* indexOfText(TextHandle text);
+        /// Get the text, return null if the handle is stale.
+        Text* findText(TextHandle text);
+        [[nodiscard]] bool isTextContain(TextHandle text) const;
+        [[nodiscard]] std::vector<TextHandle> textList() const;
+        bool drawText(TextHandle text, const Vector2& pos, Renderer* renderer);
+        /**
+         * \if EN
+         * @brief Get the size of the text, it is measured at the first call after the string or the font is changed
+         * @return The size of the text, it is empty if the handle is stale.
+         * \endif
+         */
+        const Size& textSize(TextHandle text);
+        /// Get the layout of the text, return null if the handle is stale or the font is removed.
+        const TextLayout* textLayout(TextHandle text);
+        /// Set the count of the cached layouts, the layouts not used recently are dropped over it.
+        void setLayoutCacheCapacity(size_t capacity);
+        [[nodiscard]] size_t layoutCacheSize() const;
         bool updateFont(const std::string& font_name);
-        SDL_Surface* toImage(uint64_t text_id);
+        SDL_Surface* toImage(TextHandle text);
+        /**
+         * \if EN
+         * @brief Bake the text into a surface on the thread pool
+         * @details The string, the color and the font settings are copied when it is called,
+         * so the text can be changed or removed meanwhile. Every worker shapes and rasterizes with its own
+         * surface text engine and its own instance of the font, opened from the shared face of `FontFaceCache`.
+         * Only uploading the surface (e.g. `Texture(surface.get(), renderer, true)`) has to be on the main thread.
+         * @return The future of the surface, the surface is null if the text can't be baked.
+         * The future is invalid if the text or the pool is not valid.
+         * \endif
+         */
+        Future<std::shared_ptr<SDL_Surface>> toImageAsync(TextHandle text, ThreadPool* pool);
+        /// Bake the string with the font into a surface on the thread pool, see `toImageAsync(TextHandle, ThreadPool*)`.
+        Future<std::shared_ptr<SDL_Surface>> toImageAsync(const std::string& font_name, const std::string& string,
+                                                          const SDL_Color& color, ThreadPool* pool);
     private:
         explicit TextSystem();
         void load();
         void unload();
+        /// The copy of the font settings and the string baked by a worker.
+        struct BakeJob {
+            std::string font_path;
+            float font_size;
+            uint32_t style, outline;
+            int hinting, direction, line_skip;
+            bool kerning;
+            SDL_Color color, outline_color;
+            std::string text;
+        };
+        /// The text engine and the fonts owned by one worker thread.
+        struct BakeContext {
+            TTF_TextEngine* engine{nullptr};
+            std::unordered_map<std::string, TTF_Font*> fonts;
+        };
+        Future<std::shared_ptr<SDL_Surface>> submitBake(const FontEngine& font, const std::string& string,
+                                                        const SDL_Color& color, ThreadPool* pool);
+        std::shared_ptr<SDL_Surface> bake(const BakeJob& job);
+        static SDL_Surface* bakeSurface(BakeContext& context, const BakeJob& job);
+        static void releaseBakeContext(BakeContext& context);
+        const TextLayout* ensureLayout(Text& text);
+        TTF_TextEngine* rendererEngine(Renderer* renderer);
         bool _is_loaded{false};
-        std::map<uint64_t, Text> _text_map;
-        std::unordered_map<std::string, FontEngine> _font_map;
+        SlotMap<Text, TextTag> _texts;
+        SlotMap<FontEngine, FontTag> _fonts;
+        std::unordered_map<std::string, FontHandle> _font_names;
+        std::unordered_map<SDL_Renderer*, TTF_TextEngine*> _renderer_engines;
+        struct LayoutKey {
+            TTF_Font* font;
+            uint32_t size_bits, style;
+            int outline;
+            size_t hash;
+            bool operator==(const LayoutKey&) const = default;
+        };
+        struct LayoutKeyHash {
+            size_t operator()(const LayoutKey& key) const noexcept;
+        };
+        struct LayoutEntry {
+            std::string text;
+            std::shared_ptr<const TextLayout> layout;
+            uint64_t last_used;
+        };
+        std::unordered_map<LayoutKey, LayoutEntry, LayoutKeyHash> _layout_cache;
+        size_t _layout_capacity{4096};
+        /// The surface text engine used by `toImage()`.
         TTF_TextEngine* _text_engine{nullptr};
+        std::mutex _bake_mutex;
+        std::condition_variable _bake_cond;
+        std::unordered_map<std::thread::id, BakeContext> _bake_contexts;
+        uint32_t _bake_running{0};
+        /// The jobs starting after unloading are skipped.
+        bool _bake_closed{false};
     };
 
     class AudioSystem : public Template::Singleton<AudioSystem> {
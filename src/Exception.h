@@ -27,6 +27,8 @@ namespace MyEngine {
     EXCEPTION(InvalidArgumentException);
 
     EXCEPTION(NullPointerException);
+
+    EXCEPTION(TaskCancelledException);
 }
 
 #endif //MYENGINE_EXCEPTION_H
@@ -1,6 +1,7 @@
 
 #include "SpriteSheet.h"
 #include "Utils/RGBAColor.h"
+#include "Utils/Clock.h"
 
 MyEngine::SpriteSheet::SpriteSheet(MyEngine::TextureAtlas *textureAtlas) : _atlas(textureAtlas) {
     _global_prop = std::make_shared<TextureProperty>();
@@ -9,19 +10,20 @@ MyEngine::SpriteSheet::SpriteSheet(MyEngine::TextureAtlas *textureAtlas) : _atla
         return;
     }
     _global_prop->resize(_atlas->property()->size());
-    _event_id = IDGenerator::getNewGlobalEventID();
-    EventSystem::global()->appendGlobalEvent(_event_id, [this] {
+    _event_handle = EventSystem::global()->appendGlobalEvent([this] {
         if (!_animate) return;
         /// If current animation name is null or not in the animation map, skipped!
         if (_cur_ani_name.empty() || !_animation_map.contains(_cur_ani_name)) return;
-        if (_start_time == 0) _start_time = SDL_GetTicks();
-        auto cur_time = SDL_GetTicks();
+        Engine::requestRedraw();
+        if (_start_time == 0) _start_time = Clock::ticks();
+        auto cur_time = Clock::ticks();
         auto& ani = _animation_map.at(_cur_ani_name);
         if (cur_time - _start_time >= ani.duration_per_frame) {
             _cur_frame += 1;
-            _start_time = SDL_GetTicks();
+            _start_time = Clock::ticks();
             if (_cur_frame >= ani.sequence_list.size()) {
                 _cur_frame = 0;
+                _finished_count += 1;
                 if (_ani_finished_event) {
                     _ani_finished_event();
                 }
@@ -38,19 +40,23 @@ MyEngine::SpriteSheet::SpriteSheet(const std::string &path, MyEngine::Renderer *
     }
     _global_prop = std::make_shared<TextureProperty>();
     _global_prop->resize(_atlas->property()->size());
-    _event_id = IDGenerator::getNewGlobalEventID();
-    EventSystem::global()->appendGlobalEvent(_event_id, [this] {
+    _event_handle = EventSystem::global()->appendGlobalEvent([this] {
         if (!_animate) return;
         /// If current animation name is null or not in the animation map, skipped!
         if (_cur_ani_name.empty() || !_animation_map.contains(_cur_ani_name)) return;
-        if (_start_time == 0) _start_time = SDL_GetTicks();
-        auto cur_time = SDL_GetTicks();
+        Engine::requestRedraw();
+        if (_start_time == 0) _start_time = Clock::ticks();
+        auto cur_time = Clock::ticks();
         auto& ani = _animation_map.at(_cur_ani_name);
         if (cur_time - _start_time >= ani.duration_per_frame) {
             _cur_frame += 1;
-            _start_time = SDL_GetTicks();
+            _start_time = Clock::ticks();
             if (_cur_frame >= ani.sequence_list.size()) {
                 _cur_frame = 0;
+                _finished_count += 1;
+                if (_ani_finished_event) {
+                    _ani_finished_event();
+                }
             }
         }
     });
@@ -60,20 +66,20 @@ MyEngine::SpriteSheet::~SpriteSheet() {
     if (_delete_later) {
         delete _atlas;
     }
-    EventSystem::global()->removeGlobalEvent(_event_id);
+    EventSystem::global()->removeGlobalEvent(_event_handle);
 }
 
 void MyEngine::SpriteSheet::move(float x, float y) {
     _global_prop->move(x, y);
-    for (auto& [name, prop] : *_atlas) {
-        prop.properties.front()->move(x, y);
+    for (auto& tiles : *_atlas) {
+        tiles.properties.front()->move(x, y);
     }
 }
 
 void MyEngine::SpriteSheet::move(const MyEngine::Vector2 &pos) {
     _global_prop->move(pos);
-    for (auto& [name, prop] : *_atlas) {
-        prop.properties.front()->move(pos);
+    for (auto& tiles : *_atlas) {
+        tiles.properties.front()->move(pos);
     }
 }
 
@@ -83,15 +89,15 @@ const MyEngine::Vector2 &MyEngine::SpriteSheet::position() const {
 
 void MyEngine::SpriteSheet::resize(float w, float h) {
     _global_prop->resize(w, h);
-    for (auto& [name, prop] : *_atlas) {
-        prop.properties.front()->resize(w, h);
+    for (auto& tiles : *_atlas) {
+        tiles.properties.front()->resize(w, h);
     }
 }
 
 void MyEngine::SpriteSheet::resize(const MyEngine::Size &size) {
     _global_prop->resize(size);
-    for (auto& [name, prop] : *_atlas) {
-        prop.properties.front()->resize(size);
+    for (auto& tiles : *_atlas) {
+        tiles.properties.front()->resize(size);
     }
 }
 
@@ -101,8 +107,8 @@ const MyEngine::Size &MyEngine::SpriteSheet::size() const {
 
 void MyEngine::SpriteSheet::setScale(float scale) {
     _global_prop->setScale(scale);
-    for (auto& [name, prop] : *_atlas) {
-        prop.properties.front()->setScale(scale);
+    for (auto& tiles : *_atlas) {
+        tiles.properties.front()->setScale(scale);
     }
 }
 
@@ -112,23 +118,23 @@ float MyEngine::SpriteSheet::scale() const {
 
 void MyEngine::SpriteSheet::setColorAlpha(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
     _global_prop->color_alpha = { .r = r, .g = g, .b = b, .a = a };
-    for (auto& [name, prop] : *_atlas) {
-        prop.properties.front()->color_alpha = { .r = r, .g = g, .b = b, .a = a };
+    for (auto& tiles : *_atlas) {
+        tiles.properties.front()->color_alpha = { .r = r, .g = g, .b = b, .a = a };
     }
 }
 
 void MyEngine::SpriteSheet::setColorAlpha(uint64_t hex_code) {
     auto [r, g, b, a] = RGBAColor::hexCode2RGBA(hex_code, true);
     _global_prop->color_alpha = { .r = r, .g = g, .b = b, .a = a };
-    for (auto& [name, prop] : *_atlas) {
-        prop.properties.front()->color_alpha = { .r = r, .g = g, .b = b, .a = a };
+    for (auto& tiles : *_atlas) {
+        tiles.properties.front()->color_alpha = { .r = r, .g = g, .b = b, .a = a };
     }
 }
 
 void MyEngine::SpriteSheet::setColorAlpha(const SDL_Color &color) {
     _global_prop->color_alpha = color;
-    for (auto& [name, prop] : *_atlas) {
-        prop.properties.front()->color_alpha = color;
+    for (auto& tiles : *_atlas) {
+        tiles.properties.front()->color_alpha = color;
     }
 }
 
@@ -182,6 +188,13 @@ void MyEngine::SpriteSheet::setTextureAtlas(MyEngine::TextureAtlas *textureAtlas
     if (!_atlas) {
         Logger::log("SpriteSheet: You have set 'nullptr' to current texture atlas! "
                     "It will be thrown error while drawing.",Logger::Warn);
+        return;
+    }
+    /// The handles only belong to the old texture atlas.
+    for (auto& [name, animation] : _animation_map) {
+        for (size_t i = 0; i < animation.sequence_list.size(); ++i) {
+            animation.tiles_list[i] = _atlas->tilesHandle(animation.sequence_list[i]);
+        }
     }
 }
 
@@ -196,14 +209,18 @@ bool MyEngine::SpriteSheet::appendAnimation(const std::string &name, const Strin
                     Logger::Error);
         return false;
     }
+    std::vector<TextureHandle> tiles_list;
+    tiles_list.reserve(sequence_list.size());
     for (auto& sequence : sequence_list) {
-        if (!_atlas->isTilesNameExist(sequence)) {
+        auto tiles = _atlas->tilesHandle(sequence);
+        if (!tiles) {
             Logger::log(FMT::format("SpriteSheet: The tiles named {} is not in current texture atlas!",
                                     sequence), Logger::Error);
             return false;
         }
+        tiles_list.push_back(tiles);
     }
-    _animation_map.emplace(name, FrameAnimation(sequence_list, duration_per_frame));
+    _animation_map.emplace(name, FrameAnimation(sequence_list, duration_per_frame, std::move(tiles_list)));
     return true;
 }
 
@@ -285,14 +302,19 @@ void MyEngine::SpriteSheet::draw() {
                                 _cur_ani_name), Logger::Fatal);
         Engine::throwFatalError();
     }
-    auto& frame_name = _animation_map.at(_cur_ani_name).sequence_list[_cur_frame];
-    if (!_atlas->isTilesNameExist(frame_name)) {
-        Logger::log(FMT::format("SpriteSheet: Renderer failed! "
-                                "The animation named '{}' of frame '{}' is not valid! ",
-                                _cur_ani_name, frame_name), Logger::Fatal);
-        Engine::throwFatalError();
+    auto& animation = _animation_map.at(_cur_ani_name);
+    auto& tiles = animation.tiles_list[_cur_frame];
+    if (!_atlas->isTilesHandleValid(tiles)) {
+        /// The tiles may be erased and added again.
+        tiles = _atlas->tilesHandle(animation.sequence_list[_cur_frame]);
+        if (!tiles) {
+            Logger::log(FMT::format("SpriteSheet: Renderer failed! "
+                                    "The animation named '{}' of frame '{}' is not valid! ",
+                                    _cur_ani_name, animation.sequence_list[_cur_frame]), Logger::Fatal);
+            Engine::throwFatalError();
+        }
     }
-    _atlas->draw(frame_name);
+    _atlas->draw(tiles);
 }
 
 void MyEngine::SpriteSheet::setAnimateEnabled(bool animate) {
@@ -308,3 +330,7 @@ void MyEngine::SpriteSheet::setAnimationFinishedEvent(const std::function<void()
     _ani_finished_event = event;
 }
 
+uint64_t MyEngine::SpriteSheet::animationFinishedCount() const {
+    return _finished_count;
+}
+
@@ -8,6 +8,8 @@ namespace MyEngine {
         struct FrameAnimation {
             StringList sequence_list;
             uint64_t duration_per_frame;
+            /// The handles of the tiles in `sequence_list`, so drawing doesn't look up the names.
+            std::vector<TextureHandle> tiles_list{};
         };
     public:
         explicit SpriteSheet(TextureAtlas* textureAtlas);
@@ -58,13 +60,17 @@ namespace MyEngine {
         void setAnimateEnabled(bool animate);
         [[nodiscard]] bool animateEnabled() const;
         void setAnimationFinishedEvent(const std::function<void()>& event);
+        /// The number of times the animations have played to the last frame.
+        [[nodiscard]] uint64_t animationFinishedCount() const;
 
     private:
         TextureAtlas* _atlas{nullptr};
         std::unordered_map<std::string, FrameAnimation> _animation_map;
         std::string _cur_ani_name;
-        uint64_t _start_time{0}, _event_id{0};
+        uint64_t _start_time{0};
+        GlobalEventHandle _event_handle{};
         uint64_t _cur_frame{0};
+        uint64_t _finished_count{0};
         std::shared_ptr<TextureProperty> _global_prop;
         bool _delete_later{false};
         bool _animate{false}, _visible{true};
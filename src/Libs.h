@@ -11,6 +11,7 @@
 #include <format>
 #include <string>
 #include <variant>
+#include <optional>
 #include <vector>
 #include <array>
 #include <deque>
@@ -18,6 +19,9 @@
 #include <queue>
 #include <stack>
 #include <memory>
+#include <memory_resource>
+#include <span>
+#include <cstring>
 #include <functional>
 #include <map>
 #include <unordered_map>
@@ -30,6 +34,8 @@
 #include <future>
 #include <condition_variable>
 #include <atomic>
+#include <bit>
+#include <new>
 #include <filesystem>
 #include <cstdint>
 #include <csignal>
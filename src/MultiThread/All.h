@@ -2,6 +2,12 @@
 #ifndef MYENGINE_MULTITHREAD_H
 #define MYENGINE_MULTITHREAD_H
 #include "Components.h"
+#include "TimerScheduler.h"
+#include "TaskFunction.h"
+#include "WorkStealingDeque.h"
+#include "Future.h"
+#include "JobGraph.h"
+#include "Coroutine.h"
 #include "ThreadPool.h"
 #include "Queue.h"
 #endif //MYENGINE_MULTITHREAD_H
\ No newline at end of file
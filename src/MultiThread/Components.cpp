@@ -7,7 +7,6 @@
 namespace MyEngine {
     Timer::~Timer() {
         stop();
-        if (_thread.joinable()) { _thread.join(); }
     }
 
     Timer::Timer(uint64_t delay, const std::function<void()>& event)
@@ -18,6 +17,11 @@ namespace MyEngine {
 
     void Timer::setDelay(uint64_t delay) {
         _delay = delay;
+        if (!_enabled) return;
+        /// Reschedule the rest of calls with the new delay.
+        TimerScheduler::global()->cancel(_handle.load());
+        _handle = TimerScheduler::global()->schedule(_delay * 1000000, _delay * 1000000, _run_count,
+                                                     [this] { triggered(); }, _dispatch);
     }
 
     void Timer::start(uint32_t count) {
@@ -29,16 +33,17 @@ namespace MyEngine {
         _enabled = true;
         _run_count = count;
         _finish_count = 0;
-        _current_time = SDL_GetTicks();
-        if (_thread.joinable()) { _thread.join(); }
-        _thread = std::thread(&Timer::running, this);
+        _handle = TimerScheduler::global()->schedule(_delay * 1000000, _delay * 1000000, count,
+                                                     [this] { triggered(); }, _dispatch);
         Logger::log(FMT::format("The timer ID {} is started!", _timer_id));
     }
 
     void Timer::stop() {
+        /// The last call disables the timer while it may still be queued or running, so always cancel it.
+        TimerScheduler::global()->cancel(_handle.load());
         if (!_enabled) return;
         _enabled = false;
-        Logger::log(FMT::format("Preparing to stop the timer ID {}!", _timer_id));
+        Logger::log(FMT::format("The timer ID {} is stopped!", _timer_id));
     }
 
     bool Timer::enabled() const {
@@ -53,6 +58,10 @@ namespace MyEngine {
         _function = event;
     }
 
+    void Timer::setDispatch(TimerScheduler::Dispatch dispatch) {
+        _dispatch = dispatch;
+    }
+
     bool Timer::isFinished() const {
         return _run_count == 0;
     }
@@ -61,28 +70,14 @@ namespace MyEngine {
         return _finish_count;
     }
 
-    void Timer::running() {
-        while (_enabled) {
-            _lock.lock();
-            delayMS(1);
-            _current_time = SDL_GetTicks();
-            auto current_delay = _current_time - _start_time;
-            if (current_delay >= _delay) {
-                if (_function) {
-                    _function();
-                    _run_count -= 1;
-                    _finish_count += 1;
-                    Logger::log(FMT::format("Triggered the timer event by ID {}! Elapsed triggered count: {}",
-                                            _timer_id, _run_count));
-                    if (!_run_count) {
-                        _enabled = false;
-                    }
-                    _start_time = SDL_GetTicks();
-                }
-            }
-            _lock.unlock();
+    void Timer::triggered() {
+        if (!_enabled || !_function) return;
+        _function();
+        _finish_count += 1;
+        /// The scheduler releases the entry by itself after the last call.
+        if (_run_count.fetch_sub(1) == 1) {
+            _enabled = false;
         }
-        Logger::log(FMT::format("The timer ID {} is stopped running!", _timer_id));
     }
 
     Trigger::Trigger(const std::function<bool()>& condition, const std::function<void()>& event)
@@ -93,9 +88,6 @@ namespace MyEngine {
 
     Trigger::~Trigger() {
         stop();
-        if (_thread.joinable()) {
-            _thread.join();
-        }
     }
 
     void Trigger::setCondition(const std::function<bool()>& condition) {
@@ -106,6 +98,14 @@ namespace MyEngine {
         _function = event;
     }
 
+    void Trigger::setPollInterval(uint64_t interval) {
+        _poll_interval = interval;
+    }
+
+    void Trigger::setDispatch(TimerScheduler::Dispatch dispatch) {
+        _dispatch = dispatch;
+    }
+
     void Trigger::start(uint32_t count) {
         if (_enabled) {
             Logger::log(FMT::format("Trigger ID {} is already started! "
@@ -115,14 +115,15 @@ namespace MyEngine {
         _enabled = true;
         _run_count = count;
         _finish_count = 0;
-        if (_thread.joinable()) _thread.join();
-        _thread = std::thread(&Trigger::running, this);
+        _handle = TimerScheduler::global()->schedule(_poll_interval * 1000000, _poll_interval * 1000000, 0,
+                                                     [this] { poll(); }, _dispatch);
         Logger::log(FMT::format("Trigger ID {} is started!", _trigger_id));
     }
 
     void Trigger::stop() {
         _enabled = false;
-        Logger::log(FMT::format("Trigger ID {} is preparing to stop the trigger!", _trigger_id));
+        TimerScheduler::global()->cancel(_handle.load());
+        Logger::log(FMT::format("Trigger ID {} is stopped!", _trigger_id));
     }
 
     bool Trigger::enabled() const {
@@ -137,27 +138,14 @@ namespace MyEngine {
         return _finish_count;
     }
 
-    void Trigger::running() {
-        while (_enabled) {
-            _mutex.lock();
-            delayMS(1);
-            bool c_switch = false;
-            if (_condition_function) {
-                c_switch = _condition_function();
-            }
-            if (c_switch && _function) {
-                _function();
-                _run_count -= 1;
-                _finish_count += 1;
-                if (!_run_count) {
-                    _enabled = false;
-                }
-                Logger::log(FMT::format("Triggered the trigger event by ID {}, Elapsed count: {}",
-                                        _trigger_id, _run_count));
-            }
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
-            _mutex.unlock();
+    void Trigger::poll() {
+        if (!_enabled || !_condition_function || !_function) return;
+        if (!_condition_function()) return;
+        _function();
+        _finish_count += 1;
+        if (_run_count.fetch_sub(1) == 1) {
+            _enabled = false;
+            TimerScheduler::global()->cancel(_handle.load());
         }
-        Logger::log(FMT::format("Trigger ID {} is stopped!", _trigger_id));
     }
-}
\ No newline at end of file
+}
@@ -2,6 +2,7 @@
 #ifndef MYENGINE_MULTITHREAD_COMPONENTS_H
 #define MYENGINE_MULTITHREAD_COMPONENTS_H
 #include "../Libs.h"
+#include "TimerScheduler.h"
 namespace MyEngine {
     class Timer {
     public:
@@ -18,19 +19,18 @@ namespace MyEngine {
         bool enabled() const;
         uint64_t delay() const;
         void setEvent(const std::function<void()>& event);
+        void setDispatch(TimerScheduler::Dispatch dispatch);
         bool isFinished() const;
         uint32_t triggeredCount() const;
     private:
-        void running();
-        uint32_t _delay;
+        void triggered();
+        uint64_t _delay;
         std::atomic<bool> _enabled;
         std::function<void()> _function;
-        std::thread _thread;
-        std::mutex _lock;
-        uint32_t _run_count{0};
-        uint32_t _finish_count{0};
-        uint64_t _start_time{0};
-        uint64_t _current_time{0};
+        std::atomic<TimerScheduler::Handle> _handle{};
+        TimerScheduler::Dispatch _dispatch{TimerScheduler::SchedulerThread};
+        std::atomic<uint32_t> _run_count{0};
+        std::atomic<uint32_t> _finish_count{0};
         uint64_t _timer_id{0};
     };
 
@@ -47,6 +47,8 @@ namespace MyEngine {
 
         void setCondition(const std::function<bool()>& condition);
         void setEvent(const std::function<void()>& event);
+        void setPollInterval(uint64_t interval);
+        void setDispatch(TimerScheduler::Dispatch dispatch);
 
         void start(uint32_t count = 1);
         void stop();
@@ -54,14 +56,15 @@ namespace MyEngine {
         bool isTriggered() const;
         uint64_t triggeredCount() const;
     private:
-        void running();
+        void poll();
         std::atomic<bool> _enabled;
         std::function<bool()> _condition_function;
         std::function<void()> _function;
-        std::thread _thread;
-        std::mutex _mutex;
-        uint32_t _run_count{0};
-        uint32_t _finish_count{0};
+        std::atomic<TimerScheduler::Handle> _handle{};
+        TimerScheduler::Dispatch _dispatch{TimerScheduler::SchedulerThread};
+        uint64_t _poll_interval{50};
+        std::atomic<uint32_t> _run_count{0};
+        std::atomic<uint32_t> _finish_count{0};
         uint64_t _trigger_id{0};
     };
 }
@@ -0,0 +1,233 @@
+
+#include "Coroutine.h"
+#include "Core.h"
+#include "Components.h"
+#include "Game/SpriteSheet.h"
+#include "Utils/Clock.h"
+#include "Utils/Logger.h"
+
+namespace MyEngine {
+    void Coroutine::promise_type::unhandled_exception() {
+        try {
+            std::rethrow_exception(std::current_exception());
+        } catch (const std::exception& e) {
+            Logger::log(Logger::Error, "Coroutine: Coroutine ID {} is terminated! Exception: {}", id, e.what());
+        } catch (...) {
+            Logger::log(Logger::Error, "Coroutine: Coroutine ID {} is terminated by an unknown exception!", id);
+        }
+    }
+
+    void Coroutine::NextFrame::await_suspend(Handle handle) const {
+        CoroutineScheduler::global()->waitNextFrame(handle.promise().id);
+    }
+
+    void Coroutine::Delay::await_suspend(Handle handle) const {
+        CoroutineScheduler::global()->waitUntil(handle.promise().id, Clock::ticks() + ms);
+    }
+
+    void Coroutine::Until::await_suspend(Handle handle) {
+        CoroutineScheduler::global()->waitCondition(handle.promise().id, std::move(condition));
+    }
+
+    Coroutine::LoadTexture::LoadTexture(LoadTexture &&other) noexcept
+        : future(std::move(other.future)), renderer(other.renderer), consumed(other.consumed) {
+        other.consumed = true;
+    }
+
+    Coroutine::LoadTexture::~LoadTexture() {
+        if (consumed || !future.isValid()) return;
+        /// The coroutine is cancelled before the texture is created, release the surface after it is loaded.
+        future.onFinished([f = future] {
+            if (!f.isFailed() && f.get()) SDL_DestroySurface(f.get());
+        });
+    }
+
+    void Coroutine::LoadTexture::await_suspend(Handle handle) const {
+        future.onFinished([id = handle.promise().id] { CoroutineScheduler::global()->post(id); });
+    }
+
+    std::unique_ptr<Texture> Coroutine::LoadTexture::await_resume() {
+        consumed = true;
+        SDL_Surface* surface = nullptr;
+        try {
+            surface = future.get();
+        } catch (const std::exception& e) {
+            Logger::log(Logger::Error, "Coroutine: Load texture failed! Exception: {}", e.what());
+        }
+        if (!surface) return nullptr;
+        return std::make_unique<Texture>(surface, renderer);
+    }
+
+    Coroutine &Coroutine::operator=(Coroutine &&other) noexcept {
+        if (this != &other) {
+            if (_handle) _handle.destroy();
+            _handle = std::exchange(other._handle, nullptr);
+        }
+        return *this;
+    }
+
+    Coroutine::~Coroutine() {
+        if (_handle) _handle.destroy();
+    }
+
+    Coroutine::LoadTexture Coroutine::loadTexture(const std::string &path, Renderer *renderer) {
+        auto future = CoroutineScheduler::global()->workerPool()->submit([path]() -> SDL_Surface* {
+            auto surface = IMG_Load(path.c_str());
+            if (!surface) {
+                Logger::log(FMT::format("Coroutine: Load image '{}' failed! Exception: {}", path, SDL_GetError()),
+                            Logger::Error);
+            }
+            return surface;
+        });
+        return {std::move(future), renderer};
+    }
+
+    Coroutine::Until Coroutine::animationFinished(SpriteSheet *sprite_sheet) {
+        auto count = sprite_sheet->animationFinishedCount();
+        return {[sprite_sheet, count] { return sprite_sheet->animationFinishedCount() != count; }};
+    }
+
+    Coroutine::Until Coroutine::bgmFinished(BGM *bgm) {
+        return {[bgm] {
+            auto status = bgm->playStatus();
+            return status == BGM::Loaded || status == BGM::Invalid;
+        }};
+    }
+
+    CoroutineScheduler::~CoroutineScheduler() {
+        clear();
+    }
+
+    CoroutineScheduler::ID CoroutineScheduler::start(Coroutine coroutine) {
+        auto handle = std::exchange(coroutine._handle, nullptr);
+        if (!handle) {
+            Logger::log("CoroutineScheduler: The coroutine is not valid!", Logger::Warn);
+            return 0;
+        }
+        auto id = _next_id++;
+        handle.promise().id = id;
+        _coroutines.emplace(id, handle);
+        resume(id);
+        return id;
+    }
+
+    bool CoroutineScheduler::cancel(ID id) {
+        auto it = _coroutines.find(id);
+        if (it == _coroutines.end()) return false;
+        if (id == _current) {
+            /// It is cancelled by itself, destroy it after it is suspended.
+            _cancel_current = true;
+            return true;
+        }
+        it->second.destroy();
+        _coroutines.erase(it);
+        return true;
+    }
+
+    bool CoroutineScheduler::isRunning(ID id) const {
+        return _coroutines.contains(id);
+    }
+
+    size_t CoroutineScheduler::count() const {
+        return _coroutines.size();
+    }
+
+    void CoroutineScheduler::clear() {
+        for (auto& [id, handle] : _coroutines) handle.destroy();
+        _coroutines.clear();
+        _next_frame.clear();
+        _polling.clear();
+        _sleeping = {};
+        std::lock_guard<std::mutex> lock(_posted_mutex);
+        _posted.clear();
+        _has_posted = false;
+    }
+
+    void CoroutineScheduler::setWorkerPool(ThreadPool *pool) {
+        _pool = pool;
+    }
+
+    ThreadPool *CoroutineScheduler::workerPool() {
+        if (_pool) return _pool;
+        if (!_own_pool) {
+            _own_pool = std::make_unique<ThreadPool>(256, std::min(2u, std::max(std::thread::hardware_concurrency(), 1u)));
+        }
+        return _own_pool.get();
+    }
+
+    void CoroutineScheduler::update() {
+        if (_coroutines.empty()) return;
+        /// The coroutines suspended while resuming wait for the next update.
+        _resuming.swap(_next_frame);
+        auto now = Clock::ticks();
+        while (!_sleeping.empty() && _sleeping.top().time <= now) {
+            _resuming.push_back(_sleeping.top().id);
+            _sleeping.pop();
+        }
+        if (!_polling.empty()) {
+            auto polling = std::move(_polling);
+            _polling.clear();
+            for (auto& item : polling) {
+                if (!_coroutines.contains(item.id)) continue;
+                if (item.condition()) {
+                    _resuming.push_back(item.id);
+                } else {
+                    _polling.emplace_back(std::move(item));
+                }
+            }
+        }
+        if (_has_posted.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(_posted_mutex);
+            _resuming.insert(_resuming.end(), _posted.begin(), _posted.end());
+            _posted.clear();
+            _has_posted.store(false, std::memory_order_release);
+        }
+        for (auto id : _resuming) resume(id);
+        _resuming.clear();
+    }
+
+    bool CoroutineScheduler::hasPendingFrame() const {
+        return !_next_frame.empty() || !_polling.empty() || _has_posted.load();
+    }
+
+    uint64_t CoroutineScheduler::nextWakeTime() const {
+        return _sleeping.empty() ? UINT64_MAX : _sleeping.top().time;
+    }
+
+    void CoroutineScheduler::resume(ID id) {
+        auto it = _coroutines.find(id);
+        if (it == _coroutines.end()) return;
+        auto handle = it->second;
+        auto prev = std::exchange(_current, id);
+        auto prev_cancel = std::exchange(_cancel_current, false);
+        handle.resume();
+        if (handle.done() || _cancel_current) {
+            handle.destroy();
+            _coroutines.erase(id);
+        }
+        _current = prev;
+        _cancel_current = prev_cancel;
+    }
+
+    void CoroutineScheduler::waitNextFrame(ID id) {
+        _next_frame.push_back(id);
+    }
+
+    void CoroutineScheduler::waitUntil(ID id, uint64_t time_ms) {
+        _sleeping.push({time_ms, id});
+    }
+
+    void CoroutineScheduler::waitCondition(ID id, std::function<bool()> condition) {
+        _polling.emplace_back(id, std::move(condition));
+    }
+
+    void CoroutineScheduler::post(ID id) {
+        {
+            std::lock_guard<std::mutex> lock(_posted_mutex);
+            _posted.push_back(id);
+            _has_posted.store(true);
+        }
+        /// The main loop may sleep in the redraw-on-demand mode.
+        Engine::wakeUp();
+    }
+}
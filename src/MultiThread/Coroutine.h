@@ -0,0 +1,197 @@
+#pragma once
+#ifndef MYENGINE_MULTITHREAD_COROUTINE_H
+#define MYENGINE_MULTITHREAD_COROUTINE_H
+#include "../Libs.h"
+#include "../Template/Singleton.h"
+#include "ThreadPool.h"
+#include <coroutine>
+
+namespace MyEngine {
+    class Renderer;
+    class Texture;
+    class SpriteSheet;
+    class BGM;
+
+    /**
+     * \if EN
+     * @class MyEngine::Coroutine
+     * @brief Coroutine resumed by the main loop of the engine
+     * @details A function returning `Coroutine` can use `co_await` with the awaitables below,
+     * it is started by `CoroutineScheduler::start()` and always resumed on the main thread.
+     * A suspended coroutine doesn't take any thread, it only keeps its frame in the memory.
+     * @code
+     * Coroutine blink(Sprite* sprite) {
+     *     while (true) {
+     *         sprite->setVisible(!sprite->visible());
+     *         co_await Coroutine::delay(500);
+     *     }
+     * }
+     * CoroutineScheduler::global()->start(blink(sprite));
+     * @endcode
+     * \endif
+     */
+    class Coroutine {
+    public:
+        struct promise_type {
+            uint64_t id{0};
+            Coroutine get_return_object() { return Coroutine(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception();
+        };
+        using Handle = std::coroutine_handle<promise_type>;
+
+        struct NextFrame {
+            [[nodiscard]] bool await_ready() const noexcept { return false; }
+            void await_suspend(Handle handle) const;
+            void await_resume() const noexcept {}
+        };
+
+        struct Delay {
+            uint64_t ms;
+            [[nodiscard]] bool await_ready() const noexcept { return ms == 0; }
+            void await_suspend(Handle handle) const;
+            void await_resume() const noexcept {}
+        };
+
+        /// Wait until the condition is true, it is checked once in every frame.
+        struct Until {
+            std::function<bool()> condition;
+            [[nodiscard]] bool await_ready() const { return condition(); }
+            void await_suspend(Handle handle);
+            void await_resume() const noexcept {}
+        };
+
+        template<typename T>
+        struct Wait {
+            Future<T> future;
+            [[nodiscard]] bool await_ready() const { return future.isReady(); }
+            void await_suspend(Handle handle) const;
+            decltype(auto) await_resume() const { return future.get(); }
+        };
+
+        struct LoadTexture {
+            LoadTexture(Future<SDL_Surface*> f, Renderer* r) : future(std::move(f)), renderer(r) {}
+            LoadTexture(LoadTexture&& other) noexcept;
+            LoadTexture(const LoadTexture&) = delete;
+            LoadTexture& operator=(const LoadTexture&) = delete;
+            LoadTexture& operator=(LoadTexture&&) = delete;
+            ~LoadTexture();
+            [[nodiscard]] bool await_ready() const { return future.isReady(); }
+            void await_suspend(Handle handle) const;
+            std::unique_ptr<Texture> await_resume();
+            Future<SDL_Surface*> future;
+            Renderer* renderer;
+            bool consumed{false};
+        };
+
+        Coroutine(Coroutine&& other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+        Coroutine& operator=(Coroutine&& other) noexcept;
+        Coroutine(const Coroutine&) = delete;
+        Coroutine& operator=(const Coroutine&) = delete;
+        ~Coroutine();
+
+        /// Resume at the next frame.
+        static NextFrame nextFrame() { return {}; }
+        /// Resume after `ms` milliseconds of the engine clock (see `Clock`).
+        static Delay delay(uint64_t ms) { return {ms}; }
+        static Until until(std::function<bool()> condition) { return {std::move(condition)}; }
+        /// Resume after the future is finished, `co_await` returns the result or rethrows the exception.
+        template<typename T>
+        static Wait<T> wait(Future<T> future) { return {std::move(future)}; }
+        /**
+         * \if EN
+         * @brief Load the image off the main thread, then create the texture on the main thread
+         * @details `co_await` returns `std::unique_ptr<Texture>`, it is null if the image can't be loaded.
+         * \endif
+         */
+        static LoadTexture loadTexture(const std::string& path, Renderer* renderer);
+        /// Resume after the current animation of `sprite_sheet` plays to the last frame.
+        static Until animationFinished(SpriteSheet* sprite_sheet);
+        /// Resume after `bgm` stops playing.
+        static Until bgmFinished(BGM* bgm);
+
+    private:
+        friend class CoroutineScheduler;
+        explicit Coroutine(Handle handle) : _handle(handle) {}
+        Handle _handle;
+    };
+
+    /**
+     * \if EN
+     * @class MyEngine::CoroutineScheduler
+     * @brief Run and resume the coroutines on the main thread
+     * @details `update()` is called by the engine once in every frame.
+     * \endif
+     */
+    class CoroutineScheduler : public Template::Singleton<CoroutineScheduler> {
+        friend class Template::Singleton<CoroutineScheduler>;
+        friend class Coroutine;
+    public:
+        using ID = uint64_t;
+        CoroutineScheduler(CoroutineScheduler &&) = delete;
+        CoroutineScheduler(const CoroutineScheduler &) = delete;
+        CoroutineScheduler &operator=(CoroutineScheduler &&) = delete;
+        CoroutineScheduler &operator=(const CoroutineScheduler &) = delete;
+        ~CoroutineScheduler() override;
+
+        /// Start the coroutine, it runs until the first `co_await` immediately.
+        ID start(Coroutine coroutine);
+        /// Destroy the suspended coroutine, the local variables of it are destroyed.
+        bool cancel(ID id);
+        [[nodiscard]] bool isRunning(ID id) const;
+        [[nodiscard]] size_t count() const;
+        /// Destroy all coroutines.
+        void clear();
+
+        /// Set the thread pool used by `Coroutine::loadTexture()`, a small pool is created if it is not set.
+        void setWorkerPool(ThreadPool* pool);
+        [[nodiscard]] ThreadPool* workerPool();
+
+        /// Resume the coroutines which are ready, it is called by the engine in every frame.
+        void update();
+        /// Check whether some coroutines wait for the next frame, a condition or a finished task.
+        [[nodiscard]] bool hasPendingFrame() const;
+        /// Get the earliest wake-up time of the delayed coroutines, `UINT64_MAX` if there is none.
+        [[nodiscard]] uint64_t nextWakeTime() const;
+
+    private:
+        explicit CoroutineScheduler() = default;
+        void resume(ID id);
+        void waitNextFrame(ID id);
+        void waitUntil(ID id, uint64_t time_ms);
+        void waitCondition(ID id, std::function<bool()> condition);
+        /// Thread-safe, resume the coroutine at the next update.
+        void post(ID id);
+
+        struct Sleeping {
+            uint64_t time;
+            ID id;
+            bool operator>(const Sleeping& other) const { return time > other.time; }
+        };
+        struct Polling {
+            ID id;
+            std::function<bool()> condition;
+        };
+
+        std::unordered_map<ID, Coroutine::Handle> _coroutines;
+        ID _next_id{1}, _current{0};
+        bool _cancel_current{false};
+        std::vector<ID> _next_frame, _resuming;
+        std::priority_queue<Sleeping, std::vector<Sleeping>, std::greater<>> _sleeping;
+        std::vector<Polling> _polling;
+        std::mutex _posted_mutex;
+        std::vector<ID> _posted;
+        std::atomic<bool> _has_posted{false};
+        ThreadPool* _pool{nullptr};
+        std::unique_ptr<ThreadPool> _own_pool;
+    };
+
+    template<typename T>
+    void Coroutine::Wait<T>::await_suspend(Handle handle) const {
+        future.onFinished([id = handle.promise().id] { CoroutineScheduler::global()->post(id); });
+    }
+}
+
+#endif //MYENGINE_MULTITHREAD_COROUTINE_H
@@ -0,0 +1,279 @@
+#pragma once
+#ifndef MYENGINE_MULTITHREAD_FUTURE_H
+#define MYENGINE_MULTITHREAD_FUTURE_H
+#include "../Libs.h"
+#include "../Exception.h"
+#include "TaskFunction.h"
+
+namespace MyEngine {
+    /**
+     * \if EN
+     * @class MyEngine::CancellationToken
+     * @brief Cooperative cancellation flag shared by copies
+     * @details A task which is cancelled before it starts is not called, its future fails with `TaskCancelledException`.
+     * A running task can check `isCancelled()` or call `throwIfCancelled()` to stop by itself.
+     * \endif
+     */
+    class CancellationToken {
+    public:
+        CancellationToken() : _cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+
+        void cancel() const { _cancelled->store(true, std::memory_order_release); }
+        [[nodiscard]] bool isCancelled() const { return _cancelled->load(std::memory_order_acquire); }
+        void throwIfCancelled() const {
+            if (isCancelled()) throw TaskCancelledException("CancellationToken: The task is cancelled!");
+        }
+
+    private:
+        std::shared_ptr<std::atomic<bool>> _cancelled;
+    };
+
+    template<typename T>
+    class Promise;
+
+    /**
+     * \if EN
+     * @class MyEngine::Future
+     * @brief Lightweight shared future with continuations
+     * @details Copies of the future share the same result, `get()` returns a reference to the stored value.
+     * @details The continuations added by `then()` and `onFinished()` are called on the thread which finishes the future,
+     * or immediately on the caller thread if the future is already finished.
+     * \endif
+     */
+    template<typename T>
+    class Future {
+        friend class Promise<T>;
+        template<typename>
+        friend class Future;
+    public:
+        using Value = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+        Future() = default;
+
+        [[nodiscard]] bool isValid() const { return _state != nullptr; }
+        [[nodiscard]] bool isReady() const { return _state && _state->ready.load(std::memory_order_acquire); }
+        [[nodiscard]] bool isFailed() const { return isReady() && _state->exception; }
+
+        void wait() const {
+            std::unique_lock<std::mutex> lock(_state->mutex);
+            _state->cond.wait(lock, [this] { return _state->ready.load(std::memory_order_acquire); });
+        }
+
+        template<typename Rep, typename Period>
+        bool waitFor(const std::chrono::duration<Rep, Period>& timeout) const {
+            std::unique_lock<std::mutex> lock(_state->mutex);
+            return _state->cond.wait_for(lock, timeout,
+                                         [this] { return _state->ready.load(std::memory_order_acquire); });
+        }
+
+        /// Wait for the result, the exception thrown by the task is rethrown here.
+        decltype(auto) get() const {
+            wait();
+            if (_state->exception) std::rethrow_exception(_state->exception);
+            if constexpr (!std::is_void_v<T>) {
+                return static_cast<const T&>(*_state->value);
+            }
+        }
+
+        /**
+         * \if EN
+         * @brief Call `callback` after the future is finished, no matter it succeeded or failed
+         * \endif
+         */
+        template<typename F>
+        void onFinished(F&& callback) const {
+            {
+                std::lock_guard<std::mutex> lock(_state->mutex);
+                if (!_state->ready.load(std::memory_order_relaxed)) {
+                    _state->continuations.emplace_back(std::forward<F>(callback));
+                    return;
+                }
+            }
+            callback();
+        }
+
+        /**
+         * \if EN
+         * @brief Call `func` with the result and return the future of its result
+         * @details `func` is called as `func(const T&)` (or `func()` for `Future<void>`).
+         * If this future failed, `func` is not called and the exception is passed to the returned future.
+         * \endif
+         */
+        template<typename F>
+        auto then(F&& func) const {
+            using Fn = std::decay_t<F>;
+            using R = typename decltype(continuationResult<Fn>())::type;
+            Promise<R> promise;
+            auto future = promise.future();
+            onFinished([state = _state, promise = std::move(promise), func = Fn(std::forward<F>(func))]() mutable {
+                if (state->exception) {
+                    promise.setException(state->exception);
+                    return;
+                }
+                promise.run([&]() -> R {
+                    if constexpr (std::is_void_v<T>) {
+                        return func();
+                    } else {
+                        return func(static_cast<const T&>(*state->value));
+                    }
+                });
+            });
+            return future;
+        }
+
+    private:
+        struct State {
+            std::mutex mutex;
+            std::condition_variable cond;
+            std::atomic<bool> ready{false};
+            std::optional<Value> value;
+            std::exception_ptr exception;
+            std::vector<TaskFunction> continuations;
+        };
+
+        explicit Future(std::shared_ptr<State> state) : _state(std::move(state)) {}
+
+        template<typename Fn>
+        static auto continuationResult() {
+            if constexpr (std::is_void_v<T>) {
+                return std::type_identity<std::invoke_result_t<Fn&>>{};
+            } else {
+                return std::type_identity<std::invoke_result_t<Fn&, const T&>>{};
+            }
+        }
+
+        std::shared_ptr<State> _state;
+    };
+
+    /**
+     * \if EN
+     * @class MyEngine::Promise
+     * @brief The writing side of `Future`
+     * @details If the promise is destroyed before it is finished (e.g. the task is removed from the queue),
+     * the future fails with `TaskCancelledException`.
+     * \endif
+     */
+    template<typename T>
+    class Promise {
+    public:
+        Promise() : _state(std::make_shared<typename Future<T>::State>()) {}
+        Promise(Promise&&) noexcept = default;
+        Promise& operator=(Promise&&) noexcept = default;
+        Promise(const Promise&) = delete;
+        Promise& operator=(const Promise&) = delete;
+
+        ~Promise() {
+            if (_state && !_state->ready.load(std::memory_order_acquire)) {
+                setException(std::make_exception_ptr(
+                        TaskCancelledException("Promise: The task is dropped before it is finished!")));
+            }
+        }
+
+        [[nodiscard]] Future<T> future() const { return Future<T>(_state); }
+
+        template<typename... Args>
+        void setValue(Args&&... args) {
+            complete([&] { _state->value.emplace(std::forward<Args>(args)...); });
+        }
+
+        void setException(std::exception_ptr exception) {
+            complete([&] { _state->exception = std::move(exception); });
+        }
+
+        /// Call `func` and store its result, or the exception thrown by it.
+        template<typename F>
+        void run(F&& func) {
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    func();
+                    setValue();
+                } else {
+                    setValue(func());
+                }
+            } catch (...) {
+                setException(std::current_exception());
+            }
+        }
+
+    private:
+        template<typename F>
+        void complete(F&& store) {
+            std::vector<TaskFunction> continuations;
+            {
+                std::lock_guard<std::mutex> lock(_state->mutex);
+                if (_state->ready.load(std::memory_order_relaxed)) return;
+                store();
+                _state->ready.store(true, std::memory_order_release);
+                continuations.swap(_state->continuations);
+            }
+            _state->cond.notify_all();
+            for (auto& continuation : continuations) continuation();
+        }
+
+        std::shared_ptr<typename Future<T>::State> _state;
+    };
+
+    /**
+     * \if EN
+     * @brief Return a future which is finished after all of `futures` are finished
+     * @details The values are collected in order (`Future<void>` for `void`), the first failure is passed on.
+     * \endif
+     */
+    template<typename T>
+    auto whenAll(std::vector<Future<T>> futures) {
+        using R = std::conditional_t<std::is_void_v<T>, void, std::vector<T>>;
+        struct Shared {
+            Promise<R> promise;
+            std::vector<Future<T>> futures;
+            std::atomic<size_t> remaining;
+        };
+        auto shared = std::make_shared<Shared>();
+        auto result = shared->promise.future();
+        shared->remaining = futures.size();
+        shared->futures = std::move(futures);
+        auto finish = [](Shared& s) {
+            s.promise.run([&]() -> R {
+                if constexpr (std::is_void_v<T>) {
+                    for (auto& future : s.futures) future.get();
+                } else {
+                    R values;
+                    values.reserve(s.futures.size());
+                    for (auto& future : s.futures) values.push_back(future.get());
+                    return values;
+                }
+            });
+        };
+        if (shared->futures.empty()) {
+            finish(*shared);
+            return result;
+        }
+        for (auto& future : shared->futures) {
+            future.onFinished([shared, finish] {
+                if (shared->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) finish(*shared);
+            });
+        }
+        return result;
+    }
+
+    /**
+     * \if EN
+     * @brief Return a future of the index of the first finished one in `futures`
+     * \endif
+     */
+    template<typename T>
+    Future<size_t> whenAny(const std::vector<Future<T>>& futures) {
+        auto promise = std::make_shared<Promise<size_t>>();
+        auto result = promise->future();
+        if (futures.empty()) {
+            promise->setException(std::make_exception_ptr(
+                    InvalidArgumentException("whenAny: No future is given!")));
+            return result;
+        }
+        for (size_t i = 0; i < futures.size(); ++i) {
+            futures[i].onFinished([promise, i] { promise->setValue(i); });
+        }
+        return result;
+    }
+}
+
+#endif //MYENGINE_MULTITHREAD_FUTURE_H
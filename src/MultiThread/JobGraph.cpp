@@ -0,0 +1,249 @@
+
+#include "JobGraph.h"
+#include "ThreadPool.h"
+#include "Utils/Logger.h"
+
+namespace MyEngine {
+    JobGraph::Resource JobGraph::resource(std::string_view name) {
+        /// FNV-1a
+        uint64_t hash = 14695981039346656037ull;
+        for (auto c : name) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    JobGraph::JobID JobGraph::addJob(const std::string &name, Function function,
+                                     const std::vector<Resource> &reads, const std::vector<Resource> &writes,
+                                     Affinity affinity) {
+        if (!function) {
+            Logger::log(FMT::format("JobGraph: The function of job `{}` is not valid!", name), Logger::Error);
+            return INVALID_JOB;
+        }
+        auto id = static_cast<JobID>(_jobs.size());
+        auto& job = _jobs.emplace_back();
+        job.name = name;
+        job.function = std::move(function);
+        job.reads = reads;
+        job.writes = writes;
+        job.affinity = affinity;
+        _alive_count += 1;
+        _dirty = true;
+        return id;
+    }
+
+    bool JobGraph::addDependency(JobID before, JobID after) {
+        if (!isAlive(before) || !isAlive(after) || before == after) {
+            Logger::log("JobGraph: The job ID is not valid!", Logger::Error);
+            return false;
+        }
+        compile();
+        if (reaches(after, before)) {
+            Logger::log(FMT::format("JobGraph: The dependency from `{}` to `{}` makes a cycle!",
+                                    _jobs[before].name, _jobs[after].name), Logger::Error);
+            return false;
+        }
+        _jobs[before].after.push_back(after);
+        _dirty = true;
+        return true;
+    }
+
+    bool JobGraph::removeJob(JobID id) {
+        if (!isAlive(id)) return false;
+        auto& job = _jobs[id];
+        job.alive = false;
+        job.function = nullptr;
+        job.after.clear();
+        _alive_count -= 1;
+        _dirty = true;
+        return true;
+    }
+
+    void JobGraph::setJobEnabled(JobID id, bool enabled) {
+        if (isAlive(id)) _jobs[id].enabled = enabled;
+    }
+
+    bool JobGraph::isJobEnabled(JobID id) const {
+        return isAlive(id) && _jobs[id].enabled;
+    }
+
+    JobGraph::JobID JobGraph::findJob(std::string_view name) const {
+        for (JobID id = 0; id < _jobs.size(); ++id) {
+            if (_jobs[id].alive && _jobs[id].name == name) return id;
+        }
+        return INVALID_JOB;
+    }
+
+    void JobGraph::clear() {
+        _jobs.clear();
+        _order.clear();
+        _alive_count = 0;
+        _dirty = true;
+    }
+
+    size_t JobGraph::jobCount() const {
+        return _alive_count;
+    }
+
+    bool JobGraph::isEmpty() const {
+        return _alive_count == 0;
+    }
+
+    void JobGraph::run(ThreadPool *pool) {
+        if (!_alive_count) return;
+        compile();
+        auto start = SDL_GetTicksNS();
+        if (!pool || !pool->isRunning() || _alive_count == 1) {
+            for (auto id : _order) execute(id);
+            _last_run_ns = SDL_GetTicksNS() - start;
+            return;
+        }
+        _pool = pool;
+        _finished.store(0, std::memory_order_relaxed);
+        for (auto id : _order) {
+            _remaining[id].store(_jobs[id].dependencies, std::memory_order_relaxed);
+        }
+        for (auto id : _order) {
+            if (!_jobs[id].dependencies) schedule(id);
+        }
+        while (_finished.load(std::memory_order_acquire) < _alive_count) {
+            JobID id = INVALID_JOB;
+            {
+                std::lock_guard<std::mutex> lock(_main_mutex);
+                if (!_main_queue.empty()) {
+                    id = _main_queue.front();
+                    _main_queue.pop_front();
+                }
+            }
+            if (id != INVALID_JOB) {
+                execute(id);
+                complete(id);
+                continue;
+            }
+            if (_pool->runPendingTask()) continue;
+            std::unique_lock<std::mutex> lock(_main_mutex);
+            _main_cond.wait(lock, [this] {
+                return !_main_queue.empty() || _finished.load(std::memory_order_acquire) >= _alive_count;
+            });
+        }
+        _pool = nullptr;
+        _last_run_ns = SDL_GetTicksNS() - start;
+    }
+
+    uint64_t JobGraph::lastRunTimeNS() const {
+        return _last_run_ns;
+    }
+
+    void JobGraph::compile() {
+        if (!_dirty) return;
+        struct Access {
+            JobID writer{INVALID_JOB};
+            std::vector<JobID> readers;
+        };
+        std::unordered_map<Resource, Access> accesses;
+        for (auto& job : _jobs) {
+            job.successors.clear();
+            job.dependencies = 0;
+        }
+        /// The jobs are visited in the order they are added, so the edges always point to the later jobs.
+        for (JobID id = 0; id < _jobs.size(); ++id) {
+            auto& job = _jobs[id];
+            if (!job.alive) continue;
+            for (auto res : job.reads) {
+                auto& access = accesses[res];
+                if (access.writer != INVALID_JOB && access.writer != id) {
+                    _jobs[access.writer].successors.push_back(id);
+                }
+                access.readers.push_back(id);
+            }
+            for (auto res : job.writes) {
+                auto& access = accesses[res];
+                if (access.writer != INVALID_JOB && access.writer != id) {
+                    _jobs[access.writer].successors.push_back(id);
+                }
+                for (auto reader : access.readers) {
+                    if (reader != id) _jobs[reader].successors.push_back(id);
+                }
+                access.writer = id;
+                access.readers.clear();
+            }
+            for (auto next : job.after) {
+                if (isAlive(next)) job.successors.push_back(next);
+            }
+        }
+        for (auto& job : _jobs) {
+            std::sort(job.successors.begin(), job.successors.end());
+            job.successors.erase(std::unique(job.successors.begin(), job.successors.end()), job.successors.end());
+            for (auto next : job.successors) _jobs[next].dependencies += 1;
+        }
+        /// Topological order, used by the serial fallback.
+        _order.clear();
+        std::vector<uint32_t> remaining(_jobs.size());
+        for (JobID id = 0; id < _jobs.size(); ++id) {
+            remaining[id] = _jobs[id].dependencies;
+            if (_jobs[id].alive && !remaining[id]) _order.push_back(id);
+        }
+        for (size_t i = 0; i < _order.size(); ++i) {
+            for (auto next : _jobs[_order[i]].successors) {
+                if (--remaining[next] == 0) _order.push_back(next);
+            }
+        }
+        _remaining = std::make_unique<std::atomic<uint32_t>[]>(_jobs.size());
+        _dirty = false;
+    }
+
+    bool JobGraph::isAlive(JobID id) const {
+        return id < _jobs.size() && _jobs[id].alive;
+    }
+
+    bool JobGraph::reaches(JobID from, JobID to) const {
+        std::vector<bool> visited(_jobs.size(), false);
+        std::vector<JobID> stack{from};
+        while (!stack.empty()) {
+            auto id = stack.back();
+            stack.pop_back();
+            if (id == to) return true;
+            if (visited[id]) continue;
+            visited[id] = true;
+            for (auto next : _jobs[id].successors) stack.push_back(next);
+        }
+        return false;
+    }
+
+    void JobGraph::schedule(JobID id) {
+        if (_jobs[id].affinity == MainThread) {
+            {
+                std::lock_guard<std::mutex> lock(_main_mutex);
+                _main_queue.push_back(id);
+            }
+            _main_cond.notify_one();
+            return;
+        }
+        auto task = [this, id] {
+            execute(id);
+            complete(id);
+        };
+        if (!_pool->append(task)) task();
+    }
+
+    void JobGraph::execute(JobID id) {
+        auto& job = _jobs[id];
+        if (!job.enabled) return;
+        try {
+            job.function();
+        } catch (const std::exception& e) {
+            Logger::log(Logger::Error, "JobGraph: Job `{}` failed! Exception: {}", job.name, e.what());
+        }
+    }
+
+    void JobGraph::complete(JobID id) {
+        for (auto next : _jobs[id].successors) {
+            if (_remaining[next].fetch_sub(1, std::memory_order_acq_rel) == 1) schedule(next);
+        }
+        if (_finished.fetch_add(1, std::memory_order_acq_rel) + 1 == _alive_count) {
+            std::lock_guard<std::mutex> lock(_main_mutex);
+            _main_cond.notify_all();
+        }
+    }
+}
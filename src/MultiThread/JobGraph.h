@@ -0,0 +1,99 @@
+#pragma once
+#ifndef MYENGINE_MULTITHREAD_JOBGRAPH_H
+#define MYENGINE_MULTITHREAD_JOBGRAPH_H
+#include "../Libs.h"
+
+namespace MyEngine {
+    class ThreadPool;
+
+    /**
+     * \if EN
+     * @class MyEngine::JobGraph
+     * @brief Directed acyclic graph of jobs running once per frame
+     * @details Every job declares the resources it reads and writes. A job depends on the last job (added before it)
+     * writing the resource it reads, and a writer also depends on the readers before it,
+     * so the jobs without conflicts run in parallel on the thread pool.
+     * @details The jobs with `MainThread` affinity (e.g. the jobs calling SDL functions) run on the thread calling `run()`.
+     * @note Don't modify the graph while it is running.
+     * \endif
+     */
+    class JobGraph {
+    public:
+        using JobID = uint32_t;
+        using Resource = uint64_t;
+        using Function = std::function<void()>;
+        enum Affinity : uint8_t {
+            AnyThread,
+            MainThread
+        };
+        static constexpr JobID INVALID_JOB = UINT32_MAX;
+
+        JobGraph() = default;
+        JobGraph(const JobGraph&) = delete;
+        JobGraph(JobGraph&&) = delete;
+        JobGraph& operator=(const JobGraph&) = delete;
+        JobGraph& operator=(JobGraph&&) = delete;
+        ~JobGraph() = default;
+
+        /// Return the resource ID of the name, the same name always gets the same ID.
+        static Resource resource(std::string_view name);
+
+        JobID addJob(const std::string& name, Function function,
+                     const std::vector<Resource>& reads = {}, const std::vector<Resource>& writes = {},
+                     Affinity affinity = AnyThread);
+        /// Let `after` run after `before` is finished, it fails if the dependency makes a cycle.
+        bool addDependency(JobID before, JobID after);
+        bool removeJob(JobID id);
+        void setJobEnabled(JobID id, bool enabled);
+        [[nodiscard]] bool isJobEnabled(JobID id) const;
+        [[nodiscard]] JobID findJob(std::string_view name) const;
+        void clear();
+
+        [[nodiscard]] size_t jobCount() const;
+        [[nodiscard]] bool isEmpty() const;
+
+        /**
+         * \if EN
+         * @brief Run all jobs and wait until they are finished
+         * @details If `pool` is null or stopped, the jobs are run one by one in the dependency order.
+         * The caller thread runs the `MainThread` jobs and helps the pool while waiting.
+         * \endif
+         */
+        void run(ThreadPool* pool = nullptr);
+        [[nodiscard]] uint64_t lastRunTimeNS() const;
+
+    private:
+        struct Job {
+            std::string name;
+            Function function;
+            std::vector<Resource> reads, writes;
+            std::vector<JobID> after;
+            std::vector<JobID> successors;
+            uint32_t dependencies{0};
+            Affinity affinity{AnyThread};
+            bool alive{true};
+            bool enabled{true};
+        };
+
+        void compile();
+        [[nodiscard]] bool isAlive(JobID id) const;
+        [[nodiscard]] bool reaches(JobID from, JobID to) const;
+        void schedule(JobID id);
+        void execute(JobID id);
+        void complete(JobID id);
+
+        std::vector<Job> _jobs;
+        std::vector<JobID> _order;
+        size_t _alive_count{0};
+        bool _dirty{true};
+        std::unique_ptr<std::atomic<uint32_t>[]> _remaining;
+        std::atomic<size_t> _finished{0};
+        ThreadPool* _pool{nullptr};
+        std::mutex _main_mutex;
+        std::condition_variable _main_cond;
+        std::deque<JobID> _main_queue;
+        uint64_t _last_run_ns{0};
+    };
+}
+
+#endif //MYENGINE_MULTITHREAD_JOBGRAPH_H
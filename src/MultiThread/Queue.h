@@ -2,6 +2,7 @@
 #ifndef MYENGINE_MULTITHREAD_QUEUE_H
 #define MYENGINE_MULTITHREAD_QUEUE_H
 #include "../Libs.h"
+#include "../Utils/InplaceFunction.h"
 
 namespace MyEngine {
     template <typename T>
@@ -32,7 +33,7 @@ namespace MyEngine {
                 return _datas_queue.size() <= _max_size || !_running; 
             });
             if (!_running) return false;
-            _datas_queue.push_back(data);
+            _datas_queue.push_back(std::move(data));
             _cond_var.notify_one();
             return true;
         }
@@ -43,7 +44,7 @@ namespace MyEngine {
                 return !_datas_queue.empty() || !_running;
             });
             if (!_running) return false;
-            data = _datas_queue.front();
+            data = std::move(_datas_queue.front());
             _datas_queue.pop_front();
             _cond_var.notify_one();
             return true;
@@ -92,8 +93,8 @@ namespace MyEngine {
             return _datas_queue.back();
         }
         
-        void setDeletor(const std::function<void(T&)>& deletor) {
-            _deletor = deletor;
+        void setDeletor(InplaceFunction<void(T&)> deletor) {
+            _deletor = std::move(deletor);
         }
         
     private:
@@ -102,7 +103,333 @@ namespace MyEngine {
         std::condition_variable _cond_var;
         std::atomic<bool> _running{false};
         size_t _max_size{50};
-        std::function<void(T&)> _deletor;
+        InplaceFunction<void(T&)> _deletor;
+    };
+
+    /**
+     * \if EN
+     * @class MyEngine::QueueSignal
+     * @brief Sleep/wake helper for the lock-free queues
+     * @details The waiter spins for a while at first, then sleeps on an atomic counter.
+     * The other side only touches the counter while someone is sleeping.
+     * \endif
+     */
+    class QueueSignal {
+    public:
+        template<typename Pred>
+        bool wait(Pred&& try_once, const std::atomic<bool>& running) {
+            for (int i = 0; i < SPIN_COUNT; ++i) {
+                if (try_once()) return true;
+                if (!running.load(std::memory_order_relaxed)) return false;
+                if (i >= SPIN_COUNT / 2) std::this_thread::yield();
+            }
+            while (true) {
+                auto events = _events.load();
+                _waiters.fetch_add(1);
+                /// Pairs with the fence in `notify()`, either the waiter sees the item or the notifier sees the waiter.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (try_once()) {
+                    _waiters.fetch_sub(1);
+                    return true;
+                }
+                if (!running.load()) {
+                    _waiters.fetch_sub(1);
+                    return false;
+                }
+                _events.wait(events);
+                _waiters.fetch_sub(1);
+            }
+        }
+
+        void notify() {
+            /// The item is published with a release store, which may be reordered after the load without the fence.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (_waiters.load()) {
+                _events.fetch_add(1);
+                _events.notify_all();
+            }
+        }
+
+        void wakeAll() {
+            _events.fetch_add(1);
+            _events.notify_all();
+        }
+
+    private:
+        static constexpr int SPIN_COUNT = 128;
+        std::atomic<uint32_t> _events{0};
+        std::atomic<uint32_t> _waiters{0};
+    };
+
+    /**
+     * \if EN
+     * @class MyEngine::SpscRingQueue
+     * @brief Bounded lock-free queue for one producer and one consumer
+     * @details The capacity is rounded up to the power of two. The items are moved in and out,
+     * the indexes are kept in different cache lines, and each side caches the index of the other side.
+     * @details The blocking `push()` and `pop()` return `false` after `stop()` is called.
+     * \endif
+     */
+    template<typename T>
+    class SpscRingQueue {
+    public:
+        explicit SpscRingQueue(size_t capacity) {
+            _capacity = std::bit_ceil(std::max<size_t>(capacity, 2));
+            _mask = _capacity - 1;
+            _slots = std::make_unique<Slot[]>(_capacity);
+        }
+        SpscRingQueue(SpscRingQueue &&) = delete;
+        SpscRingQueue(const SpscRingQueue &) = delete;
+        SpscRingQueue &operator=(SpscRingQueue &&) = delete;
+        SpscRingQueue &operator=(const SpscRingQueue &) = delete;
+        ~SpscRingQueue() {
+            for (auto i = _head.load(); i != _tail.load(); ++i) _slots[i & _mask].get()->~T();
+        }
+
+        template<typename... Args>
+        bool tryEmplace(Args&&... args) {
+            auto tail = _tail.load(std::memory_order_relaxed);
+            if (tail - _head_cache == _capacity) {
+                _head_cache = _head.load(std::memory_order_acquire);
+                if (tail - _head_cache == _capacity) return false;
+            }
+            new (_slots[tail & _mask].data) T(std::forward<Args>(args)...);
+            _tail.store(tail + 1, std::memory_order_release);
+            _not_empty.notify();
+            return true;
+        }
+        bool tryPush(const T& item) { return tryEmplace(item); }
+        bool tryPush(T&& item) { return tryEmplace(std::move(item)); }
+
+        bool tryPop(T& item) {
+            auto head = _head.load(std::memory_order_relaxed);
+            if (head == _tail_cache) {
+                _tail_cache = _tail.load(std::memory_order_acquire);
+                if (head == _tail_cache) return false;
+            }
+            auto ptr = _slots[head & _mask].get();
+            item = std::move(*ptr);
+            ptr->~T();
+            _head.store(head + 1, std::memory_order_release);
+            _not_full.notify();
+            return true;
+        }
+
+        /// Move the items in [first, last) into the queue as many as possible, return the number of moved items.
+        template<typename Iter>
+        size_t tryPushBatch(Iter first, Iter last) {
+            auto tail = _tail.load(std::memory_order_relaxed);
+            _head_cache = _head.load(std::memory_order_acquire);
+            auto count = std::min<size_t>(static_cast<size_t>(std::distance(first, last)),
+                                          _capacity - (tail - _head_cache));
+            for (size_t i = 0; i < count; ++i, ++first) {
+                new (_slots[(tail + i) & _mask].data) T(std::move(*first));
+            }
+            if (count) {
+                _tail.store(tail + count, std::memory_order_release);
+                _not_empty.notify();
+            }
+            return count;
+        }
+
+        /// Move at most `max_count` items to `out`, return the number of moved items.
+        template<typename OutIter>
+        size_t tryPopBatch(OutIter out, size_t max_count) {
+            auto head = _head.load(std::memory_order_relaxed);
+            _tail_cache = _tail.load(std::memory_order_acquire);
+            auto count = std::min<size_t>(max_count, _tail_cache - head);
+            for (size_t i = 0; i < count; ++i, ++out) {
+                auto ptr = _slots[(head + i) & _mask].get();
+                *out = std::move(*ptr);
+                ptr->~T();
+            }
+            if (count) {
+                _head.store(head + count, std::memory_order_release);
+                _not_full.notify();
+            }
+            return count;
+        }
+
+        bool push(T&& item) {
+            return _not_full.wait([&] { return tryPush(std::move(item)); }, _running);
+        }
+        bool push(const T& item) {
+            return _not_full.wait([&] { return tryPush(item); }, _running);
+        }
+        bool pop(T& item) {
+            return _not_empty.wait([&] { return tryPop(item); }, _running);
+        }
+
+        void start() { _running = true; }
+        void stop() {
+            _running = false;
+            _not_full.wakeAll();
+            _not_empty.wakeAll();
+        }
+        [[nodiscard]] bool isRunning() const { return _running; }
+
+        [[nodiscard]] size_t size() const {
+            return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+        }
+        [[nodiscard]] bool empty() const { return size() == 0; }
+        [[nodiscard]] size_t capacity() const { return _capacity; }
+
+    private:
+        struct Slot {
+            alignas(T) unsigned char data[sizeof(T)];
+            T* get() { return std::launder(reinterpret_cast<T*>(data)); }
+        };
+
+        std::unique_ptr<Slot[]> _slots;
+        size_t _capacity{0}, _mask{0};
+        std::atomic<bool> _running{true};
+        /// Consumer side
+        alignas(64) std::atomic<size_t> _head{0};
+        size_t _tail_cache{0};
+        QueueSignal _not_full;
+        /// Producer side
+        alignas(64) std::atomic<size_t> _tail{0};
+        size_t _head_cache{0};
+        QueueSignal _not_empty;
+    };
+
+    /**
+     * \if EN
+     * @class MyEngine::MpmcRingQueue
+     * @brief Bounded lock-free queue for multiple producers and consumers
+     * @details Every slot has a sequence number telling whether it can be written or read (Vyukov's queue),
+     * so the producers and consumers only contend on their own index.
+     * The capacity is rounded up to the power of two.
+     * \endif
+     */
+    template<typename T>
+    class MpmcRingQueue {
+    public:
+        explicit MpmcRingQueue(size_t capacity) {
+            _capacity = std::bit_ceil(std::max<size_t>(capacity, 2));
+            _mask = _capacity - 1;
+            _slots = std::make_unique<Slot[]>(_capacity);
+            for (size_t i = 0; i < _capacity; ++i) _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        MpmcRingQueue(MpmcRingQueue &&) = delete;
+        MpmcRingQueue(const MpmcRingQueue &) = delete;
+        MpmcRingQueue &operator=(MpmcRingQueue &&) = delete;
+        MpmcRingQueue &operator=(const MpmcRingQueue &) = delete;
+        ~MpmcRingQueue() {
+            for (auto i = _head.load(); i != _tail.load(); ++i) _slots[i & _mask].get()->~T();
+        }
+
+        template<typename... Args>
+        bool tryEmplace(Args&&... args) {
+            auto pos = _tail.load(std::memory_order_relaxed);
+            Slot* slot;
+            while (true) {
+                slot = &_slots[pos & _mask];
+                auto seq = slot->sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+                if (diff == 0) {
+                    if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = _tail.load(std::memory_order_relaxed);
+                }
+            }
+            new (slot->data) T(std::forward<Args>(args)...);
+            slot->sequence.store(pos + 1, std::memory_order_release);
+            _not_empty.notify();
+            return true;
+        }
+        bool tryPush(const T& item) { return tryEmplace(item); }
+        bool tryPush(T&& item) { return tryEmplace(std::move(item)); }
+
+        bool tryPop(T& item) {
+            return tryConsume([&item](T&& value) { item = std::move(value); });
+        }
+
+        /// Move the items in [first, last) into the queue until it is full, return the number of moved items.
+        template<typename Iter>
+        size_t tryPushBatch(Iter first, Iter last) {
+            size_t count = 0;
+            for (; first != last && tryPush(std::move(*first)); ++first) count += 1;
+            return count;
+        }
+
+        /// Move at most `max_count` items to `out`, return the number of moved items.
+        template<typename OutIter>
+        size_t tryPopBatch(OutIter out, size_t max_count) {
+            size_t count = 0;
+            while (count < max_count && tryConsume([&out](T&& value) { *out = std::move(value); ++out; })) {
+                count += 1;
+            }
+            return count;
+        }
+
+        bool push(T&& item) {
+            return _not_full.wait([&] { return tryPush(std::move(item)); }, _running);
+        }
+        bool push(const T& item) {
+            return _not_full.wait([&] { return tryPush(item); }, _running);
+        }
+        bool pop(T& item) {
+            return _not_empty.wait([&] { return tryPop(item); }, _running);
+        }
+
+        void start() { _running = true; }
+        void stop() {
+            _running = false;
+            _not_full.wakeAll();
+            _not_empty.wakeAll();
+        }
+        [[nodiscard]] bool isRunning() const { return _running; }
+
+        /// The approximate number of items, it may be changed by other threads at the same time.
+        [[nodiscard]] size_t size() const {
+            auto tail = _tail.load(std::memory_order_acquire);
+            auto head = _head.load(std::memory_order_acquire);
+            return tail > head ? tail - head : 0;
+        }
+        [[nodiscard]] bool empty() const { return size() == 0; }
+        [[nodiscard]] size_t capacity() const { return _capacity; }
+
+    private:
+        struct Slot {
+            std::atomic<size_t> sequence;
+            alignas(T) unsigned char data[sizeof(T)];
+            T* get() { return std::launder(reinterpret_cast<T*>(data)); }
+        };
+
+        template<typename Sink>
+        bool tryConsume(Sink&& sink) {
+            auto pos = _head.load(std::memory_order_relaxed);
+            Slot* slot;
+            while (true) {
+                slot = &_slots[pos & _mask];
+                auto seq = slot->sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+                if (diff == 0) {
+                    if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = _head.load(std::memory_order_relaxed);
+                }
+            }
+            auto ptr = slot->get();
+            sink(std::move(*ptr));
+            ptr->~T();
+            slot->sequence.store(pos + _capacity, std::memory_order_release);
+            _not_full.notify();
+            return true;
+        }
+
+        std::unique_ptr<Slot[]> _slots;
+        size_t _capacity{0}, _mask{0};
+        std::atomic<bool> _running{true};
+        alignas(64) std::atomic<size_t> _head{0};
+        alignas(64) std::atomic<size_t> _tail{0};
+        alignas(64) QueueSignal _not_full;
+        QueueSignal _not_empty;
     };
 }
 
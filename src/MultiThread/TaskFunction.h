@@ -0,0 +1,18 @@
+#pragma once
+#ifndef MYENGINE_MULTITHREAD_TASKFUNCTION_H
+#define MYENGINE_MULTITHREAD_TASKFUNCTION_H
+#include "../Utils/InplaceFunction.h"
+
+namespace MyEngine {
+    /**
+     * \if EN
+     * @brief Move-only `void()` callable of the tasks
+     * @details Callables up to 48 bytes are stored inside the object, larger ones are allocated on heap.
+     * Unlike `std::function`, it accepts move-only callables (e.g. lambdas capturing `std::promise`).
+     * \endif
+     * @see InplaceFunction
+     */
+    using TaskFunction = InplaceFunction<void(), 48, true>;
+}
+
+#endif //MYENGINE_MULTITHREAD_TASKFUNCTION_H
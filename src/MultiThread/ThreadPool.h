@@ -3,13 +3,42 @@
 #define MYENGINE_MULTITHREAD_THREADPOOL_H
 #include "../Libs.h"
 #include "../Utils/Logger.h"
+#include "TaskFunction.h"
+#include "Future.h"
+#include "WorkStealingDeque.h"
 
 namespace MyEngine {
+    /**
+     * \if EN
+     * @class MyEngine::ThreadPool
+     * @brief Work-stealing thread pool
+     * @details Every worker owns a Chase-Lev deque. Tasks appended by a worker are pushed to its own deque,
+     * tasks appended by other threads are pushed to a shared injection queue. Idle workers steal from the others,
+     * so fine-grained tasks don't fight over one lock.
+     * @details Tasks are stored in `TaskFunction` (small-buffer storage) and the task nodes are recycled by workers.
+     * @details If more than `max_waiting` tasks are waiting, the task appended by a non-worker thread
+     * is executed by the caller directly instead of blocking it.
+     * @details `submit()` returns a `Future` of the result. The priority is honoured when a worker takes the next task:
+     * `High` tasks are taken before the local tasks, `Low` tasks are taken after the others are stolen.
+     * \endif
+     */
     class ThreadPool {
     public:
-        explicit ThreadPool(uint32_t max_waiting, uint32_t max_running = std::thread::hardware_concurrency())
-            : _nums_of_threads(max_running), _max_threads_count(max_waiting), _running(true) {
-            if (!max_running || max_running > std::thread::hardware_concurrency()) {
+        enum Priority {
+            Low,
+            Medium,
+            High
+        };
+
+        /// Get the count of the hardware threads, it is 1 if the platform can't tell it.
+        static uint32_t hardwareThreads() {
+            return std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        /// The count of the threads can't be more than `hardwareThreads()`.
+        explicit ThreadPool(uint32_t max_waiting, uint32_t max_running = hardwareThreads())
+            : _nums_of_threads(max_running), _max_threads_count(max_waiting), _running(false) {
+            if (!max_running || max_running > hardwareThreads()) {
                 Logger::log("ThreadPool: Argument error: Maximum threads count argument is invalid!", Logger::Fatal);
                 throw std::invalid_argument("ThreadPool: Argument error: Maximum threads count argument is invalid!");
             }
@@ -17,153 +46,461 @@ namespace MyEngine {
                 Logger::log("ThreadPool: Argument error: Maximum waiting threads count argument is invalid!!", Logger::Fatal);
                 throw std::invalid_argument("ThreadPool: Argument error: Maximum waiting threads count argument is invalid!!");
             }
-            while (max_running--) {
-                _thread_list.emplace_back([this]{
-                    std::function<void()> this_task;
-                    while (true) {
-                        std::unique_lock<std::mutex> lock(_mutex);
-                        _condition_var.wait(lock, [this] {
-                            return !_waiting_queue.empty() || !_running;
-                        });
-                        if (!_running && _waiting_queue.empty()) return;
-                        if (_waiting_queue.empty()) continue;
-                        this_task = std::move(_waiting_queue.front());
-                        _waiting_queue.pop();
-                        _running_thread_count += 1;
-                        lock.unlock();
-                        try {
-                            this_task();
-                        } catch (const std::exception& e) {
-                            Logger::log(FMT::format("ThreadPool: Task failed! "
-                                                    "Exception: {}", e.what()), Logger::Error);
-                        }
-                        lock.lock();
-                        _running_thread_count -= 1;
-                        _condition_var.notify_all();
-                        lock.unlock();
-                    }
-                });
-            }
+            spawnWorkers();
         }
 
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool(ThreadPool&&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        ThreadPool& operator=(ThreadPool&&) = delete;
+
         ~ThreadPool() {
             stopAll();
         }
 
-        bool append(std::function<void()> function) {
-            std::unique_lock<std::mutex> lock(_mutex);
-            _condition_var.wait(lock, [this] {
-                return _waiting_queue.size() < _max_threads_count || !_running;
-            });
-            if (!_running) return false;
-            _waiting_queue.emplace(std::move(function));
-            _condition_var.notify_one();
+        template<typename F>
+        bool append(F&& function, Priority priority = Medium) {
+            if (!_running.load(std::memory_order_acquire)) return false;
+            if (!isWorkerThread() && waitingQueueCount() >= _max_threads_count) {
+                /// The pool is saturated, run it on the caller thread instead of blocking it.
+                TaskFunction task(std::forward<F>(function));
+                runSafely(task);
+                return true;
+            }
+            push(allocTask(std::forward<F>(function)), priority);
             return true;
         }
 
+        /**
+         * \if EN
+         * @brief Append a task and return the future of its result
+         * @details If the pool is stopped or the task is removed by `wait(true)`/`stopAll()`,
+         * the future fails with `TaskCancelledException`.
+         * @details `function` can take a `const CancellationToken&` argument to check the cancellation by itself.
+         * \endif
+         */
+        template<typename F>
+        auto submit(F&& function, Priority priority = Medium) {
+            auto [task, future] = packageTask(std::forward<F>(function), std::nullopt);
+            append(std::move(task), priority);
+            return future;
+        }
+
+        /**
+         * \if EN
+         * @brief Append a task which can be cancelled by `token`
+         * @details If `token` is cancelled before the task starts, the task is skipped
+         * and the future fails with `TaskCancelledException`.
+         * \endif
+         */
+        template<typename F>
+        auto submit(F&& function, const CancellationToken& token, Priority priority = Medium) {
+            auto [task, future] = packageTask(std::forward<F>(function), token);
+            append(std::move(task), priority);
+            return future;
+        }
+
         void startAll() {
-            {
-                std::unique_lock<std::mutex> lock(_mutex);
-                _running = true;
-            }
-            _condition_var.notify_all();
+            if (!_running.load(std::memory_order_acquire)) spawnWorkers();
         }
 
         void wait(bool clear_queue = false) {
-            std::unique_lock<std::mutex> lock(_mutex);
-            if (clear_queue && !_waiting_queue.empty()) {
-                _waiting_queue = {};
-                _condition_var.notify_all();
-            }
-            _condition_var.wait(lock, [this] {
-                return (_waiting_queue.empty() && _running_thread_count == 0) || !_running;
+            if (clear_queue) clearTasks();
+            std::unique_lock<std::mutex> lock(_idle_mutex);
+            _idle_cv.wait(lock, [this] {
+                return _pending.load(std::memory_order_acquire) == 0 || !_running.load(std::memory_order_acquire);
             });
         }
 
         void stopAll() {
             {
-                std::unique_lock<std::mutex> lock(_mutex);
-                if (!_running) return;
-                _running = false;
-                _waiting_queue = {};
+                std::lock_guard<std::mutex> lock(_sleep_mutex);
+                if (!_running.load(std::memory_order_acquire)) return;
+                _running.store(false, std::memory_order_release);
+            }
+            _sleep_cv.notify_all();
+            for (auto& worker : _workers) {
+                if (worker->thread.joinable()) worker->thread.join();
             }
-            _condition_var.notify_all();
-            for (auto& th : _thread_list) {
-                if (th.joinable()) th.join();
+            clearTasks();
+            for (auto& worker : _workers) {
+                for (auto task : worker->cache) delete task;
             }
+            _workers.clear();
+            std::lock_guard<std::mutex> lock(_idle_mutex);
+            _idle_cv.notify_all();
         }
 
         void restartAll() {
             if (_running) stopAll();
+            spawnWorkers();
+        }
 
-            _thread_list.clear();
-            uint32_t nums = _nums_of_threads;
-            while (nums--) {
-                _thread_list.emplace_back([this]{
-                    std::function<void()> this_task;
-                    while (true) {
-                        std::unique_lock<std::mutex> lock(_mutex);
-                        _condition_var.wait(lock, [this] {
-                            return !_waiting_queue.empty() || !_running;
-                        });
-                        if (!_running && _waiting_queue.empty()) return;
-                        if (_waiting_queue.empty()) continue;
-                        this_task = std::move(_waiting_queue.front());
-                        _waiting_queue.pop();
-                        _running_thread_count += 1;
-                        lock.unlock();
-                        try {
-                            this_task();
-                        } catch (const std::exception& e) {
-                            Logger::log(FMT::format("ThreadPool: Task failed! "
-                                                    "Exception: {}", e.what()), Logger::Error);
-                        }
-                        lock.lock();
-                        _running_thread_count -= 1;
-                        _condition_var.notify_all();
-                        lock.unlock();
+        /**
+         * \if EN
+         * @brief Call `func` for every index in [begin, end) in parallel
+         * @details The range is split into chunks (`grain` indexes per chunk, automatically chosen if it is 0),
+         * the caller thread takes part in the work and returns after all chunks are finished.
+         * @details `func` can be `func(Index i)` or `func(Index chunk_begin, Index chunk_end)`.
+         * The first exception thrown by `func` is rethrown to the caller.
+         * \endif
+         */
+        template<typename Index, typename Func>
+        void parallelFor(Index begin, Index end, Func&& func, size_t grain = 0) {
+            if (end <= begin) return;
+            const auto count = static_cast<size_t>(end - begin);
+            if (!grain) grain = std::max<size_t>(1, count / (static_cast<size_t>(_nums_of_threads) * 4));
+            const size_t chunks = (count + grain - 1) / grain;
+            auto run_chunk = [&](size_t chunk) {
+                auto first = static_cast<Index>(begin + static_cast<Index>(chunk * grain));
+                auto last = ((chunk + 1) * grain >= count ? end
+                                                          : static_cast<Index>(begin + static_cast<Index>((chunk + 1) * grain)));
+                if constexpr (std::is_invocable_v<Func&, Index, Index>) {
+                    func(first, last);
+                } else {
+                    for (auto i = first; i < last; ++i) func(i);
+                }
+            };
+            if (chunks == 1 || !_running.load(std::memory_order_acquire)) {
+                for (size_t chunk = 0; chunk < chunks; ++chunk) run_chunk(chunk);
+                return;
+            }
+            struct State {
+                std::atomic<size_t> next{0};
+                std::atomic<size_t> finished_helpers{0};
+                std::mutex mutex;
+                std::exception_ptr exception;
+            } state;
+            auto body = [&state, &run_chunk, chunks] {
+                for (auto chunk = state.next.fetch_add(1); chunk < chunks; chunk = state.next.fetch_add(1)) {
+                    try {
+                        run_chunk(chunk);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(state.mutex);
+                        if (!state.exception) state.exception = std::current_exception();
                     }
-                });
+                }
+            };
+            /// Count the helper as finished when the task is destroyed, so it also works if the queue is cleared.
+            struct HelperGuard {
+                explicit HelperGuard(State* s) : state(s) {}
+                HelperGuard(HelperGuard&& other) noexcept : state(std::exchange(other.state, nullptr)) {}
+                ~HelperGuard() { if (state) state->finished_helpers.fetch_add(1, std::memory_order_release); }
+                State* state;
+            };
+            const auto helpers = std::min<size_t>(chunks - 1, _nums_of_threads);
+            for (size_t i = 0; i < helpers; ++i) {
+                push(allocTask([guard = HelperGuard(&state), &body] { body(); }), Medium);
+            }
+            body();
+            /// The helpers are referencing the stack of this function, wait until all of them are returned.
+            while (state.finished_helpers.load(std::memory_order_acquire) < helpers) {
+                if (!runPendingTask()) std::this_thread::yield();
             }
-            startAll();
+            if (state.exception) std::rethrow_exception(state.exception);
+        }
+
+        /**
+         * \if EN
+         * @brief Map every index in [begin, end) and reduce the results in parallel
+         * @details `func` can be `T func(Index i)` or `T func(Index chunk_begin, Index chunk_end)`.
+         * The partial results are reduced in index order, so the result is deterministic.
+         * @note `identity` must be the identity value of `reduce` (e.g. 0 for addition).
+         * \endif
+         */
+        template<typename Index, typename T, typename Func, typename Reduce>
+        T parallelReduce(Index begin, Index end, T identity, Func&& func, Reduce&& reduce, size_t grain = 0) {
+            if (end <= begin) return identity;
+            const auto count = static_cast<size_t>(end - begin);
+            if (!grain) grain = std::max<size_t>(1, count / (static_cast<size_t>(_nums_of_threads) * 4));
+            const size_t chunks = (count + grain - 1) / grain;
+            std::vector<std::optional<T>> partials(chunks);
+            parallelFor<size_t>(0, chunks, [&](size_t chunk) {
+                auto first = static_cast<Index>(begin + static_cast<Index>(chunk * grain));
+                auto last = ((chunk + 1) * grain >= count ? end
+                                                          : static_cast<Index>(begin + static_cast<Index>((chunk + 1) * grain)));
+                if constexpr (std::is_invocable_v<Func&, Index, Index>) {
+                    partials[chunk].emplace(func(first, last));
+                } else {
+                    T acc = identity;
+                    for (auto i = first; i < last; ++i) acc = reduce(std::move(acc), func(i));
+                    partials[chunk].emplace(std::move(acc));
+                }
+            }, 1);
+            T result = std::move(identity);
+            for (auto& partial : partials) result = reduce(std::move(result), std::move(*partial));
+            return result;
         }
 
         [[nodiscard]] bool isRunning() const { return _running.load(std::memory_order_acquire); }
         [[nodiscard]] uint32_t threadsCount() const { return _nums_of_threads; }
-        [[nodiscard]] uint32_t waitingQueueCount() {
-            std::unique_lock<std::mutex> lock(_mutex);
-            return _waiting_queue.size();
+        [[nodiscard]] uint32_t waitingQueueCount() const {
+            auto pending = _pending.load(std::memory_order_acquire);
+            auto running = _running_thread_count.load(std::memory_order_acquire);
+            return static_cast<uint32_t>(pending > running ? pending - running : 0);
         }
         [[nodiscard]] uint32_t maxWaitingQueueCount() const { return _max_threads_count; }
         [[nodiscard]] uint32_t runningThreadsCount() const { return _running_thread_count; }
+        /// Check whether the current thread is one of the workers of this pool.
+        [[nodiscard]] bool isWorkerThread() const { return _tls_pool == this; }
+
+        /// Take one waiting task and run it on the caller thread, used to help the pool while waiting for tasks.
+        bool runPendingTask() {
+            TaskFunction* task;
+            if (!_running.load(std::memory_order_acquire) || !findTask(task)) return false;
+            execute(task);
+            return true;
+        }
+
+    protected:
+        /// Wrap `function` into a task which stores its result into a promise.
+        template<typename F>
+        static auto packageTask(F&& function, std::optional<CancellationToken> token) {
+            using Fn = std::decay_t<F>;
+            using R = typename decltype(taskResult<Fn>())::type;
+            Promise<R> promise;
+            auto future = promise.future();
+            auto task = [promise = std::move(promise), token = std::move(token),
+                         func = Fn(std::forward<F>(function))]() mutable {
+                if (token && token->isCancelled()) {
+                    promise.setException(std::make_exception_ptr(
+                            TaskCancelledException("ThreadPool: The task is cancelled!")));
+                    return;
+                }
+                promise.run([&]() -> R {
+                    if constexpr (std::is_invocable_v<Fn&, const CancellationToken&>) {
+                        return func(token ? *token : CancellationToken());
+                    } else {
+                        return func();
+                    }
+                });
+            };
+            return std::make_pair(std::move(task), std::move(future));
+        }
 
     private:
-        std::vector<std::thread> _thread_list;
+        template<typename Fn>
+        static auto taskResult() {
+            if constexpr (std::is_invocable_v<Fn&, const CancellationToken&>) {
+                return std::type_identity<std::invoke_result_t<Fn&, const CancellationToken&>>{};
+            } else {
+                return std::type_identity<std::invoke_result_t<Fn&>>{};
+            }
+        }
+
+        struct Worker {
+            WorkStealingDeque<TaskFunction*> deque;
+            std::vector<TaskFunction*> cache;
+            std::thread thread;
+        };
+        static constexpr size_t MAX_CACHED_TASKS = 256;
+        static constexpr int IDLE_SPIN_COUNT = 64;
+
+        void spawnWorkers() {
+            {
+                std::lock_guard<std::mutex> lock(_sleep_mutex);
+                _running.store(true, std::memory_order_release);
+            }
+            _workers.clear();
+            for (uint32_t i = 0; i < _nums_of_threads; ++i) {
+                _workers.emplace_back(std::make_unique<Worker>());
+            }
+            for (uint32_t i = 0; i < _nums_of_threads; ++i) {
+                _workers[i]->thread = std::thread(&ThreadPool::workerLoop, this, i);
+            }
+        }
+
+        void workerLoop(uint32_t index) {
+            auto self = _workers[index].get();
+            _tls_pool = this;
+            _tls_worker = self;
+            _tls_index = index;
+            TaskFunction* task;
+            while (_running.load(std::memory_order_acquire)) {
+                if (findTask(task)) {
+                    execute(task);
+                    continue;
+                }
+                bool found = false;
+                for (int i = 0; i < IDLE_SPIN_COUNT && !found; ++i) {
+                    std::this_thread::yield();
+                    found = findTask(task);
+                }
+                if (found) {
+                    execute(task);
+                    continue;
+                }
+                /// Read the epoch before the last try, so a task pushed after it will wake this worker up.
+                auto epoch = _epoch.load();
+                if (findTask(task)) {
+                    execute(task);
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(_sleep_mutex);
+                _sleepers.fetch_add(1);
+                _sleep_cv.wait(lock, [this, epoch] {
+                    return !_running.load(std::memory_order_acquire) || _epoch.load() != epoch;
+                });
+                _sleepers.fetch_sub(1);
+            }
+            _tls_pool = nullptr;
+            _tls_worker = nullptr;
+        }
+
+        bool findTask(TaskFunction*& task) {
+            if (popInjected(High, task)) return true;
+            if (_tls_pool == this && _tls_worker->deque.pop(task)) return true;
+            if (popInjected(Medium, task)) return true;
+            if (stealTask(task)) return true;
+            return popInjected(Low, task);
+        }
+
+        bool popInjected(Priority priority, TaskFunction*& task) {
+            if (!_inject_count[priority].load(std::memory_order_acquire)) return false;
+            std::lock_guard<std::mutex> lock(_inject_mutex);
+            auto& queue = _inject_queues[priority];
+            if (queue.empty()) return false;
+            task = queue.front();
+            queue.pop_front();
+            _inject_count[priority].fetch_sub(1, std::memory_order_release);
+            return true;
+        }
+
+        bool stealTask(TaskFunction*& task) {
+            const auto count = static_cast<uint32_t>(_workers.size());
+            const auto start = (_tls_pool == this ? _tls_index + 1 : _steal_hint.fetch_add(1, std::memory_order_relaxed));
+            for (uint32_t i = 0; i < count; ++i) {
+                auto& victim = _workers[(start + i) % count];
+                if (victim.get() != _tls_worker && victim->deque.steal(task)) return true;
+            }
+            return false;
+        }
+
+        void push(TaskFunction* task, Priority priority) {
+            _pending.fetch_add(1, std::memory_order_acq_rel);
+            if (_tls_pool == this && priority == Medium) {
+                _tls_worker->deque.push(task);
+            } else {
+                std::lock_guard<std::mutex> lock(_inject_mutex);
+                _inject_queues[priority].push_back(task);
+                _inject_count[priority].fetch_add(1, std::memory_order_release);
+            }
+            _epoch.fetch_add(1);
+            /// Only notify while any worker is sleeping.
+            if (_sleepers.load()) {
+                std::lock_guard<std::mutex> lock(_sleep_mutex);
+                _sleep_cv.notify_one();
+            }
+        }
+
+        template<typename F>
+        TaskFunction* allocTask(F&& function) {
+            if (_tls_pool == this && !_tls_worker->cache.empty()) {
+                auto task = _tls_worker->cache.back();
+                _tls_worker->cache.pop_back();
+                *task = TaskFunction(std::forward<F>(function));
+                return task;
+            }
+            return new TaskFunction(std::forward<F>(function));
+        }
+
+        void recycle(TaskFunction* task) {
+            task->reset();
+            if (_tls_pool == this && _tls_worker->cache.size() < MAX_CACHED_TASKS) {
+                _tls_worker->cache.push_back(task);
+            } else {
+                delete task;
+            }
+        }
+
+        static void runSafely(TaskFunction& task) {
+            try {
+                task();
+            } catch (const std::exception& e) {
+                Logger::log(FMT::format("ThreadPool: Task failed! "
+                                        "Exception: {}", e.what()), Logger::Error);
+            }
+        }
+
+        void execute(TaskFunction* task) {
+            _running_thread_count.fetch_add(1, std::memory_order_acq_rel);
+            runSafely(*task);
+            _running_thread_count.fetch_sub(1, std::memory_order_acq_rel);
+            recycle(task);
+            finishOne();
+        }
+
+        void finishOne(size_t count = 1) {
+            if (_pending.fetch_sub(count, std::memory_order_acq_rel) == count) {
+                std::lock_guard<std::mutex> lock(_idle_mutex);
+                _idle_cv.notify_all();
+            }
+        }
+
+        void clearTasks() {
+            std::vector<TaskFunction*> cleared;
+            {
+                std::lock_guard<std::mutex> lock(_inject_mutex);
+                for (size_t i = 0; i < _inject_queues.size(); ++i) {
+                    cleared.insert(cleared.end(), _inject_queues[i].begin(), _inject_queues[i].end());
+                    _inject_queues[i].clear();
+                    _inject_count[i].store(0, std::memory_order_release);
+                }
+            }
+            TaskFunction* task;
+            for (auto& worker : _workers) {
+                while (worker->deque.steal(task)) cleared.push_back(task);
+            }
+            /// Destroy the tasks without holding the lock, the destructors may append new tasks.
+            for (auto item : cleared) delete item;
+            if (!cleared.empty()) finishOne(cleared.size());
+        }
+
+        static inline thread_local ThreadPool* _tls_pool{nullptr};
+        static inline thread_local Worker* _tls_worker{nullptr};
+        static inline thread_local uint32_t _tls_index{0};
+
+        std::vector<std::unique_ptr<Worker>> _workers;
         uint32_t _nums_of_threads;
         uint32_t _max_threads_count;
         std::atomic<uint32_t> _running_thread_count{0};
-        std::mutex _mutex;
-        std::condition_variable _condition_var;
-        std::queue<std::function<void()>> _waiting_queue;
+        std::atomic<size_t> _pending{0};
+        std::atomic<uint32_t> _steal_hint{0};
+        std::mutex _inject_mutex;
+        std::array<std::deque<TaskFunction*>, 3> _inject_queues;
+        std::array<std::atomic<size_t>, 3> _inject_count{};
+        std::mutex _sleep_mutex;
+        std::condition_variable _sleep_cv;
+        std::atomic<uint32_t> _sleepers{0};
+        std::atomic<uint64_t> _epoch{0};
+        std::mutex _idle_mutex;
+        std::condition_variable _idle_cv;
         std::atomic<bool> _running;
     };
 
+    /**
+     * \if EN
+     * @class MyEngine::TasksManager
+     * @brief Priority tasks queue running on a thread pool
+     * @details The tasks are kept in the priority queue until a worker is going to run one of them,
+     * so a task with higher priority added later still runs before the waiting tasks with lower priority.
+     * \endif
+     */
     class TasksManager : private ThreadPool {
     public:
-        enum Priority {
-            Low,
-            Medium,
-            High
-        };
+        using Priority = ThreadPool::Priority;
+        static constexpr Priority Low = ThreadPool::Low;
+        static constexpr Priority Medium = ThreadPool::Medium;
+        static constexpr Priority High = ThreadPool::High;
 
         struct Task {
             uint64_t id;
             Priority priority;
-            std::function<void()> function;
+            TaskFunction function;
         };
 
         struct TaskCmp {
-            bool operator()(Task& t1, Task& t2) {
+            bool operator()(const Task& t1, const Task& t2) const {
                 if (t1.priority < t2.priority) return true;
                 if (t2.priority < t1.priority) return false;
                 return t1.id > t2.id;
@@ -173,32 +510,117 @@ namespace MyEngine {
         explicit TasksManager(size_t max_tasks, size_t max_threads)
             : ThreadPool(max_tasks, max_threads) {}
 
-        void addTask(std::function<void()> function, Priority priority = Low) {
-            _tasks_queue.emplace(_next_id++, priority, std::move(function));
+        ~TasksManager() {
+            /// The dispatched tickets are referencing this object, remove them before the members are destroyed.
+            stopAll();
+        }
+
+        /// Add a task into the queue, it won't run until `start()` or `startAllTasks()` is called.
+        template<typename F>
+        void addTask(F&& function, Priority priority = Low) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            pushTask(TaskFunction(std::forward<F>(function)), priority);
+        }
+
+        /**
+         * \if EN
+         * @brief Add a task and start it immediately, return the future of its result
+         * @see ThreadPool::submit()
+         * \endif
+         */
+        template<typename F>
+        auto submit(F&& function, Priority priority = Low) {
+            auto [task, future] = packageTask(std::forward<F>(function), std::nullopt);
+            submitTask(TaskFunction(std::move(task)), priority);
+            return future;
+        }
+
+        template<typename F>
+        auto submit(F&& function, const CancellationToken& token, Priority priority = Low) {
+            auto [task, future] = packageTask(std::forward<F>(function), token);
+            submitTask(TaskFunction(std::move(task)), priority);
+            return future;
         }
 
         void startAllTasks() {
-            while (!_tasks_queue.empty()) {
-                auto top = _tasks_queue.top();
-                append(top.function);
-                _tasks_queue.pop();
+            size_t count;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                count = _tasks_queue.size() - _tickets;
+                _tickets += count;
             }
+            for (size_t i = 0; i < count; ++i) dispatchTicket();
         }
 
         void start() {
-            if (_tasks_queue.empty()) return;
-            auto top = _tasks_queue.top();
-            append(top.function);
-            _tasks_queue.pop();
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_tasks_queue.size() == _tickets) return;
+                _tickets += 1;
+            }
+            dispatchTicket();
         }
 
         void stopAllTasks() { ThreadPool::wait(true); }
         void wait() { ThreadPool::wait(); }
 
-        [[nodiscard]] size_t tasksCount() const { return _tasks_queue.size(); }
+        [[nodiscard]] size_t tasksCount() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _tasks_queue.size() - _tickets;
+        }
         [[nodiscard]] size_t runningTasks() const { return runningThreadsCount(); }
     private:
-        std::priority_queue<Task, std::vector<Task>, TaskCmp> _tasks_queue;
+        /// Every started task appends a ticket to the pool, the ticket runs the task with the highest priority.
+        struct Ticket {
+            explicit Ticket(TasksManager* m) : manager(m) {}
+            Ticket(Ticket&& other) noexcept : manager(std::exchange(other.manager, nullptr)) {}
+            ~Ticket() { if (manager) manager->dropTicket(); }
+            void operator()() { std::exchange(manager, nullptr)->runNext(); }
+            TasksManager* manager;
+        };
+
+        void pushTask(TaskFunction&& function, Priority priority) {
+            _tasks_queue.emplace_back(_next_id++, priority, std::move(function));
+            std::push_heap(_tasks_queue.begin(), _tasks_queue.end(), TaskCmp());
+        }
+
+        bool popTask(Task& task) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_tickets || _tasks_queue.empty()) return false;
+            _tickets -= 1;
+            std::pop_heap(_tasks_queue.begin(), _tasks_queue.end(), TaskCmp());
+            task = std::move(_tasks_queue.back());
+            _tasks_queue.pop_back();
+            return true;
+        }
+
+        void submitTask(TaskFunction&& function, Priority priority) {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                pushTask(std::move(function), priority);
+                _tickets += 1;
+            }
+            dispatchTicket();
+        }
+
+        void dispatchTicket() {
+            append(Ticket(this));
+        }
+
+        void runNext() {
+            Task task{};
+            if (popTask(task)) task.function();
+        }
+
+        void dropTicket() {
+            /// The ticket is removed from the pool, so is the task it would run.
+            Task task{};
+            popTask(task);
+        }
+
+        mutable std::mutex _mutex;
+        std::vector<Task> _tasks_queue;
+        size_t _tickets{0};
         uint64_t _next_id{1};
     };
 }
@@ -0,0 +1,347 @@
+
+#include "TimerScheduler.h"
+#include "ThreadPool.h"
+#include "Utils/Clock.h"
+#include "Utils/Logger.h"
+
+namespace MyEngine {
+    namespace {
+        thread_local const void* current_job{nullptr};
+    }
+
+    TimerScheduler::TimerScheduler() {
+        for (auto& level : _slots) level.fill(UINT32_MAX);
+        _current_tick = currentTick();
+    }
+
+    TimerScheduler::~TimerScheduler() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _quit = true;
+        }
+        _cond.notify_all();
+        if (_thread.joinable()) _thread.join();
+    }
+
+    TimerScheduler::Handle TimerScheduler::schedule(uint64_t delay_ns, uint64_t interval_ns, uint32_t count,
+                                                    Callback callback, Dispatch dispatch) {
+        if (!callback) {
+            Logger::log("TimerScheduler: The callback is not valid!", Logger::Warn);
+            return {};
+        }
+        if (dispatch == Pool && !_pool) {
+            Logger::log("TimerScheduler: No thread pool is set! It will be dispatched on the scheduler thread!",
+                        Logger::Warn);
+            dispatch = SchedulerThread;
+        }
+        Handle handle;
+        bool wake_up;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            uint32_t index;
+            if (_free_list.empty()) {
+                index = static_cast<uint32_t>(_entries.size());
+                _entries.emplace_back();
+            } else {
+                index = _free_list.back();
+                _free_list.pop_back();
+            }
+            auto& entry = _entries[index];
+            entry.job = std::make_shared<Job>();
+            entry.job->callback = std::move(callback);
+            entry.interval = std::max<uint64_t>(interval_ns / TICK_NS, 1);
+            entry.remaining = count;
+            entry.dispatch = dispatch;
+            /// The current tick is already expired, so the first call is at the next tick at least.
+            entry.deadline = _current_tick + std::max<uint64_t>(delay_ns / TICK_NS, 1);
+            link(index);
+            _count += 1;
+            handle = {index, entry.generation};
+            wake_up = (_mode == OwnThread);
+            if (wake_up && !_thread.joinable()) {
+                _thread = std::thread(&TimerScheduler::running, this);
+            }
+        }
+        if (wake_up) _cond.notify_one();
+        return handle;
+    }
+
+    bool TimerScheduler::cancel(Handle handle) {
+        std::shared_ptr<Job> job;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (handle.index >= _entries.size()) return false;
+            auto& entry = _entries[handle.index];
+            if (entry.generation != handle.generation || !entry.job) return false;
+            job = entry.job;
+            release(handle.index);
+        }
+        job->cancelled.store(true);
+        /// Wait for the callback which is running on other threads, but never wait for itself.
+        if (current_job != job.get()) {
+            for (auto running = job->running.load(); running; running = job->running.load()) {
+                job->running.wait(running);
+            }
+        }
+        return true;
+    }
+
+    bool TimerScheduler::isScheduled(Handle handle) const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return handle.index < _entries.size() && _entries[handle.index].generation == handle.generation
+               && _entries[handle.index].job && !_entries[handle.index].finishing;
+    }
+
+    size_t TimerScheduler::scheduledCount() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _count;
+    }
+
+    void TimerScheduler::setServiceMode(ServiceMode mode) {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_mode == mode) return;
+            _mode = mode;
+            if (_mode == OwnThread && _count && !_thread.joinable()) {
+                _thread = std::thread(&TimerScheduler::running, this);
+            }
+        }
+        _cond.notify_all();
+        if (mode == MainLoop && _thread.joinable()) _thread.join();
+    }
+
+    TimerScheduler::ServiceMode TimerScheduler::serviceMode() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _mode;
+    }
+
+    void TimerScheduler::setDispatchPool(ThreadPool *pool) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pool = pool;
+    }
+
+    void TimerScheduler::setNotifier(Notifier notifier) {
+        _notifier.store(notifier);
+    }
+
+    uint64_t TimerScheduler::nextDeadlineNS() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_count) return UINT64_MAX;
+        auto next = nextWakeTick();
+        return next == UINT64_MAX ? UINT64_MAX : next * TICK_NS;
+    }
+
+    void TimerScheduler::update() {
+        Expired expired;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_mode != MainLoop) return;
+            advance(currentTick(), expired);
+        }
+        dispatch(expired);
+    }
+
+    void TimerScheduler::dispatchMainThread() {
+        if (!_has_main_jobs.load(std::memory_order_acquire)) return;
+        {
+            std::lock_guard<std::mutex> lock(_main_mutex);
+            _main_running_jobs.swap(_main_jobs);
+            _has_main_jobs.store(false, std::memory_order_release);
+        }
+        for (auto& expired : _main_running_jobs) {
+            runJob(expired.job);
+            finishJob(expired);
+        }
+        _main_running_jobs.clear();
+        notify();
+    }
+
+    void TimerScheduler::running() {
+        Expired expired;
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (!_quit && _mode == OwnThread) {
+            if (!_count) {
+                _cond.wait(lock, [this] { return _quit || _mode != OwnThread || _count; });
+                continue;
+            }
+            auto now = currentTick();
+            if (now > _current_tick) {
+                advance(now, expired);
+                if (!expired.empty()) {
+                    lock.unlock();
+                    dispatch(expired);
+                    lock.lock();
+                }
+                continue;
+            }
+            auto next = nextWakeTick();
+            auto wait_ns = (next > now ? next - now : 1) * TICK_NS;
+            /// The virtual clock doesn't follow the system clock, so check it more frequently.
+            if (Clock::isVirtual()) wait_ns = std::min<uint64_t>(wait_ns, 1000000);
+            _cond.wait_for(lock, std::chrono::nanoseconds(wait_ns));
+        }
+    }
+
+    uint64_t TimerScheduler::currentTick() const {
+        return Clock::ticksNS() / TICK_NS;
+    }
+
+    void TimerScheduler::advance(uint64_t now_tick, Expired& expired) {
+        while (_current_tick < now_tick) {
+            auto next = nextWakeTick();
+            if (next > now_tick) {
+                _current_tick = now_tick;
+                break;
+            }
+            /// Skip the empty ticks, nothing is expired or cascaded before the next wake tick.
+            _current_tick = std::max(_current_tick + 1, next);
+            for (uint32_t level = 1; level < LEVELS; ++level) {
+                if (_current_tick & ((1ull << (level * SLOT_BITS)) - 1)) break;
+                auto slot = (_current_tick >> (level * SLOT_BITS)) & (SLOTS - 1);
+                auto index = _slots[level][slot];
+                _slots[level][slot] = UINT32_MAX;
+                _occupied[level] &= ~(1ull << slot);
+                while (index != UINT32_MAX) {
+                    auto next_index = _entries[index].next;
+                    _entries[index].linked = false;
+                    link(index);
+                    index = next_index;
+                }
+            }
+            auto slot = _current_tick & (SLOTS - 1);
+            auto index = _slots[0][slot];
+            _slots[0][slot] = UINT32_MAX;
+            _occupied[0] &= ~(1ull << slot);
+            while (index != UINT32_MAX) {
+                auto& entry = _entries[index];
+                auto next_index = entry.next;
+                entry.linked = false;
+                if (entry.remaining == 1) {
+                    /// Keep the job in the entry until the call returns, so cancelling it still waits for it.
+                    expired.push_back({entry.job, entry.dispatch, index});
+                    entry.finishing = true;
+                    _count -= 1;
+                } else {
+                    expired.push_back({entry.job, entry.dispatch});
+                    if (entry.remaining) entry.remaining -= 1;
+                    entry.deadline = std::max(entry.deadline + entry.interval, _current_tick + 1);
+                    link(index);
+                }
+                index = next_index;
+            }
+        }
+    }
+
+    uint64_t TimerScheduler::nextWakeTick() const {
+        uint64_t next = UINT64_MAX;
+        for (uint32_t level = 0; level < LEVELS; ++level) {
+            if (!_occupied[level]) continue;
+            auto shift = level * SLOT_BITS;
+            auto cur = _current_tick >> shift;
+            auto from = (cur + 1) & (SLOTS - 1);
+            auto k = std::countr_zero(std::rotr(_occupied[level], static_cast<int>(from)));
+            /// Level 0 expires at the slot, others are cascaded at the beginning of the slot.
+            next = std::min(next, (cur + 1 + k) << shift);
+        }
+        return next;
+    }
+
+    void TimerScheduler::link(uint32_t index) {
+        auto& entry = _entries[index];
+        if (entry.deadline < _current_tick) entry.deadline = _current_tick;
+        auto delta = entry.deadline - _current_tick;
+        if (delta >= MAX_RANGE) {
+            entry.deadline = _current_tick + MAX_RANGE - 1;
+            delta = MAX_RANGE - 1;
+        }
+        uint8_t level = 0;
+        while (level + 1u < LEVELS && delta >= (1ull << ((level + 1) * SLOT_BITS))) level += 1;
+        auto slot = static_cast<uint8_t>((entry.deadline >> (level * SLOT_BITS)) & (SLOTS - 1));
+        auto& head = _slots[level][slot];
+        entry.level = level;
+        entry.slot = slot;
+        entry.prev = UINT32_MAX;
+        entry.next = head;
+        if (head != UINT32_MAX) _entries[head].prev = index;
+        head = index;
+        entry.linked = true;
+        _occupied[level] |= (1ull << slot);
+    }
+
+    void TimerScheduler::unlink(uint32_t index) {
+        auto& entry = _entries[index];
+        if (!entry.linked) return;
+        if (entry.prev != UINT32_MAX) {
+            _entries[entry.prev].next = entry.next;
+        } else {
+            _slots[entry.level][entry.slot] = entry.next;
+            if (entry.next == UINT32_MAX) _occupied[entry.level] &= ~(1ull << entry.slot);
+        }
+        if (entry.next != UINT32_MAX) _entries[entry.next].prev = entry.prev;
+        entry.prev = entry.next = UINT32_MAX;
+        entry.linked = false;
+    }
+
+    void TimerScheduler::release(uint32_t index) {
+        unlink(index);
+        auto& entry = _entries[index];
+        entry.job.reset();
+        entry.generation += 1;
+        _free_list.push_back(index);
+        if (!entry.finishing) _count -= 1;
+        entry.finishing = false;
+    }
+
+    void TimerScheduler::dispatch(Expired& expired) {
+        bool wake_up = false;
+        for (auto& job : expired) {
+            if (job.dispatch == MainThread) {
+                std::lock_guard<std::mutex> lock(_main_mutex);
+                _main_jobs.push_back(std::move(job));
+                _has_main_jobs.store(true, std::memory_order_release);
+                wake_up = true;
+            } else if (job.dispatch == Pool && _pool) {
+                _pool->append([this, job] {
+                    runJob(job.job);
+                    finishJob(job);
+                    notify();
+                });
+            } else {
+                runJob(job.job);
+                finishJob(job);
+                wake_up = true;
+            }
+        }
+        expired.clear();
+        if (wake_up) notify();
+    }
+
+    void TimerScheduler::runJob(const std::shared_ptr<Job>& job) {
+        if (job->cancelled.load()) return;
+        job->running.fetch_add(1);
+        /// It may be cancelled while increasing the counter.
+        if (!job->cancelled.load()) {
+            auto prev_job = current_job;
+            current_job = job.get();
+            try {
+                job->callback();
+            } catch (const std::exception& e) {
+                Logger::log(Logger::Error, "TimerScheduler: Callback failed! Exception: {}", e.what());
+            }
+            current_job = prev_job;
+        }
+        job->running.fetch_sub(1);
+        job->running.notify_all();
+    }
+
+    void TimerScheduler::finishJob(const ExpiredJob &expired) {
+        if (expired.last_index == UINT32_MAX) return;
+        std::lock_guard<std::mutex> lock(_mutex);
+        /// It is already released if it is cancelled.
+        if (_entries[expired.last_index].job == expired.job) release(expired.last_index);
+    }
+
+    void TimerScheduler::notify() const {
+        if (auto notifier = _notifier.load()) notifier();
+    }
+}
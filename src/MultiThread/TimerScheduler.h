@@ -0,0 +1,149 @@
+#pragma once
+#ifndef MYENGINE_MULTITHREAD_TIMERSCHEDULER_H
+#define MYENGINE_MULTITHREAD_TIMERSCHEDULER_H
+#include "../Libs.h"
+#include "../Template/Singleton.h"
+
+namespace MyEngine {
+    class ThreadPool;
+
+    /**
+     * \if EN
+     * @class MyEngine::TimerScheduler
+     * @brief Hierarchical timing wheel shared by all `Timer` and `Trigger` objects
+     * @details The wheel has 6 levels of 64 slots with a tick of 250 us, so inserting and cancelling
+     * a timer costs O(1) and the wheel covers about 198 days.
+     * @details By default the wheel is serviced by one scheduler thread which sleeps until the next deadline.
+     * It can also be serviced by the main loop of the engine, see `setServiceMode()`.
+     * @details The callbacks can be dispatched on the scheduler thread, on the main thread or on a thread pool.
+     * \endif
+     */
+    class TimerScheduler : public Template::Singleton<TimerScheduler> {
+        friend class Template::Singleton<TimerScheduler>;
+    public:
+        enum Dispatch : uint8_t {
+            SchedulerThread,
+            MainThread,
+            Pool
+        };
+        enum ServiceMode : uint8_t {
+            OwnThread,
+            MainLoop
+        };
+        struct Handle {
+            uint32_t index{UINT32_MAX};
+            uint32_t generation{0};
+            [[nodiscard]] bool isValid() const { return index != UINT32_MAX; }
+        };
+        using Callback = std::function<void()>;
+        using Notifier = void(*)();
+
+        static constexpr uint64_t TICK_NS = 250000;
+
+        TimerScheduler(TimerScheduler &&) = delete;
+        TimerScheduler(const TimerScheduler &) = delete;
+        TimerScheduler &operator=(TimerScheduler &&) = delete;
+        TimerScheduler &operator=(const TimerScheduler &) = delete;
+        ~TimerScheduler() override;
+
+        /**
+         * \if EN
+         * @brief Schedule a callback
+         * @param delay_ns    The delay before the first call
+         * @param interval_ns The interval between two calls
+         * @param count       The number of calls, `0` means repeating until it is cancelled
+         * @param callback    The callback function
+         * @param dispatch    Where the callback will be called
+         * @return Return the handle used to cancel the callback
+         * \endif
+         */
+        Handle schedule(uint64_t delay_ns, uint64_t interval_ns, uint32_t count,
+                        Callback callback, Dispatch dispatch = SchedulerThread);
+        /**
+         * \if EN
+         * @brief Cancel the scheduled callback
+         * @details If the callback is running on another thread, it waits until the callback returns.
+         * \endif
+         */
+        bool cancel(Handle handle);
+        [[nodiscard]] bool isScheduled(Handle handle) const;
+        [[nodiscard]] size_t scheduledCount() const;
+
+        void setServiceMode(ServiceMode mode);
+        [[nodiscard]] ServiceMode serviceMode() const;
+        void setDispatchPool(ThreadPool* pool);
+        /// Set the function called after the callbacks are called, the engine uses it to invalidate the windows.
+        void setNotifier(Notifier notifier);
+        /// Get the next tick of the wheel on the engine clock in nanoseconds, `UINT64_MAX` if nothing is scheduled.
+        [[nodiscard]] uint64_t nextDeadlineNS() const;
+
+        /// Advance the wheel, only works in `MainLoop` mode. It is called by the engine in every loop.
+        void update();
+        /// Call the expired callbacks dispatched to `MainThread`. It is called by the engine in every loop.
+        void dispatchMainThread();
+
+    private:
+        struct Job {
+            Callback callback;
+            std::atomic<uint32_t> running{0};
+            std::atomic<bool> cancelled{false};
+        };
+        struct Entry {
+            std::shared_ptr<Job> job;
+            uint64_t deadline{0}, interval{0};
+            uint32_t remaining{0};
+            uint32_t generation{0};
+            uint32_t prev{UINT32_MAX}, next{UINT32_MAX};
+            uint8_t level{0}, slot{0};
+            Dispatch dispatch{SchedulerThread};
+            bool linked{false};
+            /// The last call is dispatched, it is not scheduled anymore but the handle still cancels it.
+            bool finishing{false};
+        };
+        struct ExpiredJob {
+            std::shared_ptr<Job> job;
+            Dispatch dispatch{SchedulerThread};
+            /// The entry released after the last call, `UINT32_MAX` if it is called again later.
+            uint32_t last_index{UINT32_MAX};
+        };
+        using Expired = std::vector<ExpiredJob>;
+
+        static constexpr uint32_t LEVELS = 6;
+        static constexpr uint32_t SLOT_BITS = 6;
+        static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+        static constexpr uint64_t MAX_RANGE = 1ull << (LEVELS * SLOT_BITS);
+
+        explicit TimerScheduler();
+        void running();
+        [[nodiscard]] uint64_t currentTick() const;
+        void advance(uint64_t now_tick, Expired& expired);
+        [[nodiscard]] uint64_t nextWakeTick() const;
+        void link(uint32_t index);
+        void unlink(uint32_t index);
+        void release(uint32_t index);
+        void dispatch(Expired& expired);
+        static void runJob(const std::shared_ptr<Job>& job);
+        /// Release the entry of the job after its last call.
+        void finishJob(const ExpiredJob& expired);
+        void notify() const;
+
+        mutable std::mutex _mutex;
+        std::condition_variable _cond;
+        std::thread _thread;
+        bool _quit{false};
+        ServiceMode _mode{OwnThread};
+        ThreadPool* _pool{nullptr};
+        std::atomic<Notifier> _notifier{nullptr};
+        uint64_t _current_tick{0};
+        size_t _count{0};
+        std::vector<Entry> _entries;
+        std::vector<uint32_t> _free_list;
+        std::array<std::array<uint32_t, SLOTS>, LEVELS> _slots{};
+        std::array<uint64_t, LEVELS> _occupied{};
+        std::mutex _main_mutex;
+        std::atomic<bool> _has_main_jobs{false};
+        std::vector<ExpiredJob> _main_jobs, _main_running_jobs;
+    };
+}
+
+#endif //MYENGINE_MULTITHREAD_TIMERSCHEDULER_H
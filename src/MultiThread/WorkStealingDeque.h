@@ -0,0 +1,113 @@
+#pragma once
+#ifndef MYENGINE_MULTITHREAD_WORKSTEALINGDEQUE_H
+#define MYENGINE_MULTITHREAD_WORKSTEALINGDEQUE_H
+#include "../Libs.h"
+
+namespace MyEngine {
+    /**
+     * \if EN
+     * @class MyEngine::WorkStealingDeque
+     * @brief Chase-Lev work-stealing deque
+     * @details The owner thread pushes and pops at the bottom, other threads steal from the top without locks.
+     * The ring buffer grows automatically, old buffers are released when the deque is destroyed
+     * because a thief may still read from them.
+     * @note `push()` and `pop()` can only be called by the owner thread, `T` must be trivially copyable (e.g. pointers).
+     * \endif
+     */
+    template<typename T>
+    class WorkStealingDeque {
+        static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque: T must be trivially copyable!");
+    public:
+        explicit WorkStealingDeque(int64_t capacity = 256) {
+            int64_t real_capacity = 1;
+            while (real_capacity < capacity) real_capacity <<= 1;
+            _arrays.emplace_back(std::make_unique<Array>(real_capacity));
+            _array.store(_arrays.back().get(), std::memory_order_relaxed);
+        }
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque(WorkStealingDeque&&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+        ~WorkStealingDeque() = default;
+
+        void push(T item) {
+            auto b = _bottom.load(std::memory_order_relaxed);
+            auto t = _top.load(std::memory_order_acquire);
+            auto array = _array.load(std::memory_order_relaxed);
+            if (b - t > array->capacity - 1) {
+                _arrays.emplace_back(array->grow(b, t));
+                array = _arrays.back().get();
+                _array.store(array, std::memory_order_release);
+            }
+            array->put(b, item);
+            std::atomic_thread_fence(std::memory_order_release);
+            _bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        bool pop(T& item) {
+            auto b = _bottom.load(std::memory_order_relaxed) - 1;
+            auto array = _array.load(std::memory_order_relaxed);
+            _bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto t = _top.load(std::memory_order_relaxed);
+            if (t > b) {
+                _bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+            item = array->get(b);
+            if (t == b) {
+                /// The last item, race with thieves.
+                bool won = _top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                        std::memory_order_relaxed);
+                _bottom.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+
+        bool steal(T& item) {
+            auto t = _top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto b = _bottom.load(std::memory_order_acquire);
+            if (t >= b) return false;
+            auto array = _array.load(std::memory_order_acquire);
+            auto value = array->get(t);
+            if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return false;
+            }
+            item = value;
+            return true;
+        }
+
+        [[nodiscard]] bool empty() const {
+            return _bottom.load(std::memory_order_relaxed) <= _top.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] size_t size() const {
+            auto b = _bottom.load(std::memory_order_relaxed);
+            auto t = _top.load(std::memory_order_relaxed);
+            return b > t ? static_cast<size_t>(b - t) : 0;
+        }
+
+    private:
+        struct Array {
+            explicit Array(int64_t cap) : capacity(cap), mask(cap - 1), buffer(new std::atomic<T>[cap]) {}
+            T get(int64_t index) const { return buffer[index & mask].load(std::memory_order_relaxed); }
+            void put(int64_t index, T item) { buffer[index & mask].store(item, std::memory_order_relaxed); }
+            Array* grow(int64_t b, int64_t t) const {
+                auto array = new Array(capacity * 2);
+                for (auto i = t; i < b; ++i) array->put(i, get(i));
+                return array;
+            }
+            int64_t capacity, mask;
+            std::unique_ptr<std::atomic<T>[]> buffer;
+        };
+
+        alignas(64) std::atomic<int64_t> _top{0};
+        alignas(64) std::atomic<int64_t> _bottom{0};
+        alignas(64) std::atomic<Array*> _array{nullptr};
+        std::vector<std::unique_ptr<Array>> _arrays;
+    };
+}
+
+#endif //MYENGINE_MULTITHREAD_WORKSTEALINGDEQUE_H
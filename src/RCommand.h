@@ -2,14 +2,32 @@
 #define MYENGINE_RCOMMAND_H
 
 #include "Renderer/CommandFactory.h"
+#include "Utils/FrameArena.h"
 
 namespace MyEngine {
     template<typename T, typename ...Args>
     void Renderer::addCommand(Args... args) {
         auto ptr = RenderCommand::CommandFactory::acquire<T>(args...);
-        if (ptr) _cmd_list.push_back(std::unique_ptr<T>(ptr));
+        if (!ptr) return;
+        constexpr bool is_view = std::is_same_v<T, RenderCommand::ViewPortCMD> || std::is_same_v<T, RenderCommand::ClipViewCMD>;
+        bool native = isNativeCommand();
+        /// The glyph quads are absolute, so only the commands drawn into the same list end the batch.
+        if constexpr (!is_view) {
+            if (_glyph_pending && _glyph_native == native) flushGlyphs();
+        }
+        if (native) {
+            _native_cmd_list.push_back(std::unique_ptr<T>(ptr));
+        } else {
+            _cmd_list.push_back(std::unique_ptr<T>(ptr));
+        }
     }
     
+    template<typename... Args>
+    void Renderer::drawDebugText(const Vector2& position, const SDL_Color& color,
+                                 FMT::format_string<Args...> fmt, Args&&... args) {
+        drawDebugText(FrameArena::global()->format(fmt, std::forward<Args>(args)...), position, color);
+    }
+
     template<typename T, typename ...Args>
     void Renderer::addCustomCommand(Args... args) {
         addCommand<T>(_renderer, args...);
@@ -1,5 +1,6 @@
 
 #include "BaseCommand.h"
+#include "../Utils/FrameArena.h"
 
 namespace MyEngine {
     namespace RenderCommand {
@@ -112,22 +113,16 @@ namespace MyEngine {
 
         TextureCMD::TextureCMD(SDL_Renderer *renderer, SDL_Texture *texture, TextureProperty *property,
                                BaseCommand::Mode mode, uint32_t count,
-                               const std::vector<TextureProperty*>& properties,
-                               const std::vector<SDL_Texture*>& textures)
-                           : BaseCommand(renderer, "Texture"), _texture(texture), _property(property),
-                                _mode(mode), _count(count), _properties(properties), _textures(textures) {
-            if (_mode == Mode::Single) {
-                assert(_texture != nullptr && _property != nullptr);
-            } else if (_mode == Mode::Multiple) {
-                assert(_texture != nullptr && _count > 0 && _properties.size() == _count);
-            } else if (_mode == Mode::Custom) {
-                assert(_count > 0 && _properties.size() == _count && _textures.size() == _count);
-            }
+                               std::span<TextureProperty* const> properties,
+                               std::span<SDL_Texture* const> textures,
+                               std::span<const TextureProperty> property_values)
+                           : BaseCommand(renderer, "Texture") {
+            reset(renderer, texture, property, mode, count, properties, textures, property_values);
         }
 
         void TextureCMD::reset(SDL_Renderer *renderer, SDL_Texture *texture, TextureProperty *textureProperty,
-                       BaseCommand::Mode mode, uint32_t count, const std::vector<TextureProperty*>& properties,
-                       const std::vector<SDL_Texture*>& textures) {
+                       BaseCommand::Mode mode, uint32_t count, std::span<TextureProperty* const> properties,
+                       std::span<SDL_Texture* const> textures, std::span<const TextureProperty> property_values) {
             _renderer = renderer;
             _texture = texture;
             _property = textureProperty;
@@ -135,30 +130,29 @@ namespace MyEngine {
             _count = count;
             _properties = properties;
             _textures = textures;
+            _property_values = property_values;
+            auto prop_count = _property_values.empty() ? _properties.size() : _property_values.size();
             if (_mode == Mode::Single) {
                 assert(_texture != nullptr && _property != nullptr);
             } else if (_mode == Mode::Multiple) {
-                assert(_texture != nullptr && _count > 0 && _properties.size() == _count);
+                assert(_texture != nullptr && _count > 0 && prop_count == _count);
             } else if (_mode == Mode::Custom) {
-                assert(_count > 0 && _properties.size() == _count && _textures.size() == _count);
+                assert(_count > 0 && prop_count == _count && _textures.size() == _count);
             }
         }
 
         void TextureCMD::exec() {
             if (_mode == Mode::Single) {
                 render(_texture, _property);
-            } else if (_mode == Mode::Multiple) {
-                for (int i = 0; i < _count; ++i) {
-                    render(_texture, _properties[i]);
-                }
-            } else if (_mode == Mode::Custom) {
-                for (int i = 0; i < _count; ++i) {
-                    render(_textures[i], _properties[i]);
-                }
+                return;
+            }
+            for (uint32_t i = 0; i < _count; ++i) {
+                auto texture = (_mode == Mode::Custom ? _textures[i] : _texture);
+                render(texture, _property_values.empty() ? _properties[i] : &_property_values[i]);
             }
         }
         
-        void TextureCMD::render(SDL_Texture *texture, TextureProperty* prop) {
+        void TextureCMD::render(SDL_Texture *texture, const TextureProperty* prop) {
             auto color = prop->color_alpha;
             auto _ret = SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
             if (!_ret) {
@@ -189,28 +183,79 @@ namespace MyEngine {
         }
 
 
-        PointCMD::PointCMD(SDL_Renderer *renderer, Graphics::Point *point, BaseCommand::Mode mode, uint32_t count,
-                           const std::vector<Graphics::Point*>& point_list)
-               : BaseCommand(renderer, "Point"), _point(point),
-                 _mode(mode), _count(count), _points(point_list) {
-            if (_mode == Mode::Single) {
-                assert(_point != nullptr);
-            } else if (_mode == Mode::Multiple) {
-                assert(_count > 0 && point_list.size() == _count);
+        SpriteBatchCMD::SpriteBatchCMD(SDL_Renderer *renderer, SDL_Texture *texture,
+                                       std::span<const SDL_FRect> dest_rects, std::span<const SDL_FRect> src_rects,
+                                       std::span<const SDL_FColor> colors)
+                           : BaseCommand(renderer, "SpriteBatch") {
+            reset(renderer, texture, dest_rects, src_rects, colors);
+        }
+
+        void SpriteBatchCMD::reset(SDL_Renderer *renderer, SDL_Texture *texture,
+                                   std::span<const SDL_FRect> dest_rects, std::span<const SDL_FRect> src_rects,
+                                   std::span<const SDL_FColor> colors) {
+            _renderer = renderer;
+            _texture = texture;
+            _dest_rects = dest_rects;
+            _src_rects = src_rects;
+            _colors = colors;
+            assert(_texture != nullptr);
+            assert(_src_rects.empty() || _src_rects.size() == _dest_rects.size());
+            assert(_colors.empty() || _colors.size() == _dest_rects.size());
+        }
+
+        void SpriteBatchCMD::exec() {
+            if (_dest_rects.empty()) return;
+            float tex_w = 1.f, tex_h = 1.f;
+            if (!_src_rects.empty()) SDL_GetTextureSize(_texture, &tex_w, &tex_h);
+            /// The vertices only live until the geometry is submitted, so they are built in the frame arena.
+            auto arena = FrameArena::global()->resource();
+            auto vertices = arena->allocateArray<SDL_Vertex>(_dest_rects.size() * 4);
+            auto indices = arena->allocateArray<int>(_dest_rects.size() * 6);
+            for (size_t i = 0; i < _dest_rects.size(); ++i) {
+                auto& dst = _dest_rects[i];
+                SDL_FRect uv{0.f, 0.f, 1.f, 1.f};
+                if (!_src_rects.empty()) {
+                    auto& src = _src_rects[i];
+                    uv = {src.x / tex_w, src.y / tex_h, src.w / tex_w, src.h / tex_h};
+                }
+                auto color = _colors.empty() ? SDL_FColor{1.f, 1.f, 1.f, 1.f} : _colors[i];
+                auto v = &vertices[i * 4];
+                v[0] = {{dst.x, dst.y}, color, {uv.x, uv.y}};
+                v[1] = {{dst.x + dst.w, dst.y}, color, {uv.x + uv.w, uv.y}};
+                v[2] = {{dst.x + dst.w, dst.y + dst.h}, color, {uv.x + uv.w, uv.y + uv.h}};
+                v[3] = {{dst.x, dst.y + dst.h}, color, {uv.x, uv.y + uv.h}};
+                auto base = static_cast<int>(i * 4);
+                auto idx = &indices[i * 6];
+                idx[0] = base; idx[1] = base + 1; idx[2] = base + 2;
+                idx[3] = base; idx[4] = base + 2; idx[5] = base + 3;
+            }
+            auto _ret = SDL_RenderGeometry(_renderer, _texture, vertices.data(), static_cast<int>(vertices.size()),
+                                           indices.data(), static_cast<int>(indices.size()));
+            if (!_ret) {
+                Logger::log(FMT::format("Renderer: Set render geometry failed! Exception: {}",
+                                        SDL_GetError()), Logger::Error);
             }
         }
 
+        PointCMD::PointCMD(SDL_Renderer *renderer, Graphics::Point *point, BaseCommand::Mode mode, uint32_t count,
+                           std::span<Graphics::Point* const> point_list, std::span<const Graphics::Point> point_values)
+               : BaseCommand(renderer, "Point") {
+            reset(renderer, point, mode, count, point_list, point_values);
+        }
+
         void PointCMD::reset(SDL_Renderer *renderer, Graphics::Point *point, BaseCommand::Mode mode, uint32_t count,
-                             const std::vector<Graphics::Point*>& point_list) {
+                             std::span<Graphics::Point* const> point_list,
+                             std::span<const Graphics::Point> point_values) {
             _renderer = renderer;
             _point = point;
             _mode = mode;
             _count = count;
             _points = point_list;
+            _point_values = point_values;
             if (_mode == Mode::Single) {
                 assert(_point != nullptr);
             } else if (_mode == Mode::Multiple) {
-                assert(_count > 0 && point_list.size() == _count);
+                assert(_count > 0 && (_point_values.empty() ? _points.size() : _point_values.size()) == _count);
             }
         }
 
@@ -218,13 +263,13 @@ namespace MyEngine {
             if (_mode == Mode::Single) {
                 render(_point);
             } else if (_mode == Mode::Multiple) {
-                for (int i = 0; i < _count; ++i) {
-                    render(_points[i]);
+                for (uint32_t i = 0; i < _count; ++i) {
+                    render(_point_values.empty() ? _points[i] : &_point_values[i]);
                 }
             }
         }
         
-        void PointCMD::render(Graphics::Point *point) {
+        void PointCMD::render(const Graphics::Point *point) {
             const auto color = point->color();
             const auto pos = point->position();
             auto _ret = SDL_SetRenderDrawColor(_renderer, color.r, color.g, color.b, color.a);
@@ -313,27 +358,25 @@ namespace MyEngine {
         }
 
         RectangleCMD::RectangleCMD(SDL_Renderer *renderer, Graphics::Rectangle *rect, BaseCommand::Mode mode,
-                                   uint32_t count, const std::vector<Graphics::Rectangle*>& rect_list)
-                                   : BaseCommand(renderer, "Rectangle"), _rect(rect),
-                                     _mode(mode), _count(count), _rects(rect_list) {
-            if (_mode == Mode::Single) {
-                assert(rect != nullptr);
-            } else if (_mode == Mode::Multiple) {
-                assert(_count > 0 && _rects.size() == _count);
-            }
+                                   uint32_t count, std::span<Graphics::Rectangle* const> rect_list,
+                                   std::span<const Graphics::Rectangle> rect_values)
+                                   : BaseCommand(renderer, "Rectangle") {
+            reset(renderer, rect, mode, count, rect_list, rect_values);
         }
 
         void RectangleCMD::reset(SDL_Renderer *renderer, Graphics::Rectangle *rect, BaseCommand::Mode mode,
-                                 uint32_t count, const std::vector<Graphics::Rectangle*>& rect_list) {
+                                 uint32_t count, std::span<Graphics::Rectangle* const> rect_list,
+                                 std::span<const Graphics::Rectangle> rect_values) {
             _renderer = renderer;
             _rect = rect;
             _mode = mode;
             _count = count;
             _rects = rect_list;
+            _rect_values = rect_values;
             if (_mode == Mode::Single) {
                 assert(rect != nullptr);
             } else if (_mode == Mode::Multiple) {
-                assert(_count > 0 && _rects.size() == _count);
+                assert(_count > 0 && (_rect_values.empty() ? _rects.size() : _rect_values.size()) == _count);
             }
         }
 
@@ -341,13 +384,13 @@ namespace MyEngine {
             if (_mode == Mode::Single) {
                 render(_rect);
             } else if (_mode == Mode::Multiple) {
-                for (int i = 0; i < _count; ++i) {
-                    render(_rects[i]);
+                for (uint32_t i = 0; i < _count; ++i) {
+                    render(_rect_values.empty() ? _rects[i] : &_rect_values[i]);
                 }
             }
         }
 
-        void RectangleCMD::render(Graphics::Rectangle *rect) {
+        void RectangleCMD::render(const Graphics::Rectangle *rect) {
             auto back_color = rect->backgroundColor();
             bool border = (rect->borderSize() > 0) && (rect->borderColor().a > 0);
             if (back_color.a > 0) {
@@ -524,41 +567,30 @@ namespace MyEngine {
         }
 
         TextCMD::TextCMD(SDL_Renderer *renderer, TTF_Text *text, const Vector2& position, BaseCommand::Mode mode,
-                         uint32_t count, const std::vector<Vector2 *> &position_list,
-                         const std::vector<TTF_Text *>& text_list)
-             : BaseCommand(renderer, "Text"), _text(text), _pos(position), _mode(mode),
-               _count(count) {
-            if (_mode == Mode::Single) {
-                assert(_text != nullptr);
-            } else if (_mode == Mode::Multiple) {
-                assert(_text != nullptr && _count > 0 && position_list.size() == _count);
-                _positions = position_list;
-            } else if (_mode == Mode::Custom) {
-                assert(_count > 0 && position_list.size() == _count && text_list.size() == _count);
-                for (int i = 0; i < _count; ++i) {
-                    _texts.emplace_back(text_list[i], position_list[i]);
-                }
-            }
+                         uint32_t count, std::span<Vector2* const> position_list,
+                         std::span<TTF_Text* const> text_list, std::span<const Vector2> position_values)
+             : BaseCommand(renderer, "Text") {
+            reset(renderer, text, position, mode, count, position_list, text_list, position_values);
         }
 
         void TextCMD::reset(SDL_Renderer *renderer, TTF_Text *text, const Vector2& position, BaseCommand::Mode mode,
-                            uint32_t count, const std::vector<Vector2 *> &position_list,
-                            std::vector<TTF_Text *> text_list) {
+                            uint32_t count, std::span<Vector2* const> position_list,
+                            std::span<TTF_Text* const> text_list, std::span<const Vector2> position_values) {
             _renderer = renderer;
             _text = text;
             _pos = position;
             _mode = mode;
             _count = count;
+            _positions = position_list;
+            _position_values = position_values;
+            _texts = text_list;
+            [[maybe_unused]] auto pos_count = _position_values.empty() ? _positions.size() : _position_values.size();
             if (_mode == Mode::Single) {
                 assert(_text != nullptr);
             } else if (_mode == Mode::Multiple) {
-                assert(_text != nullptr && _count > 0 && position_list.size() == _count);
-                _positions = position_list;
+                assert(_text != nullptr && _count > 0 && pos_count == _count);
             } else if (_mode == Mode::Custom) {
-                assert(_count > 0 && position_list.size() == _count && text_list.size() == _count);
-                for (int i = 0; i < _count; ++i) {
-                    _texts.emplace_back(text_list[i], position_list[i]);
-                }
+                assert(_count > 0 && pos_count == _count && _texts.size() == _count);
             }
         }
 
@@ -566,18 +598,17 @@ namespace MyEngine {
             if (_mode == Mode::Single) {
                 render(_text, &_pos);
             } else if (_mode == Mode::Multiple) {
-                for (int i = 0; i < _count; ++i) {
-                    render(_text, _positions[i]);
+                for (uint32_t i = 0; i < _count; ++i) {
+                    render(_text, positionAt(i));
                 }
             } else if (_mode == Mode::Custom) {
-                for (int i = 0; i < _count; ++i) {
-                    auto& text = _texts[i];
-                    render(text.text, text.position);
+                for (uint32_t i = 0; i < _count; ++i) {
+                    render(_texts[i], positionAt(i));
                 }
             }
         }
 
-        void TextCMD::render(TTF_Text *text, Vector2 *position) {
+        void TextCMD::render(TTF_Text *text, const Vector2 *position) {
             bool _ret = TTF_DrawRendererText(text, position->x, position->y);
             if (!_ret) {
                 Logger::log(FMT::format("Renderer: Set render text failed! Exception: {}",
@@ -585,21 +616,23 @@ namespace MyEngine {
             }
         }
 
+        const Vector2* TextCMD::positionAt(uint32_t index) const {
+            return _position_values.empty() ? _positions[index] : &_position_values[index];
+        }
+
 
-        DebugTextCMD::DebugTextCMD(SDL_Renderer *renderer, const std::string &text, const Vector2 &position,
+        DebugTextCMD::DebugTextCMD(SDL_Renderer *renderer, const char *text, const Vector2 &position,
                                    const SDL_Color& color, BaseCommand::Mode mode, uint32_t count,
-                                   const StringList &text_list, const std::vector<Vector2 *> &position_list)
-               : BaseCommand(renderer, "Debug"), _text(text), _position(position),
-                 _mode(mode), _count(count), _text_list(text_list), _pos_list(position_list) {
-            _render_color = color;
-            if (_mode == Mode::Multiple) {
-                assert(_count > 0 && (_text_list.size() == _count) && (_pos_list.size() == _count));
-            }
+                                   std::span<const char* const> text_list, std::span<Vector2* const> position_list,
+                                   std::span<const Vector2> position_values)
+               : BaseCommand(renderer, "Debug") {
+            reset(renderer, text, position, color, mode, count, text_list, position_list, position_values);
         }
 
-        void DebugTextCMD::reset(SDL_Renderer *renderer, const std::string &text, const Vector2 &position,
+        void DebugTextCMD::reset(SDL_Renderer *renderer, const char *text, const Vector2 &position,
                                  const SDL_Color& color, BaseCommand::Mode mode, uint32_t count,
-                                 const StringList &text_list, const std::vector<Vector2 *> &position_list) {
+                                 std::span<const char* const> text_list, std::span<Vector2* const> position_list,
+                                 std::span<const Vector2> position_values) {
             _renderer = renderer;
             _render_color = color;
             _text = text;
@@ -608,8 +641,10 @@ namespace MyEngine {
             _count = count;
             _text_list = text_list;
             _pos_list = position_list;
+            _pos_values = position_values;
             if (_mode == Mode::Multiple) {
-                assert(_count > 0 && (_text_list.size() == _count) && (_pos_list.size() == _count));
+                assert(_count > 0 && (_text_list.size() == _count)
+                       && ((_pos_values.empty() ? _pos_list.size() : _pos_values.size()) == _count));
             }
         }
 
@@ -617,20 +652,20 @@ namespace MyEngine {
             if (_mode == Mode::Single) {
                 render(_text, &_position);
             } else if (_mode == Mode::Multiple) {
-                for (int i = 0; i < _count; ++i) {
-                    render(_text_list[i], _pos_list[i]);
+                for (uint32_t i = 0; i < _count; ++i) {
+                    render(_text_list[i], _pos_values.empty() ? _pos_list[i] : &_pos_values[i]);
                 }
             }
         }
 
-        void DebugTextCMD::render(const std::string &text, Vector2 *position) {
+        void DebugTextCMD::render(const char *text, const Vector2 *position) {
             auto _ret = SDL_SetRenderDrawColor(_renderer, _render_color.r, _render_color.g,
                                                _render_color.b, _render_color.a);
             if (!_ret) {
                 Logger::log(FMT::format("Renderer: Set render draw color failed! Exception: {}",
                                         SDL_GetError()), Logger::Warn);
             }
-            _ret = SDL_RenderDebugText(_renderer, position->x, position->y, text.c_str());
+            _ret = SDL_RenderDebugText(_renderer, position->x, position->y, text);
             if (!_ret) {
                 Logger::log(FMT::format("Renderer: Set render debug text failed! Exception: {}",
                                         SDL_GetError()), Logger::Warn);
@@ -91,47 +91,77 @@ namespace MyEngine {
         public:
             explicit TextureCMD(SDL_Renderer *renderer, SDL_Texture *texture, TextureProperty *property,
                                 Mode mode = Mode::Single, uint32_t count = 0,
-                                const std::vector<TextureProperty*>& properties = {},
-                                const std::vector<SDL_Texture*>& textures = {});
+                                std::span<TextureProperty* const> properties = {},
+                                std::span<SDL_Texture* const> textures = {},
+                                std::span<const TextureProperty> property_values = {});
             ~TextureCMD() override = default;
 
             void reset(SDL_Renderer *renderer, SDL_Texture *texture, TextureProperty *textureProperty,
                        Mode mode = Mode::Single, uint32_t count = 0,
-                       const std::vector<TextureProperty*>& properties = {},
-                       const std::vector<SDL_Texture*>& textures = {});
+                       std::span<TextureProperty* const> properties = {},
+                       std::span<SDL_Texture* const> textures = {},
+                       std::span<const TextureProperty> property_values = {});
 
             void exec() override;
 
-            void render(SDL_Texture* texture, TextureProperty* prop);
+            void render(SDL_Texture* texture, const TextureProperty* prop);
 
         private:
             Mode _mode;
             uint32_t _count;
             SDL_Texture *_texture;
             TextureProperty *_property;
-            std::vector<SDL_Texture*> _textures;
-            std::vector<TextureProperty*> _properties;
+            std::span<SDL_Texture* const> _textures;
+            std::span<TextureProperty* const> _properties;
+            std::span<const TextureProperty> _property_values;
+        };
+
+        /**
+         * \if EN
+         * @brief Draw the instances of one texture with a single geometry call
+         * @details The instance buffer is structure-of-arrays, the source rectangles and the colors are optional.
+         * The buffers are not copied, they must be valid until the command is executed.
+         * \endif
+         */
+        class SpriteBatchCMD : public BaseCommand {
+        public:
+            explicit SpriteBatchCMD(SDL_Renderer *renderer, SDL_Texture *texture, std::span<const SDL_FRect> dest_rects,
+                                    std::span<const SDL_FRect> src_rects = {}, std::span<const SDL_FColor> colors = {});
+            ~SpriteBatchCMD() override = default;
+
+            void reset(SDL_Renderer *renderer, SDL_Texture *texture, std::span<const SDL_FRect> dest_rects,
+                       std::span<const SDL_FRect> src_rects = {}, std::span<const SDL_FColor> colors = {});
+
+            void exec() override;
+
+        private:
+            SDL_Texture *_texture;
+            std::span<const SDL_FRect> _dest_rects, _src_rects;
+            std::span<const SDL_FColor> _colors;
         };
 
         class PointCMD : public BaseCommand {
         public:
             explicit PointCMD(SDL_Renderer *renderer, Graphics::Point* point, Mode mode = Mode::Single,
-                              uint32_t count = 0, const std::vector<Graphics::Point*>& point_list = {});
+                              uint32_t count = 0, std::span<Graphics::Point* const> point_list = {},
+                              std::span<const Graphics::Point> point_values = {});
 
             ~PointCMD() override = default;
 
             void reset(SDL_Renderer *renderer, Graphics::Point* point, Mode mode = Mode::Single,
-                          uint32_t count = 0, const std::vector<Graphics::Point*>& point_list = {});
+                          uint32_t count = 0, std::span<Graphics::Point* const> point_list = {},
+                          std::span<const Graphics::Point> point_values = {});
 
             void exec() override;
 
-            void render(Graphics::Point* point);
+            void render(const Graphics::Point* point);
 
         private:
             Graphics::Point* _point;
             Mode _mode;
             uint32_t _count;
-            std::vector<Graphics::Point*> _points;
+            std::span<Graphics::Point* const> _points;
+            std::span<const Graphics::Point> _point_values;
         };
 
         class LineCMD : public BaseCommand {
@@ -158,19 +188,22 @@ namespace MyEngine {
         class RectangleCMD : public BaseCommand {
         public:
             explicit RectangleCMD(SDL_Renderer* renderer, Graphics::Rectangle* rect, Mode mode = Mode::Single,
-                                  uint32_t count = 0, const std::vector<Graphics::Rectangle*>& rect_list = {});
+                                  uint32_t count = 0, std::span<Graphics::Rectangle* const> rect_list = {},
+                                  std::span<const Graphics::Rectangle> rect_values = {});
 
             ~RectangleCMD() override = default;
 
             void reset(SDL_Renderer* renderer, Graphics::Rectangle* rect, Mode mode = Mode::Single,
-                       uint32_t count = 0, const std::vector<Graphics::Rectangle*>& rect_list = {});
+                       uint32_t count = 0, std::span<Graphics::Rectangle* const> rect_list = {},
+                       std::span<const Graphics::Rectangle> rect_values = {});
             void exec() override;
-            void render(Graphics::Rectangle* rect);
+            void render(const Graphics::Rectangle* rect);
         private:
             Mode _mode;
             Graphics::Rectangle* _rect;
             uint32_t _count;
-            std::vector<Graphics::Rectangle*> _rects;
+            std::span<Graphics::Rectangle* const> _rects;
+            std::span<const Graphics::Rectangle> _rect_values;
         };
 
         class TriangleCMD : public BaseCommand {
@@ -213,54 +246,58 @@ namespace MyEngine {
 
         class TextCMD : public BaseCommand {
         public:
-            struct Text {
-                TTF_Text* text;
-                Vector2* position;
-            };
             explicit TextCMD(SDL_Renderer* renderer, TTF_Text* text, const Vector2& position, Mode mode = Mode::Single,
-                             uint32_t count = 0, const std::vector<Vector2*>& position_list = {},
-                             const std::vector<TTF_Text *>& text_list = {});
+                             uint32_t count = 0, std::span<Vector2* const> position_list = {},
+                             std::span<TTF_Text* const> text_list = {},
+                             std::span<const Vector2> position_values = {});
 
             ~TextCMD() override = default;
 
             void reset(SDL_Renderer* renderer, TTF_Text* text, const Vector2& position, Mode mode = Mode::Single,
-                       uint32_t count = 0, const std::vector<Vector2*>& position_list = {},
-                       std::vector<TTF_Text*> text_list = {});
+                       uint32_t count = 0, std::span<Vector2* const> position_list = {},
+                       std::span<TTF_Text* const> text_list = {},
+                       std::span<const Vector2> position_values = {});
 
             void exec() override;
 
-            void render(TTF_Text* text, Vector2* position);
+            void render(TTF_Text* text, const Vector2* position);
 
         private:
+            [[nodiscard]] const Vector2* positionAt(uint32_t index) const;
             TTF_Text* _text;
             Vector2 _pos;
             Mode _mode;
             uint32_t _count;
-            std::vector<Vector2*> _positions;
-            std::vector<Text> _texts;
+            std::span<Vector2* const> _positions;
+            std::span<const Vector2> _position_values;
+            std::span<TTF_Text* const> _texts;
         };
 
+        /// The strings and the lists are stored in the frame arena, see `FrameArena`.
         class DebugTextCMD : public BaseCommand {
         public:
-            explicit DebugTextCMD(SDL_Renderer* renderer, const std::string& text, const Vector2& position,
+            explicit DebugTextCMD(SDL_Renderer* renderer, const char* text, const Vector2& position,
                                   const SDL_Color& color, Mode mode = Mode::Single, uint32_t count = 0,
-                                  const StringList& text_list = {}, const std::vector<Vector2*>& position_list = {});
+                                  std::span<const char* const> text_list = {},
+                                  std::span<Vector2* const> position_list = {},
+                                  std::span<const Vector2> position_values = {});
 
-            void reset(SDL_Renderer* renderer, const std::string& text, const Vector2& position, const SDL_Color& color,
-                       Mode mode = Mode::Single, uint32_t count = 0, const StringList& text_list = {},
-                       const std::vector<Vector2*>& position_list = {});
+            void reset(SDL_Renderer* renderer, const char* text, const Vector2& position, const SDL_Color& color,
+                       Mode mode = Mode::Single, uint32_t count = 0, std::span<const char* const> text_list = {},
+                       std::span<Vector2* const> position_list = {}, std::span<const Vector2> position_values = {});
 
             void exec() override;
 
-            void render(const std::string& text, Vector2* position);
+            void render(const char* text, const Vector2* position);
 
         private:
-            std::string _text;
+            const char* _text;
             Vector2 _position;
             Mode _mode;
             uint32_t _count;
-            StringList _text_list;
-            std::vector<Vector2*> _pos_list;
+            std::span<const char* const> _text_list;
+            std::span<Vector2* const> _pos_list;
+            std::span<const Vector2> _pos_values;
         };
     }
 }
@@ -0,0 +1,280 @@
+
+#include "GlyphAtlas.h"
+#include "../Utils/Logger.h"
+
+namespace MyEngine {
+    std::vector<GlyphAtlas*> GlyphAtlas::_atlases{};
+    uint64_t GlyphAtlas::_font_generation{0};
+
+    namespace {
+        /// The gap between the glyphs, so the linear filtering doesn't sample the neighbours.
+        constexpr int PADDING = 1;
+    }
+
+    size_t GlyphAtlas::KeyHash::operator()(const Key& key) const noexcept {
+        auto hash = std::hash<const void*>{}(key.font);
+        auto combine = [&hash](uint64_t value) {
+            hash ^= std::hash<uint64_t>{}(value) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        };
+        combine(static_cast<uint64_t>(key.size_bits) << 32 | key.codepoint);
+        combine(static_cast<uint64_t>(key.style) << 32 | static_cast<uint32_t>(key.outline));
+        return hash;
+    }
+
+    GlyphAtlas::GlyphAtlas(SDL_Renderer* renderer, int page_size, uint32_t max_pages)
+        : _renderer(renderer), _page_size(std::max(page_size, 64)), _max_pages(std::max(max_pages, 1u)) {
+        _atlases.push_back(this);
+    }
+
+    GlyphAtlas::~GlyphAtlas() {
+        for (auto page : _pages) SDL_DestroyTexture(page);
+        std::erase(_atlases, this);
+    }
+
+    const GlyphAtlas::Glyph* GlyphAtlas::glyph(TTF_Font* font, uint32_t codepoint, uint64_t frame) {
+        if (!font) return nullptr;
+        auto size = TTF_GetFontSize(font);
+        Key key{font, std::bit_cast<uint32_t>(size), static_cast<uint32_t>(TTF_GetFontStyle(font)),
+                TTF_GetFontOutline(font), codepoint};
+        auto it = _glyphs.find(key);
+        if (it != _glyphs.end()) {
+            if (it->second.page != NO_PAGE) _shelves[it->second.shelf].last_used = frame;
+            return &it->second;
+        }
+
+        SDL_Surface* rendered = TTF_RenderGlyph_Blended(font, codepoint, {255, 255, 255, 255});
+        if (!rendered) {
+            Logger::log(Logger::Warn, "GlyphAtlas: Can't render glyph U+{:04X}! Exception: {}",
+                        codepoint, SDL_GetError());
+            return nullptr;
+        }
+        auto surface = SDL_ConvertSurface(rendered, SDL_PIXELFORMAT_RGBA32);
+        SDL_DestroySurface(rendered);
+        if (!surface) return nullptr;
+        int advance = 0;
+        if (!TTF_GetGlyphMetrics(font, codepoint, nullptr, nullptr, nullptr, nullptr, &advance)) {
+            advance = surface->w;
+        }
+        Glyph glyph{NO_PAGE, 0, {}, 0.f, 0.f, static_cast<float>(advance)};
+
+        /// Only the covered pixels are packed, the blank margins of the line height are dropped.
+        auto pixels = static_cast<const uint8_t*>(surface->pixels);
+        int min_x = surface->w, min_y = surface->h, max_x = -1, max_y = -1;
+        for (int y = 0; y < surface->h; ++y) {
+            auto row = pixels + static_cast<ptrdiff_t>(y) * surface->pitch;
+            for (int x = 0; x < surface->w; ++x) {
+                if (!row[x * 4 + 3]) continue;
+                min_x = std::min(min_x, x);
+                max_x = std::max(max_x, x);
+                min_y = std::min(min_y, y);
+                max_y = std::max(max_y, y);
+            }
+        }
+        if (max_x >= 0) {
+            int width = max_x - min_x + 1, height = max_y - min_y + 1;
+            uint32_t page, shelf;
+            int x, y;
+            if (!allocate(width + PADDING, height + PADDING, frame, page, shelf, x, y)) {
+                SDL_DestroySurface(surface);
+                return nullptr;
+            }
+            SDL_Rect rect{x, y, width, height};
+            SDL_UpdateTexture(_pages[page], &rect,
+                              pixels + static_cast<ptrdiff_t>(min_y) * surface->pitch + min_x * 4, surface->pitch);
+            glyph.page = page;
+            glyph.shelf = shelf;
+            glyph.src = {static_cast<float>(x), static_cast<float>(y),
+                         static_cast<float>(width), static_cast<float>(height)};
+            glyph.offset_x = static_cast<float>(min_x);
+            glyph.offset_y = static_cast<float>(min_y);
+            _shelves[shelf].glyphs.push_back(key);
+            _shelves[shelf].last_used = frame;
+        }
+        SDL_DestroySurface(surface);
+        return &_glyphs.emplace(key, glyph).first->second;
+    }
+
+    SDL_Texture* GlyphAtlas::page(uint32_t index) const {
+        return index < _pages.size() ? _pages[index] : nullptr;
+    }
+
+    uint32_t GlyphAtlas::pageCount() const {
+        return static_cast<uint32_t>(_pages.size());
+    }
+
+    size_t GlyphAtlas::glyphCount() const {
+        return _glyphs.size();
+    }
+
+    uint64_t GlyphAtlas::evictionCount() const {
+        return _eviction_count;
+    }
+
+    void GlyphAtlas::clear() {
+        _glyphs.clear();
+        _shelves.clear();
+        std::fill(_page_tops.begin(), _page_tops.end(), 0);
+        for (uint32_t i = 0; i < _pages.size(); ++i) clearArea(i, {0, 0, _page_size, _page_size});
+    }
+
+    void GlyphAtlas::forgetFont(TTF_Font* font) {
+        _font_generation += 1;
+        for (auto atlas : _atlases) atlas->removeFont(font);
+    }
+
+    uint64_t GlyphAtlas::fontGeneration() {
+        return _font_generation;
+    }
+
+    void GlyphAtlas::layoutText(TTF_Font* font, std::string_view text, std::vector<GlyphPlacement>& glyphs,
+                                std::vector<uint32_t>* line_starts) {
+        if (line_starts) line_starts->push_back(0);
+        auto line_skip = static_cast<float>(TTF_GetFontLineSkip(font));
+        float pen_x = 0, pen_y = 0;
+        auto str = text.data();
+        auto length = text.size();
+        uint32_t prev = 0;
+        while (length) {
+            auto codepoint = SDL_StepUTF8(&str, &length);
+            if (codepoint == '\n') {
+                pen_x = 0;
+                pen_y += line_skip;
+                prev = 0;
+                if (line_starts) line_starts->push_back(static_cast<uint32_t>(str - text.data()));
+                continue;
+            }
+            int kerning = 0, advance = 0;
+            if (prev && TTF_GetGlyphKerning(font, prev, codepoint, &kerning)) pen_x += static_cast<float>(kerning);
+            prev = codepoint;
+            glyphs.push_back({codepoint, pen_x, pen_y});
+            if (TTF_GetGlyphMetrics(font, codepoint, nullptr, nullptr, nullptr, nullptr, &advance)) {
+                pen_x += static_cast<float>(advance);
+            }
+        }
+    }
+
+    void GlyphAtlas::removeFont(TTF_Font* font) {
+        std::erase_if(_glyphs, [font](const auto& item) { return item.first.font == font; });
+        for (auto& shelf : _shelves) {
+            std::erase_if(shelf.glyphs, [font](const Key& key) { return key.font == font; });
+        }
+    }
+
+    bool GlyphAtlas::allocate(int width, int height, uint64_t frame,
+                              uint32_t& page, uint32_t& shelf, int& x, int& y) {
+        if (width > _page_size || height > _page_size) {
+            Logger::log(Logger::Warn, "GlyphAtlas: The glyph ({}x{}) is larger than the page!", width, height);
+            return false;
+        }
+        auto take = [&](uint32_t index) {
+            auto& item = _shelves[index];
+            page = item.page;
+            shelf = index;
+            x = item.cursor_x;
+            y = item.y;
+            item.cursor_x += width;
+            return true;
+        };
+        /// Best fit in the open shelves, a much taller shelf wastes the space of the others.
+        uint32_t best = NO_PAGE;
+        for (uint32_t i = 0; i < _shelves.size(); ++i) {
+            auto& item = _shelves[i];
+            if (item.page == NO_PAGE || item.height < height || item.height > height + height / 2 + 2) continue;
+            if (item.cursor_x + width > _page_size) continue;
+            if (best == NO_PAGE || item.height < _shelves[best].height) best = i;
+        }
+        if (best != NO_PAGE) return take(best);
+
+        for (uint32_t i = 0; i < _pages.size(); ++i) {
+            if (_page_tops[i] + height <= _page_size) return take(newShelf(i, height));
+        }
+        if (_pages.size() < _max_pages && addPage()) {
+            return take(newShelf(static_cast<uint32_t>(_pages.size() - 1), height));
+        }
+
+        /// The pages are full, reuse the least recently used shelf which is tall enough.
+        /// The quads recorded while painting are rendered in the next frame, so the last frame is in use as well.
+        for (uint32_t i = 0; i < _shelves.size(); ++i) {
+            auto& item = _shelves[i];
+            if (item.page == NO_PAGE || item.height < height || item.last_used + 1 >= frame) continue;
+            if (best == NO_PAGE || item.last_used < _shelves[best].last_used) best = i;
+        }
+        if (best != NO_PAGE) {
+            evictShelf(best);
+            _shelves[best].last_used = frame;
+            return take(best);
+        }
+
+        /// No shelf is tall enough, reset the least recently used page which is not in use.
+        uint32_t reset_page = NO_PAGE;
+        uint64_t reset_time = UINT64_MAX;
+        for (uint32_t i = 0; i < _pages.size(); ++i) {
+            uint64_t page_time = 0;
+            for (auto& item : _shelves) {
+                if (item.page == i) page_time = std::max(page_time, item.last_used);
+            }
+            if (page_time + 1 < frame && page_time < reset_time) {
+                reset_page = i;
+                reset_time = page_time;
+            }
+        }
+        if (reset_page != NO_PAGE) {
+            for (uint32_t i = 0; i < _shelves.size(); ++i) {
+                if (_shelves[i].page != reset_page) continue;
+                evictShelf(i);
+                _shelves[i].page = NO_PAGE;
+            }
+            _page_tops[reset_page] = 0;
+            return take(newShelf(reset_page, height));
+        }
+
+        /// Everything is in use, grow over the limit instead of breaking the text.
+        if (!addPage()) return false;
+        Logger::log(Logger::Warn, "GlyphAtlas: The glyphs of one frame exceed {} pages, {} pages are used now!",
+                    _max_pages, _pages.size());
+        return take(newShelf(static_cast<uint32_t>(_pages.size() - 1), height));
+    }
+
+    uint32_t GlyphAtlas::newShelf(uint32_t page, int height) {
+        Shelf shelf{page, _page_tops[page], height, 0, 0, {}};
+        _page_tops[page] += height;
+        for (uint32_t i = 0; i < _shelves.size(); ++i) {
+            if (_shelves[i].page == NO_PAGE) {
+                _shelves[i] = std::move(shelf);
+                return i;
+            }
+        }
+        _shelves.push_back(std::move(shelf));
+        return static_cast<uint32_t>(_shelves.size() - 1);
+    }
+
+    bool GlyphAtlas::addPage() {
+        auto texture = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC,
+                                         _page_size, _page_size);
+        if (!texture) {
+            Logger::log(Logger::Error, "GlyphAtlas: Can't create the glyph page! Exception: {}", SDL_GetError());
+            return false;
+        }
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        _pages.push_back(texture);
+        _page_tops.push_back(0);
+        /// The texture is undefined before updating, clear it so the padding is transparent.
+        clearArea(static_cast<uint32_t>(_pages.size() - 1), {0, 0, _page_size, _page_size});
+        return true;
+    }
+
+    void GlyphAtlas::clearArea(uint32_t page, const SDL_Rect& rect) {
+        std::vector<uint32_t> blank(static_cast<size_t>(rect.w) * rect.h, 0);
+        SDL_UpdateTexture(_pages[page], &rect, blank.data(), rect.w * 4);
+    }
+
+    void GlyphAtlas::evictShelf(uint32_t shelf) {
+        auto& item = _shelves[shelf];
+        for (auto& key : item.glyphs) _glyphs.erase(key);
+        item.glyphs.clear();
+        item.cursor_x = 0;
+        /// The new glyphs don't cover the padding, so the old pixels are cleared.
+        clearArea(item.page, {0, item.y, _page_size, item.height});
+        _eviction_count += 1;
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+#ifndef MYENGINE_RENDERER_GLYPHATLAS_H
+#define MYENGINE_RENDERER_GLYPHATLAS_H
+#include "../Libs.h"
+
+namespace MyEngine {
+    /// The pen position of one glyph in the laid out text, relative to the top-left corner of the text.
+    struct GlyphPlacement {
+        uint32_t codepoint;
+        float x, y;
+    };
+
+    /**
+     * \if EN
+     * @class MyEngine::GlyphAtlas
+     * @brief Glyph cache shared by all fonts and sizes drawn by one renderer
+     * @details The glyphs are rasterized on demand and packed into the shelves of a few large page textures,
+     * so the text of all fonts can be drawn as quads of a few textures.
+     * When the pages are full, the least recently used shelf is evicted. The shelves used in the current frame
+     * or the last frame are never evicted, because the quads referring to them may not be rendered yet.
+     * @note It can only be used on the main thread.
+     * \endif
+     */
+    class GlyphAtlas {
+    public:
+        struct Glyph {
+            /// The page of the glyph, `NO_PAGE` if the glyph has no pixels (e.g. space).
+            uint32_t page;
+            uint32_t shelf;
+            /// The source rectangle in the page.
+            SDL_FRect src;
+            /// The offset of the pixels from the pen position at the top of the line.
+            float offset_x, offset_y;
+            float advance;
+        };
+        static constexpr uint32_t NO_PAGE = UINT32_MAX;
+
+        explicit GlyphAtlas(SDL_Renderer* renderer, int page_size = 1024, uint32_t max_pages = 4);
+        GlyphAtlas(const GlyphAtlas&) = delete;
+        GlyphAtlas(GlyphAtlas&&) = delete;
+        GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+        GlyphAtlas& operator=(GlyphAtlas&&) = delete;
+        ~GlyphAtlas();
+
+        /**
+         * \if EN
+         * @brief Get the glyph of the current size, style and outline of the font, rasterize it if it is not cached
+         * @param frame The index of the current frame, the shelf of the glyph is kept until the next frame ends
+         * @return The glyph, it is null if the glyph can't be rasterized.
+         * The pointer is valid until the next call.
+         * \endif
+         */
+        const Glyph* glyph(TTF_Font* font, uint32_t codepoint, uint64_t frame);
+        [[nodiscard]] SDL_Texture* page(uint32_t index) const;
+        [[nodiscard]] uint32_t pageCount() const;
+        [[nodiscard]] size_t glyphCount() const;
+        /// Get the count of the evicted shelves.
+        [[nodiscard]] uint64_t evictionCount() const;
+        void clear();
+
+        /// Drop the glyphs of the font from all atlases, it is called before the font is closed or changed.
+        static void forgetFont(TTF_Font* font);
+        /// It is increased by `forgetFont()`, the caches keyed by the font pointers compare it, so a pointer
+        /// reused by a new font never matches the old entries.
+        static uint64_t fontGeneration();
+        /**
+         * \if EN
+         * @brief Lay out the UTF-8 text in one line per `\n`, with the advances and the kerning of the font
+         * @param glyphs      The placements are appended to it, the line breaks are not included
+         * @param line_starts The byte offsets where the lines start are appended to it if it is not null
+         * \endif
+         */
+        static void layoutText(TTF_Font* font, std::string_view text, std::vector<GlyphPlacement>& glyphs,
+                               std::vector<uint32_t>* line_starts = nullptr);
+
+    private:
+        struct Key {
+            TTF_Font* font;
+            uint32_t size_bits;
+            uint32_t style;
+            int32_t outline;
+            uint32_t codepoint;
+            bool operator==(const Key&) const = default;
+        };
+        struct KeyHash {
+            size_t operator()(const Key& key) const noexcept;
+        };
+        struct Shelf {
+            uint32_t page;
+            int y, height, cursor_x;
+            uint64_t last_used;
+            std::vector<Key> glyphs;
+        };
+
+        bool allocate(int width, int height, uint64_t frame, uint32_t& page, uint32_t& shelf, int& x, int& y);
+        uint32_t newShelf(uint32_t page, int height);
+        bool addPage();
+        void evictShelf(uint32_t shelf);
+        void clearArea(uint32_t page, const SDL_Rect& rect);
+        void removeFont(TTF_Font* font);
+
+        SDL_Renderer* _renderer;
+        int _page_size;
+        uint32_t _max_pages;
+        std::vector<SDL_Texture*> _pages;
+        /// The top of the free space of every page.
+        std::vector<int> _page_tops;
+        std::vector<Shelf> _shelves;
+        std::unordered_map<Key, Glyph, KeyHash> _glyphs;
+        uint64_t _eviction_count{0};
+        static std::vector<GlyphAtlas*> _atlases;
+        static uint64_t _font_generation;
+    };
+}
+
+#endif //MYENGINE_RENDERER_GLYPHATLAS_H
@@ -1,11 +1,22 @@
 #pragma once
 #ifndef MYENGINE_UTILS_H
 #define MYENGINE_UTILS_H
+#include "Clock.h"
 #include "Cursor.h"
 #include "DateTime.h"
+#include "EventRecorder.h"
 #include "Logger.h"
 #include "Random.h"
 #include "FileSystem.h"
+#include "FrameArena.h"
+#include "FontFaceCache.h"
+#include "FontIndex.h"
+#include "MappedFile.h"
+#include "InplaceFunction.h"
+#include "SlotMap.h"
+#include "TextBuffer.h"
+#include "PrefixSumTree.h"
+#include "FramePacer.h"
 #include "RGBAColor.h"
 #include "SysMemory.h"
 #include "Variant.h"
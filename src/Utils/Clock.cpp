@@ -0,0 +1,34 @@
+
+#include "Clock.h"
+
+namespace MyEngine {
+    std::atomic<bool> Clock::_virtual{false};
+    std::atomic<uint64_t> Clock::_virtual_ns{0};
+
+    uint64_t Clock::ticks() {
+        if (_virtual.load(std::memory_order_acquire)) {
+            return _virtual_ns.load(std::memory_order_relaxed) / 1000000;
+        }
+        return SDL_GetTicks();
+    }
+
+    uint64_t Clock::ticksNS() {
+        if (_virtual.load(std::memory_order_acquire)) {
+            return _virtual_ns.load(std::memory_order_relaxed);
+        }
+        return SDL_GetTicksNS();
+    }
+
+    void Clock::setVirtualTime(uint64_t time_ns) {
+        _virtual_ns.store(time_ns, std::memory_order_relaxed);
+        _virtual.store(true, std::memory_order_release);
+    }
+
+    void Clock::resetToSystemTime() {
+        _virtual.store(false, std::memory_order_release);
+    }
+
+    bool Clock::isVirtual() {
+        return _virtual.load(std::memory_order_acquire);
+    }
+}
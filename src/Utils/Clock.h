@@ -0,0 +1,72 @@
+#pragma once
+#ifndef MYENGINE_UTILS_CLOCK_H
+#define MYENGINE_UTILS_CLOCK_H
+#include "../Libs.h"
+
+namespace MyEngine {
+    /**
+     * \if EN
+     * @class MyEngine::Clock
+     * @brief Engine Clock
+     * @details Every place in the engine that reads time goes through this clock instead of `SDL_GetTicks()`.
+     * @details By default it returns the SDL system ticks. While replaying a recorded session,
+     * the time is virtualized and driven by the recorded timestamps, so animations, timers and widgets
+     * behave exactly like the recorded session.
+     * @note This class is a static class and does not require obtaining a global singleton.
+     * \endif
+     * @see EventSystem::startReplay
+     */
+    class Clock {
+    public:
+        explicit Clock() = delete;
+        Clock(const Clock&) = delete;
+        Clock(Clock&&) = delete;
+        Clock& operator=(const Clock&) = delete;
+        Clock& operator=(Clock&&) = delete;
+        ~Clock() = delete;
+
+        /**
+         * \if EN
+         * @brief Get the engine time in milliseconds
+         * @return Return the virtual time if enabled, otherwise return `SDL_GetTicks()`
+         * \endif
+         */
+        static uint64_t ticks();
+
+        /**
+         * \if EN
+         * @brief Get the engine time in nanoseconds
+         * @return Return the virtual time if enabled, otherwise return `SDL_GetTicksNS()`
+         * \endif
+         */
+        static uint64_t ticksNS();
+
+        /**
+         * \if EN
+         * @brief Enable the virtual time and set it to the specified time
+         * @param time_ns Specified the virtual time in nanoseconds
+         * \endif
+         */
+        static void setVirtualTime(uint64_t time_ns);
+
+        /**
+         * \if EN
+         * @brief Disable the virtual time and go back to the SDL system ticks
+         * \endif
+         */
+        static void resetToSystemTime();
+
+        /**
+         * \if EN
+         * @brief Check whether the virtual time is enabled
+         * \endif
+         */
+        static bool isVirtual();
+
+    private:
+        static std::atomic<bool> _virtual;
+        static std::atomic<uint64_t> _virtual_ns;
+    };
+}
+
+#endif //MYENGINE_UTILS_CLOCK_H
@@ -0,0 +1,274 @@
+
+#include "EventRecorder.h"
+#include "Logger.h"
+
+namespace MyEngine {
+    EventRecorder::EventRecorder(const std::string &path, uint64_t start_time_ns)
+            : _path(path), _last_ts(start_time_ns) {
+        _file.open(path, std::ios::binary | std::ios::trunc);
+        if (!_file.is_open()) {
+            Logger::log(Logger::Error, "EventRecorder: Can't open the file '{}' for recording!", path);
+            return;
+        }
+        _file.write(MAGIC, sizeof(MAGIC));
+        _file.put(static_cast<char>(VERSION));
+        writeVarUInt(start_time_ns);
+    }
+
+    EventRecorder::~EventRecorder() {
+        close();
+    }
+
+    bool EventRecorder::isValid() const {
+        return _file.is_open() && _file.good();
+    }
+
+    size_t EventRecorder::eventPayloadSize(uint32_t type) {
+        if (type >= SDL_EVENT_WINDOW_SHOWN && type < SDL_EVENT_KEY_DOWN) return sizeof(SDL_WindowEvent);
+        switch (type) {
+            case SDL_EVENT_QUIT:
+                return sizeof(SDL_CommonEvent);
+            case SDL_EVENT_KEY_DOWN:
+            case SDL_EVENT_KEY_UP:
+                return sizeof(SDL_KeyboardEvent);
+            case SDL_EVENT_TEXT_INPUT:
+                return sizeof(SDL_TextInputEvent);
+            case SDL_EVENT_MOUSE_MOTION:
+                return sizeof(SDL_MouseMotionEvent);
+            case SDL_EVENT_MOUSE_BUTTON_DOWN:
+            case SDL_EVENT_MOUSE_BUTTON_UP:
+                return sizeof(SDL_MouseButtonEvent);
+            case SDL_EVENT_MOUSE_WHEEL:
+                return sizeof(SDL_MouseWheelEvent);
+            case SDL_EVENT_FINGER_DOWN:
+            case SDL_EVENT_FINGER_UP:
+            case SDL_EVENT_FINGER_MOTION:
+                return sizeof(SDL_TouchFingerEvent);
+            case SDL_EVENT_DROP_FILE:
+            case SDL_EVENT_DROP_TEXT:
+            case SDL_EVENT_DROP_BEGIN:
+            case SDL_EVENT_DROP_COMPLETE:
+            case SDL_EVENT_DROP_POSITION:
+                return sizeof(SDL_DropEvent);
+            /// These events are holding pointers owned by SDL, which can't be restored while replaying.
+            case SDL_EVENT_TEXT_EDITING:
+            case SDL_EVENT_TEXT_EDITING_CANDIDATES:
+            case SDL_EVENT_CLIPBOARD_UPDATE:
+                return 0;
+            default:
+                return (type >= SDL_EVENT_USER ? 0 : sizeof(SDL_Event));
+        }
+    }
+
+    void EventRecorder::writeEvent(uint64_t frame, uint64_t timestamp_ns,
+                                   const SDL_Event &event, const InputSnapshot &snapshot) {
+        if (!isValid()) return;
+        auto payload_size = eventPayloadSize(event.type);
+        if (!payload_size) return;
+        writeHead(TAG_EVENT, frame, timestamp_ns);
+        _file.put(static_cast<char>(snapshot.mouse_state));
+        _file.write(reinterpret_cast<const char*>(&snapshot.mouse_x), sizeof(float));
+        _file.write(reinterpret_cast<const char*>(&snapshot.mouse_y), sizeof(float));
+        writeVarUInt(snapshot.keys.size());
+        for (auto& key : snapshot.keys) {
+            writeVarUInt(static_cast<uint64_t>(key));
+        }
+        writeVarUInt(payload_size);
+        _file.write(reinterpret_cast<const char*>(&event), static_cast<std::streamsize>(payload_size));
+        if (event.type == SDL_EVENT_TEXT_INPUT) {
+            writeString(event.text.text);
+        } else if (event.type >= SDL_EVENT_DROP_FILE && event.type <= SDL_EVENT_DROP_POSITION) {
+            writeString(event.drop.source);
+            writeString(event.drop.data);
+        }
+        _event_count += 1;
+    }
+
+    void EventRecorder::writeFrame(uint64_t frame, uint64_t timestamp_ns) {
+        if (!isValid()) return;
+        writeHead(TAG_FRAME, frame, timestamp_ns);
+        _frame_count += 1;
+    }
+
+    void EventRecorder::close() {
+        if (!_file.is_open()) return;
+        _file.put(static_cast<char>(TAG_END));
+        _file.close();
+        Logger::log(Logger::Info, "EventRecorder: Recorded {} event(s) in {} frame(s) to '{}'",
+                    _event_count, _frame_count, _path);
+    }
+
+    size_t EventRecorder::eventCount() const {
+        return _event_count;
+    }
+
+    size_t EventRecorder::frameCount() const {
+        return _frame_count;
+    }
+
+    void EventRecorder::writeHead(uint8_t tag, uint64_t frame, uint64_t timestamp_ns) {
+        _file.put(static_cast<char>(tag));
+        writeVarUInt(frame - _last_frame);
+        writeVarUInt(timestamp_ns >= _last_ts ? timestamp_ns - _last_ts : 0);
+        _last_frame = frame;
+        _last_ts = std::max(_last_ts, timestamp_ns);
+    }
+
+    void EventRecorder::writeVarUInt(uint64_t value) {
+        do {
+            auto byte = static_cast<uint8_t>(value & 0x7f);
+            value >>= 7;
+            if (value) byte |= 0x80;
+            _file.put(static_cast<char>(byte));
+        } while (value);
+    }
+
+    void EventRecorder::writeString(const char *str) {
+        if (!str) {
+            _file.put(0);
+            return;
+        }
+        _file.put(1);
+        auto len = std::strlen(str);
+        writeVarUInt(len);
+        _file.write(str, static_cast<std::streamsize>(len));
+    }
+
+    EventReplayer::EventReplayer(const std::string &path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            Logger::log(Logger::Error, "EventReplayer: Can't open the record file '{}'!", path);
+            return;
+        }
+        char magic[4]{};
+        file.read(magic, sizeof(magic));
+        auto version = file.get();
+        if (!file || std::memcmp(magic, EventRecorder::MAGIC, sizeof(magic)) != 0
+            || version != EventRecorder::VERSION) {
+            Logger::log(Logger::Error, "EventReplayer: The file '{}' is not a valid record file!", path);
+            return;
+        }
+        if (!readVarUInt(file, _start_ts)) {
+            Logger::log(Logger::Error, "EventReplayer: The record file '{}' is broken!", path);
+            return;
+        }
+        uint64_t frame = 0, ts = _start_ts;
+        bool broken = true;
+        while (file) {
+            auto tag = file.get();
+            if (tag == EventRecorder::TAG_END || tag == std::char_traits<char>::eof()) {
+                broken = false;
+                break;
+            }
+            uint64_t d_frame, d_ts;
+            if (!readVarUInt(file, d_frame) || !readVarUInt(file, d_ts)) break;
+            frame += d_frame;
+            ts += d_ts;
+            Record record;
+            record.frame = frame;
+            record.timestamp_ns = ts;
+            if (tag == EventRecorder::TAG_FRAME) {
+                record.is_frame = true;
+                _records.push_back(std::move(record));
+                _frame_count += 1;
+                continue;
+            }
+            if (tag != EventRecorder::TAG_EVENT) break;
+            record.snapshot.mouse_state = static_cast<uint8_t>(file.get());
+            file.read(reinterpret_cast<char*>(&record.snapshot.mouse_x), sizeof(float));
+            file.read(reinterpret_cast<char*>(&record.snapshot.mouse_y), sizeof(float));
+            if (!file) break;
+            uint64_t key_count, payload_size;
+            if (!readVarUInt(file, key_count)) break;
+            uint64_t key = 0, i = 0;
+            for (; i < key_count && readVarUInt(file, key); ++i) {
+                record.snapshot.keys.push_back(static_cast<SDL_Scancode>(key));
+            }
+            if (i < key_count || !readVarUInt(file, payload_size) || payload_size > sizeof(SDL_Event)) break;
+            file.read(reinterpret_cast<char*>(&record.event), static_cast<std::streamsize>(payload_size));
+            if (!file) break;
+            if (record.event.type == SDL_EVENT_TEXT_INPUT) {
+                if (!readString(file, record.data, record.has_data)) break;
+            } else if (record.event.type >= SDL_EVENT_DROP_FILE && record.event.type <= SDL_EVENT_DROP_POSITION) {
+                if (!readString(file, record.source, record.has_source)) break;
+                if (!readString(file, record.data, record.has_data)) break;
+            }
+            _records.push_back(std::move(record));
+            _event_count += 1;
+        }
+        if (broken) {
+            Logger::log(Logger::Warn, "EventReplayer: The record file '{}' is truncated! "
+                                      "Only {} frame(s) will be replayed.", path, _frame_count);
+        }
+        /// Restore the string pointers after all records are loaded, the vector will not be reallocated anymore.
+        for (auto& record : _records) {
+            if (record.is_frame) continue;
+            if (record.event.type == SDL_EVENT_TEXT_INPUT) {
+                record.event.text.text = record.has_data ? record.data.c_str() : nullptr;
+            } else if (record.event.type >= SDL_EVENT_DROP_FILE && record.event.type <= SDL_EVENT_DROP_POSITION) {
+                record.event.drop.source = record.has_source ? record.source.c_str() : nullptr;
+                record.event.drop.data = record.has_data ? record.data.c_str() : nullptr;
+            }
+        }
+        _valid = true;
+        Logger::log(Logger::Info, "EventReplayer: Loaded {} event(s) in {} frame(s) from '{}'",
+                    _event_count, _frame_count, path);
+    }
+
+    bool EventReplayer::isValid() const {
+        return _valid;
+    }
+
+    bool EventReplayer::finished() const {
+        return _pos >= _records.size();
+    }
+
+    bool EventReplayer::hasEventInFrame(uint64_t frame) const {
+        return _pos < _records.size() && !_records[_pos].is_frame && _records[_pos].frame <= frame;
+    }
+
+    const EventReplayer::Record* EventReplayer::nextEvent(uint64_t frame) {
+        if (!hasEventInFrame(frame)) return nullptr;
+        return &_records[_pos++];
+    }
+
+    const EventReplayer::Record* EventReplayer::nextFrame(uint64_t frame) {
+        if (_pos >= _records.size() || !_records[_pos].is_frame || _records[_pos].frame > frame) return nullptr;
+        return &_records[_pos++];
+    }
+
+    uint64_t EventReplayer::startTime() const {
+        return _start_ts;
+    }
+
+    size_t EventReplayer::frameCount() const {
+        return _frame_count;
+    }
+
+    size_t EventReplayer::eventCount() const {
+        return _event_count;
+    }
+
+    bool EventReplayer::readVarUInt(std::istream &in, uint64_t &value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            auto byte = in.get();
+            if (byte == std::char_traits<char>::eof()) return false;
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool EventReplayer::readString(std::istream &in, std::string &str, bool &present) {
+        auto flag = in.get();
+        if (flag == std::char_traits<char>::eof()) return false;
+        present = (flag != 0);
+        if (!present) return true;
+        uint64_t len;
+        if (!readVarUInt(in, len)) return false;
+        str.resize(len);
+        in.read(str.data(), static_cast<std::streamsize>(len));
+        return static_cast<bool>(in);
+    }
+}
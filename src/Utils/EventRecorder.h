@@ -0,0 +1,109 @@
+#pragma once
+#ifndef MYENGINE_UTILS_EVENTRECORDER_H
+#define MYENGINE_UTILS_EVENTRECORDER_H
+#include "../Libs.h"
+
+namespace MyEngine {
+    /**
+     * \if EN
+     * @brief Input state snapshot
+     * @details The keyboard and mouse state captured by the event system while the event is processed.
+     * \endif
+     */
+    struct InputSnapshot {
+        uint8_t mouse_state{0};
+        float mouse_x{0}, mouse_y{0};
+        std::vector<SDL_Scancode> keys;
+    };
+
+    /**
+     * \if EN
+     * @class MyEngine::EventRecorder
+     * @brief Input Event Recorder
+     * @details Write the SDL event stream with frame indices and timestamps into a compact binary file.
+     * @details The file starts with the magic `MERC`, a version byte and the start timestamp.
+     * Every record stores the frame index and the timestamp as LEB128 deltas to the previous record,
+     * so a frame marker usually costs 3 ~ 5 bytes.
+     * @details Only the fields of the event type are written instead of the whole `SDL_Event` union,
+     * and strings (text input, dropped files) are written inline.
+     * \endif
+     * @see EventReplayer
+     */
+    class EventRecorder {
+    public:
+        explicit EventRecorder(const std::string& path, uint64_t start_time_ns);
+        EventRecorder(const EventRecorder&) = delete;
+        EventRecorder(EventRecorder&&) = delete;
+        EventRecorder& operator=(const EventRecorder&) = delete;
+        EventRecorder& operator=(EventRecorder&&) = delete;
+        ~EventRecorder();
+
+        [[nodiscard]] bool isValid() const;
+        void writeEvent(uint64_t frame, uint64_t timestamp_ns, const SDL_Event& event, const InputSnapshot& snapshot);
+        void writeFrame(uint64_t frame, uint64_t timestamp_ns);
+        void close();
+        [[nodiscard]] size_t eventCount() const;
+        [[nodiscard]] size_t frameCount() const;
+
+        static constexpr char MAGIC[4] = {'M', 'E', 'R', 'C'};
+        static constexpr uint8_t VERSION = 1;
+        static constexpr uint8_t TAG_EVENT = 'E';
+        static constexpr uint8_t TAG_FRAME = 'F';
+        static constexpr uint8_t TAG_END = 'Q';
+        /// Returns the number of bytes of `SDL_Event` that needs to be stored, or 0 if the event can't be replayed.
+        static size_t eventPayloadSize(uint32_t type);
+    private:
+        void writeHead(uint8_t tag, uint64_t frame, uint64_t timestamp_ns);
+        void writeVarUInt(uint64_t value);
+        void writeString(const char* str);
+        std::ofstream _file;
+        std::string _path;
+        uint64_t _last_frame{0}, _last_ts{0};
+        size_t _event_count{0}, _frame_count{0};
+    };
+
+    /**
+     * \if EN
+     * @class MyEngine::EventReplayer
+     * @brief Input Event Replayer
+     * @details Load the file written by `EventRecorder` and feed back the events frame by frame.
+     * \endif
+     * @see EventRecorder
+     */
+    class EventReplayer {
+    public:
+        struct Record {
+            bool is_frame{false};
+            uint64_t frame{0};
+            uint64_t timestamp_ns{0};
+            SDL_Event event{};
+            InputSnapshot snapshot;
+            std::string source, data;
+            bool has_source{false}, has_data{false};
+        };
+        explicit EventReplayer(const std::string& path);
+        EventReplayer(const EventReplayer&) = delete;
+        EventReplayer(EventReplayer&&) = delete;
+        EventReplayer& operator=(const EventReplayer&) = delete;
+        EventReplayer& operator=(EventReplayer&&) = delete;
+        ~EventReplayer() = default;
+
+        [[nodiscard]] bool isValid() const;
+        [[nodiscard]] bool finished() const;
+        [[nodiscard]] bool hasEventInFrame(uint64_t frame) const;
+        const Record* nextEvent(uint64_t frame);
+        const Record* nextFrame(uint64_t frame);
+        [[nodiscard]] uint64_t startTime() const;
+        [[nodiscard]] size_t frameCount() const;
+        [[nodiscard]] size_t eventCount() const;
+    private:
+        bool readVarUInt(std::istream& in, uint64_t& value);
+        bool readString(std::istream& in, std::string& str, bool& present);
+        bool _valid{false};
+        uint64_t _start_ts{0};
+        size_t _pos{0}, _frame_count{0}, _event_count{0};
+        std::vector<Record> _records;
+    };
+}
+
+#endif //MYENGINE_UTILS_EVENTRECORDER_H
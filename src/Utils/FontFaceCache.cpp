@@ -0,0 +1,61 @@
+
+#include "FontFaceCache.h"
+#include "FileSystem.h"
+#include "Logger.h"
+
+namespace MyEngine {
+    TTF_Font* FontFaceCache::openFont(const std::string& path, float size) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto key = FileSystem::getAbsolutePath(path);
+        auto it = _faces.find(key);
+        if (it == _faces.end()) {
+            Face face;
+            if (!face.file.open(key)) {
+                return TTF_OpenFont(path.c_str(), size);
+            }
+            it = _faces.emplace(key, std::move(face)).first;
+            Logger::log(Logger::Debug, "FontFaceCache: Mapped font file '{}' ({} bytes)", key, it->second.file.size());
+        }
+        auto& face = it->second;
+        auto stream = SDL_IOFromConstMem(face.file.data(), face.file.size());
+        /// The stream is closed with the font, the bytes are kept by the face.
+        auto font = stream ? TTF_OpenFontIO(stream, true, size) : nullptr;
+        if (!font) {
+            if (!face.ref_count) _faces.erase(it);
+            return nullptr;
+        }
+        face.ref_count += 1;
+        _fonts.emplace(font, std::move(key));
+        return font;
+    }
+
+    void FontFaceCache::closeFont(TTF_Font* font) {
+        if (!font) return;
+        std::lock_guard<std::mutex> lock(_mutex);
+        TTF_CloseFont(font);
+        auto it = _fonts.find(font);
+        if (it == _fonts.end()) return;
+        auto face = _faces.find(it->second);
+        if (face != _faces.end() && --face->second.ref_count == 0) {
+            _faces.erase(face);
+        }
+        _fonts.erase(it);
+    }
+
+    size_t FontFaceCache::faceCount() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _faces.size();
+    }
+
+    size_t FontFaceCache::fontCount() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _fonts.size();
+    }
+
+    size_t FontFaceCache::mappedBytes() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        size_t total = 0;
+        for (auto& [key, face] : _faces) total += face.file.size();
+        return total;
+    }
+}
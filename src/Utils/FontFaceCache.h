@@ -0,0 +1,52 @@
+#pragma once
+#ifndef MYENGINE_UTILS_FONTFACECACHE_H
+#define MYENGINE_UTILS_FONTFACECACHE_H
+#include "../Libs.h"
+#include "../Template/Singleton.h"
+#include "MappedFile.h"
+
+namespace MyEngine {
+    /**
+     * \if EN
+     * @class MyEngine::FontFaceCache
+     * @brief Shared memory-mapped font files
+     * @details Every font file is mapped once, all fonts of the file (e.g. the different sizes) are opened
+     * from the same bytes by `SDL_IOFromConstMem()`, so the file is neither read nor copied again.
+     * The faces are reference-counted by the opened fonts, a face is unmapped when its last font is closed.
+     * If the file can't be mapped, the font is opened from the path as before.
+     * @note The fonts opened by `openFont()` must be closed by `closeFont()`.
+     * \endif
+     */
+    class FontFaceCache : public Template::Singleton<FontFaceCache> {
+        friend class Template::Singleton<FontFaceCache>;
+    public:
+        FontFaceCache(FontFaceCache &&) = delete;
+        FontFaceCache(const FontFaceCache &) = delete;
+        FontFaceCache &operator=(FontFaceCache &&) = delete;
+        FontFaceCache &operator=(const FontFaceCache &) = delete;
+        ~FontFaceCache() override = default;
+
+        /// Open the font of the size from the shared face of the file, return null if it can't be opened.
+        TTF_Font* openFont(const std::string& path, float size);
+        void closeFont(TTF_Font* font);
+        /// Get the count of the mapped font files.
+        [[nodiscard]] size_t faceCount() const;
+        /// Get the count of the fonts opened from the mapped files.
+        [[nodiscard]] size_t fontCount() const;
+        [[nodiscard]] size_t mappedBytes() const;
+
+    private:
+        explicit FontFaceCache() = default;
+        struct Face {
+            MappedFile file;
+            uint32_t ref_count{0};
+        };
+
+        mutable std::mutex _mutex;
+        std::unordered_map<std::string, Face> _faces;
+        /// The font and the key of its face.
+        std::unordered_map<TTF_Font*, std::string> _fonts;
+    };
+}
+
+#endif //MYENGINE_UTILS_FONTFACECACHE_H
@@ -0,0 +1,252 @@
+#include "FontIndex.h"
+#include "Logger.h"
+
+namespace MyEngine {
+    namespace {
+        constexpr char MAGIC[8] = {'M', 'E', 'F', 'O', 'N', 'T', 'D', 'B'};
+        constexpr std::array<std::string_view, 5> FONT_EXTENSIONS = {".ttf", ".otf", ".ttc", ".woff", ".eot"};
+        /// The symbolic links may make a loop, the directories deeper than it are skipped.
+        constexpr int MAX_DEPTH = 32;
+        constexpr uint32_t NO_DIR = UINT32_MAX;
+
+        int64_t modifiedTime(const std::string& path) {
+            std::error_code ec;
+            auto time = std::filesystem::last_write_time(path, ec);
+            return ec ? -1 : static_cast<int64_t>(time.time_since_epoch().count());
+        }
+
+        bool isFontFile(std::string_view file_name) {
+            auto pos = file_name.find_last_of('.');
+            if (pos == std::string_view::npos || pos == 0) return false;
+            return std::find(FONT_EXTENSIONS.begin(), FONT_EXTENSIONS.end(), file_name.substr(pos))
+                   != FONT_EXTENSIONS.end();
+        }
+    }
+
+    bool FontIndex::load(const std::string& index_path, const std::vector<std::string>& roots, bool rebuild) {
+        clear();
+        bool valid = !rebuild && !index_path.empty() && _file.open(index_path) && parse(_file.bytes())
+                     && _header.root_count == roots.size();
+        for (uint32_t i = 0; valid && i < _header.root_count; ++i) {
+            auto dir = dirAt(i);
+            valid = stringAt(dir.path_offset, dir.path_length) == roots[i];
+        }
+
+        std::vector<ScanDir> dirs;
+        std::vector<ScanFont> fonts;
+        if (valid) {
+            /// Only the directory times are checked, it is much faster than listing the directories.
+            std::unordered_set<std::string> known_dirs;
+            std::vector<uint32_t> new_index(_header.dir_count, NO_DIR), changed;
+            for (uint32_t i = 0; i < _header.dir_count; ++i) {
+                auto dir = dirAt(i);
+                std::string path(stringAt(dir.path_offset, dir.path_length));
+                auto mtime = modifiedTime(path);
+                known_dirs.insert(path);
+                /// The removed directory is dropped with its fonts, the roots are always kept.
+                if (mtime == -1 && i >= _header.root_count) continue;
+                new_index[i] = static_cast<uint32_t>(dirs.size());
+                if (mtime != dir.mtime) changed.push_back(new_index[i]);
+                dirs.push_back({std::move(path), mtime});
+            }
+            if (changed.empty() && dirs.size() == _header.dir_count) {
+                Logger::log(Logger::Debug, "FontIndex: Loaded {} fonts from '{}'", _header.font_count, index_path);
+                return true;
+            }
+            std::vector<std::pair<uint32_t, ScanFont>> kept;
+            for (uint32_t i = 0; i < _header.font_count; ++i) {
+                auto font = fontAt(i);
+                if (font.dir_index >= _header.dir_count) continue;
+                auto dir_index = new_index[font.dir_index];
+                if (dir_index == NO_DIR || std::find(changed.begin(), changed.end(), dir_index) != changed.end()) {
+                    continue;
+                }
+                kept.emplace_back(font.order, ScanFont{std::string(stringAt(font.name_offset, font.name_length)),
+                                                       std::string(stringAt(font.path_offset, font.path_length)),
+                                                       font.mtime, dir_index});
+            }
+            /// Restore the scanning order, so the same file wins when the names are duplicated.
+            std::sort(kept.begin(), kept.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+            for (auto& item : kept) fonts.push_back(std::move(item.second));
+            Logger::log(Logger::Debug, "FontIndex: {} font directories are changed, the index is updated",
+                        changed.size() + _header.dir_count - dirs.size());
+            for (auto index : changed) {
+                if (dirs[index].mtime != -1) scanDirectory(index, 0, &known_dirs, dirs, fonts);
+            }
+        } else {
+            /// The missing roots are recorded as well, the index is updated when they are created.
+            for (auto& root : roots) dirs.push_back({root, modifiedTime(root)});
+            for (uint32_t i = 0; i < roots.size(); ++i) {
+                if (dirs[i].mtime != -1) scanDirectory(i, 0, nullptr, dirs, fonts);
+            }
+            Logger::log(Logger::Debug, "FontIndex: Scanned {} fonts in {} directories", fonts.size(), dirs.size());
+        }
+
+        auto bytes = serialize(roots.size(), dirs, fonts);
+        _file.close();
+        if (!index_path.empty()) {
+            auto temp_path = index_path + ".tmp";
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+            file.close();
+            std::error_code ec;
+            if (file) std::filesystem::rename(temp_path, index_path, ec);
+            if (!file || ec) {
+                std::filesystem::remove(temp_path, ec);
+                Logger::log(Logger::Warn, "FontIndex: Can't write the index file '{}'!", index_path);
+            } else if (_file.open(index_path) && parse(_file.bytes())) {
+                return true;
+            }
+        }
+        _file.close();
+        _memory = std::move(bytes);
+        return parse(_memory);
+    }
+
+    bool FontIndex::isLoaded() const {
+        return !_bytes.empty();
+    }
+
+    size_t FontIndex::size() const {
+        return _bytes.empty() ? 0 : _header.font_count;
+    }
+
+    FontIndex::Font FontIndex::at(size_t index) const {
+        auto font = fontAt(index);
+        return {stringAt(font.name_offset, font.name_length), stringAt(font.path_offset, font.path_length),
+                font.mtime};
+    }
+
+    std::optional<FontIndex::Font> FontIndex::find(std::string_view name) const {
+        /// The records are sorted by the name and then the scanning order, the first match is the lower bound.
+        size_t first = 0, count = size();
+        while (count > 0) {
+            auto step = count / 2;
+            auto font = fontAt(first + step);
+            if (stringAt(font.name_offset, font.name_length) < name) {
+                first += step + 1;
+                count -= step + 1;
+            } else {
+                count = step;
+            }
+        }
+        if (first == size()) return std::nullopt;
+        auto font = at(first);
+        if (font.name != name) return std::nullopt;
+        return font;
+    }
+
+    void FontIndex::clear() {
+        _file.close();
+        _memory.clear();
+        _bytes = {};
+        _header = {};
+    }
+
+    bool FontIndex::parse(std::span<const std::byte> bytes) {
+        _bytes = {};
+        if (bytes.size() < sizeof(Header)) return false;
+        std::memcpy(&_header, bytes.data(), sizeof(Header));
+        if (std::memcmp(_header.magic, MAGIC, sizeof(MAGIC)) != 0 || _header.version != VERSION) return false;
+        auto expected = sizeof(Header) + static_cast<size_t>(_header.dir_count) * sizeof(DirRecord)
+                        + static_cast<size_t>(_header.font_count) * sizeof(FontRecord) + _header.string_size;
+        if (expected != bytes.size() || _header.root_count > _header.dir_count) return false;
+        _bytes = bytes;
+        return true;
+    }
+
+    FontIndex::DirRecord FontIndex::dirAt(size_t index) const {
+        DirRecord record;
+        std::memcpy(&record, _bytes.data() + sizeof(Header) + index * sizeof(DirRecord), sizeof(DirRecord));
+        return record;
+    }
+
+    FontIndex::FontRecord FontIndex::fontAt(size_t index) const {
+        FontRecord record;
+        auto offset = sizeof(Header) + _header.dir_count * sizeof(DirRecord) + index * sizeof(FontRecord);
+        std::memcpy(&record, _bytes.data() + offset, sizeof(FontRecord));
+        return record;
+    }
+
+    std::string_view FontIndex::stringAt(uint32_t offset, uint32_t length) const {
+        if (static_cast<size_t>(offset) + length > _header.string_size) return {};
+        auto pool = _bytes.data() + _bytes.size() - _header.string_size;
+        return {reinterpret_cast<const char*>(pool) + offset, length};
+    }
+
+    void FontIndex::scanDirectory(uint32_t dir_index, int depth, const std::unordered_set<std::string>* known_dirs,
+                                  std::vector<ScanDir>& dirs, std::vector<ScanFont>& fonts) {
+        std::error_code ec;
+        std::filesystem::directory_iterator it(dirs[dir_index].path, ec), end;
+        std::vector<std::string> sub_dirs;
+        for (; !ec && it != end; it.increment(ec)) {
+            std::error_code type_ec;
+            auto path = it->path().string();
+            if (it->is_directory(type_ec)) {
+                if (!known_dirs || !known_dirs->contains(path)) sub_dirs.push_back(std::move(path));
+                continue;
+            }
+            auto file_name = it->path().filename().string();
+            if (!isFontFile(file_name)) continue;
+            auto name = file_name.substr(0, file_name.find_last_of('.'));
+            fonts.push_back({std::move(name), std::move(path), modifiedTime(it->path().string()), dir_index});
+        }
+        if (depth >= MAX_DEPTH) return;
+        for (auto& sub_dir : sub_dirs) {
+            auto index = static_cast<uint32_t>(dirs.size());
+            auto mtime = modifiedTime(sub_dir);
+            dirs.push_back({std::move(sub_dir), mtime});
+            scanDirectory(index, depth + 1, nullptr, dirs, fonts);
+        }
+    }
+
+    std::vector<std::byte> FontIndex::serialize(size_t root_count, const std::vector<ScanDir>& dirs,
+                                                const std::vector<ScanFont>& fonts) {
+        std::string pool;
+        auto addString = [&pool](std::string_view string) {
+            auto offset = static_cast<uint32_t>(pool.size());
+            pool.append(string);
+            return std::pair<uint32_t, uint32_t>{offset, static_cast<uint32_t>(string.size())};
+        };
+        std::vector<DirRecord> dir_records;
+        dir_records.reserve(dirs.size());
+        for (auto& dir : dirs) {
+            auto [offset, length] = addString(dir.path);
+            dir_records.push_back({offset, length, dir.mtime});
+        }
+        std::vector<uint32_t> order(fonts.size());
+        for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&fonts](uint32_t a, uint32_t b) {
+            return fonts[a].name < fonts[b].name;
+        });
+        std::vector<FontRecord> font_records;
+        font_records.reserve(fonts.size());
+        for (auto index : order) {
+            auto& font = fonts[index];
+            auto [name_offset, name_length] = addString(font.name);
+            auto [path_offset, path_length] = addString(font.path);
+            font_records.push_back({name_offset, name_length, path_offset, path_length,
+                                    font.dir_index, index, font.mtime});
+        }
+        Header header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.root_count = static_cast<uint32_t>(root_count);
+        header.dir_count = static_cast<uint32_t>(dir_records.size());
+        header.font_count = static_cast<uint32_t>(font_records.size());
+        header.string_size = static_cast<uint32_t>(pool.size());
+
+        std::vector<std::byte> bytes(sizeof(Header) + dir_records.size() * sizeof(DirRecord)
+                                     + font_records.size() * sizeof(FontRecord) + pool.size());
+        auto out = bytes.data();
+        auto write = [&out](const void* data, size_t size) {
+            if (size) std::memcpy(out, data, size);
+            out += size;
+        };
+        write(&header, sizeof(Header));
+        write(dir_records.data(), dir_records.size() * sizeof(DirRecord));
+        write(font_records.data(), font_records.size() * sizeof(FontRecord));
+        write(pool.data(), pool.size());
+        return bytes;
+    }
+}
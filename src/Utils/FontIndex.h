@@ -0,0 +1,99 @@
+#pragma once
+#ifndef MYENGINE_UTILS_FONTINDEX_H
+#define MYENGINE_UTILS_FONTINDEX_H
+#include "../Libs.h"
+#include "MappedFile.h"
+#include <unordered_set>
+
+namespace MyEngine {
+    /**
+     * \if EN
+     * @class MyEngine::FontIndex
+     * @brief Persistent index of the font files in some directories
+     * @details The index file is a flat binary file (header, directory records, font records sorted by name and
+     * a string pool), it is memory-mapped and searched in place, nothing is parsed when it is loaded.
+     * Every scanned directory is recorded with its modification time. When the index is loaded again,
+     * only the directories whose time changed are listed again, the new subdirectories are scanned
+     * and the removed ones are dropped, then the index file is rewritten.
+     * \endif
+     */
+    class FontIndex {
+    public:
+        struct Font {
+            /// The file name without the extension.
+            std::string_view name;
+            std::string_view path;
+            int64_t mtime;
+        };
+
+        FontIndex() = default;
+        FontIndex(const FontIndex&) = delete;
+        FontIndex& operator=(const FontIndex&) = delete;
+
+        /**
+         * \if EN
+         * @brief Load the index of the font directories, it is updated or built if it is out of date
+         * @param index_path The path of the index file, it is kept in memory only if it is empty or can't be written
+         * @param roots      The font directories scanned recursively
+         * @param rebuild    Scan all directories even if the index file is valid
+         * \endif
+         */
+        bool load(const std::string& index_path, const std::vector<std::string>& roots, bool rebuild = false);
+        [[nodiscard]] bool isLoaded() const;
+        [[nodiscard]] size_t size() const;
+        /// Get the font at the index, the fonts are sorted by name.
+        [[nodiscard]] Font at(size_t index) const;
+        /// Find the font by the file name, the first scanned one is returned if the name is duplicated.
+        [[nodiscard]] std::optional<Font> find(std::string_view name) const;
+        void clear();
+
+    private:
+        static constexpr uint32_t VERSION = 1;
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t root_count;
+            uint32_t dir_count;
+            uint32_t font_count;
+            uint32_t string_size;
+            uint32_t reserved;
+        };
+        struct DirRecord {
+            uint32_t path_offset, path_length;
+            int64_t mtime;
+        };
+        struct FontRecord {
+            uint32_t name_offset, name_length;
+            uint32_t path_offset, path_length;
+            uint32_t dir_index, order;
+            int64_t mtime;
+        };
+        struct ScanDir {
+            std::string path;
+            int64_t mtime;
+        };
+        struct ScanFont {
+            std::string name, path;
+            int64_t mtime;
+            uint32_t dir_index;
+        };
+
+        bool parse(std::span<const std::byte> bytes);
+        [[nodiscard]] DirRecord dirAt(size_t index) const;
+        [[nodiscard]] FontRecord fontAt(size_t index) const;
+        [[nodiscard]] std::string_view stringAt(uint32_t offset, uint32_t length) const;
+        /// List the directory, the subdirectories not in `known_dirs` are appended and scanned recursively.
+        static void scanDirectory(uint32_t dir_index, int depth, const std::unordered_set<std::string>* known_dirs,
+                                  std::vector<ScanDir>& dirs, std::vector<ScanFont>& fonts);
+        static std::vector<std::byte> serialize(size_t root_count, const std::vector<ScanDir>& dirs,
+                                                const std::vector<ScanFont>& fonts);
+
+        MappedFile _file;
+        /// The index is kept here if it can't be written to the disk.
+        std::vector<std::byte> _memory;
+        std::span<const std::byte> _bytes;
+        Header _header{};
+    };
+}
+
+#endif //MYENGINE_UTILS_FONTINDEX_H
@@ -0,0 +1,96 @@
+
+#include "FrameArena.h"
+
+namespace MyEngine {
+    LinearArena::LinearArena(size_t block_size) : _block_size(std::max<size_t>(block_size, 1024)) {}
+
+    void LinearArena::reset() {
+        if (_blocks.size() > 1) {
+            /// Merge the blocks, the next frame of the same size fits in one block.
+            size_t total = 0;
+            for (auto& block : _blocks) total += block.size;
+            _blocks.clear();
+            addBlock(total);
+        }
+        _current = 0;
+        _offset = 0;
+        _used = 0;
+    }
+
+    size_t LinearArena::usedBytes() const {
+        return _used;
+    }
+
+    size_t LinearArena::highWaterMark() const {
+        return _high_water_mark;
+    }
+
+    size_t LinearArena::capacity() const {
+        size_t total = 0;
+        for (auto& block : _blocks) total += block.size;
+        return total;
+    }
+
+    const char* LinearArena::copyString(std::string_view string) {
+        auto buffer = allocateArray<char>(string.size() + 1);
+        std::memcpy(buffer.data(), string.data(), string.size());
+        buffer[string.size()] = '\0';
+        return buffer.data();
+    }
+
+    void* LinearArena::do_allocate(size_t bytes, size_t alignment) {
+        while (true) {
+            if (_current < _blocks.size()) {
+                auto& block = _blocks[_current];
+                auto base = reinterpret_cast<uintptr_t>(block.data.get());
+                auto aligned = (base + _offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+                auto end = aligned - base + bytes;
+                if (end <= block.size) {
+                    _used += end - _offset;
+                    _offset = end;
+                    _high_water_mark = std::max(_high_water_mark, _used);
+                    return reinterpret_cast<void*>(aligned);
+                }
+                if (_current + 1 < _blocks.size()) {
+                    _current += 1;
+                    _offset = 0;
+                    continue;
+                }
+            }
+            addBlock(bytes + alignment);
+            _current = _blocks.size() - 1;
+            _offset = 0;
+        }
+    }
+
+    void LinearArena::addBlock(size_t min_size) {
+        auto size = std::max(_block_size, std::bit_ceil(min_size));
+        _blocks.push_back({std::make_unique<std::byte[]>(size), size});
+    }
+
+    LinearArena* FrameArena::resource() {
+        return &_arenas[_frame_index & 1];
+    }
+
+    const char* FrameArena::copyString(std::string_view string) {
+        return resource()->copyString(string);
+    }
+
+    void FrameArena::nextFrame() {
+        _frame_index += 1;
+        /// The arena of the previous frame is kept, the commands recorded in it are executed in this frame.
+        resource()->reset();
+    }
+
+    uint64_t FrameArena::frameIndex() const {
+        return _frame_index;
+    }
+
+    size_t FrameArena::highWaterMark() const {
+        return std::max(_arenas[0].highWaterMark(), _arenas[1].highWaterMark());
+    }
+
+    size_t FrameArena::usedBytes() const {
+        return _arenas[_frame_index & 1].usedBytes();
+    }
+}
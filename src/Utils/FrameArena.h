@@ -0,0 +1,125 @@
+#pragma once
+#ifndef MYENGINE_UTILS_FRAMEARENA_H
+#define MYENGINE_UTILS_FRAMEARENA_H
+#include "../Libs.h"
+#include "../Template/Singleton.h"
+
+namespace MyEngine {
+    /**
+     * \if EN
+     * @class MyEngine::LinearArena
+     * @brief Linear (bump) allocator which releases all memory at once
+     * @details It is a `std::pmr::memory_resource`, so it can be used by `std::pmr` containers.
+     * Deallocating does nothing, the memory is reused after `reset()`. If one frame needs more than one block,
+     * the blocks are merged into one block at the next reset, so the steady state only touches one block.
+     * @note It is not thread-safe.
+     * \endif
+     */
+    class LinearArena : public std::pmr::memory_resource {
+    public:
+        explicit LinearArena(size_t block_size = 64 * 1024);
+        LinearArena(const LinearArena&) = delete;
+        LinearArena(LinearArena&&) = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+        LinearArena& operator=(LinearArena&&) = delete;
+        ~LinearArena() override = default;
+
+        /// Release all allocations, the pointers allocated before are not valid any more.
+        void reset();
+        /// Get the bytes allocated since the last reset.
+        [[nodiscard]] size_t usedBytes() const;
+        /// Get the most bytes allocated between two resets.
+        [[nodiscard]] size_t highWaterMark() const;
+        [[nodiscard]] size_t capacity() const;
+
+        /// Copy the string into the arena, the result is null-terminated.
+        const char* copyString(std::string_view string);
+        /// Allocate an uninitialized array, `T` must be trivially destructible.
+        template<typename T>
+        std::span<T> allocateArray(size_t count) {
+            static_assert(std::is_trivially_destructible_v<T>, "LinearArena: T must be trivially destructible!");
+            if (!count) return {};
+            return {static_cast<T*>(allocate(sizeof(T) * count, alignof(T))), count};
+        }
+        /// Copy the items into the arena, `T` must be trivially copyable.
+        template<typename T>
+        std::span<T> copyArray(std::span<const T> items) {
+            static_assert(std::is_trivially_copyable_v<T>, "LinearArena: T must be trivially copyable!");
+            auto array = allocateArray<T>(items.size());
+            if (!items.empty()) std::memcpy(array.data(), items.data(), items.size_bytes());
+            return array;
+        }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void*, size_t, size_t) override {}
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+    private:
+        struct Block {
+            std::unique_ptr<std::byte[]> data;
+            size_t size{0};
+        };
+        void addBlock(size_t min_size);
+
+        size_t _block_size;
+        std::vector<Block> _blocks;
+        size_t _current{0}, _offset{0};
+        size_t _used{0}, _high_water_mark{0};
+    };
+
+    /**
+     * \if EN
+     * @class MyEngine::FrameArena
+     * @brief Per-frame memory shared by the engine internals and the user code
+     * @details The engine switches between two linear arenas at the beginning of every frame,
+     * so the memory allocated in one frame is valid until the end of the next frame.
+     * Switching only resets the offset of the arena, nothing is freed.
+     * @note The memory kept by the painting commands until they are executed is in `Renderer::commandArena()`,
+     * because a window may skip frames in the redraw-on-demand mode.
+     * @code
+     * std::pmr::vector<Vector2*> list(FrameArena::global()->resource());
+     * renderer->drawDebugText(FrameArena::global()->format("Score: {}", score), {20, 40});
+     * @endcode
+     * @note It can only be used on the main thread.
+     * \endif
+     */
+    class FrameArena : public Template::Singleton<FrameArena> {
+        friend class Template::Singleton<FrameArena>;
+    public:
+        FrameArena(FrameArena &&) = delete;
+        FrameArena(const FrameArena &) = delete;
+        FrameArena &operator=(FrameArena &&) = delete;
+        FrameArena &operator=(const FrameArena &) = delete;
+        ~FrameArena() override = default;
+
+        /// Get the arena of the current frame, it is also a `std::pmr::memory_resource`.
+        LinearArena* resource();
+        const char* copyString(std::string_view string);
+        /// Format the string into the current arena, the result is null-terminated.
+        template<typename... Args>
+        std::string_view format(FMT::format_string<Args...> fmt, Args&&... args) {
+            auto size = FMT::formatted_size(fmt, std::forward<Args>(args)...);
+            auto buffer = resource()->allocateArray<char>(size + 1);
+            FMT::format_to_n(buffer.data(), size, fmt, std::forward<Args>(args)...);
+            buffer[size] = '\0';
+            return {buffer.data(), size};
+        }
+
+        /// Switch to the next frame, it is called by the engine at the beginning of every frame.
+        void nextFrame();
+        [[nodiscard]] uint64_t frameIndex() const;
+        /// Get the most bytes allocated in one frame.
+        [[nodiscard]] size_t highWaterMark() const;
+        [[nodiscard]] size_t usedBytes() const;
+
+    private:
+        explicit FrameArena() = default;
+        std::array<LinearArena, 2> _arenas;
+        uint64_t _frame_index{0};
+    };
+}
+
+#endif //MYENGINE_UTILS_FRAMEARENA_H
@@ -0,0 +1,112 @@
+
+#include "FramePacer.h"
+
+namespace MyEngine {
+    void FramePacer::setFrameTime(uint64_t frame_ns) {
+        _frame_ns = frame_ns;
+        _deadline = 0;
+    }
+
+    uint64_t FramePacer::frameTime() const {
+        return _frame_ns;
+    }
+
+    void FramePacer::setSpinThreshold(uint64_t spin_ns) {
+        _spin_ns = spin_ns;
+    }
+
+    uint64_t FramePacer::spinThreshold() const {
+        return _spin_ns;
+    }
+
+    void FramePacer::setVSyncInterval(uint64_t interval_ns) {
+        _vsync_ns = interval_ns;
+    }
+
+    uint64_t FramePacer::vsyncInterval() const {
+        return _vsync_ns;
+    }
+
+    bool FramePacer::isFrameDue() const {
+        if (!_frame_ns || !_deadline || pacedByVSync()) return true;
+        return SDL_GetTicksNS() >= effectiveDeadline();
+    }
+
+    bool FramePacer::wait() {
+        if (isFrameDue()) return true;
+        auto deadline = effectiveDeadline();
+        auto now = SDL_GetTicksNS();
+        if (now >= deadline) return true;
+        auto remaining = deadline - now;
+        if (remaining > _spin_ns + _oversleep_ns) {
+            auto sleep_ns = remaining - _spin_ns - _oversleep_ns;
+            bool woken;
+            if (sleep_ns >= 1000000) {
+                /// Sleep in the event queue, so the input is handled without waiting for the whole frame.
+                woken = SDL_WaitEventTimeout(nullptr, static_cast<Sint32>(sleep_ns / 1000000));
+            } else {
+                SDL_DelayPrecise(sleep_ns);
+                woken = false;
+            }
+            auto slept = SDL_GetTicksNS() - now;
+            if (!woken) {
+                auto over = slept > sleep_ns ? slept - sleep_ns : 0;
+                /// Grow quickly and shrink slowly, oversleeping is worse than spinning a little longer.
+                _oversleep_ns = (over > _oversleep_ns ? (over + _oversleep_ns) / 2 : (_oversleep_ns * 15 + over) / 16);
+            }
+            if (woken) return false;
+        }
+        while (SDL_GetTicksNS() < deadline) {
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    void FramePacer::frameStarted() {
+        auto now = SDL_GetTicksNS();
+        if (_last_start) {
+            _last_interval = now - _last_start;
+            if (_frame_ns && !pacedByVSync()) {
+                auto diff = (_last_interval > _frame_ns ? _last_interval - _frame_ns : _frame_ns - _last_interval);
+                _stat_sum += diff;
+                _stat_max = std::max(_stat_max, diff);
+                _stat_count += 1;
+            }
+        }
+        _last_start = now;
+        if (now - _stat_start >= 1000000000) {
+            _jitter = (_stat_count ? _stat_sum / _stat_count : 0);
+            _max_jitter = _stat_max;
+            _stat_sum = _stat_max = _stat_count = 0;
+            _stat_start = now;
+        }
+        if (!_frame_ns) return;
+        /// Keep the average frame rate, but don't try to catch up after a long frame.
+        _deadline = (_deadline && now < _deadline + _frame_ns ? _deadline + _frame_ns : now + _frame_ns);
+    }
+
+    uint64_t FramePacer::jitterNS() const {
+        return _jitter;
+    }
+
+    uint64_t FramePacer::maxJitterNS() const {
+        return _max_jitter;
+    }
+
+    uint64_t FramePacer::lastFrameIntervalNS() const {
+        return _last_interval;
+    }
+
+    uint64_t FramePacer::oversleepNS() const {
+        return _oversleep_ns;
+    }
+
+    bool FramePacer::pacedByVSync() const {
+        return _vsync_ns && _frame_ns <= _vsync_ns;
+    }
+
+    uint64_t FramePacer::effectiveDeadline() const {
+        /// With VSync, present the frame at the vertical blank nearest to the deadline.
+        return _vsync_ns ? _deadline - std::min(_deadline, _vsync_ns / 2) : _deadline;
+    }
+}
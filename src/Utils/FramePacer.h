@@ -0,0 +1,65 @@
+#pragma once
+#ifndef MYENGINE_UTILS_FRAMEPACER_H
+#define MYENGINE_UTILS_FRAMEPACER_H
+#include "../Libs.h"
+
+namespace MyEngine {
+    /**
+     * \if EN
+     * @class MyEngine::FramePacer
+     * @brief Frame pacer used by the engine loop
+     * @details Instead of polling the time in a tight loop, the pacer sleeps for the most part of the remaining time
+     * (and wakes up early if an event is coming), then spins only for the last few hundred microseconds.
+     * The oversleeping of the system timer is measured and taken into account.
+     * @details If VSync is enabled and the frame time is not longer than the VSync interval,
+     * presenting the frame already paces the loop, so the pacer doesn't wait at all.
+     * \endif
+     */
+    class FramePacer {
+    public:
+        FramePacer() = default;
+        ~FramePacer() = default;
+
+        /// Set the target frame time in nanoseconds, `0` means unlimited.
+        void setFrameTime(uint64_t frame_ns);
+        [[nodiscard]] uint64_t frameTime() const;
+        /// Set the time spinning before the deadline, default is 300 us.
+        void setSpinThreshold(uint64_t spin_ns);
+        [[nodiscard]] uint64_t spinThreshold() const;
+        /// Set the VSync interval in nanoseconds, `0` means VSync is disabled.
+        void setVSyncInterval(uint64_t interval_ns);
+        [[nodiscard]] uint64_t vsyncInterval() const;
+
+        /// Check whether the next frame should be rendered now.
+        [[nodiscard]] bool isFrameDue() const;
+        /**
+         * \if EN
+         * @brief Wait for the next frame
+         * @return Return `true` if the frame is due, `false` if it is woken up by an event.
+         * \endif
+         */
+        bool wait();
+        /// Mark the beginning of a frame, update the deadline and the jitter statistics.
+        void frameStarted();
+
+        /// Get the average absolute difference between the frame interval and the target in the last second.
+        [[nodiscard]] uint64_t jitterNS() const;
+        /// Get the maximum absolute difference between the frame interval and the target in the last second.
+        [[nodiscard]] uint64_t maxJitterNS() const;
+        [[nodiscard]] uint64_t lastFrameIntervalNS() const;
+        /// Get the estimated oversleeping of the system timer.
+        [[nodiscard]] uint64_t oversleepNS() const;
+
+    private:
+        [[nodiscard]] bool pacedByVSync() const;
+        [[nodiscard]] uint64_t effectiveDeadline() const;
+
+        uint64_t _frame_ns{0}, _spin_ns{300000}, _vsync_ns{0};
+        uint64_t _deadline{0}, _last_start{0}, _last_interval{0};
+        uint64_t _oversleep_ns{1000000};
+        uint64_t _stat_start{0}, _stat_sum{0}, _stat_max{0}, _stat_count{0};
+        uint64_t _jitter{0}, _max_jitter{0};
+    };
+}
+
+#endif //MYENGINE_UTILS_FRAMEPACER_H
@@ -0,0 +1,303 @@
+#pragma once
+#ifndef MYENGINE_UTILS_INPLACEFUNCTION_H
+#define MYENGINE_UTILS_INPLACEFUNCTION_H
+#include "../Libs.h"
+
+namespace MyEngine {
+    template<typename Signature, size_t Capacity = 48, bool HeapFallback = false>
+    class InplaceFunction;
+
+    /**
+     * \if EN
+     * @class MyEngine::InplaceFunction
+     * @brief Move-only callable which never allocates
+     * @details The callable is always stored inside the object. A callable larger than `Capacity` bytes
+     * is a compile-time error, capture less (e.g. a pointer to the state) or raise the capacity.
+     * With `HeapFallback`, such a callable is allocated on heap instead, e.g. `TaskFunction`.
+     * Trivially copyable callables (e.g. lambdas only capturing pointers) are moved by `memcpy`.
+     * @code
+     * InplaceFunction<void(int)> callback = [this](int value) { _value = value; };
+     * callback(42);
+     * @endcode
+     * \endif
+     */
+    template<typename R, typename... Args, size_t Capacity, bool HeapFallback>
+    class InplaceFunction<R(Args...), Capacity, HeapFallback> {
+    public:
+        static constexpr size_t CAPACITY = Capacity;
+
+        InplaceFunction() = default;
+        InplaceFunction(std::nullptr_t) {}
+
+        template<typename F>
+        requires (!std::is_same_v<std::decay_t<F>, InplaceFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+        InplaceFunction(F&& function) {
+            using Fn = std::decay_t<F>;
+            if constexpr (!HeapFallback) {
+                static_assert(sizeof(Fn) <= Capacity,
+                              "InplaceFunction: The callable is too large, capture less or raise the capacity!");
+                static_assert(alignof(Fn) <= alignof(std::max_align_t),
+                              "InplaceFunction: The callable is over-aligned!");
+                static_assert(std::is_nothrow_move_constructible_v<Fn>,
+                              "InplaceFunction: The callable must be nothrow move constructible!");
+            }
+            /// A function reference decays to a pointer but is never null, so it is not checked.
+            if constexpr (!std::is_function_v<std::remove_reference_t<F>>
+                          && (std::is_pointer_v<Fn> || std::is_member_pointer_v<Fn> || isStdFunction<Fn>())) {
+                if (!function) return;
+            }
+            if constexpr (isInline<Fn>()) {
+                new (_storage) Fn(std::forward<F>(function));
+                _ops = &OPS<Fn>;
+            } else {
+                /// Only the pointer is stored, so it is moved by `memcpy`.
+                new (_storage) Fn*(new Fn(std::forward<F>(function)));
+                _ops = &HEAP_OPS<Fn>;
+            }
+        }
+
+        InplaceFunction(InplaceFunction&& other) noexcept {
+            moveFrom(other);
+        }
+
+        InplaceFunction& operator=(InplaceFunction&& other) noexcept {
+            if (this != &other) {
+                reset();
+                moveFrom(other);
+            }
+            return *this;
+        }
+
+        InplaceFunction& operator=(std::nullptr_t) {
+            reset();
+            return *this;
+        }
+
+        InplaceFunction(const InplaceFunction&) = delete;
+        InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+        ~InplaceFunction() {
+            reset();
+        }
+
+        R operator()(Args... args) {
+            return _ops->invoke(_storage, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const {
+            return _ops != nullptr;
+        }
+
+        void reset() {
+            if (_ops) {
+                if (_ops->destroy) _ops->destroy(_storage);
+                _ops = nullptr;
+            }
+        }
+
+    private:
+        struct Ops {
+            R (*invoke)(void*, Args&&...);
+            /// Null if the callable is trivially copyable.
+            void (*move)(void* dst, void* src);
+            /// Null if the callable is trivially destructible.
+            void (*destroy)(void*);
+        };
+
+        template<typename Sig>
+        static std::true_type isStdFunctionImpl(const std::function<Sig>*);
+        static std::false_type isStdFunctionImpl(const void*);
+        template<typename Fn>
+        static constexpr bool isStdFunction() {
+            return decltype(isStdFunctionImpl(static_cast<Fn*>(nullptr)))::value;
+        }
+
+        template<typename Fn>
+        static constexpr bool isInline() {
+            return sizeof(Fn) <= Capacity && alignof(Fn) <= alignof(std::max_align_t)
+                   && std::is_nothrow_move_constructible_v<Fn>;
+        }
+
+        template<typename Fn>
+        static R invoke(void* p, Args&&... args) {
+            if constexpr (std::is_void_v<R>) std::invoke(*static_cast<Fn*>(p), std::forward<Args>(args)...);
+            else return std::invoke(*static_cast<Fn*>(p), std::forward<Args>(args)...);
+        }
+
+        template<typename Fn>
+        static R invokeHeap(void* p, Args&&... args) {
+            return invoke<Fn>(*static_cast<Fn**>(p), std::forward<Args>(args)...);
+        }
+
+        template<typename Fn>
+        static void move(void* dst, void* src) {
+            new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+            static_cast<Fn*>(src)->~Fn();
+        }
+
+        template<typename Fn>
+        static void destroy(void* p) {
+            static_cast<Fn*>(p)->~Fn();
+        }
+
+        template<typename Fn>
+        static void destroyHeap(void* p) {
+            delete *static_cast<Fn**>(p);
+        }
+
+        template<typename Fn>
+        static constexpr Ops OPS{
+            &invoke<Fn>,
+            std::is_trivially_copyable_v<Fn> ? nullptr : &move<Fn>,
+            std::is_trivially_destructible_v<Fn> ? nullptr : &destroy<Fn>
+        };
+
+        template<typename Fn>
+        static constexpr Ops HEAP_OPS{&invokeHeap<Fn>, nullptr, &destroyHeap<Fn>};
+
+        void moveFrom(InplaceFunction& other) {
+            _ops = other._ops;
+            if (!_ops) return;
+            if (_ops->move) _ops->move(_storage, other._storage);
+            else std::memcpy(_storage, other._storage, Capacity);
+            other._ops = nullptr;
+        }
+
+        static_assert(!HeapFallback || Capacity >= sizeof(void*), "InplaceFunction: The capacity can't keep a pointer!");
+
+        alignas(std::max_align_t) unsigned char _storage[Capacity]{};
+        const Ops* _ops{nullptr};
+    };
+
+    /**
+     * \if EN
+     * @class MyEngine::CallbackList
+     * @brief Callbacks stored contiguously and looked up by ID
+     * @details It is safe to append or remove callbacks while the list is being invoked:
+     * the removed callbacks are skipped at once, the appended ones are invoked from the next time.
+     * The removed entries are erased after the outermost invoking finishes.
+     * \endif
+     */
+    template<typename Signature, size_t Capacity = 48>
+    class CallbackList;
+
+    template<typename... Args, size_t Capacity>
+    class CallbackList<void(Args...), Capacity> {
+    public:
+        using Function = InplaceFunction<void(Args...), Capacity>;
+
+        /// Append the callback, return false if the callback with the same ID is overwritten.
+        bool append(uint64_t id, Function function) {
+            auto it = _index.find(id);
+            if (it != _index.end()) {
+                if (it->second == PENDING) {
+                    std::find_if(_pending.begin(), _pending.end(),
+                                 [id](const Entry& entry) { return entry.id == id; })->function = std::move(function);
+                } else if (!_depth) {
+                    _entries[it->second].function = std::move(function);
+                } else {
+                    /// The old callback may be running, replace it after invoking.
+                    markRemoved(it->second);
+                    _pending.push_back({id, std::move(function)});
+                    it->second = PENDING;
+                }
+                return false;
+            }
+            if (_depth) {
+                _pending.push_back({id, std::move(function)});
+                _index.emplace(id, PENDING);
+            } else {
+                _index.emplace(id, _entries.size());
+                _entries.push_back({id, std::move(function)});
+            }
+            _count += 1;
+            return true;
+        }
+
+        /// Remove the callback, return false if it is not found.
+        bool remove(uint64_t id) {
+            auto it = _index.find(id);
+            if (it == _index.end()) return false;
+            if (it->second == PENDING) {
+                std::erase_if(_pending, [id](const Entry& entry) { return entry.id == id; });
+            } else {
+                markRemoved(it->second);
+            }
+            _index.erase(it);
+            _count -= 1;
+            if (!_depth && _removed > _entries.size() / 2) compact();
+            return true;
+        }
+
+        [[nodiscard]] bool contains(uint64_t id) const {
+            return _index.contains(id);
+        }
+
+        [[nodiscard]] size_t size() const {
+            return _count;
+        }
+
+        void clear() {
+            if (_depth) {
+                /// The entries are being invoked, they are erased by the outermost invoking.
+                for (size_t i = 0; i < _entries.size(); ++i) {
+                    if (!_entries[i].removed) markRemoved(i);
+                }
+            } else {
+                _entries.clear();
+                _removed = 0;
+            }
+            _pending.clear();
+            _index.clear();
+            _count = 0;
+        }
+
+        void operator()(Args... args) {
+            /// Leave the invoking even if a callback throws, or the appended callbacks would be pending forever.
+            struct DepthGuard {
+                explicit DepthGuard(CallbackList* l) : list(l) { list->_depth += 1; }
+                ~DepthGuard() { if (--list->_depth == 0) list->compact(); }
+                CallbackList* list;
+            } guard(this);
+            /// The entries appended while invoking are pending, so the size can't change here.
+            for (size_t i = 0, size = _entries.size(); i < size; ++i) {
+                auto& entry = _entries[i];
+                if (!entry.removed && entry.function) entry.function(args...);
+            }
+        }
+
+    private:
+        static constexpr size_t PENDING = SIZE_MAX;
+        struct Entry {
+            uint64_t id;
+            Function function;
+            bool removed{false};
+        };
+
+        void markRemoved(size_t index) {
+            _entries[index].removed = true;
+            _removed += 1;
+        }
+
+        void compact() {
+            if (_removed) {
+                std::erase_if(_entries, [](const Entry& entry) { return entry.removed; });
+                for (size_t i = 0; i < _entries.size(); ++i) _index[_entries[i].id] = i;
+                _removed = 0;
+            }
+            if (!_pending.empty()) {
+                for (auto& entry : _pending) {
+                    _index[entry.id] = _entries.size();
+                    _entries.push_back(std::move(entry));
+                }
+                _pending.clear();
+            }
+        }
+
+        std::vector<Entry> _entries, _pending;
+        std::unordered_map<uint64_t, size_t> _index;
+        size_t _count{0}, _removed{0}, _depth{0};
+    };
+}
+
+#endif //MYENGINE_UTILS_INPLACEFUNCTION_H
@@ -0,0 +1,121 @@
+#include "MappedFile.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Logger.h"
+
+namespace MyEngine {
+    MappedFile::MappedFile(const std::string& path) {
+        open(path);
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : _data(std::exchange(other._data, nullptr)), _size(std::exchange(other._size, 0)),
+          _path(std::move(other._path)) {
+#ifdef _WIN32
+        _mapping = std::exchange(other._mapping, nullptr);
+#endif
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+            _path = std::move(other._path);
+#ifdef _WIN32
+            _mapping = std::exchange(other._mapping, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    bool MappedFile::open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER file_size{};
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart <= 0) {
+            CloseHandle(file);
+            return false;
+        }
+        auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) return false;
+        auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) {
+            CloseHandle(mapping);
+            Logger::log(Logger::Warn, "MappedFile: Can't map file '{}'!", path);
+            return false;
+        }
+        _mapping = mapping;
+        _size = static_cast<size_t>(file_size.QuadPart);
+        _data = static_cast<const std::byte*>(view);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        struct stat info{};
+        if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+        auto view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        /// The mapping keeps the file alive, the descriptor is not needed any more.
+        ::close(fd);
+        if (view == MAP_FAILED) {
+            Logger::log(Logger::Warn, "MappedFile: Can't map file '{}'! Exception: {}", path, std::strerror(errno));
+            return false;
+        }
+        _size = static_cast<size_t>(info.st_size);
+        _data = static_cast<const std::byte*>(view);
+#endif
+        _path = path;
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (!_data) return;
+#ifdef _WIN32
+        UnmapViewOfFile(_data);
+        CloseHandle(_mapping);
+        _mapping = nullptr;
+#else
+        munmap(const_cast<std::byte*>(_data), _size);
+#endif
+        _data = nullptr;
+        _size = 0;
+        _path.clear();
+    }
+
+    bool MappedFile::isOpen() const {
+        return _data != nullptr;
+    }
+
+    const std::byte* MappedFile::data() const {
+        return _data;
+    }
+
+    size_t MappedFile::size() const {
+        return _size;
+    }
+
+    std::span<const std::byte> MappedFile::bytes() const {
+        return {_data, _size};
+    }
+
+    const std::string& MappedFile::path() const {
+        return _path;
+    }
+}
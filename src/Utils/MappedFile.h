@@ -0,0 +1,45 @@
+#pragma once
+#ifndef MYENGINE_UTILS_MAPPEDFILE_H
+#define MYENGINE_UTILS_MAPPEDFILE_H
+#include "../Libs.h"
+
+namespace MyEngine {
+    /**
+     * \if EN
+     * @class MyEngine::MappedFile
+     * @brief Read-only memory mapping of a file
+     * @details The pages are loaded by the OS on demand and shared with the other processes mapping the same file,
+     * so opening a large file costs nearly nothing until its bytes are read.
+     * @note The bytes are invalid after the file is closed. Don't map a file which may be truncated meanwhile.
+     * \endif
+     */
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const std::string& path);
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile();
+
+        /// Map the file, the file opened before is closed. Return false if it can't be mapped or it is empty.
+        bool open(const std::string& path);
+        void close();
+        [[nodiscard]] bool isOpen() const;
+        [[nodiscard]] const std::byte* data() const;
+        [[nodiscard]] size_t size() const;
+        [[nodiscard]] std::span<const std::byte> bytes() const;
+        [[nodiscard]] const std::string& path() const;
+
+    private:
+        const std::byte* _data{nullptr};
+        size_t _size{0};
+        std::string _path;
+#ifdef _WIN32
+        void* _mapping{nullptr};
+#endif
+    };
+}
+
+#endif //MYENGINE_UTILS_MAPPEDFILE_H
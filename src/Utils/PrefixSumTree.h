@@ -0,0 +1,116 @@
+#pragma once
+#ifndef MYENGINE_UTILS_PREFIXSUMTREE_H
+#define MYENGINE_UTILS_PREFIXSUMTREE_H
+#include "../Libs.h"
+
+namespace MyEngine {
+    /**
+     * \if EN
+     * @class MyEngine::PrefixSumTree
+     * @brief Array of non-negative values with O(log n) prefix sums, updating and searching by the sum
+     * @details It is a Fenwick tree, e.g. the heights of the rows of a list, so the top of a row
+     * and the row at a scrolled distance are found in O(log n) whatever the count of the rows is.
+     * Appending is O(log n) as well, inserting and erasing in the middle rebuild the tree in O(n).
+     * \endif
+     */
+    template<typename T>
+    class PrefixSumTree {
+        static_assert(std::is_arithmetic_v<T>, "PrefixSumTree: The value must be arithmetic!");
+    public:
+        PrefixSumTree() = default;
+        PrefixSumTree(size_t count, T value) { assign(count, value); }
+
+        void assign(size_t count, T value) {
+            _values.assign(count, value);
+            rebuild();
+        }
+
+        void clear() {
+            _values.clear();
+            _tree.clear();
+        }
+
+        void pushBack(T value) {
+            _values.push_back(value);
+            /// The new node covers (index - lowbit, index], it is the difference of two prefix sums.
+            auto index = _values.size();
+            auto low = index & (~index + 1);
+            _tree.push_back(value + prefix(index - 1) - prefix(index - low));
+        }
+
+        void insert(size_t index, size_t count, T value) {
+            index = std::min(index, _values.size());
+            if (index == _values.size() && count == 1) {
+                pushBack(value);
+                return;
+            }
+            _values.insert(_values.begin() + static_cast<ptrdiff_t>(index), count, value);
+            rebuild();
+        }
+
+        void erase(size_t index, size_t count) {
+            if (index >= _values.size()) return;
+            count = std::min(count, _values.size() - index);
+            auto first = _values.begin() + static_cast<ptrdiff_t>(index);
+            _values.erase(first, first + static_cast<ptrdiff_t>(count));
+            rebuild();
+        }
+
+        void set(size_t index, T value) {
+            if (index >= _values.size()) return;
+            auto delta = value - _values[index];
+            _values[index] = value;
+            for (auto i = index + 1; i <= _tree.size(); i += i & (~i + 1)) _tree[i - 1] += delta;
+        }
+
+        [[nodiscard]] T value(size_t index) const {
+            return index < _values.size() ? _values[index] : T{};
+        }
+
+        /// Get the sum of the first `count` values.
+        [[nodiscard]] T prefix(size_t count) const {
+            T sum{};
+            for (auto i = std::min(count, _tree.size()); i; i -= i & (~i + 1)) sum += _tree[i - 1];
+            return sum;
+        }
+
+        [[nodiscard]] T total() const {
+            return prefix(_values.size());
+        }
+
+        /**
+         * \if EN
+         * @brief Find the value containing `position`, i.e. the last index whose prefix sum is not over `position`
+         * @return The index, it is `size()` if `position` is not less than the total.
+         * \endif
+         */
+        [[nodiscard]] size_t find(T position) const {
+            size_t index = 0;
+            for (auto step = std::bit_floor(_tree.size()); step; step >>= 1) {
+                if (index + step <= _tree.size() && _tree[index + step - 1] <= position) {
+                    index += step;
+                    position -= _tree[index - 1];
+                }
+            }
+            return index;
+        }
+
+        [[nodiscard]] size_t size() const { return _values.size(); }
+        [[nodiscard]] bool empty() const { return _values.empty(); }
+
+    private:
+        /// Build the tree in O(n), every node adds itself to its parent.
+        void rebuild() {
+            _tree = _values;
+            for (size_t i = 1; i <= _tree.size(); ++i) {
+                auto parent = i + (i & (~i + 1));
+                if (parent <= _tree.size()) _tree[parent - 1] += _tree[i - 1];
+            }
+        }
+
+        std::vector<T> _values;
+        std::vector<T> _tree;
+    };
+}
+
+#endif //MYENGINE_UTILS_PREFIXSUMTREE_H
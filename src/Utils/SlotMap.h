@@ -0,0 +1,166 @@
+#pragma once
+#ifndef MYENGINE_UTILS_SLOTMAP_H
+#define MYENGINE_UTILS_SLOTMAP_H
+#include "../Libs.h"
+
+namespace MyEngine {
+    /**
+     * \if EN
+     * @class MyEngine::Handle
+     * @brief Typed handle made of a slot index and a generation
+     * @details `Tag` only distinguishes the handle types, e.g. a `TextHandle` can't be passed as a `FontHandle`.
+     * The default handle is null. The value can be stored or logged by `value()` and restored by `fromValue()`.
+     * \endif
+     */
+    template<typename Tag>
+    class Handle {
+    public:
+        constexpr Handle() = default;
+        constexpr Handle(uint32_t index, uint32_t generation)
+            : _value(static_cast<uint64_t>(generation) << 32 | index) {}
+        static constexpr Handle fromValue(uint64_t value) {
+            Handle handle;
+            handle._value = value;
+            return handle;
+        }
+
+        [[nodiscard]] constexpr uint32_t index() const { return static_cast<uint32_t>(_value); }
+        [[nodiscard]] constexpr uint32_t generation() const { return static_cast<uint32_t>(_value >> 32); }
+        [[nodiscard]] constexpr uint64_t value() const { return _value; }
+        [[nodiscard]] constexpr bool isNull() const { return _value == 0; }
+        constexpr explicit operator bool() const { return _value != 0; }
+        constexpr auto operator<=>(const Handle&) const = default;
+
+    private:
+        uint64_t _value{0};
+    };
+
+    /**
+     * \if EN
+     * @class MyEngine::SlotMap
+     * @brief Generational slot map with O(1) insertion, lookup and erasing
+     * @details The values are stored densely, so iterating is as fast as iterating a `std::vector`.
+     * Every slot has a generation which is increased when the value is erased,
+     * so a handle of an erased value is detected (`get()` returns null) even after the slot is reused.
+     * @note Erasing moves the last value into the erased place, so the order of the values is not kept,
+     * and the pointers to the values are valid until the next insertion or erasing. Keep the handles instead.
+     * \endif
+     */
+    template<typename T, typename Tag = T>
+    class SlotMap {
+    public:
+        using HandleType = Handle<Tag>;
+        using iterator = typename std::vector<T>::iterator;
+        using const_iterator = typename std::vector<T>::const_iterator;
+
+        template<typename... Args>
+        HandleType emplace(Args&&... args) {
+            uint32_t slot_index;
+            if (_free_head != NO_SLOT) {
+                slot_index = _free_head;
+                _free_head = _slots[slot_index].index;
+            } else {
+                slot_index = static_cast<uint32_t>(_slots.size());
+                _slots.emplace_back();
+            }
+            _values.emplace_back(std::forward<Args>(args)...);
+            _value_slots.push_back(slot_index);
+            auto& slot = _slots[slot_index];
+            /// An odd generation means the slot is in use, so the null handle never matches.
+            slot.generation += 1;
+            slot.index = static_cast<uint32_t>(_values.size() - 1);
+            return {slot_index, slot.generation};
+        }
+
+        HandleType insert(T value) {
+            return emplace(std::move(value));
+        }
+
+        bool erase(HandleType handle) {
+            if (!contains(handle)) return false;
+            auto& slot = _slots[handle.index()];
+            auto index = slot.index;
+            if (index + 1 != _values.size()) {
+                _values[index] = std::move(_values.back());
+                _value_slots[index] = _value_slots.back();
+                _slots[_value_slots[index]].index = index;
+            }
+            _values.pop_back();
+            _value_slots.pop_back();
+            slot.generation += 1;
+            slot.index = _free_head;
+            _free_head = handle.index();
+            return true;
+        }
+
+        [[nodiscard]] bool contains(HandleType handle) const {
+            return handle.index() < _slots.size() && _slots[handle.index()].generation == handle.generation()
+                   && (handle.generation() & 1);
+        }
+
+        /// Get the value, return null if the handle is null or stale.
+        T* get(HandleType handle) {
+            return contains(handle) ? &_values[_slots[handle.index()].index] : nullptr;
+        }
+
+        const T* get(HandleType handle) const {
+            return contains(handle) ? &_values[_slots[handle.index()].index] : nullptr;
+        }
+
+        /// Get the handle of the value at `index` of the dense storage, e.g. while iterating.
+        [[nodiscard]] HandleType handleAt(size_t index) const {
+            auto slot_index = _value_slots[index];
+            return {slot_index, _slots[slot_index].generation};
+        }
+
+        [[nodiscard]] size_t size() const { return _values.size(); }
+        [[nodiscard]] bool empty() const { return _values.empty(); }
+
+        void reserve(size_t count) {
+            _values.reserve(count);
+            _value_slots.reserve(count);
+            _slots.reserve(count);
+        }
+
+        /// Erase all values, the handles got before are all stale after clearing.
+        void clear() {
+            for (auto slot_index : _value_slots) {
+                auto& slot = _slots[slot_index];
+                slot.generation += 1;
+                slot.index = _free_head;
+                _free_head = slot_index;
+            }
+            _values.clear();
+            _value_slots.clear();
+        }
+
+        iterator begin() { return _values.begin(); }
+        iterator end() { return _values.end(); }
+        const_iterator begin() const { return _values.cbegin(); }
+        const_iterator end() const { return _values.cend(); }
+        std::span<T> values() { return _values; }
+        std::span<const T> values() const { return _values; }
+
+    private:
+        static constexpr uint32_t NO_SLOT = UINT32_MAX;
+        struct Slot {
+            uint32_t generation{0};
+            /// The index of the value if the slot is used, otherwise the next free slot.
+            uint32_t index{NO_SLOT};
+        };
+
+        std::vector<T> _values;
+        std::vector<uint32_t> _value_slots;
+        std::vector<Slot> _slots;
+        uint32_t _free_head{NO_SLOT};
+    };
+}
+
+template<typename Tag>
+struct std::hash<MyEngine::Handle<Tag>> {
+    size_t operator()(const MyEngine::Handle<Tag>& handle) const noexcept {
+        return std::hash<uint64_t>{}(handle.value());
+    }
+};
+
+#endif //MYENGINE_UTILS_SLOTMAP_H
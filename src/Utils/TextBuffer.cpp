@@ -0,0 +1,192 @@
+
+#include "TextBuffer.h"
+
+namespace MyEngine {
+    TextBuffer::TextBuffer(std::string_view text) {
+        insert(0, text);
+    }
+
+    void TextBuffer::setMeasure(Measure measure) {
+        _measure = std::move(measure);
+        remeasure();
+    }
+
+    void TextBuffer::remeasure() {
+        _advance_before = 0;
+        _advance_after = 0;
+        auto gap = _lengths.gapPosition();
+        uint32_t previous = 0;
+        size_t offset = 0;
+        for (size_t i = 0; i < size(); ++i) {
+            char buffer[4];
+            size_t length = _lengths[i];
+            _bytes.copy(offset, length, buffer);
+            offset += length;
+            const char* str = buffer;
+            auto current = SDL_StepUTF8(&str, &length);
+            auto value = measure(previous, current);
+            _advances[i] = value;
+            (i < gap ? _advance_before : _advance_after) += value;
+            previous = current;
+        }
+    }
+
+    void TextBuffer::setText(std::string_view text) {
+        clear();
+        insert(0, text);
+    }
+
+    size_t TextBuffer::insert(size_t index, std::string_view text) {
+        index = std::min(index, size());
+        moveGap(index);
+        std::vector<uint8_t> lengths;
+        std::vector<float> advances;
+        lengths.reserve(text.size());
+        advances.reserve(text.size());
+        uint32_t previous = index ? codepoint(index - 1) : 0;
+        auto str = text.data();
+        auto length = text.size();
+        double total = 0;
+        while (length) {
+            auto begin = str;
+            auto current = SDL_StepUTF8(&str, &length);
+            /// Stop at the null character, the bytes after it are not a part of the string.
+            if (str == begin || !current) break;
+            lengths.push_back(static_cast<uint8_t>(str - begin));
+            advances.push_back(measure(previous, current));
+            total += advances.back();
+            previous = current;
+        }
+        auto bytes = static_cast<size_t>(str - text.data());
+        _bytes.insert(_bytes.gapPosition(), text.data(), bytes);
+        _lengths.insert(index, lengths.data(), lengths.size());
+        _advances.insert(index, advances.data(), advances.size());
+        _advance_before += total;
+        remeasureAfterGap();
+        return lengths.size();
+    }
+
+    size_t TextBuffer::erase(size_t index, size_t count) {
+        if (index >= size()) return 0;
+        count = std::min(count, size() - index);
+        moveGap(index);
+        size_t bytes = 0;
+        for (size_t i = index; i < index + count; ++i) {
+            bytes += _lengths[i];
+            _advance_after -= _advances[i];
+        }
+        _bytes.erase(_bytes.gapPosition(), bytes);
+        _lengths.erase(index, count);
+        _advances.erase(index, count);
+        remeasureAfterGap();
+        return count;
+    }
+
+    void TextBuffer::clear() {
+        _bytes.clear();
+        _lengths.clear();
+        _advances.clear();
+        _advance_before = 0;
+        _advance_after = 0;
+    }
+
+    size_t TextBuffer::size() const {
+        return _lengths.size();
+    }
+
+    size_t TextBuffer::byteSize() const {
+        return _bytes.size();
+    }
+
+    bool TextBuffer::empty() const {
+        return _lengths.empty();
+    }
+
+    uint32_t TextBuffer::codepoint(size_t index) const {
+        if (index >= size()) return 0;
+        char buffer[4];
+        size_t length = _lengths[index];
+        _bytes.copy(byteOffset(index), length, buffer);
+        const char* str = buffer;
+        return SDL_StepUTF8(&str, &length);
+    }
+
+    float TextBuffer::advance(size_t index) const {
+        return index < size() ? _advances[index] : 0.f;
+    }
+
+    float TextBuffer::position(size_t index) const {
+        index = std::min(index, size());
+        auto gap = _advances.gapPosition();
+        double x = _advance_before;
+        for (auto i = index; i < gap; ++i) x -= _advances[i];
+        for (auto i = gap; i < index; ++i) x += _advances[i];
+        return static_cast<float>(std::max(x, 0.0));
+    }
+
+    float TextBuffer::totalAdvance() const {
+        return static_cast<float>(_advance_before + _advance_after);
+    }
+
+    size_t TextBuffer::byteOffset(size_t index) const {
+        index = std::min(index, size());
+        auto gap = _lengths.gapPosition();
+        auto offset = _bytes.gapPosition();
+        for (auto i = index; i < gap; ++i) offset -= _lengths[i];
+        for (auto i = gap; i < index; ++i) offset += _lengths[i];
+        return offset;
+    }
+
+    std::string TextBuffer::substr(size_t first, size_t last) const {
+        last = std::min(last, size());
+        if (first >= last) return {};
+        auto begin = byteOffset(first), end = byteOffset(last);
+        std::string result(end - begin, '\0');
+        _bytes.copy(begin, end - begin, result.data());
+        return result;
+    }
+
+    std::string TextBuffer::toString() const {
+        std::string result(_bytes.size(), '\0');
+        _bytes.copy(0, _bytes.size(), result.data());
+        return result;
+    }
+
+    void TextBuffer::moveGap(size_t index) {
+        auto gap = _lengths.gapPosition();
+        if (index == gap) return;
+        size_t bytes = 0;
+        double advance = 0;
+        if (index < gap) {
+            for (auto i = index; i < gap; ++i) {
+                bytes += _lengths[i];
+                advance += _advances[i];
+            }
+            _bytes.moveGap(_bytes.gapPosition() - bytes);
+            _advance_before -= advance;
+            _advance_after += advance;
+        } else {
+            for (auto i = gap; i < index; ++i) {
+                bytes += _lengths[i];
+                advance += _advances[i];
+            }
+            _bytes.moveGap(_bytes.gapPosition() + bytes);
+            _advance_before += advance;
+            _advance_after -= advance;
+        }
+        _lengths.moveGap(index);
+        _advances.moveGap(index);
+    }
+
+    float TextBuffer::measure(uint32_t previous, uint32_t codepoint) {
+        return _measure ? _measure(previous, codepoint) : 0.f;
+    }
+
+    void TextBuffer::remeasureAfterGap() {
+        auto gap = _lengths.gapPosition();
+        if (gap >= size()) return;
+        auto value = measure(gap ? codepoint(gap - 1) : 0, codepoint(gap));
+        _advance_after += value - _advances[gap];
+        _advances[gap] = value;
+    }
+}
@@ -0,0 +1,156 @@
+#pragma once
+#ifndef MYENGINE_UTILS_TEXTBUFFER_H
+#define MYENGINE_UTILS_TEXTBUFFER_H
+#include "../Libs.h"
+#include "InplaceFunction.h"
+
+namespace MyEngine {
+    /**
+     * \if EN
+     * @class MyEngine::GapVector
+     * @brief Array with a movable gap, the insertion and erasing at the gap are O(1)
+     * @details Editing at another position moves the gap there first, the cost is the distance of moving,
+     * so the edits near each other (e.g. typing at the caret) never shift the whole array.
+     * \endif
+     */
+    template<typename T>
+    class GapVector {
+        static_assert(std::is_trivially_copyable_v<T>, "GapVector: The element must be trivially copyable!");
+    public:
+        [[nodiscard]] size_t size() const { return _data.size() - (_gap_end - _gap_begin); }
+        [[nodiscard]] bool empty() const { return size() == 0; }
+        /// Get the logical position of the gap.
+        [[nodiscard]] size_t gapPosition() const { return _gap_begin; }
+
+        const T& operator[](size_t index) const {
+            return index < _gap_begin ? _data[index] : _data[index + (_gap_end - _gap_begin)];
+        }
+
+        T& operator[](size_t index) {
+            return index < _gap_begin ? _data[index] : _data[index + (_gap_end - _gap_begin)];
+        }
+
+        void moveGap(size_t position) {
+            position = std::min(position, size());
+            if (position < _gap_begin) {
+                auto count = _gap_begin - position;
+                std::copy_backward(_data.begin() + position, _data.begin() + _gap_begin, _data.begin() + _gap_end);
+                _gap_begin -= count;
+                _gap_end -= count;
+            } else if (position > _gap_begin) {
+                auto count = position - _gap_begin;
+                std::copy(_data.begin() + _gap_end, _data.begin() + _gap_end + count, _data.begin() + _gap_begin);
+                _gap_begin += count;
+                _gap_end += count;
+            }
+        }
+
+        void insert(size_t position, const T* values, size_t count) {
+            moveGap(position);
+            reserveGap(count);
+            std::copy(values, values + count, _data.begin() + _gap_begin);
+            _gap_begin += count;
+        }
+
+        void erase(size_t position, size_t count) {
+            moveGap(position);
+            _gap_end += std::min(count, _data.size() - _gap_end);
+        }
+
+        void clear() {
+            _gap_begin = 0;
+            _gap_end = _data.size();
+        }
+
+        /// Copy the elements in [first, first + count) to `out`.
+        void copy(size_t first, size_t count, T* out) const {
+            auto last = first + count;
+            if (first < _gap_begin) {
+                auto end = std::min(last, _gap_begin);
+                out = std::copy(_data.begin() + first, _data.begin() + end, out);
+                first = end;
+            }
+            if (first < last) {
+                auto offset = _gap_end - _gap_begin;
+                std::copy(_data.begin() + first + offset, _data.begin() + last + offset, out);
+            }
+        }
+
+    private:
+        void reserveGap(size_t count) {
+            if (_gap_end - _gap_begin >= count) return;
+            auto size = this->size();
+            auto capacity = std::max({size + count, size * 2, size_t(64)});
+            std::vector<T> data(capacity);
+            std::copy(_data.begin(), _data.begin() + _gap_begin, data.begin());
+            auto suffix = _data.size() - _gap_end;
+            std::copy(_data.begin() + _gap_end, _data.end(), data.end() - suffix);
+            _data = std::move(data);
+            _gap_end = _data.size() - suffix;
+        }
+
+        std::vector<T> _data;
+        size_t _gap_begin{0}, _gap_end{0};
+    };
+
+    /**
+     * \if EN
+     * @class MyEngine::TextBuffer
+     * @brief Editable UTF-8 text stored in gap buffers, indexed by code points
+     * @details The bytes, the byte length and the advance of every code point are kept in three gap buffers
+     * whose gaps are always at the same code point, so the edits and the caret queries near the last edit
+     * cost the distance only, not the length of the text.
+     * The advances are measured by the function set by `setMeasure()` when the code points are inserted,
+     * and the sum of the advances before the gap is kept, so the caret position is known without laying out.
+     * \endif
+     */
+    class TextBuffer {
+    public:
+        /// Return the advance of `codepoint` including the kerning with `previous` (0 at the line start).
+        using Measure = InplaceFunction<float(uint32_t previous, uint32_t codepoint)>;
+
+        TextBuffer() = default;
+        explicit TextBuffer(std::string_view text);
+
+        void setMeasure(Measure measure);
+        /// Measure all code points again, it is called after the font is changed.
+        void remeasure();
+
+        void setText(std::string_view text);
+        /// Insert the UTF-8 text before the code point at `index`, return the count of the inserted code points.
+        size_t insert(size_t index, std::string_view text);
+        /// Erase `count` code points from `index`, return the count of the erased code points.
+        size_t erase(size_t index, size_t count);
+        void clear();
+
+        /// Get the count of the code points.
+        [[nodiscard]] size_t size() const;
+        [[nodiscard]] size_t byteSize() const;
+        [[nodiscard]] bool empty() const;
+        [[nodiscard]] uint32_t codepoint(size_t index) const;
+        [[nodiscard]] float advance(size_t index) const;
+        /// Get the x of the code point at `index`, it is O(1) at the last edited position.
+        [[nodiscard]] float position(size_t index) const;
+        [[nodiscard]] float totalAdvance() const;
+        /// Get the byte offset of the code point at `index`.
+        [[nodiscard]] size_t byteOffset(size_t index) const;
+        /// Copy the code points in [first, last) as a UTF-8 string.
+        [[nodiscard]] std::string substr(size_t first, size_t last) const;
+        [[nodiscard]] std::string toString() const;
+
+    private:
+        void moveGap(size_t index);
+        float measure(uint32_t previous, uint32_t codepoint);
+        /// Measure the code point after the gap again, its previous code point is changed.
+        void remeasureAfterGap();
+
+        GapVector<char> _bytes;
+        GapVector<uint8_t> _lengths;
+        GapVector<float> _advances;
+        Measure _measure;
+        /// The sum of the advances before and after the gap, double keeps the error small over many edits.
+        double _advance_before{0}, _advance_after{0};
+    };
+}
+
+#endif //MYENGINE_UTILS_TEXTBUFFER_H
@@ -2,8 +2,19 @@
 #include "AbstractLayout.h"
 
 #include <utility>
+#include <unordered_set>
 
 namespace MyEngine::Widget {
+    namespace {
+        /// The rounds of the layout pass before the layouts invalidating each other are left to the next frame.
+        constexpr uint32_t MAX_PASS_ROUNDS = 8;
+        /// The dirty layouts of every window, a destroyed layout is set to null.
+        std::unordered_map<uint32_t, std::vector<AbstractLayout*>> pending_layouts;
+        /// The windows with the layout pass installed.
+        std::unordered_set<uint32_t> pass_windows;
+        /// The window running its layout pass, the layouts invalidated in it are laid out in the same pass.
+        uint32_t passing_window = 0;
+    }
 
     AbstractLayout::AbstractLayout(std::string object_name, Window *window)
             : AbstractWidget(std::move(object_name), window), _margin(0, 0, 0, 0) {}
@@ -14,21 +25,31 @@ namespace MyEngine::Widget {
     AbstractLayout::AbstractLayout(Window *window)
             : AbstractWidget(window), _margin(0, 0, 0, 0) {}
 
-    AbstractLayout::~AbstractLayout() = default;
+    AbstractLayout::~AbstractLayout() {
+        if (!_layout_window) return;
+        auto iter = pending_layouts.find(_layout_window);
+        if (iter != pending_layouts.end()) std::ranges::replace(iter->second, this, nullptr);
+    }
 
     void AbstractLayout::addWidget(AbstractWidget *widget) {
-        if (!widget->parent()) {
+        if (!widget) return;
+        if (widget->parent()) {
+            if (widget->parent() != this) {
+                Logger::log(Logger::Warn, "AbstractLayout ({}): Widget \"{}\" is already had its parent! Skipped adding widget to layout! ", objectName(), widget->objectName());
+                return;
+            }
+            if (indexOf(widget)) return;
+        } else {
             widget->setParent(this);
-            _widgets.emplace_back(widget);
-        } else if (widget->parent() != this) {
-            Logger::log(Logger::Warn, "AbstractLayout ({}): Widget \"{}\" is already had its parent! Skipped adding widget to layout! ", objectName(), widget->objectName());
-            return;
         }
         _widgets.emplace_back(widget);
-        layoutChanged();
+        _stretches.emplace_back(1.f);
+        invalidateLayout();
     }
 
     void AbstractLayout::addWidgets(const std::vector<AbstractWidget *> &widgets) {
+        _widgets.reserve(_widgets.size() + widgets.size());
+        _stretches.reserve(_stretches.size() + widgets.size());
         for (auto& w : widgets) {
             if (w->parent()) {
                 Logger::log(Logger::Warn, "AbstractLayout ({}): Widget \"{}\" is already had its parent! Skipped adding widget to layout! ", objectName(), w->objectName());
@@ -37,26 +58,29 @@ namespace MyEngine::Widget {
             w->setParent(this);
 
             _widgets.emplace_back(w);
+            _stretches.emplace_back(1.f);
         }
-        layoutChanged();
+        invalidateLayout();
     }
 
     void AbstractLayout::removeWidget(AbstractWidget *widget) {
         auto idx = indexOf(widget);
         if (!idx) return;
-        _widgets.at(idx.value())->setParent(nullptr);
-        _widgets.erase(_widgets.begin() + idx.value());
-        layoutChanged();
+        removeWidget(static_cast<uint32_t>(idx.value()));
     }
 
     void AbstractLayout::removeWidget(uint32_t index) {
-        _widgets.erase(_widgets.cbegin() + index);
-        layoutChanged();
+        if (index >= _widgets.size()) return;
+        _widgets[index]->setParent(nullptr);
+        _widgets.erase(_widgets.begin() + index);
+        _stretches.erase(_stretches.begin() + index);
+        invalidateLayout();
     }
 
     void AbstractLayout::removeWidget(const std::string &object_name) {
-        std::erase_if(_widgets, [&object_name](AbstractWidget* w) { return w->objectName() == object_name; });
-        layoutChanged();
+        for (size_t i = _widgets.size(); i > 0; --i) {
+            if (_widgets[i - 1]->objectName() == object_name) removeWidget(static_cast<uint32_t>(i - 1));
+        }
     }
 
     std::optional<AbstractWidget *> AbstractLayout::widget(const std::string &object_name) const {
@@ -76,15 +100,14 @@ namespace MyEngine::Widget {
         if (!widget_1 || !widget_2) return false;
         auto idx1 = indexOf(widget_1), idx2 = indexOf(widget_2);
         if (!idx1 || !idx2) return false;
-        std::swap(_widgets[idx1.value()], _widgets[idx2.value()]);
-        layoutChanged();
-        return true;
+        return swapWidget(static_cast<uint32_t>(idx1.value()), static_cast<uint32_t>(idx2.value()));
     }
 
     bool AbstractLayout::swapWidget(uint32_t index_1, uint32_t index_2) {
-        if (index_1 > _widgets.size() || index_2 > _widgets.size()) return false;
+        if (index_1 >= _widgets.size() || index_2 >= _widgets.size()) return false;
         std::swap(_widgets[index_1], _widgets[index_2]);
-        layoutChanged();
+        std::swap(_stretches[index_1], _stretches[index_2]);
+        invalidateLayout();
         return true;
     }
 
@@ -102,8 +125,7 @@ namespace MyEngine::Widget {
                 .top = margin,
                 .bottom = margin
         };
-        resizeLayout();
-        layoutChanged();
+        invalidateLayout();
     }
 
     void AbstractLayout::setMargin(float h, float v) {
@@ -113,34 +135,30 @@ namespace MyEngine::Widget {
                 .top = v,
                 .bottom = v
         };
-        resizeLayout();
-        layoutChanged();
+        invalidateLayout();
     }
 
     void AbstractLayout::setMargin(const Margin &margin) {
         _margin = margin;
-        resizeLayout();
-        layoutChanged();
+        invalidateLayout();
     }
 
     const Margin &AbstractLayout::margin() const {
         return _margin;
     }
-    
+
     void AbstractLayout::setPadding(float padding) {
         _padding_h = padding;
         _padding_v = padding;
-        resizeLayout();
-        layoutChanged();
+        invalidateLayout();
     }
 
     void AbstractLayout::setPadding(float h, float v) {
         _padding_h = h;
         _padding_v = v;
-        resizeLayout();
-        layoutChanged();
+        invalidateLayout();
     }
-    
+
     float AbstractLayout::paddingHorizontal() const {
         return _padding_h;
     }
@@ -149,6 +167,46 @@ namespace MyEngine::Widget {
         return _padding_v;
     }
 
+    void AbstractLayout::setStretch(AbstractWidget *widget, float stretch) {
+        auto idx = indexOf(widget);
+        if (!idx) {
+            Logger::log(Logger::Warn, "AbstractLayout ({}): The widget is not in the layout! Skipped setting its stretch!", objectName());
+            return;
+        }
+        _stretches[idx.value()] = std::max(stretch, 0.f);
+        invalidateLayout();
+    }
+
+    float AbstractLayout::stretch(AbstractWidget *widget) const {
+        auto iter = std::find(_widgets.begin(), _widgets.end(), widget);
+        if (iter == _widgets.end()) return 0.f;
+        return _stretches[iter - _widgets.begin()];
+    }
+
+    void AbstractLayout::invalidateLayout() {
+        if (_layout_dirty) return;
+        _layout_dirty = true;
+        _layout_window = _window->windowID();
+        pending_layouts[_layout_window].emplace_back(this);
+        if (pass_windows.insert(_layout_window).second) {
+            /// The pass is installed in the front, so it is run before the widgets are painted.
+            _window->installPaintEvent([window_id = _layout_window](Renderer*) {
+                runLayoutPass(window_id);
+            });
+        }
+        if (passing_window != _layout_window) requestRedraw();
+    }
+
+    void AbstractLayout::updateLayout() {
+        auto render_geometry = geometry();
+        if (_parent) calcRenderGeometry(_parent, render_geometry);
+        runLayout(render_geometry);
+    }
+
+    bool AbstractLayout::isLayoutDirty() const {
+        return _layout_dirty;
+    }
+
     void AbstractLayout::loadEvent() {
     }
 
@@ -168,10 +226,53 @@ namespace MyEngine::Widget {
         }
     }
 
+    void AbstractLayout::moveEvent(const Vector2 &position) {
+        AbstractWidget::moveEvent(position);
+        invalidateLayout();
+    }
+
     void AbstractLayout::resizeEvent(const Size &size) {
         AbstractWidget::resizeEvent(size);
-        resizeLayout();
-        layoutChanged();
+        invalidateLayout();
+    }
+
+    void AbstractLayout::placeWidget(AbstractWidget *widget, const GeometryF &geometry) {
+        if (!_in_pass) {
+            widget->setGeometry(geometry);
+            return;
+        }
+        /// The same as `calcRenderGeometry()`, but the render geometry of the layout is known.
+        GeometryF render_geometry(geometry.pos.x + _pass_render.pos.x, geometry.pos.y + _pass_render.pos.y,
+                                  std::min(_pass_render.size.width - geometry.pos.x, geometry.size.width),
+                                  std::min(_pass_render.size.height - geometry.pos.y, geometry.size.height));
+        auto new_render = toGeometryInt(render_geometry);
+        auto& old_render = widget->_render_geometry;
+        bool moved = widget->geometry().pos != geometry.pos;
+        bool resized = widget->geometry().size != geometry.size;
+        bool render_changed = old_render.x != new_render.x || old_render.y != new_render.y ||
+                              old_render.width != new_render.width || old_render.height != new_render.height;
+        auto layout = dynamic_cast<AbstractLayout*>(widget);
+        if (moved || resized) widget->_trigger_area.setGeometry(geometry);
+        if (render_changed) {
+            widget->_render_geometry.setGeometry(new_render);
+            widget->_status.viewport_changed = false;
+            /// The inner layout is laid out below instead of being added to the pass by its events.
+            if (layout) layout->_layout_dirty = true;
+        }
+        if (moved) widget->moveEvent(geometry.pos);
+        if (resized) widget->resizeEvent(geometry.size);
+        if (layout && layout->_layout_dirty) layout->runLayout(render_geometry);
+    }
+
+    const std::vector<float> &AbstractLayout::solveLengths(bool horizontal, float length) {
+        _length_solver.begin(_widgets.size());
+        for (size_t i = 0; i < _widgets.size(); ++i) {
+            auto& min_size = _widgets[i]->_min_size;
+            auto& max_size = _widgets[i]->_max_size;
+            _length_solver.append(horizontal ? min_size.width : min_size.height,
+                                  horizontal ? max_size.width : max_size.height, _stretches[i]);
+        }
+        return _length_solver.solve(length);
     }
 
     void AbstractLayout::resizeLayout() {
@@ -180,5 +281,50 @@ namespace MyEngine::Widget {
                                 geometry().size.height - _margin.top - _margin.bottom);
     }
 
+    void AbstractLayout::runLayout(const GeometryF &render_geometry) {
+        _layout_dirty = false;
+        resizeLayout();
+        _in_pass = true;
+        _pass_render = render_geometry;
+        layoutChanged();
+        _in_pass = false;
+    }
+
+    uint32_t AbstractLayout::layoutDepth() const {
+        uint32_t depth = 0;
+        for (auto parent = _parent; parent; parent = parent->_parent) ++depth;
+        return depth;
+    }
+
+    void AbstractLayout::runLayoutPass(uint32_t window_id) {
+        auto iter = pending_layouts.find(window_id);
+        if (iter == pending_layouts.end()) return;
+        auto& layouts = iter->second;
+        passing_window = window_id;
+        for (uint32_t round = 0; !layouts.empty(); ++round) {
+            if (round == MAX_PASS_ROUNDS) {
+                Logger::log(Logger::Warn, "AbstractLayout: The layouts of window {} are still invalidated after {} rounds! "
+                                          "Left them to the next frame!", window_id, MAX_PASS_ROUNDS);
+                for (auto layout : layouts) {
+                    if (layout) {
+                        layout->requestRedraw();
+                        break;
+                    }
+                }
+                break;
+            }
+            /// The outer layouts are laid out first, they lay out the inner ones they change.
+            std::erase(layouts, nullptr);
+            std::ranges::stable_sort(layouts, {}, [](AbstractLayout* layout) { return layout->layoutDepth(); });
+            auto count = layouts.size();
+            for (size_t i = 0; i < count; ++i) {
+                /// The list may grow while laying out, so it is indexed every time.
+                auto layout = layouts[i];
+                if (layout && layout->_layout_dirty) layout->updateLayout();
+            }
+            layouts.erase(layouts.begin(), layouts.begin() + static_cast<std::ptrdiff_t>(count));
+        }
+        passing_window = 0;
+    }
 
-} // MyEngine::Widget
\ No newline at end of file
+} // MyEngine::Widget
@@ -3,6 +3,7 @@
 #define MYENGINE_WIDGETS_ABSTRACTLAYOUT_H
 
 #include "AbstractWidget.h"
+#include "LengthSolver.h"
 
 namespace MyEngine {
     namespace Widget {
@@ -10,6 +11,17 @@ namespace MyEngine {
             float left, right, top, bottom;
         };
 
+        /**
+         * \if EN
+         * @class MyEngine::Widget::AbstractLayout
+         * @brief Base of the layouts arranging their widgets in the padding geometry
+         * @details Changing the widgets, the margin, the padding or the geometry only marks the layout dirty.
+         * The dirty layouts of a window are laid out once in a pass before the widgets are painted,
+         * from the outer layouts to the inner ones, so building a layout of n widgets costs O(n).
+         * The lengths of the widgets are solved from their minimum and maximum sizes and the stretches,
+         * and they are reused while the constraints and the length of the layout are not changed.
+         * \endif
+         */
         class AbstractLayout : public AbstractWidget {
         public:
             explicit AbstractLayout(std::string object_name, Window* window);
@@ -38,20 +50,49 @@ namespace MyEngine {
             [[nodiscard]] float paddingHorizontal() const;
             [[nodiscard]] float paddingVertical() const;
 
+            /// Set the share of the free length given to the widget, 0 keeps it at its minimum size. Default is 1.
+            void setStretch(AbstractWidget* widget, float stretch);
+            [[nodiscard]] float stretch(AbstractWidget* widget) const;
+
+            /// Mark the layout dirty, it is laid out in the layout pass before the next frame is painted.
+            void invalidateLayout();
+            /// Lay out the widgets now instead of waiting for the layout pass.
+            void updateLayout();
+            [[nodiscard]] bool isLayoutDirty() const;
+
         protected:
             void loadEvent() override;
             void paintEvent(MyEngine::Renderer *renderer) override;
             void enableChangedEvent(bool enabled) override;
             void visibleChangedEvent(bool visible) override;
+            void moveEvent(const MyEngine::Vector2 &position) override;
             void resizeEvent(const MyEngine::Size &size) override;
+            /// Place the widgets in the padding geometry, it is called by the layout pass.
             virtual void layoutChanged() = 0;
+            /// Set the geometry of the widget, in the layout pass its render geometry is taken from the layout
+            /// instead of being calculated through all the parents, and nothing is done if it is not changed.
+            void placeWidget(AbstractWidget* widget, const GeometryF& geometry);
+            /// Get the lengths of the widgets along the axis fitting in `length` without the paddings.
+            const std::vector<float>& solveLengths(bool horizontal, float length);
 
             std::vector<AbstractWidget*> _widgets;
+            /// The stretch of every widget, in the same order as `_widgets`.
+            std::vector<float> _stretches;
             Margin _margin;
             float _padding_h{0}, _padding_v{0};
             GeometryF _padding_geometry;
         private:
             void resizeLayout();
+            void runLayout(const GeometryF& render_geometry);
+            [[nodiscard]] uint32_t layoutDepth() const;
+            static void runLayoutPass(uint32_t window_id);
+
+            bool _layout_dirty{false};
+            /// Whether `layoutChanged()` is called by the layout pass, and the render geometry it is placed in.
+            bool _in_pass{false};
+            GeometryF _pass_render{};
+            uint32_t _layout_window{0};
+            LengthSolver _length_solver;
         };
     }
 } // MyEngine
@@ -1,22 +1,20 @@
 
 #include "AbstractWidget.h"
+#include "AbstractLayout.h"
 #include "Algorithm/Collider.h"
 
 namespace MyEngine::Widget {
-    AbstractWidget::AbstractWidget(Window *window) : _window(window), _renderer(nullptr),
-                _ev_id(IDGenerator::getNewEventID()) {
+    AbstractWidget::AbstractWidget(Window *window) : _window(window), _renderer(nullptr) {
         load();
     }
 
     AbstractWidget::AbstractWidget(std::string object_name, MyEngine::Window *window)
-        : _window(window), _renderer(nullptr), _object_name(std::move(object_name)),
-          _ev_id(IDGenerator::getNewEventID()) {
+        : _window(window), _renderer(nullptr), _object_name(std::move(object_name)) {
         load();
     }
 
     AbstractWidget::AbstractWidget(std::string object_name, MyEngine::Widget::AbstractWidget *parent)
-        : _window(parent->_window), _renderer(parent->_renderer), _object_name(std::move(object_name)),
-          _ev_id(IDGenerator::getNewEventID()) {
+        : _window(parent->_window), _renderer(parent->_renderer), _object_name(std::move(object_name)) {
         load();
     }
 
@@ -52,6 +50,8 @@ namespace MyEngine::Widget {
         _renderer = _window->renderer();
         _renderer->window()->installPaintEvent([this](Renderer* r) {
             if (!_visible) return;
+            /// The widgets stay sharp while the dynamic resolution scaling is enabled.
+            r->beginNativeLayer();
             if (_parent) {
                 if (!_status.viewport_changed) {
                     _status.viewport_changed = true;
@@ -72,10 +72,11 @@ namespace MyEngine::Widget {
             }
             paintEvent(r);
             if (_parent) r->setViewport({});
+            r->endNativeLayer();
         }, true);
         _trigger_area.setGeometry(0, 0, 200, 50);
         uint64_t win_id = _window->windowID();
-        EventSystem::global()->appendEvent(_ev_id, [this, win_id](SDL_Event ev) {
+        _ev_handle = EventSystem::global()->appendEvent([this, win_id](SDL_Event ev) {
             if (!_engine->isWindowExist(win_id)) {
                 unload();
                 return;
@@ -107,23 +108,44 @@ namespace MyEngine::Widget {
                 }
             }
             // Input Event
+            /// The key dispatched to the input mode is not dispatched again by the keyboard event below.
+            bool key_dispatched = false;
             if (_status.input_mode) {
                 // Set the keys to cope with different events
-                if (ev.key.down) {
+                if (ev.type == SDL_EVENT_KEY_DOWN) {
+                    key_dispatched = true;
                     switch (ev.key.key) {
                         case SDLK_RETURN:
                         case SDLK_KP_ENTER:
                         case SDLK_ESCAPE:
                             setInputModeEnabled(false);
+                            key_dispatched = false;
                             break;
                         case SDLK_BACKSPACE:
                             keyDownEvent(SDL_SCANCODE_BACKSPACE);
+                            break;
                         case SDLK_LEFT:
                             keyDownEvent(SDL_SCANCODE_LEFT);
+                            break;
                         case SDLK_RIGHT:
                             keyDownEvent(SDL_SCANCODE_RIGHT);
+                            break;
+                        case SDLK_HOME:
+                            keyDownEvent(SDL_SCANCODE_HOME);
+                            break;
+                        case SDLK_END:
+                            keyDownEvent(SDL_SCANCODE_END);
+                            break;
                         case SDLK_DELETE:
                             keyDownEvent(SDL_SCANCODE_DELETE);
+                            break;
+                        case SDLK_V:
+                            if (ev.key.mod & SDL_KMOD_CTRL) keyDownEvent(SDL_SCANCODE_V);
+                            else key_dispatched = false;
+                            break;
+                        default:
+                            key_dispatched = false;
+                            break;
                     }
                 }
 
@@ -139,7 +161,7 @@ namespace MyEngine::Widget {
                     if (!cur_cap_keys.empty()) {
                         _status.key_down = true;
                         uint64_t scancode = ev.key.scancode;
-                        if (scancode) {
+                        if (scancode && !key_dispatched) {
                             keyDownEvent(static_cast<SDL_Scancode>(scancode));
                         }
                     }
@@ -156,7 +178,7 @@ namespace MyEngine::Widget {
                         if (scancode) {
                             if (std::find(cur_cap_keys.begin(), cur_cap_keys.end(),
                                           scancode) != cur_cap_keys.end()) {
-                                keyDownEvent(static_cast<SDL_Scancode>(scancode));
+                                if (!key_dispatched) keyDownEvent(static_cast<SDL_Scancode>(scancode));
                             } else {
                                 keyUpEvent(static_cast<SDL_Scancode>(scancode));
                             }
@@ -174,6 +196,10 @@ namespace MyEngine::Widget {
             } else {
                 trigger = (Algorithm::comparePosInRect(cur_pos, _trigger_area) > 0);
             }
+            if (trigger && ev.type == SDL_EVENT_MOUSE_WHEEL) {
+                float flipped = (ev.wheel.direction == SDL_MOUSEWHEEL_FLIPPED) ? -1.f : 1.f;
+                mouseWheelEvent({ev.wheel.x * flipped, ev.wheel.y * flipped});
+            }
             // Add the input event when the mouse moved out and clicked
             if (_status.input_mode && !trigger && EventSystem::global()->captureMouse(MouseStatus::Left)) {
                 setInputModeEnabled(false);
@@ -270,7 +296,7 @@ namespace MyEngine::Widget {
 
     void AbstractWidget::unload() {
         unloadEvent();
-        EventSystem::global()->removeEvent(_ev_id);
+        EventSystem::global()->removeEvent(std::exchange(_ev_handle, {}));
     }
 
     void AbstractWidget::calcRenderGeometry(const MyEngine::Widget::AbstractWidget *parent, GeometryF& new_geo) {
@@ -319,6 +345,7 @@ namespace MyEngine::Widget {
     void AbstractWidget::setVisible(bool visible) {
         _visible = visible;
         visibleChangedEvent(visible);
+        requestRedraw();
     }
 
     bool AbstractWidget::visible() const {
@@ -328,6 +355,7 @@ namespace MyEngine::Widget {
     void AbstractWidget::setEnabled(bool enabled) {
         _enabled = enabled;
         enableChangedEvent(enabled);
+        requestRedraw();
     }
 
     bool AbstractWidget::enabled() const {
@@ -343,6 +371,7 @@ namespace MyEngine::Widget {
         _render_geometry.setGeometry(toGeometryInt(new_render_geo));
         moveEvent(_trigger_area.geometry().pos);
         resizeEvent(_trigger_area.geometry().size);
+        requestRedraw();
     }
 
     void AbstractWidget::setGeometry(const Vector2 &position, const Size &size) {
@@ -354,6 +383,7 @@ namespace MyEngine::Widget {
         _render_geometry.setGeometry(toGeometryInt(new_render_geo));
         moveEvent(_trigger_area.geometry().pos);
         resizeEvent(_trigger_area.geometry().size);
+        requestRedraw();
     }
 
     void AbstractWidget::setGeometry(const GeometryF &geometry) {
@@ -365,6 +395,7 @@ namespace MyEngine::Widget {
         _render_geometry.setGeometry(toGeometryInt(new_render_geo));
         moveEvent(_trigger_area.geometry().pos);
         resizeEvent(_trigger_area.geometry().size);
+        requestRedraw();
     }
 
     const GeometryF &AbstractWidget::geometry() const {
@@ -380,6 +411,7 @@ namespace MyEngine::Widget {
         }
         _render_geometry.setGeometry(toGeometryInt(new_render_geo));
         moveEvent(_trigger_area.geometry().pos);
+        requestRedraw();
     }
 
     void AbstractWidget::move(const Vector2 &position) {
@@ -391,6 +423,7 @@ namespace MyEngine::Widget {
         }
         _render_geometry.setGeometry(toGeometryInt(new_render_geo));
         moveEvent(_trigger_area.geometry().pos);
+        requestRedraw();
     }
 
     const Vector2 &AbstractWidget::position() const {
@@ -406,6 +439,7 @@ namespace MyEngine::Widget {
         }
         _render_geometry.setGeometry(toGeometryInt(new_render_geo));
         resizeEvent(_trigger_area.geometry().size);
+        requestRedraw();
     }
 
     void AbstractWidget::resize(const Size &size) {
@@ -417,12 +451,39 @@ namespace MyEngine::Widget {
         }
         _render_geometry.setGeometry(toGeometryInt(new_render_geo));
         resizeEvent(_trigger_area.geometry().size);
+        requestRedraw();
     }
 
     const Size &AbstractWidget::size() const {
         return _trigger_area.geometry().size;
     }
 
+    void AbstractWidget::setMinimumSize(float w, float h) {
+        _min_size.reset(std::max(w, 0.f), std::max(h, 0.f));
+        if (auto layout = dynamic_cast<AbstractLayout*>(_parent)) layout->invalidateLayout();
+    }
+
+    void AbstractWidget::setMinimumSize(const Size &size) {
+        setMinimumSize(size.width, size.height);
+    }
+
+    void AbstractWidget::setMaximumSize(float w, float h) {
+        _max_size.reset(std::max(w, 0.f), std::max(h, 0.f));
+        if (auto layout = dynamic_cast<AbstractLayout*>(_parent)) layout->invalidateLayout();
+    }
+
+    void AbstractWidget::setMaximumSize(const Size &size) {
+        setMaximumSize(size.width, size.height);
+    }
+
+    const Size &AbstractWidget::minimumSize() const {
+        return _min_size;
+    }
+
+    const Size &AbstractWidget::maximumSize() const {
+        return _max_size;
+    }
+
     void AbstractWidget::setFocusEnabled(bool enabled) {
         _focus = enabled;
         if (_focus) focusInEvent(); else focusOutEvent();
@@ -436,6 +497,10 @@ namespace MyEngine::Widget {
         return _status.mouse_in;
     }
 
+    void AbstractWidget::requestRedraw() {
+        if (_window) _window->requestRedraw();
+    }
+
     void AbstractWidget::setInputModeEnabled(bool enabled) {
         if (enabled) {
             if (SDL_StartTextInput(_window->self())) {
@@ -481,6 +546,7 @@ namespace MyEngine::Widget {
             _prop_map.try_emplace(name, value);
         }
         propertyChanged(name, _prop_map.at(name));
+        requestRedraw();
     }
     
     void AbstractWidget::setProperty(const std::string& name, int8_t value) {
@@ -490,6 +556,7 @@ namespace MyEngine::Widget {
             _prop_map.try_emplace(name, value);
         }
         propertyChanged(name, _prop_map.at(name));
+        requestRedraw();
     }
 
     void AbstractWidget::setProperty(const std::string& name, int16_t value) {
@@ -499,6 +566,7 @@ namespace MyEngine::Widget {
             _prop_map.try_emplace(name, value);
         }
         propertyChanged(name, _prop_map.at(name));
+        requestRedraw();
     }
 
     void AbstractWidget::setProperty(const std::string& name, int32_t value) {
@@ -508,6 +576,7 @@ namespace MyEngine::Widget {
             _prop_map.try_emplace(name, value);
         }
         propertyChanged(name, _prop_map.at(name));
+        requestRedraw();
     }
 
     void AbstractWidget::setProperty(const std::string& name, int64_t value) {
@@ -517,6 +586,7 @@ namespace MyEngine::Widget {
             _prop_map.try_emplace(name, value);
         }
         propertyChanged(name, _prop_map.at(name));
+        requestRedraw();
     }
 
     void AbstractWidget::setProperty(const std::string& name, uint8_t value) {
@@ -526,6 +596,7 @@ namespace MyEngine::Widget {
             _prop_map.try_emplace(name, value);
         }
         propertyChanged(name, _prop_map.at(name));
+        requestRedraw();
     }
 
     void AbstractWidget::setProperty(const std::string& name, uint16_t value) {
@@ -535,6 +606,7 @@ namespace MyEngine::Widget {
             _prop_map.try_emplace(name, value);
         }
         propertyChanged(name, _prop_map.at(name));
+        requestRedraw();
     }
 
     void AbstractWidget::setProperty(const std::string& name, uint32_t value) {
@@ -544,6 +616,7 @@ namespace MyEngine::Widget {
             _prop_map.try_emplace(name, value);
         }
         propertyChanged(name, _prop_map.at(name));
+        requestRedraw();
     }
 
     void AbstractWidget::setProperty(const std::string& name, uint64_t value) {
@@ -553,6 +626,7 @@ namespace MyEngine::Widget {
             _prop_map.try_emplace(name, value);
         }
         propertyChanged(name, _prop_map.at(name));
+        requestRedraw();
     }
 
     void AbstractWidget::setProperty(const std::string& name, float value) {
@@ -562,6 +636,7 @@ namespace MyEngine::Widget {
             _prop_map.try_emplace(name, value);
         }
         propertyChanged(name, _prop_map.at(name));
+        requestRedraw();
     }
 
     void AbstractWidget::setProperty(const std::string& name, double value) {
@@ -571,6 +646,7 @@ namespace MyEngine::Widget {
             _prop_map.try_emplace(name, value);
         }
         propertyChanged(name, _prop_map.at(name));
+        requestRedraw();
     }
 
     void AbstractWidget::setProperty(const std::string& name, const char* value) {
@@ -580,6 +656,7 @@ namespace MyEngine::Widget {
             _prop_map.try_emplace(name, value);
         }
         propertyChanged(name, _prop_map.at(name));
+        requestRedraw();
     }
 
     void AbstractWidget::setProperty(const std::string& name, const std::string& value) {
@@ -589,6 +666,7 @@ namespace MyEngine::Widget {
             _prop_map.try_emplace(name, value.c_str());
         }
         propertyChanged(name, _prop_map.at(name));
+        requestRedraw();
     }
 
     void AbstractWidget::setProperty(const std::string& name, std::string&& value) {
@@ -598,6 +676,7 @@ namespace MyEngine::Widget {
             _prop_map.try_emplace(name, value);
         }
         propertyChanged(name, _prop_map.at(name));
+        requestRedraw();
     }
 
     void AbstractWidget::setProperty(const std::string& name, void* value) {
@@ -607,6 +686,7 @@ namespace MyEngine::Widget {
             _prop_map.try_emplace(name, value);
         }
         propertyChanged(name, _prop_map.at(name));
+        requestRedraw();
     }
 
     void AbstractWidget::setProperty(const std::string& name, void* value, std::function<void(void*)> deleter) {
@@ -617,6 +697,7 @@ namespace MyEngine::Widget {
             _prop_map.try_emplace(name, value, std::move(deleter));
         }
         propertyChanged(name, _prop_map.at(name));
+        requestRedraw();
     }
 
     void AbstractWidget::setProperty(const std::string& name) {
@@ -626,6 +707,7 @@ namespace MyEngine::Widget {
             _prop_map.try_emplace(name);
         }
         propertyChanged(name, _prop_map.at(name));
+        requestRedraw();
     }
 
     void AbstractWidget::eraseProperty(const std::string& name) {
@@ -692,6 +774,8 @@ namespace MyEngine::Widget {
 
     void AbstractWidget::customContextMenuRequestEvent(const Vector2 &position) {}
 
+    void AbstractWidget::mouseWheelEvent(const Vector2 &distance) {}
+
     void AbstractWidget::keyDownEvent(SDL_Scancode scancode) {}
 
     void AbstractWidget::keyUpEvent(SDL_Scancode scancode) {}
@@ -5,6 +5,7 @@
 #include "../Utils/Cursor.h"
 #include "../Utils/Variant.h"
 #include "../Algorithm/Collider.h"
+#include <limits>
 
 #define _NEW_PROPERTY_PTR(POINTER, NAME, CLASS)                                   \
 POINTER->setProperty(NAME, static_cast<void*>(new CLASS()), [](void* v) {        \
@@ -71,7 +72,11 @@ namespace MyEngine {
             FingerTapped
         };
 
+        class AbstractLayout;
+
         class AbstractWidget {
+            /// The layouts set the geometry of their widgets in the layout pass without the recursive calculations.
+            friend class AbstractLayout;
         public:
             explicit AbstractWidget(Window* window);
             explicit AbstractWidget(std::string object_name, Window* window);
@@ -103,9 +108,19 @@ namespace MyEngine {
             void resize(const Size& size);
             [[nodiscard]] const Size& size() const;
 
+            /// Set the size constraints used by the layouts, the widget is never laid out out of them.
+            void setMinimumSize(float w, float h);
+            void setMinimumSize(const Size& size);
+            void setMaximumSize(float w, float h);
+            void setMaximumSize(const Size& size);
+            [[nodiscard]] const Size& minimumSize() const;
+            [[nodiscard]] const Size& maximumSize() const;
+
             void setFocusEnabled(bool enabled);
             [[nodiscard]] bool isFocusEnabled() const;
             [[nodiscard]] bool isHovered() const;
+            /// Invalidate the window of the widget, see `Window::requestRedraw()`.
+            void requestRedraw();
 
         protected:
             void setInputModeEnabled(bool enabled);
@@ -169,6 +184,8 @@ namespace MyEngine {
             virtual void mouseEnteredEvent();
             virtual void mouseLeftEvent();
             virtual void customContextMenuRequestEvent(const Vector2 &position);
+            /// The wheel is scrolled over the widget, the distance is positive when it is scrolled up or right.
+            virtual void mouseWheelEvent(const Vector2 &distance);
             virtual void keyDownEvent(SDL_Scancode scancode);
             virtual void keyUpEvent(SDL_Scancode scancode);
             virtual void keyPressedEvent(SDL_Scancode scancode);
@@ -204,7 +221,7 @@ namespace MyEngine {
             Window* _window;
             Renderer* _renderer;
             Engine* _engine{nullptr};
-            uint64_t _ev_id{0};
+            EventHandle _ev_handle{};
             std::vector<SDL_Scancode> _hot_key;
             std::vector<std::vector<int>> _hot_key_list;
             bool _visible{true}, _enabled{true}, _focus{false};
@@ -229,6 +246,8 @@ namespace MyEngine {
             Status _status{};
             std::string _cur_ch{};
             GeometryF _viewport_geometry{};
+            Size _min_size{0, 0};
+            Size _max_size{std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
             std::unordered_map<std::string, Variant> _prop_map{};
         };
     }
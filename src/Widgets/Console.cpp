@@ -0,0 +1,385 @@
+
+#include "Console.h"
+#include "../Utils/RGBAColor.h"
+
+namespace MyEngine::Widget {
+    namespace {
+        constexpr size_t DEFAULT_ARENA_CAPACITY = 1 << 20;
+
+        bool isSameColor(const SDL_Color& a, const SDL_Color& b) {
+            return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+        }
+    }
+
+    Console::Console(Window *window) : AbstractWidget(window) {
+        _lines.resize(_max_lines);
+        _arena.resize(DEFAULT_ARENA_CAPACITY);
+    }
+
+    Console::Console(std::string object_name, Window *window) : AbstractWidget(std::move(object_name), window) {
+        _lines.resize(_max_lines);
+        _arena.resize(DEFAULT_ARENA_CAPACITY);
+    }
+
+    Console::~Console() {}
+
+    void Console::setFont(const std::string &font_name, const std::string &font_path, float font_size) {
+        if (!TextSystem::global()->isFontContain(font_name)) {
+            TextSystem::global()->addFont(font_name, font_path,
+                                          AbstractWidget::render(), font_size);
+            TextSystem::global()->font(font_name)->setFontPath(font_path);
+            TextSystem::global()->font(font_name)->setFontSize(font_size);
+        }
+        setFont(font_name);
+    }
+
+    void Console::setFont(const std::string &font_name) {
+        if (!TextSystem::global()->isFontContain(font_name)) {
+            Logger::log(Logger::Error, "Console ({}): The font name '{}' is not contained! You need to specified font path.", _object_name, font_name);
+            return;
+        }
+        _font = TextSystem::global()->font(font_name);
+        if (_font_name != font_name) {
+            _font_name = font_name;
+            _changer_signal |= ENGINE_SIGNAL_CONSOLE_FONT_CHANGED;
+        }
+        requestRedraw();
+    }
+
+    std::string_view Console::fontName() const {
+        return _font_name;
+    }
+
+    bool Console::appendLine(std::string_view line) {
+        if (_pending.tryEmplace(PendingLine{std::string(line), {}, false})) {
+            requestRedraw();
+            return true;
+        }
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    bool Console::appendLine(std::string_view line, const SDL_Color &color) {
+        if (_pending.tryEmplace(PendingLine{std::string(line), color, true})) {
+            requestRedraw();
+            return true;
+        }
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void Console::flush() {
+        takePendingLines();
+    }
+
+    void Console::clear() {
+        _first_id += _line_count;
+        _painted_first_id = _first_id;
+        _line_head = 0;
+        _line_count = 0;
+        _arena_tail = 0;
+        _scroll.reset();
+        _follow_bottom = true;
+        requestRedraw();
+    }
+
+    size_t Console::lineCount() const {
+        return _line_count;
+    }
+
+    std::string_view Console::line(size_t index) const {
+        if (index >= _line_count) return {};
+        auto& item = lineAt(index);
+        return {_arena.data() + item.offset % _arena.size(), item.length};
+    }
+
+    uint64_t Console::droppedCount() const {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+    void Console::setMaxLines(size_t count) {
+        count = std::max<size_t>(count, 1);
+        if (count == _lines.size()) return;
+        auto kept = std::min(count, _line_count);
+        std::vector<Line> lines(count);
+        for (size_t i = 0; i < kept; ++i) lines[i] = lineAt(_line_count - kept + i);
+        _first_id += _line_count - kept;
+        _lines = std::move(lines);
+        _line_head = 0;
+        _line_count = kept;
+        _max_lines = count;
+        requestRedraw();
+    }
+
+    size_t Console::maxLines() const {
+        return _max_lines;
+    }
+
+    void Console::setArenaCapacity(size_t bytes) {
+        bytes = std::max(bytes, MAX_LINE_LENGTH);
+        if (bytes == _arena.size()) return;
+        clear();
+        _arena.assign(bytes, 0);
+        _arena.shrink_to_fit();
+    }
+
+    size_t Console::arenaCapacity() const {
+        return _arena.size();
+    }
+
+    void Console::setTextColor(const SDL_Color &color) {
+        _text_color = color;
+        requestRedraw();
+    }
+
+    void Console::setTextColor(uint64_t hex_code, bool alpha) {
+        setTextColor(RGBAColor::hexCode2RGBA(hex_code, alpha));
+    }
+
+    const SDL_Color &Console::textColor() const {
+        return _text_color;
+    }
+
+    void Console::setBackgroundVisible(bool visible) {
+        _visible_bg = visible;
+        requestRedraw();
+    }
+
+    void Console::setBackgroundColor(const SDL_Color &back_color) {
+        _trigger_area.setBackgroundColor(back_color);
+        requestRedraw();
+    }
+
+    void Console::setBackgroundColor(uint64_t hex_code, bool alpha) {
+        setBackgroundColor(RGBAColor::hexCode2RGBA(hex_code, alpha));
+    }
+
+    bool Console::backgroundVisible() const {
+        return _visible_bg;
+    }
+
+    const SDL_Color &Console::backgroundColor() const {
+        return _trigger_area.backgroundColor();
+    }
+
+    void Console::setPadding(int value) {
+        _padding = std::max(value, 0);
+        requestRedraw();
+    }
+
+    int Console::padding() const {
+        return _padding;
+    }
+
+    void Console::scrollBy(float distance) {
+        auto max_scroll = maxScroll();
+        _scroll.scrollBy(distance, max_scroll);
+        _follow_bottom = (_scroll.target >= max_scroll - 0.5);
+        requestRedraw();
+    }
+
+    void Console::scrollToTop() {
+        scrollBy(static_cast<float>(-_scroll.target));
+    }
+
+    void Console::scrollToBottom() {
+        scrollBy(static_cast<float>(maxScroll() - _scroll.target));
+        _follow_bottom = true;
+    }
+
+    bool Console::isFollowingBottom() const {
+        return _follow_bottom;
+    }
+
+    void Console::setWheelStep(uint32_t lines) {
+        _scroll.wheel_step = lines;
+    }
+
+    uint32_t Console::wheelStep() const {
+        return _scroll.wheel_step;
+    }
+
+    void Console::loadEvent() {
+        AbstractWidget::loadEvent();
+        _scroll.restart();
+    }
+
+    void Console::unloadEvent() {
+        releaseRows();
+        AbstractWidget::unloadEvent();
+    }
+
+    void Console::paintEvent(MyEngine::Renderer *renderer) {
+        AbstractWidget::paintEvent(renderer);
+        takePendingLines();
+        if (_changer_signal & ENGINE_SIGNAL_CONSOLE_FONT_CHANGED) {
+            for (auto& row : _rows) {
+                TextSystem::global()->setTextFont(row.handle, _font_name);
+                row.line_id = NO_LINE;
+            }
+        }
+        _changer_signal = 0;
+        updateScroll();
+        if (_visible_bg) {
+            renderer->drawRectangle(&_trigger_area);
+        }
+        if (!_font || _row_height <= 0 || !_line_count) return;
+
+        auto clip_geo = _parent ? _render_geometry : toGeometryInt(_trigger_area.geometry());
+        if (clip_geo.width <= 0 || clip_geo.height <= 0) return;
+        auto view_height = std::max(_trigger_area.geometry().size.height - 2.f * _padding, 0.f);
+        auto first = static_cast<size_t>(_scroll.position / _row_height);
+        auto offset_y = static_cast<float>(first * _row_height - _scroll.position);
+        auto count = static_cast<size_t>(std::ceil(view_height / _row_height)) + 1;
+        updateRows(count);
+        if (_rows.empty()) return;
+
+        renderer->setClipView(clip_geo);
+        auto pos_x = static_cast<float>(_padding);
+        auto pos_y = static_cast<float>(_padding) + offset_y;
+        for (size_t i = first; i < std::min(first + count, _line_count); ++i, pos_y += _row_height) {
+            auto& item = lineAt(i);
+            if (!item.length) continue;
+            /// The consecutive lines are always in different rows, a row is only reset when its line is scrolled out.
+            auto id = _first_id + i;
+            auto& row = _rows[id % _rows.size()];
+            auto& color = item.has_color ? item.color : _text_color;
+            bool reset = (row.line_id != id);
+            if (reset) {
+                TextSystem::global()->setText(row.handle, std::string(line(i)));
+                row.line_id = id;
+            }
+            if (reset || !isSameColor(row.color, color)) {
+                TextSystem::global()->setTextColor(row.handle, color);
+                row.color = color;
+            }
+            TextSystem::global()->drawText(row.handle, {pos_x, pos_y}, renderer);
+        }
+        renderer->setClipView({});
+    }
+
+    void Console::keyDownEvent(SDL_Scancode scancode) {
+        AbstractWidget::keyDownEvent(scancode);
+        auto page = std::max(_trigger_area.geometry().size.height - 2.f * _padding - _row_height, _row_height);
+        switch (scancode) {
+            case SDL_SCANCODE_UP:
+                scrollBy(-_row_height);
+                break;
+            case SDL_SCANCODE_DOWN:
+                scrollBy(_row_height);
+                break;
+            case SDL_SCANCODE_PAGEUP:
+                scrollBy(-page);
+                break;
+            case SDL_SCANCODE_PAGEDOWN:
+                scrollBy(page);
+                break;
+            case SDL_SCANCODE_HOME:
+                scrollToTop();
+                break;
+            case SDL_SCANCODE_END:
+                scrollToBottom();
+                break;
+            default:
+                break;
+        }
+    }
+
+    void Console::mouseWheelEvent(const Vector2 &distance) {
+        AbstractWidget::mouseWheelEvent(distance);
+        scrollBy(static_cast<float>(_scroll.wheelDistance(distance.y, _row_height)));
+    }
+
+    void Console::takePendingLines() {
+        _pending.tryPopBatch(std::back_inserter(_taken), PENDING_CAPACITY);
+        for (auto& pending : _taken) {
+            std::string_view text = pending.text;
+            while (true) {
+                auto end = text.find('\n');
+                auto item = text.substr(0, end);
+                if (!item.empty() && item.back() == '\r') item.remove_suffix(1);
+                storeLine(item, pending.color, pending.has_color);
+                if (end == std::string_view::npos) break;
+                text.remove_prefix(end + 1);
+            }
+        }
+        _taken.clear();
+    }
+
+    void Console::storeLine(std::string_view text, const SDL_Color &color, bool has_color) {
+        auto length = std::min(text.size(), MAX_LINE_LENGTH);
+        /// Don't cut a character in the middle.
+        if (length < text.size()) {
+            while (length && (static_cast<uint8_t>(text[length]) & 0xC0) == 0x80) length -= 1;
+        }
+        uint64_t capacity = _arena.size();
+        auto offset = _arena_tail;
+        /// The bytes of a line are contiguous, a line which doesn't fit the rest of the arena starts from its head.
+        if (offset % capacity + length > capacity) offset += capacity - offset % capacity;
+        auto end = offset + length;
+        if (_line_count == _lines.size()) evictOldestLine();
+        while (_line_count && end > capacity && lineAt(0).offset < end - capacity) evictOldestLine();
+        std::memcpy(_arena.data() + offset % capacity, text.data(), length);
+        _lines[(_line_head + _line_count) % _lines.size()] = {offset, static_cast<uint32_t>(length), color, has_color};
+        _line_count += 1;
+        _arena_tail = end;
+    }
+
+    void Console::evictOldestLine() {
+        _line_head = (_line_head + 1) % _lines.size();
+        _line_count -= 1;
+        _first_id += 1;
+    }
+
+    const Console::Line &Console::lineAt(size_t index) const {
+        return _lines[(_line_head + index) % _lines.size()];
+    }
+
+    float Console::rowHeight() const {
+        auto font = _font ? _font->self() : nullptr;
+        return font ? static_cast<float>(TTF_GetFontLineSkip(font)) : 0.f;
+    }
+
+    float Console::maxScroll() const {
+        auto view_height = std::max(_trigger_area.geometry().size.height - 2.f * _padding, 0.f);
+        return std::max(static_cast<float>(_line_count) * _row_height - view_height, 0.f);
+    }
+
+    void Console::updateScroll() {
+        auto row_height = rowHeight();
+        /// Keep the same lines in the view if the font is changed.
+        if (_row_height > 0 && row_height > 0 && row_height != _row_height) {
+            _scroll.position *= row_height / _row_height;
+            _scroll.target *= row_height / _row_height;
+        }
+        _row_height = row_height;
+        /// The dropped lines were above the view, move up with them so the view doesn't jump.
+        if (_first_id != _painted_first_id) {
+            _scroll.shift(-static_cast<double>(_first_id - _painted_first_id) * _row_height);
+            _painted_first_id = _first_id;
+        }
+        auto max_scroll = maxScroll();
+        if (_follow_bottom) _scroll.target = max_scroll;
+        if (_scroll.update(max_scroll)) requestRedraw();
+    }
+
+    void Console::updateRows(size_t count) {
+        if (_rows.size() == count || _font_name.empty()) return;
+        while (_rows.size() > count) {
+            TextSystem::global()->removeText(_rows.back().handle);
+            _rows.pop_back();
+        }
+        while (_rows.size() < count) {
+            auto handle = TextSystem::global()->addText(_font_name, "");
+            if (!handle) break;
+            _rows.push_back({handle});
+        }
+        /// The rows of the lines are changed with the count.
+        for (auto& row : _rows) row.line_id = NO_LINE;
+    }
+
+    void Console::releaseRows() {
+        for (auto& row : _rows) TextSystem::global()->removeText(row.handle);
+        _rows.clear();
+    }
+}
@@ -0,0 +1,152 @@
+#pragma once
+#ifndef MYENGINE_WIDGETS_CONSOLE_H
+#define MYENGINE_WIDGETS_CONSOLE_H
+#include "AbstractWidget.h"
+#include "SmoothScroll.h"
+#include "../MultiThread/Queue.h"
+
+#define ENGINE_SIGNAL_CONSOLE_FONT_CHANGED                       0b1
+
+namespace MyEngine {
+    namespace Widget {
+        /**
+         * \if EN
+         * @class MyEngine::Widget::Console
+         * @brief Scrolling view of many text lines, e.g. the log of the application
+         * @details The lines are kept in a bounded ring, their bytes are written one after another into a ring arena,
+         * so appending a line never allocates on the main thread, and the oldest lines are dropped
+         * when the count of the lines or the bytes exceeds the limits.
+         * Only the visible rows are laid out and drawn. Every row keeps its text item and only sets a new string
+         * when another line scrolls into it, so scrolling by one line lays out one row.
+         * @note `appendLine()` can be called from any thread, the lines are pushed into a lock-free queue
+         * and taken in while painting. The other functions can only be called on the main thread.
+         * \endif
+         */
+        class Console : public AbstractWidget {
+        public:
+            /// The count of the lines waiting to be taken in, the lines appended while it is full are dropped.
+            static constexpr size_t PENDING_CAPACITY = 8192;
+            /// The longer lines are cut at this length (in bytes).
+            static constexpr size_t MAX_LINE_LENGTH = 4096;
+
+            explicit Console(Window* window);
+            explicit Console(std::string object_name, Window* window);
+            ~Console();
+
+            void setFont(const std::string &font_name, const std::string& font_path, float font_size = 9.f);
+            void setFont(const std::string &font_name);
+            [[nodiscard]] std::string_view fontName() const;
+
+            /**
+             * \if EN
+             * @brief Append a line, the text is split at `\n` into more lines
+             * @details It is thread-safe and lock-free, the line is copied into the pending queue
+             * and the window is invalidated. It never waits for the main thread.
+             * @return False if the pending queue is full and the line is dropped, see `droppedCount()`.
+             * \endif
+             */
+            bool appendLine(std::string_view line);
+            bool appendLine(std::string_view line, const SDL_Color& color);
+            /// Take in the pending lines now, e.g. while the console is hidden and not painted.
+            void flush();
+            /// Remove the lines taken in, the pending lines are kept.
+            void clear();
+            [[nodiscard]] size_t lineCount() const;
+            /// Get the line at `index`, 0 is the oldest line kept. The view is valid until the next line is taken in.
+            [[nodiscard]] std::string_view line(size_t index) const;
+            /// Get the count of the lines dropped because the pending queue was full.
+            [[nodiscard]] uint64_t droppedCount() const;
+
+            void setMaxLines(size_t count);
+            [[nodiscard]] size_t maxLines() const;
+            /// Set the size of the text arena (in bytes), the lines taken in are removed.
+            void setArenaCapacity(size_t bytes);
+            [[nodiscard]] size_t arenaCapacity() const;
+
+            void setTextColor(const SDL_Color& color);
+            void setTextColor(uint64_t hex_code, bool alpha = false);
+            [[nodiscard]] const SDL_Color& textColor() const;
+            void setBackgroundVisible(bool visible);
+            void setBackgroundColor(const SDL_Color& back_color);
+            void setBackgroundColor(uint64_t hex_code, bool alpha = false);
+            [[nodiscard]] bool backgroundVisible() const;
+            [[nodiscard]] const SDL_Color& backgroundColor() const;
+            void setPadding(int value);
+            [[nodiscard]] int padding() const;
+
+            /// Scroll by `distance` pixels smoothly, it is positive to scroll down.
+            void scrollBy(float distance);
+            void scrollToTop();
+            /// Scroll to the last line, the console follows the new lines until it is scrolled up again.
+            void scrollToBottom();
+            [[nodiscard]] bool isFollowingBottom() const;
+            /// Set the count of the lines scrolled by one step of the mouse wheel.
+            void setWheelStep(uint32_t lines);
+            [[nodiscard]] uint32_t wheelStep() const;
+
+        protected:
+            void loadEvent() override;
+            void unloadEvent() override;
+            void paintEvent(MyEngine::Renderer *renderer) override;
+            void keyDownEvent(SDL_Scancode scancode) override;
+            void mouseWheelEvent(const Vector2 &distance) override;
+
+        private:
+            static constexpr uint64_t NO_LINE = UINT64_MAX;
+            /// The line is drawn with `textColor()` unless it is appended with a color.
+            struct PendingLine {
+                std::string text;
+                SDL_Color color;
+                bool has_color;
+            };
+            struct Line {
+                /// The monotonic arena position of the first byte, the byte is at `offset % arena size`.
+                uint64_t offset;
+                uint32_t length;
+                SDL_Color color;
+                bool has_color;
+            };
+            struct Row {
+                TextHandle handle{};
+                /// The id of the line set to the text item.
+                uint64_t line_id{NO_LINE};
+                SDL_Color color{};
+            };
+
+            void takePendingLines();
+            void storeLine(std::string_view text, const SDL_Color& color, bool has_color);
+            void evictOldestLine();
+            [[nodiscard]] const Line& lineAt(size_t index) const;
+            [[nodiscard]] float rowHeight() const;
+            [[nodiscard]] float maxScroll() const;
+            void updateScroll();
+            void updateRows(size_t count);
+            void releaseRows();
+        private:
+            MpmcRingQueue<PendingLine> _pending{PENDING_CAPACITY};
+            std::atomic<uint64_t> _dropped{0};
+            std::vector<PendingLine> _taken{};
+            /// The ring of the lines, the oldest line is at `_line_head`.
+            std::vector<Line> _lines{};
+            size_t _line_head{0}, _line_count{0}, _max_lines{10000};
+            std::vector<char> _arena{};
+            uint64_t _arena_tail{0};
+            /// The count of the lines dropped from the ring, it is also the id of the oldest line.
+            uint64_t _first_id{0}, _painted_first_id{0};
+            std::vector<Row> _rows{};
+            Font* _font{};
+            std::string _font_name{};
+            SDL_Color _text_color{StdColor::Black};
+            bool _visible_bg{true};
+            int _padding{4};
+            /// The distance scrolled from the top of the oldest line.
+            SmoothScroll _scroll{};
+            /// The row height the scrolled distances are measured with.
+            float _row_height{0};
+            bool _follow_bottom{true};
+            uint16_t _changer_signal{};
+        };
+    }
+}
+
+#endif //MYENGINE_WIDGETS_CONSOLE_H
@@ -16,24 +16,19 @@ void MyEngine::Widget::HorizontalLayout::paintEvent(MyEngine::Renderer *renderer
 
 void MyEngine::Widget::HorizontalLayout::resizeEvent(const MyEngine::Size &size) {
     AbstractLayout::resizeEvent(size);
-    layoutChanged();
 }
 
 void MyEngine::Widget::HorizontalLayout::layoutChanged() {
     if (_widgets.empty()) return;
-    Size avg_size;
     size_t wid_size = _widgets.size();
-    if (wid_size == 1)
-        avg_size.reset(_padding_geometry.size);
-    else if (wid_size > 1)
-        avg_size.reset((_padding_geometry.size.width - _padding_h * (float)(wid_size - 1)) / (float)wid_size,
-                       _padding_geometry.size.height );
+    auto& widths = solveLengths(true, _padding_geometry.size.width - _padding_h * (float)(wid_size - 1));
     float next_width = 0;
-    for (auto& widget : _widgets) {
-        Vector2 new_pos = {_padding_geometry.pos.x + next_width, _padding_geometry.pos.y};
-        widget->setGeometry(new_pos, avg_size);
-        next_width += avg_size.width + _padding_h;
+    for (size_t i = 0; i < wid_size; ++i) {
+        auto widget = _widgets[i];
+        float height = std::max(widget->minimumSize().height,
+                                std::min(_padding_geometry.size.height, widget->maximumSize().height));
+        placeWidget(widget, GeometryF(_padding_geometry.pos.x + next_width, _padding_geometry.pos.y,
+                                      widths[i], height));
+        next_width += widths[i] + _padding_h;
     }
 }
-
-
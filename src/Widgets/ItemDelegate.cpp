@@ -0,0 +1,38 @@
+
+#include "ItemDelegate.h"
+
+namespace MyEngine::Widget {
+    TextItemDelegate::TextItemDelegate(std::string font_name, const SDL_Color &color, float padding)
+        : _font_name(std::move(font_name)), _color(color), _padding(padding) {}
+
+    TextItemDelegate::~TextItemDelegate() {
+        for (auto text : _texts) TextSystem::global()->removeText(text);
+    }
+
+    void TextItemDelegate::bind(const AbstractItemModel &model, size_t row) {
+        _column_count = model.columnCount();
+        while (_texts.size() < _column_count) {
+            auto text = TextSystem::global()->addText(_font_name, "");
+            if (!text) {
+                _column_count = _texts.size();
+                break;
+            }
+            TextSystem::global()->setTextColor(text, _color);
+            _texts.push_back(text);
+        }
+        for (size_t i = 0; i < _column_count; ++i) {
+            TextSystem::global()->setText(_texts[i], model.data(row, i));
+        }
+    }
+
+    void TextItemDelegate::unbind() {
+        _column_count = 0;
+    }
+
+    void TextItemDelegate::paint(Renderer *renderer, size_t column, const GeometryF &rect, bool selected) {
+        if (column >= _column_count) return;
+        auto& size = TextSystem::global()->textSize(_texts[column]);
+        Vector2 pos(rect.pos.x + _padding, rect.pos.y + (rect.size.height - size.height) * 0.5f);
+        TextSystem::global()->drawText(_texts[column], pos, renderer);
+    }
+}
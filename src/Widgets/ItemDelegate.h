@@ -0,0 +1,51 @@
+#pragma once
+#ifndef MYENGINE_WIDGETS_ITEMDELEGATE_H
+#define MYENGINE_WIDGETS_ITEMDELEGATE_H
+#include "../Components.h"
+#include "ItemModel.h"
+
+namespace MyEngine {
+    namespace Widget {
+        /**
+         * \if EN
+         * @class MyEngine::Widget::AbstractItemDelegate
+         * @brief Draw the cells of one row of an item view
+         * @details The view only keeps the delegates of the visible rows. When a row is scrolled out,
+         * its delegate is bound to the row scrolled in, so the text items and the other resources
+         * of a delegate are reused instead of created for every row.
+         * \endif
+         */
+        class AbstractItemDelegate {
+        public:
+            virtual ~AbstractItemDelegate() = default;
+            /// Bind the delegate to the row, it is called when the row is scrolled in or its data is changed.
+            virtual void bind(const AbstractItemModel& model, size_t row) = 0;
+            /// The delegate is not bound to a row anymore.
+            virtual void unbind() {}
+            /// Paint the cell of the bound row, `rect` is relative to the current clip view.
+            virtual void paint(Renderer* renderer, size_t column, const GeometryF& rect, bool selected) = 0;
+        };
+
+        /// The default delegate, it draws the data of every column as one line of text centered vertically.
+        class TextItemDelegate : public AbstractItemDelegate {
+        public:
+            explicit TextItemDelegate(std::string font_name, const SDL_Color& color = StdColor::Black,
+                                      float padding = 4.f);
+            ~TextItemDelegate() override;
+
+            void bind(const AbstractItemModel& model, size_t row) override;
+            void unbind() override;
+            void paint(Renderer* renderer, size_t column, const GeometryF& rect, bool selected) override;
+
+        private:
+            std::string _font_name;
+            SDL_Color _color;
+            float _padding;
+            std::vector<TextHandle> _texts{};
+            /// The count of the columns bound, the text items after it are kept for reuse.
+            size_t _column_count{0};
+        };
+    }
+}
+
+#endif //MYENGINE_WIDGETS_ITEMDELEGATE_H
@@ -0,0 +1,89 @@
+
+#include "ItemModel.h"
+
+namespace MyEngine::Widget {
+    AbstractItemModel::~AbstractItemModel() {
+        /// The listener may remove itself while being notified.
+        auto listeners = std::move(_listeners);
+        for (auto listener : listeners) listener->modelDestroyed();
+    }
+
+    void AbstractItemModel::addListener(ItemModelListener *listener) {
+        if (!listener || std::find(_listeners.begin(), _listeners.end(), listener) != _listeners.end()) return;
+        _listeners.push_back(listener);
+    }
+
+    void AbstractItemModel::removeListener(ItemModelListener *listener) {
+        if (!listener) return;
+        if (_notifying) std::ranges::replace(_listeners, listener, nullptr);
+        else std::erase(_listeners, listener);
+    }
+
+    void AbstractItemModel::notifyRowsInserted(size_t first, size_t count) {
+        if (!count) return;
+        notifyListeners([&](ItemModelListener* listener) { listener->rowsInserted(first, count); });
+    }
+
+    void AbstractItemModel::notifyRowsRemoved(size_t first, size_t count) {
+        if (!count) return;
+        notifyListeners([&](ItemModelListener* listener) { listener->rowsRemoved(first, count); });
+    }
+
+    void AbstractItemModel::notifyDataChanged(size_t first, size_t last) {
+        if (first > last) return;
+        notifyListeners([&](ItemModelListener* listener) { listener->dataChanged(first, last); });
+    }
+
+    void AbstractItemModel::notifyModelReset() {
+        notifyListeners([](ItemModelListener* listener) { listener->modelReset(); });
+    }
+
+    StringListModel::StringListModel(StringList strings) : _strings(std::move(strings)) {}
+
+    void StringListModel::setStringList(StringList strings) {
+        _strings = std::move(strings);
+        notifyModelReset();
+    }
+
+    const StringList &StringListModel::stringList() const {
+        return _strings;
+    }
+
+    void StringListModel::append(std::string string) {
+        _strings.push_back(std::move(string));
+        notifyRowsInserted(_strings.size() - 1, 1);
+    }
+
+    void StringListModel::insert(size_t row, std::string string) {
+        row = std::min(row, _strings.size());
+        _strings.insert(_strings.begin() + static_cast<ptrdiff_t>(row), std::move(string));
+        notifyRowsInserted(row, 1);
+    }
+
+    void StringListModel::remove(size_t row, size_t count) {
+        if (row >= _strings.size()) return;
+        count = std::min(count, _strings.size() - row);
+        auto first = _strings.begin() + static_cast<ptrdiff_t>(row);
+        _strings.erase(first, first + static_cast<ptrdiff_t>(count));
+        notifyRowsRemoved(row, count);
+    }
+
+    void StringListModel::setString(size_t row, std::string string) {
+        if (row >= _strings.size()) return;
+        _strings[row] = std::move(string);
+        notifyDataChanged(row, row);
+    }
+
+    void StringListModel::clear() {
+        _strings.clear();
+        notifyModelReset();
+    }
+
+    size_t StringListModel::rowCount() const {
+        return _strings.size();
+    }
+
+    std::string StringListModel::data(size_t row, size_t column) const {
+        return (row < _strings.size() && !column) ? _strings[row] : std::string();
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+#ifndef MYENGINE_WIDGETS_ITEMMODEL_H
+#define MYENGINE_WIDGETS_ITEMMODEL_H
+#include "../Basic.h"
+
+namespace MyEngine {
+    namespace Widget {
+        /// Receive the changes of an item model, e.g. the item views showing it.
+        class ItemModelListener {
+        public:
+            virtual ~ItemModelListener() = default;
+            virtual void rowsInserted(size_t first, size_t count) = 0;
+            virtual void rowsRemoved(size_t first, size_t count) = 0;
+            /// The data of the rows in [first, last] is changed.
+            virtual void dataChanged(size_t first, size_t last) = 0;
+            /// Everything is changed, e.g. the columns or the whole data.
+            virtual void modelReset() = 0;
+            /// The model is being destroyed, the listener must not use it anymore.
+            virtual void modelDestroyed() = 0;
+        };
+
+        /**
+         * \if EN
+         * @class MyEngine::Widget::AbstractItemModel
+         * @brief Data of the rows and columns shown by the item views
+         * @details The views only ask for the rows they show, so the data can be generated or loaded on demand.
+         * A model loading the data incrementally returns true from `canFetchMore()`,
+         * the view calls `fetchMore()` when it is scrolled near the last row.
+         * The subclasses call the `notify*()` functions after changing the data.
+         * @note It can only be used on the main thread.
+         * \endif
+         */
+        class AbstractItemModel {
+        public:
+            AbstractItemModel() = default;
+            AbstractItemModel(const AbstractItemModel&) = delete;
+            AbstractItemModel(AbstractItemModel&&) = delete;
+            AbstractItemModel& operator=(const AbstractItemModel&) = delete;
+            AbstractItemModel& operator=(AbstractItemModel&&) = delete;
+            virtual ~AbstractItemModel();
+
+            [[nodiscard]] virtual size_t rowCount() const = 0;
+            [[nodiscard]] virtual size_t columnCount() const { return 1; }
+            [[nodiscard]] virtual std::string data(size_t row, size_t column) const = 0;
+            [[nodiscard]] virtual std::string headerData(size_t column) const { return {}; }
+            /// Get the height of the row, 0 means the default height of the view.
+            /// It is only asked when the row is shown for the first time after it is changed.
+            [[nodiscard]] virtual float rowHeight(size_t row) const { return 0.f; }
+            [[nodiscard]] virtual bool canFetchMore() const { return false; }
+            /// Load more rows and call `notifyRowsInserted()`, it is called when the view reaches the last rows.
+            virtual void fetchMore() {}
+
+            void addListener(ItemModelListener* listener);
+            void removeListener(ItemModelListener* listener);
+
+        protected:
+            void notifyRowsInserted(size_t first, size_t count);
+            void notifyRowsRemoved(size_t first, size_t count);
+            void notifyDataChanged(size_t first, size_t last);
+            void notifyModelReset();
+
+        private:
+            /// Call the listeners, the ones removed while being notified are set to null and erased after it.
+            template<typename Func>
+            void notifyListeners(Func&& func) {
+                _notifying += 1;
+                auto count = _listeners.size();
+                for (size_t i = 0; i < count; ++i) {
+                    if (auto listener = _listeners[i]) func(listener);
+                }
+                if (--_notifying == 0) std::erase(_listeners, nullptr);
+            }
+
+            std::vector<ItemModelListener*> _listeners;
+            uint32_t _notifying{0};
+        };
+
+        /// Model of a list of strings, one string per row.
+        class StringListModel : public AbstractItemModel {
+        public:
+            StringListModel() = default;
+            explicit StringListModel(StringList strings);
+
+            void setStringList(StringList strings);
+            [[nodiscard]] const StringList& stringList() const;
+            void append(std::string string);
+            void insert(size_t row, std::string string);
+            void remove(size_t row, size_t count = 1);
+            void setString(size_t row, std::string string);
+            void clear();
+
+            [[nodiscard]] size_t rowCount() const override;
+            [[nodiscard]] std::string data(size_t row, size_t column) const override;
+
+        private:
+            StringList _strings;
+        };
+    }
+}
+
+#endif //MYENGINE_WIDGETS_ITEMMODEL_H
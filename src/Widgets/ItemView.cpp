@@ -0,0 +1,430 @@
+
+#include "ItemView.h"
+
+namespace MyEngine::Widget {
+    namespace {
+        /// The padding above and below the text of the rows with the default height.
+        constexpr float ROW_PADDING = 4.f;
+
+        Geometry intersectGeometry(const GeometryF& a, const GeometryF& b) {
+            auto left = std::max(a.pos.x, b.pos.x);
+            auto top = std::max(a.pos.y, b.pos.y);
+            auto right = std::min(a.pos.x + a.size.width, b.pos.x + b.size.width);
+            auto bottom = std::min(a.pos.y + a.size.height, b.pos.y + b.size.height);
+            if (right <= left || bottom <= top) return {};
+            return {static_cast<int>(std::floor(left)), static_cast<int>(std::floor(top)),
+                    static_cast<int>(std::ceil(right - std::floor(left))),
+                    static_cast<int>(std::ceil(bottom - std::floor(top)))};
+        }
+    }
+
+    AbstractItemView::AbstractItemView(Window *window) : AbstractWidget(window) {
+        _selection_rect.setBorder(0, _selection_color);
+        _selection_rect.setBackgroundColor(_selection_color);
+    }
+
+    AbstractItemView::AbstractItemView(std::string object_name, Window *window)
+        : AbstractWidget(std::move(object_name), window) {
+        _selection_rect.setBorder(0, _selection_color);
+        _selection_rect.setBackgroundColor(_selection_color);
+    }
+
+    AbstractItemView::~AbstractItemView() {
+        if (_model) _model->removeListener(this);
+    }
+
+    void AbstractItemView::setModel(AbstractItemModel *model) {
+        if (_model == model) return;
+        if (_model) _model->removeListener(this);
+        _model = model;
+        if (_model) _model->addListener(this);
+        modelReset();
+    }
+
+    AbstractItemModel *AbstractItemView::model() const {
+        return _model;
+    }
+
+    void AbstractItemView::setDelegateFactory(DelegateFactory factory) {
+        _delegate_factory = std::move(factory);
+        _changer_signal |= ENGINE_SIGNAL_ITEM_VIEW_DELEGATES_CHANGED;
+        requestRedraw();
+    }
+
+    void AbstractItemView::setFont(const std::string &font_name, const std::string &font_path, float font_size) {
+        if (!TextSystem::global()->isFontContain(font_name)) {
+            TextSystem::global()->addFont(font_name, font_path,
+                                          AbstractWidget::render(), font_size);
+            TextSystem::global()->font(font_name)->setFontPath(font_path);
+            TextSystem::global()->font(font_name)->setFontSize(font_size);
+        }
+        setFont(font_name);
+    }
+
+    void AbstractItemView::setFont(const std::string &font_name) {
+        if (!TextSystem::global()->isFontContain(font_name)) {
+            Logger::log(Logger::Error, "AbstractItemView ({}): The font name '{}' is not contained! You need to specified font path.", _object_name, font_name);
+            return;
+        }
+        _font = TextSystem::global()->font(font_name);
+        if (_font_name != font_name) {
+            _font_name = font_name;
+            _changer_signal |= ENGINE_SIGNAL_ITEM_VIEW_FONT_CHANGED;
+        }
+        requestRedraw();
+    }
+
+    std::string_view AbstractItemView::fontName() const {
+        return _font_name;
+    }
+
+    void AbstractItemView::setTextColor(const SDL_Color &color) {
+        _text_color = color;
+        _changer_signal |= ENGINE_SIGNAL_ITEM_VIEW_DELEGATES_CHANGED;
+        requestRedraw();
+    }
+
+    const SDL_Color &AbstractItemView::textColor() const {
+        return _text_color;
+    }
+
+    void AbstractItemView::setSelectionColor(const SDL_Color &color) {
+        _selection_color = color;
+        _selection_rect.setBorder(0, color);
+        _selection_rect.setBackgroundColor(color);
+        requestRedraw();
+    }
+
+    const SDL_Color &AbstractItemView::selectionColor() const {
+        return _selection_color;
+    }
+
+    void AbstractItemView::setBackgroundVisible(bool visible) {
+        _visible_bg = visible;
+        requestRedraw();
+    }
+
+    void AbstractItemView::setBackgroundColor(const SDL_Color &back_color) {
+        _trigger_area.setBackgroundColor(back_color);
+        requestRedraw();
+    }
+
+    bool AbstractItemView::backgroundVisible() const {
+        return _visible_bg;
+    }
+
+    const SDL_Color &AbstractItemView::backgroundColor() const {
+        return _trigger_area.backgroundColor();
+    }
+
+    void AbstractItemView::setDefaultRowHeight(float height) {
+        _default_height = std::max(height, 0.f);
+        updateRowHeight();
+        requestRedraw();
+    }
+
+    float AbstractItemView::defaultRowHeight() const {
+        return _row_height;
+    }
+
+    float AbstractItemView::rowPosition(size_t row) const {
+        return static_cast<float>(_heights.prefix(row));
+    }
+
+    size_t AbstractItemView::rowAt(float position) const {
+        if (position < 0) return NO_ROW;
+        auto row = _heights.find(position);
+        return row < _heights.size() ? row : NO_ROW;
+    }
+
+    float AbstractItemView::contentHeight() const {
+        return static_cast<float>(_heights.total());
+    }
+
+    void AbstractItemView::setCurrentRow(size_t row) {
+        _current_row = (row < _heights.size()) ? row : NO_ROW;
+        requestRedraw();
+    }
+
+    std::optional<size_t> AbstractItemView::currentRow() const {
+        if (_current_row == NO_ROW) return std::nullopt;
+        return _current_row;
+    }
+
+    void AbstractItemView::setRowClickedEvent(const std::function<void(size_t)> &event) {
+        _row_clicked_event = event;
+    }
+
+    void AbstractItemView::scrollBy(float distance) {
+        _scroll.scrollBy(distance, maxScroll());
+        requestRedraw();
+    }
+
+    void AbstractItemView::scrollToRow(size_t row) {
+        if (row >= _heights.size()) return;
+        measureRow(row);
+        auto top = _heights.prefix(row);
+        auto bottom = top + _heights.value(row);
+        if (top < _scroll.target) {
+            scrollBy(static_cast<float>(top - _scroll.target));
+        } else if (bottom > _scroll.target + _view_height) {
+            scrollBy(static_cast<float>(bottom - _view_height - _scroll.target));
+        }
+    }
+
+    void AbstractItemView::setWheelStep(uint32_t rows) {
+        _scroll.wheel_step = rows;
+    }
+
+    uint32_t AbstractItemView::wheelStep() const {
+        return _scroll.wheel_step;
+    }
+
+    void AbstractItemView::loadEvent() {
+        AbstractWidget::loadEvent();
+        _scroll.restart();
+    }
+
+    void AbstractItemView::unloadEvent() {
+        releaseDelegates();
+        AbstractWidget::unloadEvent();
+    }
+
+    void AbstractItemView::paintEvent(MyEngine::Renderer *renderer) {
+        AbstractWidget::paintEvent(renderer);
+        if (_changer_signal & (ENGINE_SIGNAL_ITEM_VIEW_FONT_CHANGED | ENGINE_SIGNAL_ITEM_VIEW_DELEGATES_CHANGED)) {
+            releaseDelegates();
+        }
+        _changer_signal = 0;
+        updateRowHeight();
+        if (_visible_bg) {
+            renderer->drawRectangle(&_trigger_area);
+        }
+
+        auto area = viewArea();
+        auto header = std::min(headerHeight(), area.size.height);
+        GeometryF content(area.pos.x, area.pos.y + header, area.size.width, area.size.height - header);
+        _view_height = content.size.height;
+        updateColumns(content.size.width, _column_widths);
+        updateScroll();
+        if (header > 0) paintHeader(renderer, GeometryF(area.pos.x, area.pos.y, area.size.width, header));
+        if (!_model || _heights.empty() || content.size.height <= 0) return;
+
+        /// Measure the rows from the first visible one, its top doesn't move when the rows are measured.
+        auto first = std::min(_heights.find(_scroll.position), _heights.size() - 1);
+        auto top = _heights.prefix(first);
+        auto last = first;
+        for (auto bottom = top; last < _heights.size() && bottom < _scroll.position + _view_height; ++last) {
+            measureRow(last);
+            bottom += _heights.value(last);
+        }
+        resizeDelegates(last - first);
+        if (_delegates.empty()) return;
+
+        for (auto row = first; row < last; ++row) {
+            auto height = _heights.value(row);
+            auto slot = row % _delegates.size();
+            auto& delegate = _delegates[slot];
+            if (_delegate_rows[slot] != row) {
+                if (_delegate_rows[slot] != NO_ROW) delegate->unbind();
+                delegate->bind(*_model, row);
+                _delegate_rows[slot] = row;
+            }
+            auto y = content.pos.y + static_cast<float>(top - _scroll.position);
+            top += height;
+            if (height <= 0) continue;
+            bool selected = (row == _current_row);
+            auto x = content.pos.x;
+            for (size_t column = 0; column < _column_widths.size(); ++column) {
+                GeometryF cell(x, y, _column_widths[column], static_cast<float>(height));
+                x += _column_widths[column];
+                /// The clip view is the viewport as well, so the cell is painted relative to the clipped area.
+                auto clip = intersectGeometry(cell, content);
+                if (clip.width <= 0 || clip.height <= 0) continue;
+                renderer->setClipView(clip);
+                GeometryF rect(cell.pos.x - static_cast<float>(clip.x), cell.pos.y - static_cast<float>(clip.y),
+                               cell.size.width, cell.size.height);
+                if (selected) {
+                    _selection_rect.setGeometry(rect);
+                    renderer->drawRectangle(&_selection_rect);
+                }
+                delegate->paint(renderer, column, rect, selected);
+            }
+        }
+        renderer->setClipView({});
+
+        /// Load the next rows before the last page is reached.
+        if (last + (last - first) >= _heights.size() && _model->canFetchMore()) {
+            _model->fetchMore();
+        }
+    }
+
+    void AbstractItemView::mouseClickedEvent() {
+        AbstractWidget::mouseClickedEvent();
+        auto area = viewArea();
+        auto& pos = EventSystem::global()->captureMousePosition();
+        auto y = pos.y - area.pos.y - headerHeight();
+        if (y < 0) return;
+        auto row = rowAt(static_cast<float>(y + _scroll.position));
+        if (row == NO_ROW) return;
+        setCurrentRow(row);
+        if (_row_clicked_event) _row_clicked_event(row);
+    }
+
+    void AbstractItemView::keyDownEvent(SDL_Scancode scancode) {
+        AbstractWidget::keyDownEvent(scancode);
+        if (_heights.empty()) return;
+        auto last = _heights.size() - 1;
+        auto row = _current_row;
+        switch (scancode) {
+            case SDL_SCANCODE_UP:
+                row = (row == NO_ROW || !row) ? 0 : row - 1;
+                break;
+            case SDL_SCANCODE_DOWN:
+                row = (row == NO_ROW) ? 0 : std::min(row + 1, last);
+                break;
+            case SDL_SCANCODE_PAGEUP:
+                row = rowAt(std::max(rowPosition(row == NO_ROW ? 0 : row) - _view_height, 0.f));
+                break;
+            case SDL_SCANCODE_PAGEDOWN:
+                row = rowAt(rowPosition(row == NO_ROW ? 0 : row) + _view_height);
+                if (row == NO_ROW) row = last;
+                break;
+            case SDL_SCANCODE_HOME:
+                row = 0;
+                break;
+            case SDL_SCANCODE_END:
+                row = last;
+                break;
+            default:
+                return;
+        }
+        setCurrentRow(row);
+        scrollToRow(row);
+    }
+
+    void AbstractItemView::mouseWheelEvent(const Vector2 &distance) {
+        AbstractWidget::mouseWheelEvent(distance);
+        scrollBy(static_cast<float>(_scroll.wheelDistance(distance.y, _row_height)));
+    }
+
+    void AbstractItemView::rowsInserted(size_t first, size_t count) {
+        first = std::min(first, _heights.size());
+        /// Keep the visible rows in place if the rows are inserted above them.
+        bool above = first < _heights.size() && _heights.prefix(first) < _scroll.position;
+        if (first == _heights.size()) {
+            for (size_t i = 0; i < count; ++i) _heights.pushBack(_row_height);
+        } else {
+            _heights.insert(first, count, _row_height);
+        }
+        _measured.insert(_measured.begin() + static_cast<ptrdiff_t>(first), count, 0);
+        if (above) _scroll.shift(static_cast<double>(count) * _row_height);
+        if (_current_row != NO_ROW && _current_row >= first) _current_row += count;
+        unbindDelegates(first);
+        requestRedraw();
+    }
+
+    void AbstractItemView::rowsRemoved(size_t first, size_t count) {
+        if (first >= _heights.size()) return;
+        count = std::min(count, _heights.size() - first);
+        auto removed = _heights.prefix(first + count) - _heights.prefix(first);
+        if (_heights.prefix(first + count) <= _scroll.position) _scroll.shift(-removed);
+        _heights.erase(first, count);
+        auto begin = _measured.begin() + static_cast<ptrdiff_t>(first);
+        _measured.erase(begin, begin + static_cast<ptrdiff_t>(count));
+        if (_current_row != NO_ROW && _current_row >= first) {
+            _current_row = (_current_row < first + count) ? NO_ROW : _current_row - count;
+        }
+        unbindDelegates(first);
+        requestRedraw();
+    }
+
+    void AbstractItemView::dataChanged(size_t first, size_t last) {
+        last = std::min(last, _heights.size() - 1);
+        if (first > last || _heights.empty()) return;
+        /// The height is asked again when the row is shown, the old one is kept until then.
+        std::fill(_measured.begin() + static_cast<ptrdiff_t>(first),
+                  _measured.begin() + static_cast<ptrdiff_t>(last + 1), 0);
+        for (size_t i = 0; i < _delegates.size(); ++i) {
+            if (_delegate_rows[i] == NO_ROW || _delegate_rows[i] < first || _delegate_rows[i] > last) continue;
+            _delegates[i]->unbind();
+            _delegate_rows[i] = NO_ROW;
+        }
+        requestRedraw();
+    }
+
+    void AbstractItemView::modelReset() {
+        auto count = _model ? _model->rowCount() : 0;
+        _heights.assign(count, _row_height);
+        _measured.assign(count, 0);
+        _current_row = NO_ROW;
+        _scroll.reset();
+        unbindDelegates(0);
+        requestRedraw();
+    }
+
+    void AbstractItemView::modelDestroyed() {
+        _model = nullptr;
+        modelReset();
+    }
+
+    GeometryF AbstractItemView::viewArea() const {
+        return _parent ? toGeometryFloat(_render_geometry) : _trigger_area.geometry();
+    }
+
+    void AbstractItemView::updateRowHeight() {
+        auto height = _default_height;
+        if (height <= 0) {
+            auto font = _font ? _font->self() : nullptr;
+            height = font ? static_cast<float>(TTF_GetFontLineSkip(font)) + 2 * ROW_PADDING : 24.f;
+        }
+        if (height == _row_height) return;
+        /// The rows are measured again with the new default height when they are shown.
+        _row_height = height;
+        _heights.assign(_heights.size(), height);
+        _measured.assign(_measured.size(), 0);
+    }
+
+    void AbstractItemView::updateScroll() {
+        if (_scroll.update(maxScroll())) requestRedraw();
+    }
+
+    float AbstractItemView::maxScroll() const {
+        return std::max(static_cast<float>(_heights.total()) - _view_height, 0.f);
+    }
+
+    void AbstractItemView::measureRow(size_t row) {
+        if (!_model || row >= _measured.size() || _measured[row]) return;
+        _measured[row] = 1;
+        auto height = _model->rowHeight(row);
+        if (height <= 0) height = _row_height;
+        if (height != _heights.value(row)) _heights.set(row, height);
+    }
+
+    void AbstractItemView::resizeDelegates(size_t count) {
+        /// The pool only grows, the count of the visible rows changes with their heights while scrolling.
+        if (count <= _delegates.size()) return;
+        while (_delegates.size() < count) {
+            auto delegate = _delegate_factory ? _delegate_factory()
+                                              : std::make_unique<TextItemDelegate>(_font_name, _text_color);
+            if (!delegate) break;
+            _delegates.push_back(std::move(delegate));
+        }
+        /// The rows of the delegates are changed with the count.
+        _delegate_rows.resize(_delegates.size(), NO_ROW);
+        unbindDelegates(0);
+    }
+
+    void AbstractItemView::unbindDelegates(size_t first_row) {
+        for (size_t i = 0; i < _delegates.size(); ++i) {
+            if (_delegate_rows[i] == NO_ROW || _delegate_rows[i] < first_row) continue;
+            _delegates[i]->unbind();
+            _delegate_rows[i] = NO_ROW;
+        }
+    }
+
+    void AbstractItemView::releaseDelegates() {
+        _delegates.clear();
+        _delegate_rows.clear();
+    }
+}
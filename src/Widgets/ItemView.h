@@ -0,0 +1,131 @@
+#pragma once
+#ifndef MYENGINE_WIDGETS_ITEMVIEW_H
+#define MYENGINE_WIDGETS_ITEMVIEW_H
+#include "AbstractWidget.h"
+#include "ItemDelegate.h"
+#include "SmoothScroll.h"
+#include "../Utils/PrefixSumTree.h"
+
+#define ENGINE_SIGNAL_ITEM_VIEW_FONT_CHANGED                     0b1
+#define ENGINE_SIGNAL_ITEM_VIEW_DELEGATES_CHANGED                0b10
+
+namespace MyEngine {
+    namespace Widget {
+        /**
+         * \if EN
+         * @class MyEngine::Widget::AbstractItemView
+         * @brief Base of the views showing the rows of an item model in one widget
+         * @details Only the visible rows are bound to delegates and painted, the delegates are recycled
+         * while scrolling, so the cost doesn't grow with the count of the rows.
+         * The heights of the rows are kept in a prefix sum tree, so the row at a scrolled distance is found
+         * in O(log n). A row is measured when it is shown for the first time, the other rows use the default height.
+         * When the view is scrolled near the last row, it asks the model to fetch more rows.
+         * \endif
+         */
+        class AbstractItemView : public AbstractWidget, protected ItemModelListener {
+        public:
+            using DelegateFactory = std::function<std::unique_ptr<AbstractItemDelegate>()>;
+            static constexpr size_t NO_ROW = SIZE_MAX;
+
+            explicit AbstractItemView(Window* window);
+            explicit AbstractItemView(std::string object_name, Window* window);
+            ~AbstractItemView() override;
+
+            /// Set the model shown by the view, it is not owned by the view.
+            void setModel(AbstractItemModel* model);
+            [[nodiscard]] AbstractItemModel* model() const;
+            /// Set the function creating the delegates, the default one creates `TextItemDelegate`.
+            void setDelegateFactory(DelegateFactory factory);
+
+            void setFont(const std::string &font_name, const std::string& font_path, float font_size = 9.f);
+            void setFont(const std::string &font_name);
+            [[nodiscard]] std::string_view fontName() const;
+            void setTextColor(const SDL_Color& color);
+            [[nodiscard]] const SDL_Color& textColor() const;
+            void setSelectionColor(const SDL_Color& color);
+            [[nodiscard]] const SDL_Color& selectionColor() const;
+            void setBackgroundVisible(bool visible);
+            void setBackgroundColor(const SDL_Color& back_color);
+            [[nodiscard]] bool backgroundVisible() const;
+            [[nodiscard]] const SDL_Color& backgroundColor() const;
+
+            /// Set the height of the rows without a height from the model, 0 uses the line height of the font.
+            void setDefaultRowHeight(float height);
+            [[nodiscard]] float defaultRowHeight() const;
+            /// Get the top of the row in the content, the rows not shown yet have the default height.
+            [[nodiscard]] float rowPosition(size_t row) const;
+            /// Get the row at the distance from the top of the content, `NO_ROW` if it is after the last row.
+            [[nodiscard]] size_t rowAt(float position) const;
+            [[nodiscard]] float contentHeight() const;
+
+            void setCurrentRow(size_t row);
+            [[nodiscard]] std::optional<size_t> currentRow() const;
+            /// Set the event called with the row clicked by the mouse.
+            void setRowClickedEvent(const std::function<void(size_t)>& event);
+
+            /// Scroll by `distance` pixels smoothly, it is positive to scroll down.
+            void scrollBy(float distance);
+            /// Scroll the least distance to show the whole row.
+            void scrollToRow(size_t row);
+            void setWheelStep(uint32_t rows);
+            [[nodiscard]] uint32_t wheelStep() const;
+
+        protected:
+            void loadEvent() override;
+            void unloadEvent() override;
+            void paintEvent(MyEngine::Renderer *renderer) override;
+            void mouseClickedEvent() override;
+            void keyDownEvent(SDL_Scancode scancode) override;
+            void mouseWheelEvent(const Vector2 &distance) override;
+
+            void rowsInserted(size_t first, size_t count) override;
+            void rowsRemoved(size_t first, size_t count) override;
+            void dataChanged(size_t first, size_t last) override;
+            void modelReset() override;
+            void modelDestroyed() override;
+
+            /// Set the widths of the columns for the width of the view.
+            virtual void updateColumns(float width, std::vector<float>& widths) = 0;
+            virtual float headerHeight() const { return 0.f; }
+            /// Paint the header above the rows, `area` is in the coordinates of the window.
+            virtual void paintHeader(Renderer* renderer, const GeometryF& area) {}
+            /// Get the area of the view in the coordinates of the window.
+            [[nodiscard]] GeometryF viewArea() const;
+
+            std::vector<float> _column_widths{};
+
+        private:
+            void updateRowHeight();
+            void updateScroll();
+            [[nodiscard]] float maxScroll() const;
+            void measureRow(size_t row);
+            void resizeDelegates(size_t count);
+            void unbindDelegates(size_t first_row);
+            void releaseDelegates();
+        private:
+            AbstractItemModel* _model{};
+            DelegateFactory _delegate_factory{};
+            std::vector<std::unique_ptr<AbstractItemDelegate>> _delegates{};
+            /// The row bound to every delegate, the row is in the delegate at `row % count`.
+            std::vector<size_t> _delegate_rows{};
+            PrefixSumTree<double> _heights{};
+            /// Whether the height of the row is asked from the model.
+            std::vector<uint8_t> _measured{};
+            float _default_height{0}, _row_height{0};
+            Font* _font{};
+            std::string _font_name{};
+            SDL_Color _text_color{StdColor::Black};
+            SDL_Color _selection_color{0x33, 0x99, 0xff, 0x66};
+            Graphics::Rectangle _selection_rect{};
+            bool _visible_bg{true};
+            size_t _current_row{NO_ROW};
+            std::function<void(size_t)> _row_clicked_event{};
+            /// The distance scrolled from the top of the content.
+            SmoothScroll _scroll{};
+            float _view_height{0};
+            uint16_t _changer_signal{};
+        };
+    }
+}
+
+#endif //MYENGINE_WIDGETS_ITEMVIEW_H
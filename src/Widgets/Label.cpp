@@ -34,7 +34,7 @@ namespace MyEngine::Widget {
             TextSystem::global()->font(font_name)->setFontSize(font_size);
         }
         _font = TextSystem::global()->font(font_name);
-        if (_text_id > 0) {
+        if (_text_handle) {
             auto font = property(ENGINE_PROP_FONT_NAME)->toString();
             auto f_size = property(ENGINE_PROP_FONT_SIZE)->toFloat();
             if (font != font_name) {
@@ -46,13 +46,8 @@ namespace MyEngine::Widget {
                 _changer_signal |= ENGINE_SIGNAL_LABEL_FONT_SIZE_CHANGED;
             }
         } else {
-            _text_id = IDGenerator::getNewTextID();
-            TextSystem::global()->addText(_text_id, font_name, _string);
-            bool is_contain = TextSystem::global()->isTextContain(_text_id);
-            if (is_contain) {
-                _text = TextSystem::global()->indexOfText(_text_id);
-            }
-            _visible_text = is_contain;
+            _text_handle = TextSystem::global()->addText(font_name, _string);
+            _visible_text = static_cast<bool>(_text_handle);
         }
         _changer_signal |= ENGINE_SIGNAL_LABEL_TEXT_COLOR_CHANGED;
     }
@@ -63,24 +58,19 @@ namespace MyEngine::Widget {
             return;
         }
         _font = TextSystem::global()->font(font_name);
-        if (_text_id > 0) {
+        if (_text_handle) {
             _changer_signal |= ENGINE_SIGNAL_LABEL_FONT_CHANGED;
             setProperty(ENGINE_PROP_FONT_NAME, font_name);
         } else {
-            _text_id = IDGenerator::getNewTextID();
-            if (TextSystem::global()->isTextContain(_text_id)) {
-                TextSystem::global()->setTextFont(_text_id, font_name);
-            } else {
-                TextSystem::global()->addText(_text_id, font_name, _string);
-            }
+            _text_handle = TextSystem::global()->addText(font_name, _string);
         }
-        _text = TextSystem::global()->indexOfText(_text_id);
-        _visible_text = true;
+        _visible_text = static_cast<bool>(_text_handle);
         _changer_signal |= ENGINE_SIGNAL_LABEL_TEXT_COLOR_CHANGED;
     }
 
     std::string_view Label::fontName() const {
-        return _text ? _text->font_name.data() : nullptr;
+        auto text = textItem();
+        return text ? text->font_name.data() : nullptr;
     }
 
     std::string_view Label::fontPath() const {
@@ -88,25 +78,25 @@ namespace MyEngine::Widget {
     }
 
     void Label::setText(const std::string &text) {
-        if (TextSystem::global()->isTextContain(_text_id)) {
+        if (TextSystem::global()->isTextContain(_text_handle)) {
             _changer_signal |= ENGINE_SIGNAL_LABEL_TEXT_CHANGED;
             _string = text;
         }
     }
 
     const std::string &Label::text() const {
-        return TextSystem::global()->indexOfText(_text_id)->text;
+        return TextSystem::global()->indexOfText(_text_handle)->text;
     }
 
     void Label::appendText(const std::string &text) {
-        if (TextSystem::global()->isTextContain(_text_id)) {
+        if (TextSystem::global()->isTextContain(_text_handle)) {
             _string += text;
             _changer_signal |= ENGINE_SIGNAL_LABEL_TEXT_CHANGED;
         }
     }
 
     void Label::setTextColor(const SDL_Color &color) {
-        if (TextSystem::global()->isTextContain(_text_id)) {
+        if (TextSystem::global()->isTextContain(_text_handle)) {
             _changer_signal |= ENGINE_SIGNAL_LABEL_TEXT_COLOR_CHANGED;
             auto text_color = _GET_PROPERTY_PTR(this, ENGINE_PROP_TEXT_COLOR, SDL_Color);
             text_color->r = color.r;
@@ -118,7 +108,7 @@ namespace MyEngine::Widget {
 
     void Label::setTextColor(uint64_t hex_code, bool alpha) {
         auto color = RGBAColor::hexCode2RGBA(hex_code, alpha);
-        if (TextSystem::global()->isTextContain(_text_id)) {
+        if (TextSystem::global()->isTextContain(_text_handle)) {
             _changer_signal |= ENGINE_SIGNAL_LABEL_TEXT_COLOR_CHANGED;
         }
     }
@@ -132,7 +122,7 @@ namespace MyEngine::Widget {
     }
 
     const SDL_Color &Label::textColor() const {
-        return _text->font_color;
+        return textItem()->font_color;
     }
 
     float Label::fontSize() const {
@@ -265,29 +255,29 @@ namespace MyEngine::Widget {
         AbstractWidget::paintEvent(renderer);
         bool update_text = false, update_img = false;
         bool size_changed = (_changer_signal & ENGINE_SIGNAL_LABEL_SIZE_CHANGED);
-        if (_text) {
+        if (textItem()) {
             if (_changer_signal & ENGINE_SIGNAL_LABEL_TEXT_CHANGED) {
-                TextSystem::global()->setText(_text_id, _string);
+                TextSystem::global()->setText(_text_handle, _string);
                 update_text = true;
             }
             if (_changer_signal & ENGINE_SIGNAL_LABEL_TEXT_COLOR_CHANGED) {
                 auto text_color = *_GET_PROPERTY_PTR(this, ENGINE_PROP_TEXT_COLOR, SDL_Color);
-                TextSystem::global()->setTextColor(_text_id, text_color);
+                TextSystem::global()->setTextColor(_text_handle, text_color);
                 update_text = true;
             }
             if (_changer_signal & ENGINE_SIGNAL_LABEL_FONT_CHANGED) {
                 auto font = property(ENGINE_PROP_FONT_NAME)->toString();
-                TextSystem::global()->setTextFont(_text_id, font);
+                TextSystem::global()->setTextFont(_text_handle, font);
                 update_text = true;
             }
             if (_changer_signal & ENGINE_SIGNAL_LABEL_FONT_SIZE_CHANGED) {
                 auto size = property(ENGINE_PROP_FONT_SIZE)->toFloat();
-                TextSystem::global()->setFontSize(_text->font_name, size);
+                TextSystem::global()->setFontSize(textItem()->font_name, size);
                 update_text = true;
             }
             if (_changer_signal & ENGINE_SIGNAL_LABEL_AUTO_RESIZED_TEXT_CHANGED) {
                 if (_auto_resize_by_text) {
-                    _trigger_area.resize(_text->text_size);
+                    _trigger_area.resize(TextSystem::global()->textSize(_text_handle));
                 }
                 update_text = true;
             }
@@ -353,7 +343,7 @@ namespace MyEngine::Widget {
             renderer->setClipView(clip_geo);
             if (_visible_img && _bg_img) _bg_img->draw();
             if (_visible_text) {
-                TextSystem::global()->drawText(_text_id,_text_pos, renderer);
+                TextSystem::global()->drawText(_text_handle,_text_pos, renderer);
             }
             renderer->setClipView({});
         }
@@ -425,11 +415,11 @@ namespace MyEngine::Widget {
     void Label::updateTextGeometry() {
         if (_auto_resize_by_text) {
             _text_pos.reset(0, 0);
-            _trigger_area.resize(_text->text_size);
+            _trigger_area.resize(TextSystem::global()->textSize(_text_handle));
             return;
         }
         const GeometryF& GEOMETRY = _trigger_area.geometry();
-        const Size& SIZE = _text->text_size;
+        const Size& SIZE = TextSystem::global()->textSize(_text_handle);
         switch (_alignment)  {
             case LeftTop:
                 _text_pos.reset(0, 0);
@@ -465,4 +455,7 @@ namespace MyEngine::Widget {
         }
     }
 
+    TextSystem::Text* Label::textItem() const {
+        return TextSystem::global()->findText(_text_handle);
+    }
 }
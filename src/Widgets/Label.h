@@ -70,14 +70,14 @@ namespace MyEngine {
         private:
             void updateBgIMGGeometry();
             void updateTextGeometry();
+            [[nodiscard]] TextSystem::Text* textItem() const;
         private:
-            uint64_t _text_id{0};
+            TextHandle _text_handle{};
             bool _visible_bg{true};
             bool _visible_text{};
             bool _visible_img{};
             bool _auto_resize_by_text{};
             Font* _font{};
-            TextSystem::Text* _text{};
             std::unique_ptr<Texture> _bg_img{};
             std::string _string{};
             Vector2 _text_pos{};
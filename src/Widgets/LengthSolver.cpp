@@ -0,0 +1,59 @@
+#include "LengthSolver.h"
+
+namespace MyEngine::Widget {
+    void LengthSolver::begin(size_t count) {
+        _solving.clear();
+        _solving.reserve(count);
+    }
+
+    void LengthSolver::append(float min, float max, float stretch) {
+        _solving.push_back({min, std::max(min, max), stretch});
+    }
+
+    const std::vector<float> &LengthSolver::solve(float length) {
+        if (length == _solved_length && _solving == _constraints) return _lengths;
+        std::swap(_solving, _constraints);
+        _solved_length = length;
+
+        auto count = _constraints.size();
+        _lengths.assign(count, 0.f);
+        std::vector<uint8_t> frozen(count, 0);
+        float free_length = length, stretch_sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (_constraints[i].stretch > 0) {
+                stretch_sum += _constraints[i].stretch;
+                continue;
+            }
+            frozen[i] = 1;
+            _lengths[i] = _constraints[i].min;
+            free_length -= _lengths[i];
+        }
+        /// Share the free length by the stretches, then freeze the items out of their sizes and share again.
+        /// Every round freezes one item at least, it is done in one or two rounds in general.
+        while (stretch_sum > 0) {
+            float unit = std::max(free_length, 0.f) / stretch_sum;
+            float violation = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (frozen[i]) continue;
+                float share = unit * _constraints[i].stretch;
+                _lengths[i] = std::clamp(share, _constraints[i].min, _constraints[i].max);
+                violation += _lengths[i] - share;
+            }
+            if (std::abs(violation) < 0.01f) break;
+            for (size_t i = 0; i < count; ++i) {
+                if (frozen[i]) continue;
+                float share = unit * _constraints[i].stretch;
+                if ((violation > 0 && _lengths[i] > share) || (violation < 0 && _lengths[i] < share)) {
+                    frozen[i] = 1;
+                    free_length -= _lengths[i];
+                    stretch_sum -= _constraints[i].stretch;
+                }
+            }
+        }
+        return _lengths;
+    }
+
+    const std::vector<float> &LengthSolver::lengths() const {
+        return _lengths;
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#ifndef MYENGINE_WIDGETS_LENGTHSOLVER_H
+#define MYENGINE_WIDGETS_LENGTHSOLVER_H
+#include "../Libs.h"
+
+namespace MyEngine {
+    namespace Widget {
+        /**
+         * \if EN
+         * @class MyEngine::Widget::LengthSolver
+         * @brief Share a length of a layout by the stretches within the minimum and maximum lengths
+         * @details The items without a stretch keep their minimum lengths. The free length is shared
+         * by the stretches, the items out of their limits are frozen at the limits and the rest is shared again.
+         * The lengths are reused while the constraints and the length are not changed.
+         * \endif
+         */
+        class LengthSolver {
+        public:
+            /// Start appending the constraints of the next solving.
+            void begin(size_t count);
+            /// Append the constraint of an item, `max` less than `min` is taken as `min`.
+            void append(float min, float max, float stretch);
+            /// Get the lengths of the appended items fitting in `length`.
+            const std::vector<float>& solve(float length);
+            [[nodiscard]] const std::vector<float>& lengths() const;
+
+        private:
+            struct Constraint {
+                float min, max, stretch;
+                bool operator==(const Constraint&) const = default;
+            };
+
+            /// The constraints and the length of the last solving, and the lengths solved.
+            std::vector<Constraint> _constraints, _solving;
+            float _solved_length{-1};
+            std::vector<float> _lengths;
+        };
+    }
+}
+
+#endif //MYENGINE_WIDGETS_LENGTHSOLVER_H
@@ -1,5 +1,6 @@
 
 #include "LineEdit.h"
+#include "../Utils/Clock.h"
 
 namespace MyEngine::Widget {
     LineEdit::LineEdit(Window *window) : AbstractWidget(window) {
@@ -21,7 +22,7 @@ namespace MyEngine::Widget {
             TextSystem::global()->font(font_name)->setFontSize(font_size);
         }
         _font = TextSystem::global()->font(font_name);
-        if (_text_id > 0) {
+        if (_text_handle) {
             auto font = property(ENGINE_PROP_FONT_NAME)->toString();
             auto f_size = property(ENGINE_PROP_FONT_SIZE)->toFloat();
             if (font != font_name) {
@@ -33,15 +34,8 @@ namespace MyEngine::Widget {
                 _changer_signal |= ENGINE_SIGNAL_LINE_EDIT_FONT_SIZE_CHANGED;
             }
         } else {
-            _text_id = IDGenerator::getNewTextID();
-            _place_text_id = IDGenerator::getNewTextID();
-            TextSystem::global()->addText(_text_id, font_name, "");
-            TextSystem::global()->addText(_place_text_id, font_name, "");
-            bool is_contain = TextSystem::global()->isTextContain(_text_id);
-            if (is_contain) {
-                _text = TextSystem::global()->indexOfText(_text_id);
-                _place_text = TextSystem::global()->indexOfText(_place_text_id);
-            }
+            _text_handle = TextSystem::global()->addText(font_name, "");
+            _place_text_handle = TextSystem::global()->addText(font_name, "");
         }
         _changer_signal |= ENGINE_SIGNAL_LINE_EDIT_TEXT_COLOR_CHANGED;
     }
@@ -52,31 +46,24 @@ namespace MyEngine::Widget {
             return;
         }
         _font = TextSystem::global()->font(font_name);
-        if (_text_id > 0) {
+        if (_text_handle) {
             _changer_signal |= ENGINE_SIGNAL_LINE_EDIT_FONT_CHANGED;
             setProperty(ENGINE_PROP_FONT_NAME, font_name);
         } else {
-            _text_id = IDGenerator::getNewTextID();
-            _place_text_id = IDGenerator::getNewTextID();
-            if (TextSystem::global()->isTextContain(_text_id)) {
-                TextSystem::global()->setTextFont(_text_id, font_name);
-            } else {
-                TextSystem::global()->addText(_text_id, font_name, "");
-                TextSystem::global()->addText(_place_text_id, font_name, "");
-            }
+            _text_handle = TextSystem::global()->addText(font_name, "");
+            _place_text_handle = TextSystem::global()->addText(font_name, "");
         }
-        _text = TextSystem::global()->indexOfText(_text_id);
-        _place_text = TextSystem::global()->indexOfText(_place_text_id);
         _changer_signal |= ENGINE_SIGNAL_LINE_EDIT_TEXT_COLOR_CHANGED;
     }
 
     std::string_view LineEdit::fontName() const {
-        return _text ? _text->font_name.data() : nullptr;
+        auto text = textItem();
+        return text ? text->font_name.data() : nullptr;
     }
 
     std::string_view LineEdit::fontPath() const {
         auto font = fontName();
-        return _text ? TextSystem::global()->font(font.data())->fontPath().data() : nullptr;
+        return textItem() ? TextSystem::global()->font(font.data())->fontPath().data() : nullptr;
     }
 
     void LineEdit::setFontSize(float size) {
@@ -89,35 +76,62 @@ namespace MyEngine::Widget {
     }
 
     void LineEdit::setText(const std::string &text) {
-        _strings = Algorithm::splitUTF8(text);
-        _changer_signal |= ENGINE_SIGNAL_LINE_EDIT_TEXT_CHANGED;
-        if (_strings.empty()) {
-            _status ^= ENGINE_BOOL_LINE_EDIT_HAS_TEXT;
-            if (!placeHolderText().empty()) _status |= ENGINE_BOOL_LINE_EDIT_PLACEHOLDER_TEXT_VISIBLE;
-        } else {
-            _status |= ENGINE_BOOL_LINE_EDIT_HAS_TEXT;
-            if (!placeHolderText().empty()) _status ^= ENGINE_BOOL_LINE_EDIT_PLACEHOLDER_TEXT_VISIBLE;
-        }
-        if (_status & ENGINE_BOOL_LINE_EDIT_PASSWORD_MODE) {
-            setProperty(ENGINE_PROP_LINE_EDIT_PASSWORD_LENGTH, (uint64_t)_strings.size());
-            setProperty(ENGINE_PROP_LINE_EDIT_PASSWORD,
-                        Algorithm::multiplicationString(_secret_char, _strings.size()));
-        }
-        textChangedEvent();
+        _buffer.setText(text);
+        _cursor = _buffer.size();
+        textEdited();
     }
 
     std::string_view LineEdit::text() const {
+        /// The properties of the text are only built when they are asked, not for every edit.
+        if (_text_dirty) const_cast<LineEdit*>(this)->updateText();
         return {property(ENGINE_PROP_LINE_EDIT_TEXT)->toString()};
     }
 
     const StringList &LineEdit::textList() const {
+        if (_strings_dirty) {
+            _strings = Algorithm::splitUTF8(_buffer.toString());
+            _strings_dirty = false;
+        }
         return _strings;
     }
 
+    const TextBuffer &LineEdit::textBuffer() const {
+        return _buffer;
+    }
+
+    void LineEdit::insertText(const std::string &text) {
+        size_t count;
+        if (text.find_first_of("\r\n") != std::string::npos) {
+            /// It is a single line editor, the line breaks of the pasted text are dropped.
+            std::string line;
+            line.reserve(text.size());
+            for (auto ch : text) {
+                if (ch != '\r' && ch != '\n') line.push_back(ch);
+            }
+            count = _buffer.insert(_cursor, line);
+        } else {
+            count = _buffer.insert(_cursor, text);
+        }
+        if (!count) return;
+        _cursor += count;
+        textEdited();
+    }
+
+    void LineEdit::setCursorPosition(size_t index) {
+        index = std::min(index, _buffer.size());
+        if (index == _cursor) return;
+        _cursor = index;
+        _changer_signal |= ENGINE_SIGNAL_LINE_EDIT_CURSOR_MOVED;
+    }
+
+    size_t LineEdit::cursorPosition() const {
+        return _cursor;
+    }
+
     void LineEdit::setPlaceHolderText(const std::string &text) {
         setProperty(ENGINE_PROP_LINE_EDIT_PLACEHOLDER_TEXT, text);
         _changer_signal |= ENGINE_SIGNAL_LINE_EDIT_PLACEHOLDER_TEXT_CHANGED;
-        if (_strings.empty()) {
+        if (_buffer.empty()) {
             _status |= ENGINE_BOOL_LINE_EDIT_PLACEHOLDER_TEXT_VISIBLE;
         }
     }
@@ -130,13 +144,10 @@ namespace MyEngine::Widget {
         if (enabled) {
             _status |= ENGINE_BOOL_LINE_EDIT_PASSWORD_MODE;
             strncpy(_secret_char, secret, sizeof(char) * 8);
-            setProperty(ENGINE_PROP_LINE_EDIT_PASSWORD_LENGTH, (uint64_t)_strings.size());
-            setProperty(ENGINE_PROP_LINE_EDIT_PASSWORD,
-                        Algorithm::multiplicationString(_secret_char, _strings.size()));
         } else {
-            setProperty(ENGINE_PROP_LINE_EDIT_PASSWORD_LENGTH, 0);
-            _status ^= ENGINE_BOOL_LINE_EDIT_PASSWORD_MODE;
+            _status &= ~ENGINE_BOOL_LINE_EDIT_PASSWORD_MODE;
         }
+        _text_dirty = true;
         _changer_signal |= ENGINE_SIGNAL_LINE_EDIT_PASSWORD_CHANGED;
     }
 
@@ -278,7 +289,7 @@ namespace MyEngine::Widget {
         _changer_signal |= (ENGINE_SIGNAL_LINE_EDIT_PLACEHOLDER_TEXT_COLOR_CHANGED |
                             ENGINE_SIGNAL_LINE_EDIT_TEXT_COLOR_CHANGED);
 
-        if (!_strings.empty()) _status |= ENGINE_BOOL_LINE_EDIT_HAS_TEXT;
+        if (!_buffer.empty()) _status |= ENGINE_BOOL_LINE_EDIT_HAS_TEXT;
     }
 
     void LineEdit::unloadEvent() {
@@ -309,37 +320,37 @@ namespace MyEngine::Widget {
         }
         renderer->drawRectangle(&_trigger_area);
 
-        if (_text) {
+        if (textItem()) {
             bool show_text_mode = false, update_text_pos = false;
             if (!(_status & ENGINE_BOOL_LINE_EDIT_PLACEHOLDER_TEXT_VISIBLE)) {
                 show_text_mode = false;     // show text
             } else {
                 show_text_mode = true;      // show placeholder text
             }
-            if (_changer_signal & ENGINE_SIGNAL_LINE_EDIT_TEXT_CHANGED) {
-                updateText();
+            /// Only the visible part of the text is set to the text item, the whole text is not built.
+            if (_changer_signal & (ENGINE_SIGNAL_LINE_EDIT_TEXT_CHANGED | ENGINE_SIGNAL_LINE_EDIT_PASSWORD_CHANGED)) {
                 update_text_pos = true;
             }
-            if (_changer_signal & ENGINE_SIGNAL_LINE_EDIT_PASSWORD_CHANGED) {
-                updateText();
+            if (_changer_signal & ENGINE_SIGNAL_LINE_EDIT_CURSOR_MOVED) {
+                update_text_pos = true;
             }
             if (_changer_signal & ENGINE_SIGNAL_LINE_EDIT_TEXT_SIZE_CHANGED) {
-                TextSystem::global()->setFontSize(_text->font_name,
+                TextSystem::global()->setFontSize(textItem()->font_name,
                                                   property(ENGINE_PROP_FONT_SIZE)->toFloat());
                 update_text_pos = true;
             }
             if (_changer_signal & ENGINE_SIGNAL_LINE_EDIT_TEXT_COLOR_CHANGED) {
                 auto color = *_GET_PROPERTY_PTR(this, ENGINE_PROP_LINE_EDIT_TEXT_COLOR, SDL_Color);
-                TextSystem::global()->setTextColor(_text_id, color);
+                TextSystem::global()->setTextColor(_text_handle, color);
             }
             if (_changer_signal & ENGINE_SIGNAL_LINE_EDIT_PLACEHOLDER_TEXT_CHANGED) {
                 auto text = property(ENGINE_PROP_LINE_EDIT_PLACEHOLDER_TEXT)->toString();
-                TextSystem::global()->setText(_place_text_id, text);
+                TextSystem::global()->setText(_place_text_handle, text);
                 update_text_pos = true;
             }
             if (_changer_signal & ENGINE_SIGNAL_LINE_EDIT_PLACEHOLDER_TEXT_COLOR_CHANGED) {
                 auto color = *_GET_PROPERTY_PTR(this, ENGINE_PROP_LINE_EDIT_PLACE_HOLDER_TEXT_COLOR, SDL_Color);
-                TextSystem::global()->setTextColor(_place_text_id, color);
+                TextSystem::global()->setTextColor(_place_text_handle, color);
             }
 
             if (update_text_pos) {
@@ -361,21 +372,25 @@ namespace MyEngine::Widget {
             }
             renderer->setClipView(new_clip_view);
             if (show_text_mode) {
-                TextSystem::global()->drawText(_place_text_id, _text_pos, renderer);
+                TextSystem::global()->drawText(_place_text_handle, _text_pos, renderer);
             } else {
-                TextSystem::global()->drawText(_text_id, _text_pos, renderer);
+                TextSystem::global()->drawText(_text_handle, _text_pos, renderer);
             }
             new_clip_view.width += horizontalPadding();
             renderer->setClipView(new_clip_view);
             bool show_cur = (_status & ENGINE_BOOL_LINE_EDIT_CURSOR_VISIBLE);
-            if (!_start_tick) _start_tick = SDL_GetTicks();
-            auto now_tick = SDL_GetTicks();
+            if (!_start_tick) _start_tick = Clock::ticks();
+            auto now_tick = Clock::ticks();
             if (now_tick - _start_tick >= 500) {
                 show_cur = !show_cur;
                 _status ^= ENGINE_BOOL_LINE_EDIT_CURSOR_VISIBLE;
-                _start_tick = SDL_GetTicks();
+                _start_tick = Clock::ticks();
+            }
+            if (_wid_status == WidgetStatus::Input) {
+                if (show_cur) renderer->drawLine(&_cursor_line);
+                /// Keep the cursor blinking while the window is only redrawn on demand.
+                renderer->window()->requestRedrawAfter(500 - std::min<uint64_t>(Clock::ticks() - _start_tick, 500));
             }
-            if (_wid_status == WidgetStatus::Input && show_cur) renderer->drawLine(&_cursor_line);
             renderer->setClipView({});
         }
         _changer_signal = 0;
@@ -401,13 +416,30 @@ namespace MyEngine::Widget {
                 setInputModeEnabled(false);
                 break;
             case SDL_SCANCODE_BACKSPACE:
-                if (!_strings.empty()) {
-                    _strings.pop_back();
-                    _changer_signal |= ENGINE_SIGNAL_LINE_EDIT_TEXT_CHANGED;
+                if (_cursor) eraseText(_cursor - 1, 1);
+                break;
+            case SDL_SCANCODE_DELETE:
+                eraseText(_cursor, 1);
+                break;
+            case SDL_SCANCODE_LEFT:
+                if (_cursor) setCursorPosition(_cursor - 1);
+                break;
+            case SDL_SCANCODE_RIGHT:
+                setCursorPosition(_cursor + 1);
+                break;
+            case SDL_SCANCODE_HOME:
+                setCursorPosition(0);
+                break;
+            case SDL_SCANCODE_END:
+                setCursorPosition(_buffer.size());
+                break;
+            case SDL_SCANCODE_V:
+                if (SDL_GetModState() & SDL_KMOD_CTRL) {
+                    if (auto clipboard = SDL_GetClipboardText()) {
+                        insertText(clipboard);
+                        SDL_free(clipboard);
+                    }
                 }
-                if (_status & ENGINE_BOOL_LINE_EDIT_HAS_TEXT) _status ^= ENGINE_BOOL_LINE_EDIT_HAS_TEXT;
-                if (_strings.empty() && !placeHolderText().empty())
-                    _status |= ENGINE_BOOL_LINE_EDIT_PLACEHOLDER_TEXT_VISIBLE;
                 break;
             default:
                 break;
@@ -462,16 +494,7 @@ namespace MyEngine::Widget {
 
     void LineEdit::inputEvent(const char *string) {
         AbstractWidget::inputEvent(string);
-        auto new_str = Algorithm::splitUTF8(string);
-        for (auto& s : new_str) {
-            _strings.emplace_back(s);
-        }
-
-        _changer_signal |= ENGINE_SIGNAL_LINE_EDIT_TEXT_CHANGED;
-        if (_status & ENGINE_BOOL_LINE_EDIT_PLACEHOLDER_TEXT_VISIBLE)
-            _status ^= ENGINE_BOOL_LINE_EDIT_PLACEHOLDER_TEXT_VISIBLE;
-        _status |= ENGINE_BOOL_LINE_EDIT_HAS_TEXT;
-        textChangedEvent();
+        insertText(string);
     }
 
     void LineEdit::textChangedEvent() {}
@@ -518,6 +541,19 @@ namespace MyEngine::Widget {
         _cursor_line.setColor(StdColor::Black);
         _status |= (ENGINE_BOOL_LINE_EDIT_BACKGROUND_VISIBLE |
                     ENGINE_BOOL_LINE_EDIT_BORDER_VISIBLE);
+        _buffer.setMeasure([this](uint32_t previous, uint32_t codepoint) -> float {
+            if (!_measured_font) return 0.f;
+            if (_measured_password) {
+                const char* secret = _secret_char;
+                size_t length = strnlen(_secret_char, sizeof(_secret_char));
+                codepoint = SDL_StepUTF8(&secret, &length);
+                if (previous) previous = codepoint;
+            }
+            int kerning = 0, advance = 0;
+            if (previous) TTF_GetGlyphKerning(_measured_font, previous, codepoint, &kerning);
+            TTF_GetGlyphMetrics(_measured_font, codepoint, nullptr, nullptr, nullptr, nullptr, &advance);
+            return static_cast<float>(kerning + advance);
+        });
     }
 
     void LineEdit::updateStatus(WidgetStatus status) {
@@ -535,57 +571,113 @@ namespace MyEngine::Widget {
     }
 
     void LineEdit::updateTextPosition() {
-        if (!_text) return;
-        _text_pos.reset(_trigger_area.geometry().pos);
-        auto hp = (float)horizontalPadding();
-        float dis = _trigger_area.geometry().size.width - _text->text_size.width;
-        Vector2 st_pos, ed_pos;
+        if (!textItem()) return;
+        syncTextMeasure();
         auto real_area = toGeometryFloat(_real_area);
-        //st_pos.y += real_area.pos.y;
-        float text_height = 0.f;
-        if (_status & ENGINE_BOOL_LINE_EDIT_PLACEHOLDER_TEXT_VISIBLE) {
-            text_height = _place_text->text_size.height;
+        auto width = real_area.size.width;
+        auto cursor_x = _buffer.position(_cursor);
+        if (_wid_status == WidgetStatus::Input) {
+            /// Scroll as little as possible to keep the cursor visible.
+            if (cursor_x - _scroll_x > width) _scroll_x = cursor_x - width;
+            if (cursor_x < _scroll_x) _scroll_x = cursor_x;
+            _scroll_x = std::clamp(_scroll_x, 0.f, std::max(_buffer.totalAdvance() - width, 0.f));
         } else {
-            text_height = _text->text_size.height;
+            _scroll_x = 0;
         }
+        updateVisibleText();
 
-        if (dis - hp * 2 < 0) {
-            st_pos.x += real_area.size.width;
-            ed_pos.reset(st_pos);
-            _text_pos = {_wid_status == WidgetStatus::Input ? dis - hp * 2 : 0,
-                         real_area.size.height / 2.f - text_height / 2.f};
+        float text_height = 0.f;
+        if (_status & ENGINE_BOOL_LINE_EDIT_PLACEHOLDER_TEXT_VISIBLE) {
+            text_height = TextSystem::global()->textSize(_place_text_handle).height;
         } else {
-            st_pos.x += _text->text_size.width;
-            ed_pos.reset(st_pos);
-            _text_pos = {0, real_area.size.height / 2.f - text_height / 2.f};
+            text_height = TextSystem::global()->textSize(_text_handle).height;
         }
-        ed_pos.y += real_area.size.height;
+        _text_pos = {_buffer.position(_visible_first) - _scroll_x, real_area.size.height / 2.f - text_height / 2.f};
 
+        Vector2 st_pos{std::min(cursor_x - _scroll_x, width), 0}, ed_pos;
+        ed_pos.reset(st_pos);
+        ed_pos.y += real_area.size.height;
         _cursor_line.setStartPosition(st_pos);
         _cursor_line.setEndPosition(ed_pos);
-
     }
 
     void LineEdit::updateText() {
-        auto text = Algorithm::mergeStringList(_strings);
-        setProperty(ENGINE_PROP_LINE_EDIT_TEXT, text);
+        _text_dirty = false;
+        auto size = _buffer.size();
+        setProperty(ENGINE_PROP_LINE_EDIT_TEXT, _buffer.toString());
         if (_status & ENGINE_BOOL_LINE_EDIT_PASSWORD_MODE) {
-            auto passwd = property(ENGINE_PROP_LINE_EDIT_PASSWORD)->toString();
-            auto pass_length = property(ENGINE_PROP_LINE_EDIT_PASSWORD_LENGTH)->toUInt64();
-            if (pass_length < _strings.size()) {
-                passwd.append(Algorithm::multiplicationString
-                                      (_secret_char, _strings.size() - pass_length));
-            } else {
-                passwd.assign(passwd.substr(0, _strings.size() * strlen(_secret_char)));
+            setProperty(ENGINE_PROP_LINE_EDIT_PASSWORD, Algorithm::multiplicationString(_secret_char, size));
+            setProperty(ENGINE_PROP_LINE_EDIT_PASSWORD_LENGTH, (uint64_t)size);
+        } else {
+            setProperty(ENGINE_PROP_LINE_EDIT_PASSWORD);
+            setProperty(ENGINE_PROP_LINE_EDIT_PASSWORD_LENGTH, (uint64_t)0);
+        }
+    }
+
+    void LineEdit::updateVisibleText() {
+        auto width = static_cast<float>(_real_area.width);
+        auto size = _buffer.size();
+        size_t first = 0;
+        float x = 0;
+        if (_scroll_x > 0) {
+            /// The cursor is visible while scrolled, so search from it instead of the beginning.
+            first = _cursor;
+            x = _buffer.position(_cursor);
+            while (first > 0 && x > _scroll_x) {
+                first -= 1;
+                x -= _buffer.advance(first);
             }
-            TextSystem::global()->setText(_text_id, passwd);
-            setProperty(ENGINE_PROP_LINE_EDIT_PASSWORD, passwd);
-            setProperty(ENGINE_PROP_LINE_EDIT_PASSWORD_LENGTH, (uint64_t)_strings.size());
+        }
+        auto last = first;
+        while (last < size && x < _scroll_x + width) {
+            x += _buffer.advance(last);
+            last += 1;
+        }
+        _visible_first = first;
+        _visible_last = last;
+        if (_status & ENGINE_BOOL_LINE_EDIT_PASSWORD_MODE) {
+            TextSystem::global()->setText(_text_handle,
+                                          Algorithm::multiplicationString(_secret_char, last - first));
         } else {
-            TextSystem::global()->setText(_text_id, text);
+            TextSystem::global()->setText(_text_handle, _buffer.substr(first, last));
         }
     }
 
+    void LineEdit::syncTextMeasure() {
+        auto font = _font ? _font->self() : nullptr;
+        auto size = font ? TTF_GetFontSize(font) : 0.f;
+        auto generation = GlyphAtlas::fontGeneration();
+        bool password = _status & ENGINE_BOOL_LINE_EDIT_PASSWORD_MODE;
+        if (font == _measured_font && size == _measured_size &&
+            generation == _measured_generation && password == _measured_password) return;
+        _measured_font = font;
+        _measured_size = size;
+        _measured_generation = generation;
+        _measured_password = password;
+        _buffer.remeasure();
+    }
+
+    void LineEdit::eraseText(size_t index, size_t count) {
+        count = _buffer.erase(index, count);
+        if (!count) return;
+        if (_cursor > index) _cursor -= std::min(_cursor - index, count);
+        textEdited();
+    }
+
+    void LineEdit::textEdited() {
+        _strings_dirty = true;
+        _text_dirty = true;
+        _changer_signal |= ENGINE_SIGNAL_LINE_EDIT_TEXT_CHANGED;
+        if (_buffer.empty()) {
+            _status &= ~ENGINE_BOOL_LINE_EDIT_HAS_TEXT;
+            if (!placeHolderText().empty()) _status |= ENGINE_BOOL_LINE_EDIT_PLACEHOLDER_TEXT_VISIBLE;
+        } else {
+            _status |= ENGINE_BOOL_LINE_EDIT_HAS_TEXT;
+            _status &= ~ENGINE_BOOL_LINE_EDIT_PLACEHOLDER_TEXT_VISIBLE;
+        }
+        textChangedEvent();
+    }
+
     std::string LineEdit::getBorderColorPropertyKey(WidgetStatus status) {
         switch (status) {
             case WidgetStatus::Active:
@@ -631,4 +723,12 @@ namespace MyEngine::Widget {
         }
         return StdColor::Black;
     }
+
+    TextSystem::Text* LineEdit::textItem() const {
+        return TextSystem::global()->findText(_text_handle);
+    }
+
+    TextSystem::Text* LineEdit::placeTextItem() const {
+        return TextSystem::global()->findText(_place_text_handle);
+    }
 }
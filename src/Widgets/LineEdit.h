@@ -4,6 +4,7 @@
 #include "AbstractWidget.h"
 #include "../Utils/RGBAColor.h"
 #include "../Algorithm/String.h"
+#include "../Utils/TextBuffer.h"
 
 #define ENGINE_PROP_LINE_EDIT_BORDER_COLOR_INPUT                   "lineEdit.input.borderColor"
 #define ENGINE_PROP_LINE_EDIT_BACKGROUND_COLOR_INPUT               "lineEdit.input.backgroundColor"
@@ -39,6 +40,7 @@
 #define ENGINE_SIGNAL_LINE_EDIT_FONT_SIZE_CHANGED                  0b100000
 #define ENGINE_SIGNAL_LINE_EDIT_TEXT_COLOR_CHANGED                 0b1000000
 #define ENGINE_SIGNAL_LINE_EDIT_TEXT_SIZE_CHANGED                  0b10000000
+#define ENGINE_SIGNAL_LINE_EDIT_CURSOR_MOVED                       0b100000000
 
 namespace MyEngine {
     namespace Widget {
@@ -57,7 +59,14 @@ namespace MyEngine {
 
             void setText(const std::string& text);
             [[nodiscard]] std::string_view text() const;
+            /// Get the characters of the text, it is built on demand, prefer `text()` or `textBuffer()`.
             [[nodiscard]] const StringList& textList() const;
+            [[nodiscard]] const TextBuffer& textBuffer() const;
+            /// Insert the text at the cursor and move the cursor after it.
+            void insertText(const std::string& text);
+            /// Set the cursor before the character at `index`, it is clamped to the text length.
+            void setCursorPosition(size_t index);
+            [[nodiscard]] size_t cursorPosition() const;
             void setPlaceHolderText(const std::string& text);
             [[nodiscard]] std::string_view placeHolderText() const;
             void setPasswordEnabled(bool enabled, const char* secret = ((char*)u8"\u25CF"));
@@ -111,17 +120,38 @@ namespace MyEngine {
             void init();
             void updateStatus(WidgetStatus status);
             void updateTextPosition();
+            /// Set the text and password properties from the buffer.
             void updateText();
+            /// Set the visible part of the text to the text item, only it is laid out and drawn.
+            void updateVisibleText();
+            /// Measure the characters again if the font, its size or the password mode is changed.
+            void syncTextMeasure();
+            void eraseText(size_t index, size_t count);
+            void textEdited();
             static std::string getBackgroundColorPropertyKey(WidgetStatus status);
             static std::string getBorderColorPropertyKey(WidgetStatus status);
             SDL_Color getBackgroundColor(WidgetStatus status);
             SDL_Color getBorderColor(WidgetStatus status);
+            [[nodiscard]] TextSystem::Text* textItem() const;
+            [[nodiscard]] TextSystem::Text* placeTextItem() const;
         private:
-            uint64_t _text_id{}, _place_text_id{};
+            TextHandle _text_handle{}, _place_text_handle{};
             Font* _font{};
-            TextSystem::Text* _text{}, *_place_text{};
             char _secret_char[8]{};
-            StringList _strings{};
+            TextBuffer _buffer{};
+            mutable StringList _strings{};
+            mutable bool _strings_dirty{false};
+            /// Whether the text and password properties are older than the buffer, they are built in `text()`.
+            bool _text_dirty{false};
+            size_t _cursor{0};
+            /// The scrolled distance of the text, and the visible characters in [first, last).
+            float _scroll_x{0};
+            size_t _visible_first{0}, _visible_last{0};
+            /// The font state the advances in `_buffer` are measured with.
+            TTF_Font* _measured_font{};
+            float _measured_size{};
+            uint64_t _measured_generation{};
+            bool _measured_password{false};
             Vector2 _text_pos{};
             uint16_t _changer_signal{};
             WidgetStatus _wid_status{};
@@ -0,0 +1,14 @@
+
+#include "ListView.h"
+
+namespace MyEngine::Widget {
+    ListView::ListView(Window *window) : AbstractItemView(window) {}
+
+    ListView::ListView(std::string object_name, Window *window) : AbstractItemView(std::move(object_name), window) {}
+
+    ListView::~ListView() {}
+
+    void ListView::updateColumns(float width, std::vector<float> &widths) {
+        widths.assign(1, width);
+    }
+}
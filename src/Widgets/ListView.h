@@ -0,0 +1,21 @@
+#pragma once
+#ifndef MYENGINE_WIDGETS_LISTVIEW_H
+#define MYENGINE_WIDGETS_LISTVIEW_H
+#include "ItemView.h"
+
+namespace MyEngine {
+    namespace Widget {
+        /// Item view showing the first column of the model as a list, see `AbstractItemView`.
+        class ListView : public AbstractItemView {
+        public:
+            explicit ListView(Window* window);
+            explicit ListView(std::string object_name, Window* window);
+            ~ListView() override;
+
+        protected:
+            void updateColumns(float width, std::vector<float>& widths) override;
+        };
+    }
+}
+
+#endif //MYENGINE_WIDGETS_LISTVIEW_H
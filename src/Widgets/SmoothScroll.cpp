@@ -0,0 +1,43 @@
+#include "SmoothScroll.h"
+#include "../Utils/Clock.h"
+
+namespace MyEngine::Widget {
+    void SmoothScroll::restart() {
+        tick = Clock::ticks();
+    }
+
+    void SmoothScroll::scrollBy(double distance, double max) {
+        /// Start easing from now, the time since the last painting is not a part of the animation.
+        if (std::abs(target - position) < 0.5) restart();
+        target = std::clamp(target + distance, 0.0, std::max(max, 0.0));
+    }
+
+    void SmoothScroll::shift(double distance) {
+        position = std::max(position + distance, 0.0);
+        target = std::max(target + distance, 0.0);
+    }
+
+    void SmoothScroll::reset() {
+        position = target = 0;
+    }
+
+    double SmoothScroll::wheelDistance(float wheel_y, float row_height) const {
+        return -static_cast<double>(wheel_y) * wheel_step * row_height;
+    }
+
+    bool SmoothScroll::update(double max) {
+        max = std::max(max, 0.0);
+        target = std::clamp(target, 0.0, max);
+        position = std::clamp(position, 0.0, max);
+        auto now = Clock::ticks();
+        /// Don't jump over the whole distance after a long pause of painting.
+        auto elapsed = static_cast<double>(std::min<uint64_t>(now - tick, 100));
+        tick = now;
+        if (std::abs(target - position) < 0.5) {
+            position = target;
+            return false;
+        }
+        position += (target - position) * (1.0 - std::exp(-elapsed / EASING_MS));
+        return true;
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#ifndef MYENGINE_WIDGETS_SMOOTHSCROLL_H
+#define MYENGINE_WIDGETS_SMOOTHSCROLL_H
+#include "../Libs.h"
+
+namespace MyEngine {
+    namespace Widget {
+        /**
+         * \if EN
+         * @class MyEngine::Widget::SmoothScroll
+         * @brief Scrolled distance easing to its target, shared by the scrollable widgets
+         * @details Scrolling only moves the target, the distance approaches it exponentially when it is updated
+         * in every painting, so the speed is the same whatever the frame rate is.
+         * \endif
+         */
+        struct SmoothScroll {
+            /// The time constant of easing the scrolled distance (in milliseconds).
+            static constexpr double EASING_MS = 50.0;
+
+            /// Start easing from now, the time before it is not a part of the animation.
+            void restart();
+            /// Move the target by `distance` within [0, max].
+            void scrollBy(double distance, double max);
+            /// Move the distance and the target together, e.g. the content above the view is changed.
+            void shift(double distance);
+            void reset();
+            /// Get the distance scrolled by the wheel, it is positive to scroll down.
+            [[nodiscard]] double wheelDistance(float wheel_y, float row_height) const;
+            /// Clamp the distances within [0, max] and ease the distance, return true if it is still moving.
+            bool update(double max);
+
+            /// The distance scrolled from the top of the content, and the distance it eases to.
+            double position{0}, target{0};
+            uint64_t tick{0};
+            /// The count of the rows scrolled by one step of the mouse wheel.
+            uint32_t wheel_step{3};
+        };
+    }
+}
+
+#endif //MYENGINE_WIDGETS_SMOOTHSCROLL_H
@@ -0,0 +1,149 @@
+
+#include "TableView.h"
+
+namespace MyEngine::Widget {
+    namespace {
+        /// The least width of the columns sharing the width left.
+        constexpr float MIN_AUTO_COLUMN_WIDTH = 40.f;
+        constexpr float HEADER_PADDING = 4.f;
+    }
+
+    TableView::TableView(Window *window) : AbstractItemView(window) {
+        init();
+    }
+
+    TableView::TableView(std::string object_name, Window *window) : AbstractItemView(std::move(object_name), window) {
+        init();
+    }
+
+    TableView::~TableView() {}
+
+    void TableView::setColumnWidth(size_t column, float width) {
+        if (_fixed_widths.size() <= column) _fixed_widths.resize(column + 1, 0.f);
+        _fixed_widths[column] = std::max(width, 0.f);
+        requestRedraw();
+    }
+
+    float TableView::columnWidth(size_t column) const {
+        return column < _column_widths.size() ? _column_widths[column] : 0.f;
+    }
+
+    void TableView::setHeaderVisible(bool visible) {
+        _header_visible = visible;
+        requestRedraw();
+    }
+
+    bool TableView::headerVisible() const {
+        return _header_visible;
+    }
+
+    void TableView::setHeaderBackgroundColor(const SDL_Color &color) {
+        _header_rect.setBackgroundColor(color);
+        requestRedraw();
+    }
+
+    const SDL_Color &TableView::headerBackgroundColor() const {
+        return _header_rect.backgroundColor();
+    }
+
+    void TableView::setHeaderTextColor(const SDL_Color &color) {
+        _header_text_color = color;
+        _header_dirty = true;
+        requestRedraw();
+    }
+
+    const SDL_Color &TableView::headerTextColor() const {
+        return _header_text_color;
+    }
+
+    void TableView::unloadEvent() {
+        releaseHeaderTexts();
+        AbstractItemView::unloadEvent();
+    }
+
+    void TableView::modelReset() {
+        _header_dirty = true;
+        AbstractItemView::modelReset();
+    }
+
+    void TableView::updateColumns(float width, std::vector<float> &widths) {
+        auto count = model() ? model()->columnCount() : 0;
+        widths.assign(count, 0.f);
+        float fixed = 0;
+        size_t auto_count = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (i < _fixed_widths.size() && _fixed_widths[i] > 0) {
+                widths[i] = _fixed_widths[i];
+                fixed += widths[i];
+            } else {
+                auto_count += 1;
+            }
+        }
+        if (!auto_count) return;
+        auto shared = std::max((width - fixed) / static_cast<float>(auto_count), MIN_AUTO_COLUMN_WIDTH);
+        for (auto& item : widths) {
+            if (item <= 0) item = shared;
+        }
+    }
+
+    float TableView::headerHeight() const {
+        return (_header_visible && model()) ? defaultRowHeight() : 0.f;
+    }
+
+    void TableView::paintHeader(Renderer *renderer, const GeometryF &area) {
+        updateHeaderTexts();
+        auto clip = toGeometryInt(area);
+        if (clip.width <= 0 || clip.height <= 0) return;
+        renderer->setClipView(clip);
+        _header_rect.setGeometry(0, 0, area.size.width, area.size.height);
+        renderer->drawRectangle(&_header_rect);
+        float x = 0;
+        for (size_t i = 0; i < _header_texts.size() && i < _column_widths.size(); ++i) {
+            auto width = std::min(_column_widths[i], area.size.width - x);
+            if (width <= 0) break;
+            /// Clip every column, so a long title doesn't cover the next one.
+            renderer->setClipView({clip.x + static_cast<int>(x), clip.y,
+                                   static_cast<int>(std::ceil(width)), clip.height});
+            auto& size = TextSystem::global()->textSize(_header_texts[i]);
+            TextSystem::global()->drawText(_header_texts[i],
+                                           {HEADER_PADDING, (area.size.height - size.height) * 0.5f}, renderer);
+            x += _column_widths[i];
+        }
+        renderer->setClipView({});
+    }
+
+    void TableView::init() {
+        _header_rect.setBorder(0, StdColor::LightGray);
+        _header_rect.setBackgroundColor(StdColor::LightGray);
+    }
+
+    void TableView::updateHeaderTexts() {
+        auto font = std::string(fontName());
+        if (font != _header_font) {
+            releaseHeaderTexts();
+            _header_font = font;
+            _header_dirty = true;
+        }
+        if (!_header_dirty || _header_font.empty()) return;
+        _header_dirty = false;
+        auto count = model() ? model()->columnCount() : 0;
+        while (_header_texts.size() > count) {
+            TextSystem::global()->removeText(_header_texts.back());
+            _header_texts.pop_back();
+        }
+        while (_header_texts.size() < count) {
+            auto text = TextSystem::global()->addText(_header_font, "");
+            if (!text) break;
+            _header_texts.push_back(text);
+        }
+        for (size_t i = 0; i < _header_texts.size(); ++i) {
+            TextSystem::global()->setText(_header_texts[i], model()->headerData(i));
+            TextSystem::global()->setTextColor(_header_texts[i], _header_text_color);
+        }
+    }
+
+    void TableView::releaseHeaderTexts() {
+        for (auto text : _header_texts) TextSystem::global()->removeText(text);
+        _header_texts.clear();
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+#ifndef MYENGINE_WIDGETS_TABLEVIEW_H
+#define MYENGINE_WIDGETS_TABLEVIEW_H
+#include "ItemView.h"
+
+namespace MyEngine {
+    namespace Widget {
+        /// Item view showing the columns of the model with a header, see `AbstractItemView`.
+        class TableView : public AbstractItemView {
+        public:
+            explicit TableView(Window* window);
+            explicit TableView(std::string object_name, Window* window);
+            ~TableView() override;
+
+            /// Set the width of the column, 0 shares the width left by the other columns.
+            void setColumnWidth(size_t column, float width);
+            /// Get the width of the column laid out in the last painting.
+            [[nodiscard]] float columnWidth(size_t column) const;
+            void setHeaderVisible(bool visible);
+            [[nodiscard]] bool headerVisible() const;
+            void setHeaderBackgroundColor(const SDL_Color& color);
+            [[nodiscard]] const SDL_Color& headerBackgroundColor() const;
+            void setHeaderTextColor(const SDL_Color& color);
+            [[nodiscard]] const SDL_Color& headerTextColor() const;
+
+        protected:
+            void unloadEvent() override;
+            void modelReset() override;
+            void updateColumns(float width, std::vector<float>& widths) override;
+            float headerHeight() const override;
+            void paintHeader(Renderer* renderer, const GeometryF& area) override;
+
+        private:
+            void init();
+            void updateHeaderTexts();
+            void releaseHeaderTexts();
+        private:
+            std::vector<float> _fixed_widths{};
+            std::vector<TextHandle> _header_texts{};
+            std::string _header_font{};
+            bool _header_dirty{true};
+            bool _header_visible{true};
+            Graphics::Rectangle _header_rect{};
+            SDL_Color _header_text_color{StdColor::Black};
+        };
+    }
+}
+
+#endif //MYENGINE_WIDGETS_TABLEVIEW_H
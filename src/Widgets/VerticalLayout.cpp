@@ -16,22 +16,19 @@ void MyEngine::Widget::VerticalLayout::paintEvent(MyEngine::Renderer *renderer)
 
 void MyEngine::Widget::VerticalLayout::resizeEvent(const MyEngine::Size &size) {
     AbstractLayout::resizeEvent(size);
-    layoutChanged();
 }
 
 void MyEngine::Widget::VerticalLayout::layoutChanged() {
     if (_widgets.empty()) return;
-    Size avg_size;
     size_t wid_size = _widgets.size();
-    if (wid_size == 1)
-        avg_size.reset(_padding_geometry.size);
-    else if (wid_size > 1)
-        avg_size.reset(_padding_geometry.size.width,
-                       (_padding_geometry.size.height - _padding_v * (float)(wid_size - 1)) / (float)wid_size );
+    auto& heights = solveLengths(false, _padding_geometry.size.height - _padding_v * (float)(wid_size - 1));
     float next_height = 0;
-    for (auto& widget : _widgets) {
-        Vector2 new_pos = { _padding_geometry.pos.x,_padding_geometry.pos.y + next_height};
-        widget->setGeometry(new_pos, avg_size);
-        next_height += avg_size.height + _padding_v;
+    for (size_t i = 0; i < wid_size; ++i) {
+        auto widget = _widgets[i];
+        float width = std::max(widget->minimumSize().width,
+                               std::min(_padding_geometry.size.width, widget->maximumSize().width));
+        placeWidget(widget, GeometryF(_padding_geometry.pos.x, _padding_geometry.pos.y + next_height,
+                                      width, heights[i]));
+        next_height += heights[i] + _padding_v;
     }
 }
@@ -84,3 +84,67 @@ TEST_CASE("EventSystem Input Device Test", "[Core][Engine][Events]") {
     });
     CHECK_NOFAIL(engine.exec());
 }
+
+TEST_CASE("EventSystem Record and Replay Test", "[Core][Engine][Events]") {
+    const std::string record_path = "test_event_system.rec";
+    {
+        EventRecorder recorder(record_path, 1000000);
+        REQUIRE(recorder.isValid());
+        SDL_Event text_ev{};
+        text_ev.type = SDL_EVENT_TEXT_INPUT;
+        text_ev.text.text = "Hello";
+        recorder.writeEvent(0, 1500000, text_ev, {1, 10.5f, 20.f, {SDL_SCANCODE_A}});
+        recorder.writeFrame(0, 2000000);
+        SDL_Event key_ev{};
+        key_ev.type = SDL_EVENT_KEY_DOWN;
+        key_ev.key.scancode = SDL_SCANCODE_A;
+        recorder.writeEvent(1, 2500000, key_ev, {});
+        recorder.writeFrame(1, 18000000);
+    }
+    EventReplayer replayer(record_path);
+    REQUIRE(replayer.isValid());
+    CHECK(replayer.startTime() == 1000000);
+    CHECK(replayer.eventCount() == 2);
+    CHECK(replayer.frameCount() == 2);
+
+    auto text_record = replayer.nextEvent(0);
+    REQUIRE(text_record);
+    CHECK(std::string(text_record->event.text.text) == "Hello");
+    CHECK(text_record->timestamp_ns == 1500000);
+    CHECK(text_record->snapshot.mouse_x == 10.5f);
+    CHECK(text_record->snapshot.keys.size() == 1);
+    CHECK_FALSE(replayer.hasEventInFrame(0));
+    CHECK(replayer.nextFrame(0)->timestamp_ns == 2000000);
+
+    auto key_record = replayer.nextEvent(1);
+    REQUIRE(key_record);
+    CHECK(key_record->event.key.scancode == SDL_SCANCODE_A);
+    CHECK(replayer.nextFrame(1)->timestamp_ns == 18000000);
+    CHECK(replayer.finished());
+    std::filesystem::remove(record_path);
+}
+
+TEST_CASE("EventSystem Truncated Record Test", "[Core][Engine][Events]") {
+    const std::string record_path = "test_event_system_truncated.rec";
+    {
+        EventRecorder recorder(record_path, 1000000);
+        REQUIRE(recorder.isValid());
+        SDL_Event key_ev{};
+        key_ev.type = SDL_EVENT_KEY_DOWN;
+        key_ev.key.scancode = SDL_SCANCODE_A;
+        recorder.writeEvent(0, 1500000, key_ev, {});
+        recorder.writeFrame(0, 2000000);
+        recorder.writeEvent(1, 2500000, key_ev, {});
+    }
+    // Cut the end tag and the tail of the last event's payload.
+    std::filesystem::resize_file(record_path, std::filesystem::file_size(record_path) - 3);
+    EventReplayer replayer(record_path);
+    REQUIRE(replayer.isValid());
+    CHECK(replayer.eventCount() == 1);
+    CHECK(replayer.frameCount() == 1);
+    REQUIRE(replayer.nextEvent(0));
+    CHECK(replayer.nextFrame(0));
+    CHECK(replayer.nextEvent(1) == nullptr);
+    CHECK(replayer.finished());
+    std::filesystem::remove(record_path);
+}
@@ -0,0 +1,137 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+
+#include "MultiThread/Queue.h"
+using namespace MyEngine;
+
+TEST_CASE("SpscRingQueue Single Thread Test", "[MultiThread][Queue]") {
+    SpscRingQueue<int> queue(5);
+    CHECK(queue.capacity() == 8);
+    CHECK(queue.empty());
+
+    SECTION("Full and empty") {
+        for (int i = 0; i < 8; ++i) CHECK(queue.tryPush(i));
+        CHECK_FALSE(queue.tryPush(8));
+        CHECK(queue.size() == 8);
+        int value{};
+        for (int i = 0; i < 8; ++i) {
+            REQUIRE(queue.tryPop(value));
+            CHECK(value == i);
+        }
+        CHECK_FALSE(queue.tryPop(value));
+        CHECK(queue.empty());
+    }
+
+    SECTION("Wrap around keeps the order") {
+        int value{}, expected{};
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE(queue.tryPush(i));
+            if (i % 3 == 2) {
+                while (queue.tryPop(value)) CHECK(value == expected++);
+            }
+        }
+        while (queue.tryPop(value)) CHECK(value == expected++);
+        CHECK(expected == 100);
+    }
+
+    SECTION("Batch push and pop") {
+        std::vector<int> input(12);
+        std::iota(input.begin(), input.end(), 0);
+        CHECK(queue.tryPushBatch(input.begin(), input.end()) == 8);
+        std::vector<int> output;
+        CHECK(queue.tryPopBatch(std::back_inserter(output), 3) == 3);
+        CHECK(queue.tryPushBatch(input.begin() + 8, input.end()) == 3);
+        CHECK(queue.tryPopBatch(std::back_inserter(output), 100) == 8);
+        CHECK(output == std::vector<int>(input.begin(), input.begin() + 11));
+    }
+}
+
+TEST_CASE("SpscRingQueue Destroy Items Test", "[MultiThread][Queue]") {
+    auto item = std::make_shared<int>(1);
+    {
+        SpscRingQueue<std::shared_ptr<int>> queue(4);
+        queue.tryPush(item);
+        queue.tryPush(item);
+        std::shared_ptr<int> out;
+        queue.tryPop(out);
+        out.reset();
+        CHECK(item.use_count() == 2);
+    }
+    // The items left in the queue are destroyed with it.
+    CHECK(item.use_count() == 1);
+}
+
+TEST_CASE("SpscRingQueue Two Threads Test", "[MultiThread][Queue]") {
+    constexpr uint64_t COUNT = 200000;
+    SpscRingQueue<uint64_t> queue(64);
+    uint64_t sum{0};
+    bool ordered{true};
+    std::thread consumer([&] {
+        uint64_t value{}, expected{0};
+        for (uint64_t i = 0; i < COUNT; ++i) {
+            if (!queue.pop(value)) break;
+            ordered &= value == expected++;
+            sum += value;
+        }
+    });
+    for (uint64_t i = 0; i < COUNT; ++i) queue.push(i);
+    consumer.join();
+    CHECK(ordered);
+    CHECK(sum == COUNT * (COUNT - 1) / 2);
+}
+
+TEST_CASE("MpmcRingQueue Single Thread Test", "[MultiThread][Queue]") {
+    MpmcRingQueue<int> queue(3);
+    CHECK(queue.capacity() == 4);
+    for (int i = 0; i < 4; ++i) CHECK(queue.tryPush(i));
+    CHECK_FALSE(queue.tryPush(4));
+    int value{};
+    REQUIRE(queue.tryPop(value));
+    CHECK(value == 0);
+    CHECK(queue.tryPush(4));
+    std::vector<int> output;
+    CHECK(queue.tryPopBatch(std::back_inserter(output), 10) == 4);
+    CHECK(output == std::vector<int>{1, 2, 3, 4});
+    CHECK_FALSE(queue.tryPop(value));
+}
+
+TEST_CASE("MpmcRingQueue Multiple Threads Test", "[MultiThread][Queue]") {
+    constexpr uint64_t PRODUCERS = 4, CONSUMERS = 4, COUNT = 50000;
+    MpmcRingQueue<uint64_t> queue(128);
+    std::atomic<uint64_t> sum{0}, popped{0};
+    std::vector<std::thread> threads;
+    for (uint64_t p = 0; p < PRODUCERS; ++p) {
+        threads.emplace_back([&queue, p] {
+            for (uint64_t i = 0; i < COUNT; ++i) queue.push(p * COUNT + i);
+        });
+    }
+    for (uint64_t c = 0; c < CONSUMERS; ++c) {
+        threads.emplace_back([&] {
+            uint64_t value{};
+            while (queue.pop(value)) {
+                sum += value;
+                if (++popped == PRODUCERS * COUNT) queue.stop();
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    constexpr auto TOTAL = PRODUCERS * COUNT;
+    CHECK(popped == TOTAL);
+    CHECK(sum == TOTAL * (TOTAL - 1) / 2);
+    CHECK(queue.empty());
+}
+
+TEST_CASE("Queue Stop Wakes Waiters Test", "[MultiThread][Queue]") {
+    SpscRingQueue<int> spsc(2);
+    MpmcRingQueue<int> mpmc(2);
+    bool spsc_result{true}, mpmc_result{true};
+    std::thread spsc_waiter([&] { int value; spsc_result = spsc.pop(value); });
+    std::thread mpmc_waiter([&] { int value; mpmc_result = mpmc.pop(value); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    spsc.stop();
+    mpmc.stop();
+    spsc_waiter.join();
+    mpmc_waiter.join();
+    CHECK_FALSE(spsc_result);
+    CHECK_FALSE(mpmc_result);
+}
@@ -0,0 +1,179 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+
+#include "MultiThread/TimerScheduler.h"
+#include "Utils/Clock.h"
+using namespace MyEngine;
+
+namespace {
+    constexpr uint64_t TICK = TimerScheduler::TICK_NS;
+    uint64_t now_ns{0};
+
+    /// Drive the wheel by the virtual clock, so the ticks are exact whatever the machine is.
+    TimerScheduler* scheduler() {
+        static auto instance = [] {
+            Clock::setVirtualTime(now_ns);
+            auto scheduler = TimerScheduler::global();
+            scheduler->setServiceMode(TimerScheduler::MainLoop);
+            return scheduler;
+        }();
+        return instance;
+    }
+
+    void step(uint64_t ticks) {
+        now_ns += ticks * TICK;
+        Clock::setVirtualTime(now_ns);
+        scheduler()->update();
+        scheduler()->dispatchMainThread();
+    }
+
+    /// Step tick by tick and return the number of ticks until `fired` is changed, 0 if it isn't in `limit` ticks.
+    uint64_t ticksUntil(const int& fired, uint64_t limit) {
+        auto before = fired;
+        for (uint64_t i = 1; i <= limit; ++i) {
+            step(1);
+            if (fired != before) return i;
+        }
+        return 0;
+    }
+}
+
+TEST_CASE("TimerScheduler Deadline Test", "[MultiThread][TimerScheduler]") {
+    auto timers = scheduler();
+    int fired = 0;
+
+    SECTION("Level 0") {
+        auto handle = timers->schedule(10 * TICK, 0, 1, [&fired] { fired += 1; });
+        CHECK(timers->isScheduled(handle));
+        CHECK(ticksUntil(fired, 100) == 10);
+        CHECK(fired == 1);
+        CHECK_FALSE(timers->isScheduled(handle));
+    }
+
+    SECTION("Zero delay is called at the next tick") {
+        timers->schedule(0, 0, 1, [&fired] { fired += 1; });
+        CHECK(ticksUntil(fired, 10) == 1);
+    }
+
+    SECTION("Repeat with interval") {
+        auto handle = timers->schedule(5 * TICK, 3 * TICK, 3, [&fired] { fired += 1; });
+        CHECK(ticksUntil(fired, 100) == 5);
+        CHECK(ticksUntil(fired, 100) == 3);
+        CHECK(timers->isScheduled(handle));
+        CHECK(ticksUntil(fired, 100) == 3);
+        CHECK(fired == 3);
+        CHECK_FALSE(timers->isScheduled(handle));
+        CHECK(ticksUntil(fired, 100) == 0);
+    }
+
+    SECTION("Late update calls every expired tick") {
+        timers->schedule(TICK, TICK, 4, [&fired] { fired += 1; });
+        step(10);
+        CHECK(fired == 4);
+    }
+    CHECK(timers->scheduledCount() == 0);
+}
+
+TEST_CASE("TimerScheduler Cascade Test", "[MultiThread][TimerScheduler]") {
+    auto timers = scheduler();
+    // The deadlines are cascaded from the higher levels, but still called at the exact tick.
+    for (uint64_t delay : {63ull, 64ull, 65ull, 64ull * 64 - 1, 64ull * 64 + 7, 64ull * 64 * 64 + 100}) {
+        DYNAMIC_SECTION("Delay " << delay << " ticks") {
+            int fired = 0;
+            timers->schedule(delay * TICK, 0, 1, [&fired] { fired += 1; });
+            step(delay - 1);
+            CHECK(fired == 0);
+            CHECK(timers->nextDeadlineNS() <= now_ns + TICK);
+            step(1);
+            CHECK(fired == 1);
+            CHECK(timers->scheduledCount() == 0);
+        }
+    }
+
+    SECTION("Different levels in the same update") {
+        std::vector<int> order;
+        timers->schedule(3000 * TICK, 0, 1, [&order] { order.push_back(3); });
+        timers->schedule(70 * TICK, 0, 1, [&order] { order.push_back(2); });
+        timers->schedule(2 * TICK, 0, 1, [&order] { order.push_back(1); });
+        step(5000);
+        CHECK(order == std::vector<int>{1, 2, 3});
+    }
+    CHECK(timers->scheduledCount() == 0);
+}
+
+TEST_CASE("TimerScheduler Cancel During Dispatch Test", "[MultiThread][TimerScheduler]") {
+    auto timers = scheduler();
+    int fired = 0;
+
+    SECTION("Cancel itself while repeating") {
+        TimerScheduler::Handle handle;
+        handle = timers->schedule(TICK, TICK, 0, [&] {
+            fired += 1;
+            CHECK(timers->cancel(handle));
+        });
+        step(10);
+        CHECK(fired == 1);
+        CHECK_FALSE(timers->isScheduled(handle));
+    }
+
+    SECTION("Cancel itself in the last call") {
+        for (auto dispatch : {TimerScheduler::SchedulerThread, TimerScheduler::MainThread}) {
+            TimerScheduler::Handle handle;
+            handle = timers->schedule(TICK, 0, 1, [&] {
+                fired += 1;
+                // The last call is still cancellable, and isn't released twice after returning.
+                CHECK(timers->cancel(handle));
+            }, dispatch);
+            step(1);
+            CHECK_FALSE(timers->cancel(handle));
+        }
+        CHECK(fired == 2);
+    }
+
+    SECTION("Cancel another job expired at the same tick") {
+        TimerScheduler::Handle first, second;
+        first = timers->schedule(4 * TICK, 0, 1, [&] { fired += 1; timers->cancel(second); });
+        second = timers->schedule(4 * TICK, 0, 1, [&] { fired += 1; timers->cancel(first); });
+        step(4);
+        CHECK(fired == 1);
+    }
+
+    SECTION("Cancel a main thread job before it is dispatched") {
+        auto handle = timers->schedule(TICK, 0, 1, [&fired] { fired += 1; }, TimerScheduler::MainThread);
+        now_ns += TICK;
+        Clock::setVirtualTime(now_ns);
+        timers->update();
+        CHECK(timers->cancel(handle));
+        timers->dispatchMainThread();
+        CHECK(fired == 0);
+    }
+    CHECK(timers->scheduledCount() == 0);
+}
+
+TEST_CASE("TimerScheduler Generation Reuse Test", "[MultiThread][TimerScheduler]") {
+    auto timers = scheduler();
+    int fired = 0;
+    auto old_handle = timers->schedule(10 * TICK, 0, 1, [&fired] { fired += 100; });
+    CHECK(timers->cancel(old_handle));
+    CHECK_FALSE(timers->cancel(old_handle));
+
+    auto handle = timers->schedule(10 * TICK, 0, 1, [&fired] { fired += 1; });
+    REQUIRE(handle.index == old_handle.index);
+    CHECK(handle.generation != old_handle.generation);
+    CHECK_FALSE(timers->isScheduled(old_handle));
+    CHECK_FALSE(timers->cancel(old_handle));
+    CHECK(timers->isScheduled(handle));
+    CHECK(timers->scheduledCount() == 1);
+
+    step(10);
+    CHECK(fired == 1);
+    // The entry is released after the last call, the handle is stale after that.
+    auto next_handle = timers->schedule(TICK, 0, 1, [&fired] { fired += 1; });
+    CHECK(next_handle.index == handle.index);
+    CHECK_FALSE(timers->cancel(handle));
+    CHECK(timers->isScheduled(next_handle));
+    CHECK(timers->cancel(next_handle));
+    CHECK_FALSE(TimerScheduler::Handle{}.isValid());
+    CHECK_FALSE(timers->cancel({}));
+    CHECK(timers->scheduledCount() == 0);
+}
@@ -0,0 +1,95 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+
+#include "Utils/InplaceFunction.h"
+using namespace MyEngine;
+
+TEST_CASE("CallbackList Invoke Test", "[Utils][CallbackList]") {
+    CallbackList<void(int)> list;
+    int sum = 0;
+    CHECK(list.append(1, [&sum](int value) { sum += value; }));
+    CHECK(list.append(2, [&sum](int value) { sum += value * 10; }));
+    CHECK(list.size() == 2);
+    list(1);
+    CHECK(sum == 11);
+
+    // Appending the same ID replaces the callback.
+    CHECK_FALSE(list.append(2, [&sum](int value) { sum += value * 100; }));
+    CHECK(list.size() == 2);
+    list(1);
+    CHECK(sum == 112);
+
+    CHECK(list.remove(1));
+    CHECK_FALSE(list.remove(1));
+    CHECK_FALSE(list.contains(1));
+    list(1);
+    CHECK(sum == 212);
+}
+
+TEST_CASE("CallbackList Change While Invoking Test", "[Utils][CallbackList]") {
+    CallbackList<void()> list;
+    std::vector<int> calls;
+
+    SECTION("Remove a callback not invoked yet") {
+        list.append(1, [&] { calls.push_back(1); list.remove(2); });
+        list.append(2, [&] { calls.push_back(2); });
+        list();
+        list();
+        CHECK(calls == std::vector<int>{1, 1});
+        CHECK(list.size() == 1);
+    }
+
+    SECTION("Append is invoked from the next time") {
+        list.append(1, [&] {
+            calls.push_back(1);
+            if (!list.contains(2)) list.append(2, [&] { calls.push_back(2); });
+        });
+        list();
+        CHECK(calls == std::vector<int>{1});
+        CHECK(list.contains(2));
+        list();
+        CHECK(calls == std::vector<int>{1, 1, 2});
+    }
+
+    SECTION("Clear while invoking") {
+        list.append(1, [&] {
+            calls.push_back(1);
+            list.clear();
+            list.append(3, [&] { calls.push_back(3); });
+        });
+        list.append(2, [&] { calls.push_back(2); });
+        list();
+        CHECK(list.size() == 1);
+        CHECK_FALSE(list.contains(1));
+        list();
+        CHECK(calls == std::vector<int>{1, 3});
+    }
+
+    SECTION("Replace the running callback") {
+        list.append(1, [&] {
+            calls.push_back(1);
+            list.append(1, [&] { calls.push_back(2); });
+            calls.push_back(3);
+        });
+        list();
+        list();
+        CHECK(calls == std::vector<int>{1, 3, 2});
+        CHECK(list.size() == 1);
+    }
+}
+
+TEST_CASE("CallbackList Throw Test", "[Utils][CallbackList]") {
+    CallbackList<void()> list;
+    int calls = 0;
+    list.append(1, [&] {
+        calls += 1;
+        list.append(2, [&] { calls += 10; });
+        throw std::runtime_error("Callback failed");
+    });
+    CHECK_THROWS(list());
+    // The list is left by the throwing callback, so the removal is done at once and the appended one is kept.
+    CHECK(list.remove(1));
+    list();
+    CHECK(calls == 11);
+    CHECK(list.size() == 1);
+}
@@ -0,0 +1,104 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+
+#include "Utils/PrefixSumTree.h"
+using namespace MyEngine;
+
+namespace {
+    /// Check every prefix sum and search against the plain array.
+    void checkTree(const PrefixSumTree<int>& tree, const std::vector<int>& values) {
+        REQUIRE(tree.size() == values.size());
+        int sum = 0;
+        for (size_t i = 0; i < values.size(); ++i) {
+            CHECK(tree.value(i) == values[i]);
+            CHECK(tree.prefix(i) == sum);
+            sum += values[i];
+        }
+        CHECK(tree.prefix(values.size()) == sum);
+        CHECK(tree.total() == sum);
+        for (int position = 0; position <= sum; ++position) {
+            auto index = tree.find(position);
+            // The last index whose prefix sum is not over the position.
+            size_t expected = 0;
+            int prefix = 0;
+            while (expected < values.size() && prefix + values[expected] <= position) prefix += values[expected++];
+            CHECK(index == expected);
+        }
+    }
+}
+
+TEST_CASE("PrefixSumTree Build Test", "[Utils][PrefixSumTree]") {
+    PrefixSumTree<int> tree;
+    CHECK(tree.empty());
+    CHECK(tree.total() == 0);
+    CHECK(tree.find(10) == 0);
+
+    tree.assign(13, 3);
+    checkTree(tree, std::vector<int>(13, 3));
+    CHECK(tree.find(0) == 0);
+    CHECK(tree.find(5) == 1);
+    CHECK(tree.find(6) == 2);
+    CHECK(tree.find(39) == 13);
+    CHECK(tree.value(13) == 0);
+}
+
+TEST_CASE("PrefixSumTree Edit Test", "[Utils][PrefixSumTree]") {
+    PrefixSumTree<int> tree;
+    std::vector<int> values;
+
+    SECTION("Push back") {
+        for (int i = 1; i <= 37; ++i) {
+            tree.pushBack(i % 5);
+            values.push_back(i % 5);
+            checkTree(tree, values);
+        }
+    }
+
+    SECTION("Set") {
+        tree.assign(20, 2);
+        values.assign(20, 2);
+        for (size_t i = 0; i < 20; i += 3) {
+            tree.set(i, static_cast<int>(i));
+            values[i] = static_cast<int>(i);
+        }
+        tree.set(100, 1);
+        checkTree(tree, values);
+    }
+
+    SECTION("Insert and erase in the middle") {
+        tree.assign(10, 1);
+        values.assign(10, 1);
+        tree.insert(4, 3, 5);
+        values.insert(values.begin() + 4, 3, 5);
+        checkTree(tree, values);
+        tree.insert(100, 1, 7);
+        values.push_back(7);
+        checkTree(tree, values);
+        tree.erase(2, 4);
+        values.erase(values.begin() + 2, values.begin() + 6);
+        checkTree(tree, values);
+        tree.erase(5, 100);
+        values.resize(5);
+        checkTree(tree, values);
+        tree.erase(100, 1);
+        checkTree(tree, values);
+    }
+
+    SECTION("Zero values are skipped by searching") {
+        values = {0, 4, 0, 0, 2, 0};
+        for (auto value : values) tree.pushBack(value);
+        checkTree(tree, values);
+        CHECK(tree.find(0) == 1);
+        CHECK(tree.find(4) == 4);
+        CHECK(tree.find(6) == 6);
+    }
+}
+
+TEST_CASE("PrefixSumTree Float Test", "[Utils][PrefixSumTree]") {
+    PrefixSumTree<float> tree(4, 20.f);
+    tree.set(1, 40.f);
+    CHECK(tree.prefix(2) == 60.f);
+    CHECK(tree.total() == 100.f);
+    CHECK(tree.find(59.5f) == 1);
+    CHECK(tree.find(60.f) == 2);
+}
@@ -0,0 +1,89 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+
+#include "Utils/SlotMap.h"
+using namespace MyEngine;
+
+TEST_CASE("SlotMap Insert And Get Test", "[Utils][SlotMap]") {
+    SlotMap<int> map;
+    auto a = map.insert(1);
+    auto b = map.insert(2);
+    auto c = map.emplace(3);
+    CHECK(map.size() == 3);
+    CHECK_FALSE(a.isNull());
+    CHECK(a != b);
+    REQUIRE(map.get(a));
+    REQUIRE(map.get(b));
+    REQUIRE(map.get(c));
+    CHECK(*map.get(a) == 1);
+    CHECK(*map.get(b) == 2);
+    CHECK(*map.get(c) == 3);
+    CHECK(map.get(SlotMap<int>::HandleType{}) == nullptr);
+    CHECK(Handle<int>::fromValue(b.value()) == b);
+}
+
+TEST_CASE("SlotMap Stale Handle Test", "[Utils][SlotMap]") {
+    SlotMap<int> map;
+    auto a = map.insert(1);
+    auto b = map.insert(2);
+    auto c = map.insert(3);
+
+    SECTION("Erased handle is stale") {
+        CHECK(map.erase(a));
+        CHECK_FALSE(map.contains(a));
+        CHECK(map.get(a) == nullptr);
+        CHECK_FALSE(map.erase(a));
+        // The last value is moved into the erased place, the other handles still work.
+        CHECK(map.size() == 2);
+        CHECK(*map.get(b) == 2);
+        CHECK(*map.get(c) == 3);
+    }
+
+    SECTION("Reused slot doesn't match the old handle") {
+        map.erase(b);
+        auto d = map.insert(4);
+        CHECK(d.index() == b.index());
+        CHECK(d.generation() != b.generation());
+        CHECK(map.get(b) == nullptr);
+        CHECK(*map.get(d) == 4);
+        CHECK_FALSE(map.erase(b));
+        CHECK(*map.get(d) == 4);
+    }
+
+    SECTION("Clear makes all handles stale") {
+        map.clear();
+        CHECK(map.empty());
+        CHECK(map.get(a) == nullptr);
+        CHECK(map.get(b) == nullptr);
+        CHECK(map.get(c) == nullptr);
+        auto d = map.insert(5);
+        CHECK_FALSE(map.contains(a));
+        CHECK_FALSE(map.contains(b));
+        CHECK_FALSE(map.contains(c));
+        CHECK(*map.get(d) == 5);
+    }
+
+    SECTION("Handle out of the slots") {
+        CHECK(map.get(SlotMap<int>::HandleType{100, 1}) == nullptr);
+    }
+}
+
+TEST_CASE("SlotMap Dense Iteration Test", "[Utils][SlotMap]") {
+    SlotMap<int> map;
+    std::vector<SlotMap<int>::HandleType> handles;
+    for (int i = 0; i < 100; ++i) handles.push_back(map.insert(i));
+    for (int i = 0; i < 100; i += 2) map.erase(handles[i]);
+    REQUIRE(map.size() == 50);
+
+    int sum = 0;
+    for (auto value : map) sum += value;
+    CHECK(sum == 2500);
+
+    // handleAt() gets the handle of a dense value back.
+    for (size_t i = 0; i < map.size(); ++i) {
+        auto handle = map.handleAt(i);
+        REQUIRE(map.get(handle));
+        CHECK(*map.get(handle) == map.values()[i]);
+        CHECK(handles[map.values()[i]] == handle);
+    }
+}
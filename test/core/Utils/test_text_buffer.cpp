@@ -0,0 +1,154 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+
+#include "Utils/TextBuffer.h"
+using namespace MyEngine;
+
+namespace {
+    std::vector<int> toVector(const GapVector<int>& vector) {
+        std::vector<int> result(vector.size());
+        vector.copy(0, vector.size(), result.data());
+        return result;
+    }
+
+    /// Every code point is as wide as its byte length, plus 0.5 of kerning after another code point.
+    float measureBytes(uint32_t previous, uint32_t codepoint) {
+        float width = codepoint < 0x80 ? 1.f : codepoint < 0x800 ? 2.f : codepoint < 0x10000 ? 3.f : 4.f;
+        return width + (previous ? 0.5f : 0.f);
+    }
+}
+
+TEST_CASE("GapVector Gap Move Test", "[Utils][TextBuffer]") {
+    GapVector<int> vector;
+    std::vector<int> expected;
+    int values[] = {0, 1, 2, 3, 4, 5, 6, 7};
+    vector.insert(0, values, 8);
+    expected.assign(values, values + 8);
+    CHECK(vector.gapPosition() == 8);
+    CHECK(toVector(vector) == expected);
+
+    SECTION("Move the gap backward and forward") {
+        int extra[] = {10, 11};
+        vector.insert(2, extra, 2);
+        expected.insert(expected.begin() + 2, extra, extra + 2);
+        CHECK(vector.gapPosition() == 4);
+        CHECK(toVector(vector) == expected);
+
+        vector.insert(9, extra, 1);
+        expected.insert(expected.begin() + 9, 10);
+        CHECK(vector.gapPosition() == 10);
+        CHECK(toVector(vector) == expected);
+
+        vector.moveGap(0);
+        CHECK(toVector(vector) == expected);
+        vector.moveGap(100);
+        CHECK(vector.gapPosition() == vector.size());
+        CHECK(toVector(vector) == expected);
+        for (size_t i = 0; i < expected.size(); ++i) CHECK(vector[i] == expected[i]);
+    }
+
+    SECTION("Erase around the gap") {
+        vector.erase(3, 2);
+        expected.erase(expected.begin() + 3, expected.begin() + 5);
+        CHECK(toVector(vector) == expected);
+        vector.erase(0, 1);
+        expected.erase(expected.begin());
+        CHECK(toVector(vector) == expected);
+        vector.erase(4, 100);
+        expected.resize(4);
+        CHECK(toVector(vector) == expected);
+    }
+
+    SECTION("Copy a range across the gap") {
+        vector.moveGap(4);
+        std::vector<int> range(4);
+        vector.copy(2, 4, range.data());
+        CHECK(range == std::vector<int>{2, 3, 4, 5});
+    }
+
+    SECTION("Grow keeps the elements after the gap") {
+        vector.moveGap(3);
+        std::vector<int> many(200, 9);
+        vector.insert(3, many.data(), many.size());
+        expected.insert(expected.begin() + 3, many.begin(), many.end());
+        CHECK(toVector(vector) == expected);
+    }
+}
+
+TEST_CASE("TextBuffer UTF-8 Boundary Test", "[Utils][TextBuffer]") {
+    // 1, 2, 3 and 4 bytes code points.
+    TextBuffer buffer("aé中😀b");
+    REQUIRE(buffer.size() == 5);
+    CHECK(buffer.byteSize() == 11);
+    CHECK(buffer.codepoint(0) == U'a');
+    CHECK(buffer.codepoint(1) == U'é');
+    CHECK(buffer.codepoint(2) == U'中');
+    CHECK(buffer.codepoint(3) == U'😀');
+    CHECK(buffer.codepoint(4) == U'b');
+    CHECK(buffer.codepoint(5) == 0);
+    CHECK(buffer.byteOffset(0) == 0);
+    CHECK(buffer.byteOffset(1) == 1);
+    CHECK(buffer.byteOffset(2) == 3);
+    CHECK(buffer.byteOffset(3) == 6);
+    CHECK(buffer.byteOffset(4) == 10);
+    CHECK(buffer.byteOffset(5) == 11);
+
+    SECTION("Substring on the code points") {
+        CHECK(buffer.substr(1, 3) == "é中");
+        CHECK(buffer.substr(3, 100) == "😀b");
+        CHECK(buffer.substr(3, 3).empty());
+    }
+
+    SECTION("Insert between the multi-byte code points") {
+        CHECK(buffer.insert(2, "xü") == 2);
+        CHECK(buffer.toString() == "aéxü中😀b");
+        CHECK(buffer.codepoint(3) == U'ü');
+        CHECK(buffer.byteOffset(4) == 6);
+        CHECK(buffer.insert(100, "!") == 1);
+        CHECK(buffer.toString() == "aéxü中😀b!");
+    }
+
+    SECTION("Erase the multi-byte code points") {
+        CHECK(buffer.erase(1, 2) == 2);
+        CHECK(buffer.toString() == "a😀b");
+        CHECK(buffer.byteSize() == 6);
+        CHECK(buffer.erase(1, 100) == 2);
+        CHECK(buffer.toString() == "a");
+        CHECK(buffer.erase(5, 1) == 0);
+    }
+
+    SECTION("Stop at the null character") {
+        buffer.setText(std::string_view("ab\0cd", 5));
+        CHECK(buffer.size() == 2);
+        CHECK(buffer.toString() == "ab");
+    }
+}
+
+TEST_CASE("TextBuffer Advance Test", "[Utils][TextBuffer]") {
+    TextBuffer buffer("aé中");
+    buffer.setMeasure(measureBytes);
+    CHECK(buffer.advance(0) == 1.f);
+    CHECK(buffer.advance(1) == 2.5f);
+    CHECK(buffer.advance(2) == 3.5f);
+    CHECK(buffer.totalAdvance() == 7.f);
+
+    // The gap is moved to every edit, the positions must be the same as summing the advances.
+    buffer.insert(0, "😀");
+    buffer.insert(2, "b");
+    buffer.erase(3, 1);
+    buffer.insert(3, "cd");
+    REQUIRE(buffer.toString() == "😀abcd中");
+    // The code point after every edit is measured again with its new previous code point.
+    CHECK(buffer.advance(0) == 4.f);
+    CHECK(buffer.advance(1) == 1.5f);
+    float x = 0;
+    for (size_t i = 0; i <= buffer.size(); ++i) {
+        CHECK(buffer.position(i) == x);
+        x += buffer.advance(i);
+    }
+    CHECK(buffer.totalAdvance() == buffer.position(buffer.size()));
+
+    buffer.clear();
+    CHECK(buffer.empty());
+    CHECK(buffer.totalAdvance() == 0.f);
+}
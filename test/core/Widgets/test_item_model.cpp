@@ -0,0 +1,92 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+
+#include "Widgets/ItemModel.h"
+using namespace MyEngine;
+using namespace MyEngine::Widget;
+
+namespace {
+    /// Count the notifications, it can remove a listener from the model when it is notified.
+    class CountListener : public ItemModelListener {
+    public:
+        void rowsInserted(size_t, size_t) override { notified(); }
+        void rowsRemoved(size_t, size_t) override { notified(); }
+        void dataChanged(size_t, size_t) override { notified(); }
+        void modelReset() override { notified(); }
+        void modelDestroyed() override { destroyed = true; }
+
+        void notified() {
+            count += 1;
+            if (model && remove) model->removeListener(remove);
+        }
+
+        AbstractItemModel* model{nullptr};
+        ItemModelListener* remove{nullptr};
+        int count{0};
+        bool destroyed{false};
+    };
+}
+
+TEST_CASE("ItemModel Notification Test", "[Widgets][ItemModel]") {
+    StringListModel model({"a", "b"});
+    CountListener first, second;
+    model.addListener(&first);
+    model.addListener(&second);
+    model.append("c");
+    model.setString(0, "d");
+    model.remove(0);
+    model.setStringList({"e"});
+    CHECK(first.count == 4);
+    CHECK(second.count == 4);
+    CHECK(model.stringList() == StringList{"e"});
+
+    model.removeListener(&first);
+    model.clear();
+    CHECK(first.count == 4);
+    CHECK(second.count == 5);
+}
+
+TEST_CASE("ItemModel Remove Listener While Notifying Test", "[Widgets][ItemModel]") {
+    StringListModel model;
+    CountListener first, second, third;
+    for (auto listener : {&first, &second, &third}) {
+        listener->model = &model;
+        model.addListener(listener);
+    }
+
+    SECTION("Remove itself") {
+        second.remove = &second;
+        model.append("a");
+        model.append("b");
+        CHECK(first.count == 2);
+        CHECK(second.count == 1);
+        CHECK(third.count == 2);
+    }
+
+    SECTION("Remove a listener not notified yet") {
+        first.remove = &third;
+        model.append("a");
+        model.append("b");
+        CHECK(first.count == 2);
+        CHECK(second.count == 2);
+        CHECK(third.count == 0);
+    }
+
+    SECTION("Remove a notified listener") {
+        third.remove = &first;
+        model.append("a");
+        model.append("b");
+        CHECK(first.count == 1);
+        CHECK(second.count == 2);
+        CHECK(third.count == 2);
+    }
+}
+
+TEST_CASE("ItemModel Destroyed Test", "[Widgets][ItemModel]") {
+    CountListener listener;
+    {
+        StringListModel model;
+        model.addListener(&listener);
+    }
+    CHECK(listener.destroyed);
+}
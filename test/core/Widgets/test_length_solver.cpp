@@ -0,0 +1,78 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_test_macros.hpp>
+
+#include "Widgets/LengthSolver.h"
+using namespace MyEngine::Widget;
+
+namespace {
+    struct Item {
+        float min, max, stretch;
+    };
+
+    std::vector<float> solve(LengthSolver& solver, std::initializer_list<Item> items, float length) {
+        solver.begin(items.size());
+        for (auto& item : items) solver.append(item.min, item.max, item.stretch);
+        return solver.solve(length);
+    }
+
+    bool near(const std::vector<float>& lengths, const std::vector<float>& expected) {
+        if (lengths.size() != expected.size()) return false;
+        for (size_t i = 0; i < lengths.size(); ++i) {
+            if (std::abs(lengths[i] - expected[i]) > 0.01f) return false;
+        }
+        return true;
+    }
+
+    constexpr float NO_MAX = 1e9f;
+}
+
+TEST_CASE("LengthSolver Stretch Test", "[Widgets][Layout]") {
+    LengthSolver solver;
+    CHECK(solve(solver, {}, 100).empty());
+    CHECK(near(solve(solver, {{0, NO_MAX, 1}, {0, NO_MAX, 1}, {0, NO_MAX, 2}}, 100), {25, 25, 50}));
+    // The items without a stretch keep the minimum length, the rest is shared.
+    CHECK(near(solve(solver, {{30, NO_MAX, 0}, {0, NO_MAX, 1}, {0, NO_MAX, 1}}, 100), {30, 35, 35}));
+    // The maximum less than the minimum is taken as the minimum.
+    CHECK(near(solve(solver, {{20, 10, 1}, {0, NO_MAX, 1}}, 100), {20, 80}));
+}
+
+TEST_CASE("LengthSolver Min Max Freezing Test", "[Widgets][Layout]") {
+    LengthSolver solver;
+
+    SECTION("Freeze at the maximum") {
+        CHECK(near(solve(solver, {{0, 10, 1}, {0, NO_MAX, 1}, {0, NO_MAX, 1}}, 100), {10, 45, 45}));
+    }
+
+    SECTION("Freeze at the minimum") {
+        CHECK(near(solve(solver, {{60, NO_MAX, 1}, {0, NO_MAX, 1}, {0, NO_MAX, 1}}, 100), {60, 20, 20}));
+    }
+
+    SECTION("Freezing one makes another out of its limit") {
+        // The share is 33.3 first, the first item is frozen at 10, then the share 45 is over the second's 40.
+        CHECK(near(solve(solver, {{0, 10, 1}, {0, 40, 1}, {0, NO_MAX, 1}}, 100), {10, 40, 50}));
+        // The share is 25 first, the first item is frozen at 40, then the share 20 is under the second's 22.
+        CHECK(near(solve(solver, {{40, NO_MAX, 1}, {22, NO_MAX, 1}, {0, NO_MAX, 1}, {0, NO_MAX, 1}}, 100),
+                   {40, 22, 19, 19}));
+    }
+
+    SECTION("All items are limited") {
+        CHECK(near(solve(solver, {{0, 10, 1}, {0, 20, 1}}, 100), {10, 20}));
+        CHECK(near(solve(solver, {{40, NO_MAX, 1}, {50, NO_MAX, 1}}, 60), {40, 50}));
+    }
+
+    SECTION("No free length") {
+        CHECK(near(solve(solver, {{80, NO_MAX, 0}, {10, NO_MAX, 1}, {0, NO_MAX, 1}}, 50), {80, 10, 0}));
+    }
+}
+
+TEST_CASE("LengthSolver Cache Test", "[Widgets][Layout]") {
+    LengthSolver solver;
+    auto& lengths = solver.lengths();
+    solve(solver, {{0, NO_MAX, 1}, {0, NO_MAX, 1}}, 100);
+    REQUIRE(near(lengths, {50, 50}));
+    // Nothing is changed, the lengths are reused, and every change of the constraints or the length solves again.
+    CHECK(near(solve(solver, {{0, NO_MAX, 1}, {0, NO_MAX, 1}}, 100), {50, 50}));
+    CHECK(near(solve(solver, {{0, NO_MAX, 1}, {0, NO_MAX, 1}}, 60), {30, 30}));
+    CHECK(near(solve(solver, {{0, NO_MAX, 1}, {0, NO_MAX, 2}}, 60), {20, 40}));
+    CHECK(near(solve(solver, {{0, NO_MAX, 1}, {0, 10, 2}}, 60), {50, 10}));
+}